@@ -0,0 +1,103 @@
+/**
+ * Frame packer benchmark
+ *
+ * For a range of event densities, generates random 2-bit frames, decodes
+ * them with FrameUnpacker and prints the time FramePacker takes to pack
+ * the events back, and the event rate (sparse or bulk path). Correctness
+ * is checked by test/unit/test_frame_packer.cpp.
+ *
+ * Usage:
+ *   ./bench_pack [width height] [ms_per_density]
+ *   Defaults: 1280 720, 200 ms per density
+ */
+
+#include "config.hpp"
+#include "frame_packer.hpp"
+#include "frame_unpacker.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * Random frame: events at `density` of the pixels, some code-11 pixels,
+ * random bits in the padding of the last byte
+ */
+std::vector<uint8_t> makeFrame(const converter::Config& cfg, double density, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::vector<uint8_t> frame(static_cast<size_t>(cfg.frame_size()), 0);
+    const size_t padded = frame.size() * 4;
+    for (size_t pixel = 0; pixel < padded; pixel++) {
+        uint8_t code = 0;
+        const double r = chance(rng);
+        if (pixel >= static_cast<size_t>(cfg.total_pixels())) {
+            code = static_cast<uint8_t>(rng() & 3);
+        } else if (r < density) {
+            code = r < density / 2 ? 1 : 2;
+        } else if (r < density + 0.001) {
+            code = 3;
+        }
+        frame[pixel / 4] |= static_cast<uint8_t>(code << (6 - 2 * (pixel % 4)));
+    }
+    return frame;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    converter::Config cfg;
+    cfg.unpack_kernel = converter::UnpackKernel::Scalar;
+    if (argc > 2) {
+        cfg.width = std::stoi(argv[1]);
+        cfg.height = std::stoi(argv[2]);
+    }
+    const int duration_ms = argc > 3 ? std::stoi(argv[3]) : 200;
+
+    const std::vector<double> densities = {0.0, 0.001, 0.01, 0.02, 0.05, 0.25, 0.5, 1.0};
+    std::mt19937 rng(12345);
+
+    converter::FramePacker packer(cfg);
+    converter::FrameUnpacker unpacker(cfg);
+
+    std::cout << "Frame packer benchmark: " << cfg.width << " x " << cfg.height
+              << " (" << cfg.frame_size() << " bytes/frame), bulk kernel " << packer.getKernelName()
+              << ", bulk path from " << cfg.total_pixels() / converter::FramePacker::kBulkDivisor
+              << " events" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(10) << "density" << std::setw(10) << "path"
+              << std::setw(14) << "ms/frame" << "MEv/s" << std::endl;
+
+    for (double density : densities) {
+        const std::vector<uint8_t> frame = makeFrame(cfg, density, rng);
+        dv::EventPacket packet;
+        unpacker.unpack(frame.data(), frame.size(), 0, packet);
+        const size_t events = packet.elements.size();
+
+        std::vector<uint8_t> packed;
+        size_t frames = 0;
+        const auto start = std::chrono::steady_clock::now();
+        const auto deadline = start + std::chrono::milliseconds(duration_ms);
+        auto now = start;
+        do {
+            packer.pack(packet.elements.data(), events, packed);
+            frames++;
+            now = std::chrono::steady_clock::now();
+        } while (now < deadline);
+        const double ns_per_frame = std::chrono::duration<double, std::nano>(now - start).count() / frames;
+
+        const bool bulk = events * converter::FramePacker::kBulkDivisor >= static_cast<size_t>(cfg.total_pixels());
+        std::cout << std::left << std::setw(10) << (std::to_string(density * 100.0).substr(0, 5) + "%")
+                  << std::setw(10) << (bulk ? "bulk" : "sparse")
+                  << std::setw(14) << std::to_string(ns_per_frame / 1e6).substr(0, 6)
+                  << (events > 0 ? std::to_string(events / (ns_per_frame / 1e3)).substr(0, 6) : "-") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * AEDAT4 output transport benchmark
+ *
+ * Streams synthetic event batches through dv::io::NetworkWriter and reads
+ * them back with dv::io::NetworkReader on the same host, once over TCP
+ * loopback and once over a Unix domain socket, and reports the delivered
+ * event rate for each.
+ *
+ * Usage:
+ *   ./bench_transport [events_per_batch] [batches]
+ *   Defaults: 50000 events per batch, 2000 batches (100M events)
+ */
+
+#include <dv-processing/io/network_writer.hpp>
+#include <dv-processing/io/network_reader.hpp>
+#include <dv-processing/io/stream.hpp>
+#include <dv-processing/core/event.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <filesystem>
+#include <functional>
+
+namespace {
+
+constexpr int kWidth = 1280;
+constexpr int kHeight = 720;
+constexpr uint16_t kTcpPort = 17777;
+constexpr const char* kSocketPath = "/tmp/dvbridge_bench.sock";
+
+// Keep the writer from queueing the whole run in memory
+constexpr size_t kMaxQueuedPackets = 32;
+
+dv::EventStore makeBatch(size_t count)
+{
+    dv::EventStore events;
+    for (size_t i = 0; i < count; i++) {
+        const auto pixel = static_cast<int>((i * 7919) % (kWidth * kHeight));
+        events.emplace_back(static_cast<int64_t>(i), static_cast<int16_t>(pixel % kWidth),
+                            static_cast<int16_t>(pixel / kWidth), (i & 1) != 0);
+    }
+    return events;
+}
+
+struct Result {
+    uint64_t events = 0;
+    double seconds = 0.0;
+};
+
+Result run(const std::string& name,
+           const std::function<std::unique_ptr<dv::io::NetworkWriter>()>& make_writer,
+           const std::function<std::unique_ptr<dv::io::NetworkReader>()>& make_reader,
+           const dv::EventStore& batch, size_t batches)
+{
+    std::cout << "Running " << name << "..." << std::endl;
+
+    auto writer = make_writer();
+    auto reader = make_reader();
+
+    // Wait for the writer to register the client before streaming
+    while (writer->getClientCount() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const uint64_t expected = static_cast<uint64_t>(batch.size()) * batches;
+    std::atomic<bool> done{false};
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread producer([&]() {
+        for (size_t i = 0; i < batches && !done; i++) {
+            while (writer->getQueuedPacketCount() > kMaxQueuedPackets && !done) {
+                std::this_thread::yield();
+            }
+            writer->writeEvents(batch);
+        }
+    });
+
+    Result result;
+    auto last_progress = std::chrono::steady_clock::now();
+    while (result.events < expected) {
+        auto events = reader->getNextEventBatch();
+        if (events.has_value()) {
+            result.events += events->size();
+            last_progress = std::chrono::steady_clock::now();
+        } else if (std::chrono::steady_clock::now() - last_progress > std::chrono::seconds(5)) {
+            std::cerr << "  Stalled after " << result.events << " of " << expected << " events" << std::endl;
+            break;
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    done = true;
+    producer.join();
+    return result;
+}
+
+void printResult(const std::string& name, const Result& r)
+{
+    const double meps = r.events / (r.seconds * 1000000.0);
+    const double mbps = (r.events * sizeof(dv::Event) * 8.0) / (r.seconds * 1000000.0);
+    std::cout << std::left << std::setw(16) << name
+              << " Events: " << r.events
+              << " | Time: " << std::fixed << std::setprecision(2) << r.seconds << " s"
+              << " | MEv/s: " << std::setprecision(2) << meps
+              << " | Payload: " << std::setprecision(1) << mbps << " Mbps"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t events_per_batch = argc > 1 ? std::stoul(argv[1]) : 50000;
+    const size_t batches = argc > 2 ? std::stoul(argv[2]) : 2000;
+
+    std::cout << "AEDAT4 transport benchmark: " << batches << " batches x "
+              << events_per_batch << " events" << std::endl;
+
+    const dv::EventStore batch = makeBatch(events_per_batch);
+    const dv::io::Stream stream = dv::io::Stream::EventStream(0, "events", "DVS", cv::Size(kWidth, kHeight));
+
+    Result tcp = run("TCP loopback",
+        [&]() { return std::make_unique<dv::io::NetworkWriter>("127.0.0.1", kTcpPort, stream); },
+        [&]() { return std::make_unique<dv::io::NetworkReader>("127.0.0.1", kTcpPort); },
+        batch, batches);
+
+    std::error_code ec;
+    std::filesystem::remove(kSocketPath, ec);
+    Result uds = run("Unix socket",
+        [&]() { return std::make_unique<dv::io::NetworkWriter>(std::filesystem::path(kSocketPath), stream); },
+        [&]() { return std::make_unique<dv::io::NetworkReader>(std::filesystem::path(kSocketPath)); },
+        batch, batches);
+    std::filesystem::remove(kSocketPath, ec);
+
+    std::cout << std::endl;
+    printResult("TCP loopback", tcp);
+    printResult("Unix socket", uds);
+    if (tcp.seconds > 0 && uds.seconds > 0 && tcp.events > 0) {
+        const double speedup = (uds.events / uds.seconds) / (tcp.events / tcp.seconds);
+        std::cout << "Unix socket / TCP: " << std::setprecision(2) << speedup << "x" << std::endl;
+    }
+    return 0;
+}
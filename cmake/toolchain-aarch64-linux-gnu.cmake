@@ -0,0 +1,28 @@
+# Cross-compile for 64-bit ARM Linux (Jetson, Zynq UltraScale+ APU)
+#
+#   cmake -S . -B build-arm64 -DCMAKE_TOOLCHAIN_FILE=cmake/toolchain-aarch64-linux-gnu.cmake \
+#         -DCMAKE_PREFIX_PATH=/path/to/aarch64/sysroot/usr -DBUILD_BENCHMARKS=ON
+#
+# With qemu-user installed, the resulting binaries run on an x86 host, e.g.
+#   qemu-aarch64 -L /usr/aarch64-linux-gnu build-arm64/bench_unpack 1280 720 50
+
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR aarch64)
+
+set(CMAKE_C_COMPILER aarch64-linux-gnu-gcc)
+set(CMAKE_CXX_COMPILER aarch64-linux-gnu-g++)
+
+if(NOT DEFINED AARCH64_SYSROOT)
+    set(AARCH64_SYSROOT /usr/aarch64-linux-gnu)
+endif()
+set(CMAKE_FIND_ROOT_PATH ${AARCH64_SYSROOT})
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_PACKAGE ONLY)
+
+# Lets ctest run cross-built test executables through qemu-user
+find_program(QEMU_AARCH64 qemu-aarch64)
+if(QEMU_AARCH64)
+    set(CMAKE_CROSSCOMPILING_EMULATOR ${QEMU_AARCH64} -L ${AARCH64_SYSROOT})
+endif()
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "config.hpp"
+#include "frame_unpacker.hpp"
+#include "decode_scheduler.hpp"
+#include "mapped_file.hpp"
+#include "metrics.hpp"
+#include "recording.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Parallel offline conversion of a raw capture to AEDAT4
+ *
+ * Splits input_file into chunks of convert_chunk_frames frames. Every
+ * chunk is one job on a DecodeScheduler (decode_threads workers, 0 = one
+ * per core) that decodes the chunk straight from the memory-mapped file
+ * and encodes it into its own AEDAT4 segment with its own writer, so both
+ * decoding and compression run on all cores and nothing is shared between
+ * jobs but the mapping:
+ *
+ *   capture.aedat4 -> capture.00000.aedat4, capture.00001.aedat4, ...
+ *
+ * Each segment is a complete AEDAT4 file with its own packet table;
+ * segment N holds frames [N * convert_chunk_frames, (N + 1) *
+ * convert_chunk_frames) with the same timestamps (frame number x
+ * frame_interval_us) as a single-file conversion, so the segments read in
+ * name order are the whole recording. Chunks are started in file order,
+ * at most one per worker at a time. Every finished segment is added to
+ * the recording's index (RecordingIndex, out.aedat4.index).
+ *
+ *   BatchConverter batch(cfg);
+ *   batch.start();
+ *   while (batch.isRunning()) { ... getFramesConverted() ... }
+ *
+ * Frames must be fixed-size (has_header = false) so chunks can be located
+ * without reading the file first. Decimation and tile subscriptions do not
+ * apply; every frame is decoded whole.
+ */
+class BatchConverter {
+public:
+    /**
+     * Constructor
+     * @param cfg Configuration reference (must outlive the converter)
+     */
+    explicit BatchConverter(const Config& cfg);
+
+    /**
+     * Destructor - stops and waits for running chunks
+     */
+    ~BatchConverter();
+
+    // Disable copy
+    BatchConverter(const BatchConverter&) = delete;
+    BatchConverter& operator=(const BatchConverter&) = delete;
+
+    /**
+     * Map input_file and start converting
+     * @return false if the input or the index cannot be opened
+     */
+    bool start();
+
+    /**
+     * Stop after the frames being converted; chunks not started are left
+     * out and running ones end early (their segments stay valid)
+     * Blocks until all workers have finished.
+     */
+    void stop();
+
+    /**
+     * Check if chunks are still being converted
+     */
+    bool isRunning() const;
+
+    /**
+     * Check if every chunk was converted completely
+     */
+    bool isComplete() const;
+
+    /**
+     * Get the number of frames in the input (trailing partial frame excluded)
+     */
+    uint64_t getFrameCount() const { return frame_count_; }
+
+    /**
+     * Get the number of segments the input is split into
+     */
+    size_t getSegmentCount() const { return chunk_count_; }
+
+    /**
+     * Get frames converted so far (all workers)
+     */
+    uint64_t getFramesConverted() const { return frames_converted_.value(); }
+
+    /**
+     * Get events written so far (all workers)
+     */
+    uint64_t getEventsConverted() const { return events_converted_.value(); }
+
+    /**
+     * Get input bytes converted so far (all workers)
+     */
+    uint64_t getBytesConverted() const { return bytes_converted_.value(); }
+
+private:
+    /**
+     * Job: decode and write one chunk, then start the next one
+     */
+    void convertChunk(size_t chunk);
+
+    /**
+     * Submit the next chunk in file order, if any (chunk_mutex_ held)
+     */
+    void submitNext();
+
+    const Config& config_;
+    MappedFile input_;
+    RecordingIndex index_;
+    uint64_t frame_count_;
+    size_t chunk_count_;
+
+    mutable std::mutex chunk_mutex_;
+    std::condition_variable chunk_cv_;
+    size_t next_chunk_;                 // Next chunk to submit
+    size_t chunks_running_;
+    size_t chunks_completed_;           // Converted to the end
+    std::atomic<bool> stop_requested_;
+
+    // Registry metrics convert_frames / convert_events / convert_bytes / convert_segments
+    Counter frames_converted_;
+    Counter events_converted_;
+    Counter bytes_converted_;
+    Counter segments_written_;
+
+    std::vector<std::unique_ptr<FrameUnpacker>> unpackers_;   // One per worker
+    std::unique_ptr<DecodeScheduler> scheduler_;    // Last: workers stop before the rest is destroyed
+};
+
+} // namespace converter
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+namespace converter {
+
+/**
+ * Fixed-size pool of reusable buffers
+ *
+ * acquire() hands out a buffer as a std::shared_ptr whose deleter puts it
+ * back into the pool instead of freeing it. Consumers can keep, copy and
+ * pass the pointer around; the buffer is reused only after the last copy
+ * is gone, so no one ever sees it overwritten. Buffers keep their
+ * allocations (vector capacity etc.) between uses.
+ *
+ * Buffers are created lazily up to `capacity`. When all are in use,
+ * acquire() returns nullptr and the caller decides what to drop.
+ *
+ * Thread-safe; buffers may be released from any thread, and may outlive
+ * the pool object itself.
+ */
+template <typename T>
+class BufferPool {
+public:
+    using Ptr = std::shared_ptr<T>;
+
+    /**
+     * Constructor
+     * @param capacity Maximum number of buffers in circulation
+     */
+    explicit BufferPool(size_t capacity)
+        : state_(std::make_shared<State>())
+    {
+        state_->capacity = capacity;
+    }
+
+    // Disable copy
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * Take a free buffer (contents are whatever the last user left)
+     * @return Buffer, or nullptr if all buffers are in use
+     */
+    Ptr acquire()
+    {
+        std::unique_ptr<T> buffer;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (!state_->free.empty()) {
+                buffer = std::move(state_->free.back());
+                state_->free.pop_back();
+            } else if (state_->created < state_->capacity) {
+                state_->created++;
+            } else {
+                return nullptr;
+            }
+        }
+        if (!buffer) {
+            buffer = std::make_unique<T>();
+        }
+
+        std::shared_ptr<State> state = state_;
+        return Ptr(buffer.release(), [state](T* p) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->free.emplace_back(p);
+        });
+    }
+
+    /**
+     * Get the number of buffers currently handed out
+     * @return Buffers in use
+     */
+    size_t inUse() const
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->created - state_->free.size();
+    }
+
+    /**
+     * Get the maximum number of buffers
+     * @return Pool capacity
+     */
+    size_t capacity() const { return state_->capacity; }
+
+private:
+    // Shared with the deleters of outstanding buffers
+    struct State {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<T>> free;
+        size_t created = 0;
+        size_t capacity = 0;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace converter
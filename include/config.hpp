@@ -10,7 +10,8 @@ namespace converter {
  */
 enum class Protocol {
     TCP,    // TCP server - listens for FPGA connection (FPGA connects to us)
-    UDP     // UDP receiver - binds to port and receives datagrams
+    UDP,    // UDP receiver - binds to port and receives datagrams
+    File    // Raw frame file (input_file) - offline conversion of recordings
 };
 
 /**
@@ -20,10 +21,59 @@ inline const char* protocolToString(Protocol p) {
     switch (p) {
         case Protocol::TCP: return "TCP";
         case Protocol::UDP: return "UDP";
+        case Protocol::File: return "File";
         default: return "Unknown";
     }
 }
 
+/**
+ * Frame decode kernel selection (see unpack_kernels.hpp)
+ */
+enum class UnpackKernel {
+    Auto,   // Benchmark all supported kernels at startup, use the fastest
+    Scalar, // Reference implementation, bit by bit
+    Lut,    // 256-entry byte lookup table, 8-byte zero skipping
+    Sse2,   // 16-byte zero skipping with SSE2 compares
+    Avx2,   // 32-byte zero skipping with AVX2 compares
+    Avx512, // 64-byte blocks, AVX-512 VBMI2 compress-store of coordinates
+    Neon    // 64-byte zero skipping with NEON compares (ARM64)
+};
+
+/**
+ * Helper to convert UnpackKernel enum to string
+ */
+inline const char* kernelToString(UnpackKernel k) {
+    switch (k) {
+        case UnpackKernel::Auto: return "auto";
+        case UnpackKernel::Scalar: return "scalar";
+        case UnpackKernel::Lut: return "lut";
+        case UnpackKernel::Sse2: return "sse2";
+        case UnpackKernel::Avx2: return "avx2";
+        case UnpackKernel::Avx512: return "avx512";
+        case UnpackKernel::Neon: return "neon";
+        default: return "unknown";
+    }
+}
+
+/**
+ * Frame header layout (has_header = true)
+ */
+enum class HeaderFormat {
+    Length, // header_size-byte little-endian payload length (TCP, file)
+    V1      // Versioned header with counter and timestamp (frame_header.hpp)
+};
+
+/**
+ * Helper to convert HeaderFormat enum to string
+ */
+inline const char* headerFormatToString(HeaderFormat f) {
+    switch (f) {
+        case HeaderFormat::Length: return "length";
+        case HeaderFormat::V1: return "v1";
+        default: return "unknown";
+    }
+}
+
 /**
  * Configuration for TCP/UDP to AEDAT4 Converter
  * 
@@ -67,6 +117,26 @@ struct Config {
     // Receive buffer size (bytes) - larger = handles bursts better
     int recv_buffer_size = 50 * 1024 * 1024;  // 50 MB
 
+    // =========================================================================
+    // TCP-SPECIFIC SETTINGS
+    // =========================================================================
+
+    // Parallel connections the camera stripes frames across (1 = a single
+    // stream). Each frame travels whole on one of them behind a v1 header,
+    // whose counter puts it back in order (needs header_format = v1). All
+    // are accepted on camera_port and read on a thread each, so ingest is
+    // not limited to one core's TCP receive path. Up to reorder_window
+    // frames are held for reordering; a connection that goes quiet holds
+    // output up for at most reorder_max_wait_ms (see stripe_assembler.hpp)
+    int tcp_connections = 1;
+
+    // Map received payload pages into the converter instead of copying
+    // them (getsockopt TCP_ZEROCOPY_RECEIVE, Linux). Frames whose payload
+    // was mapped whole are decoded in place; bytes the kernel cannot map
+    // (not page aligned by the NIC) are copied as before. Pays off with
+    // large frames on NICs that split headers onto separate pages
+    bool tcp_zerocopy = false;
+
     // =========================================================================
     // UDP-SPECIFIC SETTINGS
     // =========================================================================
@@ -76,23 +146,95 @@ struct Config {
     // Jumbo frames on 10G: up to 9000 bytes MTU, ~8972 payload
     // Set this to match your network configuration
     int udp_packet_size = 65535;
-    
+
+    // =========================================================================
+    // FILE INPUT (protocol = file)
+    // =========================================================================
+
+    // Raw FPGA frames stored back to back (e.g. from sim_camera --transcode).
+    // The file is memory-mapped and converted as fast as the disk and
+    // decoders allow; nothing is dropped and the converter exits at its end
+    std::string input_file = "";
+
+    // Batch mode (needs output_file and has_header = false): split
+    // input_file into chunks of N frames, each decoded and AEDAT4-encoded
+    // by one of decode_threads workers (0 = all cores) into its own
+    // segment file out.00000.aedat4, out.00001.aedat4, ... (see
+    // batch_converter.hpp). 0 = stream through the pipeline into one file
+    int convert_chunk_frames = 0;
+
     // =========================================================================
     // NETWORK SETTINGS - OUTPUT (to DV viewer)
     // =========================================================================
     
     int aedat_port = 7777;      // Port where DV viewer connects
-    
+
+    // Serve AEDAT4 over TCP on aedat_port (disable for socket-only setups)
+    bool aedat_tcp_enabled = true;
+
+    // Also serve AEDAT4 on a Unix domain socket (Linux/macOS, empty = disabled)
+    // Same-host DV software (e.g. dv-gui) avoids the TCP loopback overhead
+    // Example: "/tmp/dvbridge.sock"
+    std::string aedat_socket_path = "";
+
+    // Write AEDAT4 to this file (empty = disabled), e.g. for offline
+    // conversion of an input_file
+    std::string output_file = "";
+
+    // Start a new output_file segment every N frames (0 = one file):
+    // out.aedat4 -> out.00000.aedat4, out.00001.aedat4, ... Segments are
+    // listed with their frame and time ranges in <output_file>.index
+    int output_segment_frames = 0;
+
     // =========================================================================
-    // FRAME HEADER SETTINGS (TCP only)
+    // SHARED MEMORY OUTPUT (Linux only, same-host consumers)
     // =========================================================================
 
-    // Does the camera send a size header before each frame?
+    // Publish events into a POSIX shared memory ring in addition to AEDAT4.
+    // Local consumers map it with SharedMemoryReader (no TCP, no AEDAT4 encode)
+    bool shm_enabled = false;
+    std::string shm_name = "/dvbridge_events";  // Name passed to shm_open()
+
+    // Permissions of the shared memory object (octal). Readers open it
+    // read-write for the waiter count, so anyone allowed to read can also
+    // write the ring; default owner only, 0660 for consumers in the group
+    int shm_mode = 0600;
+
+    // Ring geometry: slots x events per slot (16 bytes per event)
+    // Default: 32 x 65536 events = 32 MB. Frames larger than one slot are
+    // split over several packets; readers more than shm_slot_count packets
+    // behind are overrun and skip ahead
+    int shm_slot_count = 32;
+    int shm_slot_events = 65536;
+
+    // Structure-of-arrays slots: x / y arrays, bit-packed polarity and one
+    // timestamp per packet (~4 bytes per event instead of 16). Readers get
+    // SIMD-ready arrays without transposing. shm_slot_events is rounded up
+    // to a multiple of 64
+    bool shm_soa = false;
+
+    // =========================================================================
+    // FRAME HEADER SETTINGS
+    // =========================================================================
+
+    // Does the camera send a header before each frame?
     // FPGA sends raw data without headers
     bool has_header = false;
+
+    // Header layout (only used if has_header = true):
+    //   Length: header_size-byte payload length (TCP and file input)
+    //   V1:     24-byte versioned header with frame counter and camera
+    //           timestamp (TCP, UDP and file input). Events are stamped
+    //           with the camera's clock instead of frame number x
+    //           frame_interval_us, and counter gaps count as rx_frames_lost
+    HeaderFormat header_format = HeaderFormat::Length;
     
-    // Header size in bytes (only used if has_header = true)
+    // Header size in bytes (only used if has_header = true, header_format = length)
     int header_size = 4;
+
+    // Check the CRC32C trailer of frames whose v1 header announces one
+    // (FrameFlags::Crc32c); frames that fail are dropped before decoding
+    bool verify_crc = true;
     
     // =========================================================================
     // TIMING SETTINGS
@@ -103,6 +245,98 @@ struct Config {
     // Adjust based on actual frame rate from FPGA
     int64_t frame_interval_us = 10000;
     
+    // =========================================================================
+    // DECODE SETTINGS
+    // =========================================================================
+
+    // Decode kernel: Auto benchmarks every kernel this CPU supports on
+    // synthetic frames at startup and picks the fastest
+    UnpackKernel unpack_kernel = UnpackKernel::Auto;
+
+    // Event density (fraction of pixels with an event) of the synthetic
+    // frames used by the startup benchmark
+    double kernel_bench_density = 0.05;
+
+    // Time budget per kernel for each benchmark run (milliseconds)
+    int kernel_bench_ms = 20;
+
+    // Re-run the benchmark in the background every N frames at the live
+    // event density and switch kernels if another one is faster
+    // (0 = disabled, only used with UnpackKernel::Auto)
+    int kernel_reeval_interval = 0;
+
+    // Decode worker threads (work-stealing, see decode_scheduler.hpp).
+    // 0 = decode on the receive thread. Pipelines created with a shared
+    // scheduler use that one instead. Each worker keeps a frame-sized
+    // decode buffer per pipeline (~15 MB at 1280x720)
+    int decode_threads = 0;
+
+    // With decode_threads > 0: split each frame into bands of N rows that
+    // are decoded in parallel, so one dense frame uses several cores
+    // (0 = one job per frame; dv::EventStore delivery only, SoA frames
+    // are always decoded whole)
+    int decode_band_rows = 0;
+
+    // With decode_threads > 0, frames leave the decoders through a reorder
+    // stage that releases them in frame order. A missing frame is skipped
+    // (and counted) once it has held up output for reorder_max_wait_ms or
+    // reorder_window later frames are waiting behind it
+    int reorder_window = 32;
+    int reorder_max_wait_ms = 50;
+
+    // Overload protection (see event_limiter.hpp): frames with more than
+    // decimation_event_budget events, or arriving while
+    // decimation_backlog_frames or more frames wait for delivery, are
+    // decoded with spatially uniform subsampling - every 2nd, 4th, ...
+    // pixel up to decimation_max_factor (power of two). The factor is
+    // chosen per frame and reported in EventFrame::decimation
+    bool decimation_enabled = false;
+    int decimation_event_budget = 200000;
+    int decimation_backlog_frames = 4;
+    int decimation_max_factor = 16;
+
+    // =========================================================================
+    // PIPELINE SETTINGS (in-process delivery, see pipeline.hpp)
+    // =========================================================================
+
+    // Decoded frames in circulation. A frame's buffer returns to the pool
+    // once the consumer drops its last reference; while all are held,
+    // new frames are dropped (and counted)
+    int pipeline_pool_size = 8;
+
+    // Frames buffered for Pipeline::next() (pull mode). When full, the
+    // oldest frame is dropped
+    int pipeline_queue_depth = 4;
+
+    // Deliver EventFrameSoA arrays instead of a dv::EventStore
+    bool pipeline_soa = false;
+
+    // Receive with coroutines on an epoll event loop instead of blocking
+    // socket calls (Linux). Applications with several cameras can share
+    // one loop thread between pipelines, see event_loop.hpp
+    bool pipeline_async = false;
+
+    // Cut-through decode: deliver each frame in parts of N rows as its
+    // bytes arrive, instead of once the last byte is in (0 = whole
+    // frames). The first events leave one part's transfer time after
+    // arriving rather than a frame period. TCP and UDP only, decoded on
+    // the receive thread; not with decode_threads, pipeline_soa,
+    // decimation_enabled or tile_activity, which need the whole frame
+    int stream_rows = 0;
+
+    // Count events per 32x32 tile of every frame (see tile_activity.hpp)
+    // and attach the map to EventFrame::tiles
+    bool tile_activity = false;
+
+    // Events a tile needs in a frame to count as active (tiles_active
+    // metric, "active" tile subscriptions)
+    int tile_active_threshold = 4;
+
+    // Decode only these tiles: "active", tile indices / ranges such as
+    // "0-39,120", or both. Empty = whole frame. Applications can add
+    // subscriptions with Pipeline::subscribeTiles()
+    std::string tile_subscription = "";
+
     // =========================================================================
     // DEBUG SETTINGS
     // =========================================================================
@@ -112,10 +346,29 @@ struct Config {
     
     // Print verbose debug messages
     bool verbose = false;
+
+    // Prepended to every metric name (see metrics.hpp), e.g. "left." when
+    // one process runs a pipeline per camera
+    std::string metrics_prefix = "";
+
+    // Record pipeline stage timings into per-thread trace rings (see
+    // trace.hpp); cheap enough to leave on
+    bool trace_enabled = true;
+
+    // Records kept per thread (rounded up to a power of two, 24 bytes each)
+    int trace_ring_events = 16384;
+
+    // Trace dump file; dumps get a sequence suffix (.1, .2, ...)
+    std::string trace_path = "dvbridge_trace.bin";
+
+    // Dump the trace when a frame takes longer than this from end of
+    // receive to delivery, in microseconds (0 = only on SIGUSR1)
+    int trace_latency_threshold_us = 0;
 };
 
 // Global configuration instance
-// Modify this in main() or load from file if needed
+// Defaults above; overridden at startup from --config FILE and command line
+// options (see config_loader.hpp)
 inline Config config;
 
 } // namespace converter
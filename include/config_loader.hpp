@@ -0,0 +1,84 @@
+#pragma once
+
+#include "config.hpp"
+#include <string>
+#include <iosfwd>
+
+namespace converter {
+
+/**
+ * Runtime configuration loading
+ *
+ * Every Config field can be set without recompiling, either from a config
+ * file or from the command line. Option names are the Config member names:
+ *
+ *   Config file (key = value, '#' starts a comment):
+ *     width = 640
+ *     height = 480
+ *     protocol = udp
+ *     recv_buffer_size = 104857600
+ *
+ *   Command line (overrides the file):
+ *     ./converter --config rig2.conf --width=640 --protocol udp --verbose
+ *
+ * Boolean options accept true/false, yes/no, on/off, 1/0; a bare
+ * "--flag" on the command line means true.
+ */
+
+/**
+ * Result of command line parsing
+ */
+enum class ParseResult {
+    Ok,         // Continue with the parsed configuration
+    Exit,       // --help / --dump-config handled, exit successfully
+    Error       // Invalid option or value, exit with failure
+};
+
+/**
+ * Set one option by name
+ * @param key Option name (Config member name)
+ * @param value Option value as text
+ * @param cfg Configuration to modify
+ * @return true if the key is known and the value is valid
+ */
+bool applyConfigOption(const std::string& key, const std::string& value, Config& cfg);
+
+/**
+ * Load a config file (key = value lines)
+ * @param path Config file path
+ * @param cfg Configuration to modify
+ * @return true if the file was read and every line was valid
+ */
+bool loadConfigFile(const std::string& path, Config& cfg);
+
+/**
+ * Parse command line arguments
+ * --config FILE is applied first, all other options override it.
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @param cfg Configuration to modify
+ * @return Parse result
+ */
+ParseResult parseCommandLine(int argc, char* argv[], Config& cfg);
+
+/**
+ * Check a configuration for values the converter cannot run with
+ * @param cfg Configuration to check
+ * @return true if valid (errors are printed to stderr)
+ */
+bool validateConfig(const Config& cfg);
+
+/**
+ * Write all options in config file format
+ * @param cfg Configuration to write
+ * @param out Output stream
+ */
+void writeConfig(const Config& cfg, std::ostream& out);
+
+/**
+ * Print command line help with all options
+ * @param program Program name (argv[0])
+ */
+void printUsage(const char* program);
+
+} // namespace converter
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace converter {
+
+/**
+ * CPU instruction set support, detected once at startup
+ *
+ * Used by the unpack kernel registry to decide which decode kernels can
+ * run on this machine. A feature is only reported if the OS also enables
+ * the matching register state (e.g. YMM for AVX2).
+ */
+struct CpuFeatures {
+    bool sse2 = false;
+    bool sse42 = false;         // crc32 instruction (CRC32C)
+    bool avx2 = false;
+    bool bmi2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vbmi2 = false;   // vpcompressb/w, vpexpandb/w (Ice Lake and newer)
+    bool neon = false;          // Advanced SIMD, mandatory on ARMv8-A (AArch64)
+    bool crc32 = false;         // ARMv8 CRC32 extension (crc32c* instructions)
+};
+
+/**
+ * Get the features of the CPU we are running on
+ * @return Detected features (cached after first call)
+ */
+const CpuFeatures& cpuFeatures();
+
+} // namespace converter
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * CRC32C (Castagnoli) of a buffer, as in iSCSI, ext4 and SSE4.2
+ *
+ * Reflected polynomial 0x82F63B78, initial value and final XOR 0xFFFFFFFF
+ * (crc32c("123456789") = 0xE3069283). Runs on the CPU's CRC instructions
+ * (SSE4.2 crc32, ARMv8 crc32c) with three interleaved streams to hide
+ * their latency, else on a slicing-by-8 table; chosen once at first use.
+ *
+ * @param data Buffer
+ * @param size Bytes
+ * @param crc CRC of the preceding bytes, to continue a running CRC
+ *            (0 to start)
+ * @return CRC of all bytes so far
+ */
+uint32_t crc32c(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+/**
+ * CRC of the concatenation A + B from the CRCs of both parts
+ * Lets parts of a buffer be checked on different threads.
+ * @param crc_a CRC of A
+ * @param crc_b CRC of B
+ * @param size_b Bytes in B
+ */
+uint32_t crc32cCombine(uint32_t crc_a, uint32_t crc_b, size_t size_b);
+
+/**
+ * Name of the implementation crc32c() uses ("sse4.2", "armv8", "table")
+ */
+const char* crc32cImplementation();
+
+} // namespace converter
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "config.hpp"
+#include "metrics.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Work-stealing thread pool for decode jobs
+ *
+ * Each worker owns a deque. Jobs submitted from outside are spread
+ * round-robin over the workers; jobs submitted by a worker (e.g. the bands
+ * of a frame it split) go to its own deque. A worker takes its newest job
+ * first and, when its deque is empty, steals the oldest job of another
+ * worker. Load therefore evens out across cores whether it comes from one
+ * camera with dense frames or from many cameras.
+ *
+ * Jobs finish in any order; callers that need ordered output put results
+ * through a ReorderBuffer (see Pipeline).
+ *
+ *   auto scheduler = std::make_shared<converter::DecodeScheduler>(cfg);
+ *   scheduler->submit([&] { decode(frame); });
+ *
+ * One scheduler can serve several pipelines (pass it to their
+ * constructors). Thread-safe.
+ */
+class DecodeScheduler {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * Constructor - starts the workers
+     * @param cfg Configuration (decode_threads; 0 = one per hardware thread)
+     */
+    explicit DecodeScheduler(const Config& cfg);
+
+    /**
+     * Destructor - runs the jobs still queued, then joins the workers
+     */
+    ~DecodeScheduler();
+
+    // Disable copy
+    DecodeScheduler(const DecodeScheduler&) = delete;
+    DecodeScheduler& operator=(const DecodeScheduler&) = delete;
+
+    /**
+     * Queue a job (any thread)
+     * Jobs must not throw; an escaping exception is logged and dropped.
+     */
+    void submit(Job job);
+
+    /**
+     * Get the number of worker threads
+     */
+    size_t workerCount() const { return workers_.size(); }
+
+    /**
+     * Index of the calling worker of this scheduler
+     * Lets jobs use per-worker state (e.g. one FrameUnpacker per worker).
+     * @return 0 .. workerCount()-1, or -1 if not called from a worker
+     */
+    int currentWorker() const;
+
+    /**
+     * Get number of jobs run so far
+     */
+    uint64_t getJobsExecuted() const { return jobs_executed_.value(); }
+
+    /**
+     * Get number of jobs a worker took from another worker's deque
+     */
+    uint64_t getJobsStolen() const { return jobs_stolen_.value(); }
+
+private:
+    /**
+     * Per-worker deque, on its own cache line so that owners pushing and
+     * popping do not slow each other down
+     */
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::thread thread;
+    };
+
+    void workerLoop(size_t index);
+
+    /**
+     * Take a job: newest of the own deque, else oldest of another's
+     * @return false if every deque is empty
+     */
+    bool takeJob(size_t index, Job& job);
+
+    void push(size_t index, Job job);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_worker_;
+
+    // Queued (not yet taken) jobs; workers sleep while it is zero.
+    // push() only takes sleep_mutex_ when a worker sleeps (sleepers_).
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<int64_t> queued_;
+    std::atomic<int> sleepers_;
+    bool stopping_;
+
+    Counter jobs_executed_;             // decode_jobs
+    Counter jobs_stolen_;               // decode_steals
+};
+
+} // namespace converter
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "config.hpp"
+#include "metrics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Chooses a decimation factor per frame so that delivery keeps up
+ *
+ * A burst (e.g. a lighting change that fires every pixel) produces frames
+ * with up to width * height events, far more than the outputs can publish
+ * at frame rate; without a limit the backlog - and latency - grows for
+ * seconds. EventLimiter looks at two signals per frame:
+ *
+ *   - the frame's event count (countEvents(), before decoding): a frame
+ *     over decimation_event_budget gets the smallest power-of-two factor
+ *     that brings it under budget
+ *   - the delivery backlog (frames queued or still decoding): while it is
+ *     at decimation_backlog_frames or more, an extra halving is added per
+ *     frame; it is taken back one step per frame once the backlog is empty
+ *
+ * The product is capped at decimation_max_factor. FrameUnpacker then
+ * decodes an even lattice of 1 in `factor` pixels, so the scene keeps its
+ * shape at lower density.
+ *
+ *   size_t events = countEvents(data, size);
+ *   unpacker.setDecimation(limiter.choose(events, backlog));
+ *
+ * Registry metrics: decimation_factor (gauge, last frame),
+ * decimation_frames (frames decimated), decimation_events_dropped
+ * (estimated from the event count and factor).
+ *
+ * Not thread-safe; called from the receive thread.
+ */
+class EventLimiter {
+public:
+    /**
+     * Constructor
+     * @param cfg Configuration (decimation_*)
+     */
+    explicit EventLimiter(const Config& cfg);
+
+    /**
+     * Choose the factor for the next frame
+     * @param frame_events Events in the frame
+     * @param backlog Frames waiting for delivery ahead of it
+     * @return Decimation factor (1 = decode every pixel)
+     */
+    int choose(size_t frame_events, size_t backlog);
+
+    /**
+     * Get the factor chosen for the last frame
+     */
+    int getFactor() const { return factor_; }
+
+private:
+    const Config& config_;
+    int pressure_;          // Extra halvings for backlog (log2)
+    int factor_;
+
+    Gauge factor_gauge_;                // decimation_factor
+    Counter frames_decimated_;          // decimation_frames
+    Counter events_dropped_;            // decimation_events_dropped
+};
+
+} // namespace converter
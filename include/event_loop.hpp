@@ -0,0 +1,162 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "task.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Single-threaded coroutine executor over epoll (Linux)
+ *
+ * Lets one thread service many sockets and timers: receivers await
+ * readiness instead of blocking in recv()/accept(), so adding cameras
+ * adds coroutines, not threads.
+ *
+ *   EventLoop loop;
+ *   loop.open();
+ *   loop.spawn(receiveLoop(loop));     // Task<void>
+ *   loop.run();                        // until stop()
+ *
+ * Inside a task:
+ *   if (!co_await loop.readable(fd)) { ... }   // false: fd error / hang-up
+ *   co_await loop.sleepFor(std::chrono::seconds(1));
+ *
+ * Each fd may have one waiter at a time. Everything except spawn(), post()
+ * and stop() must be called on the loop thread (i.e. from tasks).
+ */
+class EventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    EventLoop();
+    ~EventLoop();
+
+    // Disable copy
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * Create the epoll instance and wake-up eventfd
+     * @return true on success
+     */
+    bool open();
+
+    /**
+     * Start a task; the loop owns it until it completes (thread-safe)
+     * The task first runs on the loop thread. Exceptions escaping it are
+     * logged.
+     */
+    void spawn(Task<void> task);
+
+    /**
+     * Run ready tasks, I/O and timers until stop()
+     */
+    void run();
+
+    /**
+     * Make run() return (thread-safe)
+     * Unfinished tasks stay suspended and are destroyed with the loop.
+     */
+    void stop();
+
+    /**
+     * Run a function on the loop thread (thread-safe)
+     */
+    void post(std::function<void()> fn);
+
+    /**
+     * Check if the calling thread is the one inside run()
+     */
+    bool inLoopThread() const { return loop_thread_ == std::this_thread::get_id(); }
+
+    /**
+     * Get number of tasks not yet finished
+     */
+    size_t activeTasks() const { return tasks_.size(); }
+
+    /**
+     * Awaitable: resumes once fd has the requested events
+     * co_await yields false if the fd reported an error or hang-up
+     * (callers then see the reason from recv()/accept()).
+     */
+    class IoAwaiter {
+    public:
+        IoAwaiter(EventLoop& loop, int fd, uint32_t events) : loop_(loop), fd_(fd), events_(events) {}
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h);
+        bool await_resume() const noexcept { return ok_; }
+
+    private:
+        friend class EventLoop;
+        EventLoop& loop_;
+        int fd_;
+        uint32_t events_;
+        std::coroutine_handle<> handle_;
+        bool ok_ = false;
+    };
+
+    /**
+     * Awaitable: resumes after a delay
+     */
+    class TimerAwaiter {
+    public:
+        TimerAwaiter(EventLoop& loop, Clock::time_point deadline) : loop_(loop), deadline_(deadline) {}
+        bool await_ready() const noexcept { return deadline_ <= Clock::now(); }
+        void await_suspend(std::coroutine_handle<> h);
+        void await_resume() const noexcept {}
+
+    private:
+        EventLoop& loop_;
+        Clock::time_point deadline_;
+    };
+
+    IoAwaiter readable(int fd);
+    IoAwaiter writable(int fd);
+    TimerAwaiter sleepFor(Clock::duration delay) { return TimerAwaiter(*this, Clock::now() + delay); }
+
+private:
+    struct Timer {
+        Clock::time_point deadline;
+        uint64_t sequence;              // FIFO among equal deadlines
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer& other) const
+        {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    bool arm(IoAwaiter& awaiter);
+    void wake();
+    void runPosted();
+    void reapFinished();
+    int nextTimeoutMs() const;
+
+    int epoll_fd_;
+    int wake_fd_;
+    std::atomic<bool> stop_requested_;
+    std::atomic<std::thread::id> loop_thread_;
+
+    std::vector<Task<void>> tasks_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+    uint64_t timer_sequence_;
+
+    // Cross-thread hand-off, drained by run()
+    std::mutex posted_mutex_;
+    std::vector<std::function<void()>> posted_;
+    std::vector<Task<void>> spawned_;
+};
+
+} // namespace converter
+
+#endif // __linux__
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Number of 64-bit words needed for n bit-packed polarities
+ */
+inline size_t polarityWords(size_t n) { return (n + 63) / 64; }
+
+/**
+ * Polarity of event i in a bit-packed polarity array
+ * Bit (i % 64) of word (i / 64); 1 = positive, 0 = negative.
+ */
+inline bool polarityAt(const uint64_t* polarity, size_t i) {
+    return ((polarity[i >> 6] >> (i & 63)) & 1) != 0;
+}
+
+/**
+ * Appends bits to a bit-packed polarity array
+ * Whole words are stored once full, so the array needs no clearing; an
+ * existing partial word (count % 64 != 0) is continued.
+ */
+class PolarityPacker {
+public:
+    PolarityPacker(uint64_t* words, size_t count)
+        : words_(words)
+        , count_(count)
+        , acc_((count & 63) ? words[count >> 6] & ((1ULL << (count & 63)) - 1) : 0)
+    {
+    }
+
+    /**
+     * Append n bits (n <= 32, bits above n must be zero)
+     */
+    void push(uint64_t bits, unsigned n)
+    {
+        const unsigned used = static_cast<unsigned>(count_ & 63);
+        acc_ |= bits << used;
+        if (used + n >= 64) {
+            words_[count_ >> 6] = acc_;
+            acc_ = used != 0 ? bits >> (64 - used) : 0;
+        }
+        count_ += n;
+    }
+
+    /**
+     * Store the trailing partial word
+     */
+    void flush()
+    {
+        if (count_ & 63) {
+            words_[count_ >> 6] = acc_;
+        }
+    }
+
+private:
+    uint64_t* words_;
+    size_t count_;
+    uint64_t acc_;
+};
+
+/**
+ * One frame of events in structure-of-arrays form
+ *
+ * Alternative to dv::EventStore for consumers that process events with
+ * SIMD (accumulators, time surfaces) and would otherwise transpose the
+ * 16-byte dv::Event records first:
+ *   - x[i], y[i]: coordinates of event i
+ *   - polarity: one bit per event, see polarityAt()
+ *   - timestamp: shared by every event of the frame, stored once
+ *
+ * Events are in the same order as FrameUnpacker::unpack() produces them.
+ * The arrays are sized to the worst-case frame by reserve() and reused
+ * between frames; only the first `count` entries are valid.
+ *
+ * Has no dependency on dv-processing, so shared-memory consumers can use
+ * it without linking the DV libraries.
+ */
+struct EventFrameSoA {
+    // Extra entries past the worst case: SIMD kernels store whole vectors
+    static constexpr size_t kPadding = 32;
+
+    uint64_t frame_number = 0;
+    int64_t timestamp = 0;          // Microseconds, all events of the frame
+    size_t count = 0;               // Valid events
+
+    std::vector<int16_t> x;
+    std::vector<int16_t> y;
+    std::vector<uint64_t> polarity; // Bit-packed, see polarityAt()
+
+    /**
+     * Make room for up to max_events events (no-op if already large enough)
+     * @param max_events Worst-case events per frame
+     */
+    void reserve(size_t max_events) {
+        if (x.size() < max_events + kPadding) {
+            x.resize(max_events + kPadding);
+            y.resize(max_events + kPadding);
+            polarity.resize(polarityWords(max_events + kPadding));
+        }
+    }
+
+    /**
+     * Polarity of event i
+     * @return true if positive
+     */
+    bool positive(size_t i) const { return polarityAt(polarity.data(), i); }
+};
+
+} // namespace converter
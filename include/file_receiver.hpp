@@ -0,0 +1,160 @@
+#pragma once
+
+#include "config.hpp"
+#include "metrics.hpp"
+#include "mapped_file.hpp"
+#include "frame_header.hpp"
+#ifdef __linux__
+    #include "event_loop.hpp"
+#endif
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Raw frame file input (protocol = file)
+ *
+ * Reads a stored FPGA stream - frames of frame_size() bytes back to back,
+ * as written by `sim_camera --transcode` or a capture of the TCP stream -
+ * from input_file for offline conversion. Same interface as TcpReceiver /
+ * UdpReceiver, so the pipeline decodes it like a live camera, except that
+ * nothing is dropped (see Pipeline) and input ends at end of file.
+ *
+ * The file is memory-mapped (MappedFile) with sequential read-ahead, so
+ * receiveFrame() is a memcpy out of the page cache; pages already
+ * consumed are released from the mapping so resident memory stays flat on
+ * multi-terabyte files.
+ *
+ * With has_header, each frame is preceded by the same header as on the
+ * TCP stream (header_format: length, or v1 with camera timestamps).
+ */
+class FileReceiver {
+public:
+    /**
+     * Constructor
+     * @param cfg Configuration reference
+     */
+    explicit FileReceiver(const Config& cfg);
+
+    /**
+     * Destructor - unmaps the file
+     */
+    ~FileReceiver();
+
+    // Disable copy and move (owns the mapping)
+    FileReceiver(const FileReceiver&) = delete;
+    FileReceiver& operator=(const FileReceiver&) = delete;
+
+    /**
+     * Open and map input_file, starting at its first frame
+     * @return true if the file could be opened
+     */
+    bool connect();
+
+    /**
+     * Unmap and close the file
+     */
+    void disconnect();
+
+    /**
+     * Make a receiveFrame() in another thread return false
+     */
+    void interrupt();
+
+    /**
+     * Check if the file is open
+     * @return true if open
+     */
+    bool isConnected() const;
+
+    /**
+     * Read the next frame
+     * @param buffer Output buffer (will be resized to frame size)
+     * @return true if a frame was read, false at end of file (atEnd()) or
+     *         on an error
+     */
+    bool receiveFrame(std::vector<uint8_t>& buffer);
+
+#ifdef __linux__
+    /**
+     * connect() for an EventLoop task (opening a file does not block on
+     * the network)
+     */
+    Task<bool> connectAsync(EventLoop& loop);
+
+    /**
+     * receiveFrame() for an EventLoop task
+     */
+    Task<bool> receiveFrameAsync(EventLoop& loop, std::vector<uint8_t>& buffer);
+#endif
+
+    /**
+     * Check if the whole file has been read
+     * @return true once receiveFrame() has returned the last frame
+     */
+    bool atEnd() const { return at_end_; }
+
+    /**
+     * Get the size of the open file
+     * @return Size in bytes
+     */
+    uint64_t getFileSize() const { return file_.size(); }
+
+    /**
+     * Get the expected frame size (without header)
+     * @return Frame size in bytes
+     */
+    int getFrameSize() const;
+
+    /**
+     * Camera timestamp (us) of the last frame read, -1 without
+     * versioned headers (header_format = v1)
+     */
+    int64_t getFrameTimestamp() const { return header_.timestamp(); }
+
+    /**
+     * CRC32C sent with the last frame (v1 header with FrameFlags::Crc32c)
+     */
+    std::optional<uint32_t> getFrameCrc() const { return header_.crc(); }
+
+    /**
+     * Get total bytes read
+     * @return Total bytes read (see metrics.hpp)
+     */
+    uint64_t getTotalBytesReceived() const { return bytes_received_.value(); }
+
+    /**
+     * Get total frames read
+     * @return Total frames read (see metrics.hpp)
+     */
+    uint64_t getTotalFramesReceived() const { return frames_received_.value(); }
+
+private:
+    /**
+     * Copy `size` bytes at the read position into `out`
+     * @return false if fewer than `size` bytes are left
+     */
+    bool read(uint8_t* out, size_t size);
+
+    /**
+     * Drop mapped pages before the read position from the mapping
+     */
+    void releaseConsumed();
+
+    const Config& config_;
+    MappedFile file_;
+    uint64_t offset_;               // Read position
+    uint64_t released_;             // Mapping released up to here
+    bool at_end_;
+    std::atomic<bool> interrupted_;
+    FrameHeaderParser header_;
+
+    // Registry metrics rx_bytes / rx_frames (readable from any thread)
+    Counter bytes_received_;
+    Counter frames_received_;
+};
+
+} // namespace converter
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "config.hpp"
+#include "metrics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace converter {
+
+/**
+ * Versioned frame header (header_format = v1)
+ *
+ * Sent by the camera in front of every frame payload, on TCP, UDP and in
+ * raw captures. 24 bytes, little-endian, no padding:
+ *
+ *   offset  size  field
+ *        0     4  magic         "DVBF" (0x46425644)
+ *        4     1  version       1
+ *        5     1  format        FrameFormat (1 = 2-bit packed pixels)
+ *        6     2  flags         FrameFlags
+ *        8     4  counter       Frame counter, +1 per frame, wraps
+ *       12     4  length        Payload bytes following the header
+ *       16     8  timestamp     Camera (FPGA) clock at frame start, us
+ *
+ * The timestamp becomes the frame's event timestamp; the counter shows
+ * frames lost between camera and converter (rx_frames_lost). With the
+ * Crc32c flag the payload is followed by a 4-byte little-endian CRC32C of
+ * the payload (not counted in length), checked before decoding
+ * (verify_crc).
+ */
+struct FrameHeader {
+    uint8_t version = 0;
+    uint8_t format = 0;
+    uint16_t flags = 0;
+    uint32_t counter = 0;
+    uint32_t length = 0;
+    int64_t timestamp = 0;  // Microseconds
+};
+
+constexpr uint32_t kFrameHeaderMagic = 0x46425644;  // "DVBF"
+constexpr uint8_t kFrameHeaderVersion = 1;
+constexpr size_t kFrameHeaderSize = 24;
+constexpr size_t kFrameTrailerSize = 4;    // CRC32C (FrameFlags::Crc32c)
+
+// Longest header of any header_format (receive buffers)
+constexpr size_t kMaxFrameHeaderSize = kFrameHeaderSize;
+
+/**
+ * Payload formats (FrameHeader::format)
+ */
+enum class FrameFormat : uint8_t {
+    Packed2Bit = 1      // 2 bits per pixel, see ARCHITECTURE.md section 2
+};
+
+/**
+ * FrameHeader::flags bits
+ */
+namespace FrameFlags {
+    // The counter restarted (camera reset, new stream): not a gap
+    constexpr uint16_t CounterReset = 1u << 0;
+    // A CRC32C trailer follows the payload
+    constexpr uint16_t Crc32c = 1u << 1;
+}
+
+/**
+ * Decode a v1 header
+ * @param data kFrameHeaderSize bytes
+ * @return false if the magic or version does not match
+ */
+bool decodeFrameHeader(const uint8_t* data, FrameHeader& header);
+
+/**
+ * Encode a v1 header (magic and version filled in)
+ * @param out kFrameHeaderSize bytes
+ */
+void encodeFrameHeader(const FrameHeader& header, uint8_t* out);
+
+/**
+ * Frame header handling shared by the receivers
+ *
+ * Knows the configured header (none, header_size-byte length, or v1),
+ * validates what was received and keeps the per-connection state: the
+ * last v1 timestamp and the expected next counter. Gap detection is one
+ * compare per frame.
+ *
+ *   uint8_t header[kMaxFrameHeaderSize];
+ *   receiveExact(header, parser.size());
+ *   size_t payload = 0;
+ *   if (!parser.parse(header, payload)) { ... out of sync ... }
+ *   receiveExact(buffer, payload);
+ *   if (parser.trailerSize() > 0) {
+ *       receiveExact(trailer, parser.trailerSize());
+ *       parser.parseTrailer(trailer);
+ *   }
+ */
+class FrameHeaderParser {
+public:
+    /**
+     * Constructor
+     * @param cfg Configuration reference (must outlive the parser)
+     * @param count_gaps Count counter gaps in rx_frames_lost (off for one
+     *                   connection of a striped stream, which only sees
+     *                   every K-th frame)
+     */
+    explicit FrameHeaderParser(const Config& cfg, bool count_gaps = true);
+
+    FrameHeaderParser(const FrameHeaderParser&) = default;
+
+    /**
+     * Take over the connection state of another parser (receiver move
+     * assignment); both must be for the same Config
+     */
+    FrameHeaderParser& operator=(const FrameHeaderParser& other);
+
+    /**
+     * Header bytes in front of every frame (0 without has_header)
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * Check for the v1 header (hardware timestamps and counters)
+     */
+    bool isVersioned() const { return versioned_; }
+
+    /**
+     * Parse a received header
+     * @param data size() bytes
+     * @param payload_size Output: payload bytes that follow
+     * @return false for an invalid v1 header (wrong magic, version,
+     *         format or length): the stream is out of sync
+     */
+    bool parse(const uint8_t* data, size_t& payload_size);
+
+    /**
+     * Trailer bytes after the payload of the last parsed frame (CRC32C)
+     */
+    size_t trailerSize() const { return trailer_size_; }
+
+    /**
+     * Parse the trailer of the last parsed frame
+     * @param data trailerSize() bytes
+     */
+    void parseTrailer(const uint8_t* data);
+
+    /**
+     * Camera timestamp (us) of the last parsed frame, -1 without v1 headers
+     */
+    int64_t timestamp() const { return timestamp_; }
+
+    /**
+     * Frame counter and flags of the last parsed v1 header
+     */
+    uint32_t counter() const { return counter_; }
+    uint16_t flags() const { return flags_; }
+
+    /**
+     * CRC32C the camera sent for the last frame's payload, if any
+     */
+    std::optional<uint32_t> crc() const { return crc_; }
+
+    /**
+     * Forget the counter, e.g. for a new connection (no gap is reported
+     * for the first frame after this)
+     */
+    void reset();
+
+private:
+    const Config& config_;
+    const size_t size_;
+    const bool versioned_;
+    const bool count_gaps_;
+    int64_t timestamp_;
+    uint32_t counter_;
+    uint16_t flags_;
+    size_t trailer_size_;
+    std::optional<uint32_t> crc_;
+    uint32_t next_counter_;
+    bool counter_valid_;
+
+    // Registry metrics rx_frames_lost / rx_header_errors
+    Counter frames_lost_;
+    Counter header_errors_;
+};
+
+/**
+ * Called by a TCP / UDP receiver while a frame's payload arrives
+ * (cut-through decode, stream_rows)
+ * @param payload Frame payload; the first `received` bytes are in
+ * @param size Payload bytes of the whole frame
+ * @param received Bytes received so far (size for the last call)
+ */
+using PayloadHandler = std::function<void(const uint8_t* payload, size_t size, size_t received)>;
+
+/**
+ * The reads that make up one frame: header (repeated until one is valid),
+ * payload (in chunks when a PayloadHandler wants progress), trailer
+ *
+ * Shared by the receivers, so that their blocking and coroutine paths
+ * only differ in how they get bytes:
+ *
+ *   FrameReader frame(header_, buffer, frame_size, &payload_handler_, payload_chunk_);
+ *   for (FrameReader::Step step; frame.next(step);) {
+ *       if (!receiveBytes(step.data, step.size)) {     // or co_await ...Async()
+ *           return false;
+ *       }
+ *       if (!frame.received(step)) {
+ *           ... invalid header: resync (UDP) or give up (TCP) ...
+ *       }
+ *   }
+ *
+ * Lives for one frame; the parser keeps the state across frames.
+ */
+class FrameReader {
+public:
+    enum class Part {
+        Header,
+        Payload,
+        Trailer,
+        Done
+    };
+
+    /**
+     * Bytes to receive next
+     */
+    struct Step {
+        Part part = Part::Done;
+        uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    /**
+     * Constructor
+     * @param header Parser of the connection
+     * @param buffer Receives the payload (resized once the size is known)
+     * @param frame_size Payload bytes without a header (Config::frame_size())
+     * @param handler Called after every `chunk` payload bytes (null or empty: none)
+     * @param chunk Payload bytes per step with a handler
+     */
+    FrameReader(FrameHeaderParser& header, std::vector<uint8_t>& buffer, size_t frame_size,
+                const PayloadHandler* handler = nullptr, size_t chunk = 0);
+
+    /**
+     * Get the next bytes to receive
+     * @return false once the frame is complete
+     */
+    bool next(Step& step);
+
+    /**
+     * Process the bytes of a step after receiving them
+     * @return false for an invalid header (next() asks for a header again)
+     */
+    bool received(const Step& step);
+
+    /**
+     * Payload bytes of the frame (known after the header)
+     */
+    size_t payloadSize() const { return payload_size_; }
+
+private:
+    /**
+     * Continue with the payload of payload_size_ bytes
+     */
+    void startPayload();
+
+    FrameHeaderParser& header_;
+    std::vector<uint8_t>& buffer_;
+    const PayloadHandler* handler_;
+    const size_t chunk_;
+    Part part_;
+    size_t payload_size_;
+    size_t payload_received_;
+    uint8_t head_[kMaxFrameHeaderSize];
+    uint8_t trailer_[kFrameTrailerSize];
+};
+
+} // namespace converter
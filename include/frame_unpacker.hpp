@@ -1,7 +1,13 @@
 #pragma once
 
 #include "config.hpp"
+#include "kernel_dispatcher.hpp"
+#include "event_soa.hpp"
+#include "metrics.hpp"
+#include "tile_activity.hpp"
 #include <dv-processing/core/event.hpp>
+#include <array>
+#include <memory>
 #include <vector>
 #include <cstdint>
 
@@ -29,14 +35,28 @@ namespace converter {
  *
  * Output format:
  *   - dv::EventStore containing events with (timestamp, x, y, polarity)
+ *   - or, with unpackSoA(), an EventFrameSoA: separate x / y arrays,
+ *     bit-packed polarity and one timestamp per frame
+ *
+ * Decoding is done by one of several kernels (scalar, LUT, SSE2, AVX2,
+ * see unpack_kernels.hpp), chosen at runtime by a KernelDispatcher.
+ *
+ * With setDecimation(), only an even lattice of 1 in N pixels is decoded
+ * (overload protection, see EventLimiter); with setRanges(), only the
+ * given byte ranges (subscribed tiles, see TileGrid).
+ *
+ * Events are stamped frame_number x frame_interval_us, or with the
+ * camera's timestamp set by setTimestamp() (versioned frame headers).
  */
 class FrameUnpacker {
 public:
     /**
      * Constructor
      * @param cfg Configuration reference
+     * @param dispatcher Kernel dispatcher to share between unpackers
+     *                   (nullptr = create and initialize a private one)
      */
-    explicit FrameUnpacker(const Config& cfg);
+    explicit FrameUnpacker(const Config& cfg, std::shared_ptr<KernelDispatcher> dispatcher = nullptr);
 
     /**
      * Unpack a binary frame into events
@@ -68,6 +88,111 @@ public:
         dv::EventStore& events
     );
 
+    /**
+     * Unpack a binary frame into an existing event packet
+     *
+     * For callers that recycle packets (see BufferPool): the packet's
+     * element storage is reused, so steady-state decoding does not allocate.
+     *
+     * @param frame_data Raw binary frame data pointer
+     * @param data_size Size of frame data in bytes
+     * @param frame_number Frame sequence number (for timestamp generation)
+     * @param packet Output packet (previous elements are replaced)
+     * @return Number of events unpacked
+     */
+    size_t unpack(
+        const uint8_t* frame_data,
+        size_t data_size,
+        uint64_t frame_number,
+        dv::EventPacket& packet
+    );
+
+    /**
+     * Unpack a binary frame into structure-of-arrays form
+     *
+     * Same events in the same order as unpack(), written straight into
+     * separate arrays instead of dv::Event records. The arrays of
+     * `frame` are grown on first use and reused afterwards.
+     *
+     * @param frame_data Raw binary frame data pointer
+     * @param data_size Size of frame data in bytes
+     * @param frame_number Frame sequence number (for timestamp generation)
+     * @param frame Output frame (count reset first)
+     * @return Number of events unpacked
+     */
+    size_t unpackSoA(
+        const uint8_t* frame_data,
+        size_t data_size,
+        uint64_t frame_number,
+        EventFrameSoA& frame
+    );
+
+    /**
+     * Decode part of a frame into a caller-provided buffer
+     *
+     * For parallel decoding: the events of consecutive ranges, concatenated
+     * in order, are exactly the events unpack() produces for the whole
+     * frame. Unlike unpack(), this does not report the frame to the kernel
+     * dispatcher's density profile.
+     *
+     * @param frame_data Raw binary frame data pointer
+     * @param data_size Size of frame data in bytes
+     * @param frame_number Frame sequence number (for timestamp generation)
+     * @param begin First byte to decode
+     * @param end One past the last byte to decode (<= frame size)
+     * @param out Output, room for 4 * (end - begin) events
+     * @return Number of events written (0 if the frame is too short)
+     */
+    size_t unpackRange(
+        const uint8_t* frame_data,
+        size_t data_size,
+        uint64_t frame_number,
+        size_t begin,
+        size_t end,
+        dv::Event* out
+    );
+
+    /**
+     * Account a frame decoded piecewise with unpackRange()
+     * (kernel density profile and decode metrics, as unpack() does)
+     * @param events Events decoded from the whole frame
+     */
+    void recordFrame(size_t events);
+
+    /**
+     * Decode only 1 in `factor` pixels from now on
+     * The frame is masked with a precomputed lattice (buildDecimationMask)
+     * before the kernel runs, so every kernel and unpackRange() band
+     * agrees on which pixels are kept.
+     * @param factor Power of two, 1 (everything) to 64
+     */
+    void setDecimation(int factor);
+
+    /**
+     * Get the current decimation factor (1 = none)
+     */
+    int getDecimation() const { return decimation_; }
+
+    /**
+     * Decode only these byte ranges from now on (nullptr = whole frame)
+     * Bytes outside them are not read at all. Ranges must be sorted and
+     * disjoint, as TileGrid::ranges() makes them. Applies to all unpack
+     * variants; unpackRange() decodes the part of its range they cover.
+     */
+    void setRanges(std::shared_ptr<const std::vector<ByteRange>> ranges) { ranges_ = std::move(ranges); }
+
+    /**
+     * Stamp the next frames' events with this time (us) instead of
+     * frame_number x frame_interval_us; negative = derive from the frame
+     * number again
+     */
+    void setTimestamp(int64_t timestamp) { timestamp_ = timestamp; }
+
+    /**
+     * Get the kernel dispatcher (to share it with further unpackers)
+     */
+    std::shared_ptr<KernelDispatcher> getDispatcher() const { return dispatcher_; }
+
     /**
      * Get expected frame size in bytes
      * @return Frame size (230,400 bytes for 1280x720)
@@ -80,12 +205,98 @@ public:
      */
     cv::Size getResolution() const;
 
+    /**
+     * Get name of the decode kernel used for the next frame
+     * @return Kernel name ("scalar", "lut", "sse2", "avx2", ...)
+     */
+    const char* getKernelName() const;
+
+    /**
+     * Rebuild resolution-dependent lookup tables
+     * Called automatically by unpack() when width/height in the config
+     * differ from the ones the tables were built for.
+     */
+    void rebuildTables();
+
 private:
+    /**
+     * Run the selected kernel over a whole frame into scratch_
+     * @param count Output: number of events in scratch_
+     * @return false if the frame is too short
+     */
+    bool decode(const uint8_t* frame_data, size_t data_size, uint64_t frame_number, size_t& count);
+
+    /**
+     * Check the frame size and refresh the tables for the current resolution
+     * @return false if the frame is too short
+     */
+    bool prepare(size_t data_size);
+
+    /**
+     * Run the selected kernel over bytes [begin, end) of a frame
+     * Bytes past the last full one go to the bounds-checked reference.
+     */
+    size_t decodeBytes(UnpackContext& ctx, size_t begin, size_t end, dv::Event* out) const;
+
+    /**
+     * Decode bytes [begin, end) of a frame, restricted to ranges_ and
+     * decimated, into `out`
+     */
+    size_t decodeSelected(UnpackContext& ctx, const uint8_t* frame_data, size_t begin, size_t end, dv::Event* out);
+
+    /**
+     * SoA counterpart of decodeSelected() (appends to out)
+     */
+    void decodeSelectedSoA(UnpackContext& ctx, const uint8_t* frame_data, size_t begin, size_t end, SoaOutput& out);
+
+    /**
+     * Apply the decimation mask to bytes [begin, end) of a frame
+     * @return Frame to decode: frame_data itself without decimation,
+     *         otherwise masked_ (valid in [begin, end))
+     */
+    const uint8_t* decimate(const uint8_t* frame_data, size_t begin, size_t end);
+
+    /**
+     * Event timestamp of a frame (setTimestamp() or from frame_number)
+     */
+    int64_t frameTimestamp(uint64_t frame_number) const
+    {
+        return timestamp_ >= 0 ? timestamp_ : static_cast<int64_t>(frame_number) * config_.frame_interval_us;
+    }
+
     const Config& config_;
+    std::shared_ptr<KernelDispatcher> dispatcher_;
     
     // Pre-computed coordinate lookup for fast pixel index to (x, y) conversion
-    // For each byte index, stores the base pixel index
-    std::vector<int32_t> byte_to_base_pixel_;
+    // For each byte index, stores x and y of its first pixel
+    std::vector<int16_t> byte_x_;
+    std::vector<int16_t> byte_y_;
+
+    // Kernel output buffer, sized for a frame with every pixel active
+    std::vector<dv::Event> scratch_;
+
+    // Structure-of-arrays kernel (unpackSoA)
+    UnpackSoaKernelFn soa_kernel_;
+
+    // Decimation: factor, masks per log2(factor) built on first use,
+    // masked copy of the frame being decoded
+    int decimation_;
+    std::array<std::vector<uint8_t>, 7> decimation_masks_;
+    std::vector<uint8_t> masked_;
+
+    // Byte ranges to decode (nullptr = all)
+    std::shared_ptr<const std::vector<ByteRange>> ranges_;
+
+    // Camera timestamp of the frame (-1 = frame_number x frame_interval_us)
+    int64_t timestamp_;
+
+    // Resolution the tables above were built for
+    int table_width_;
+    int table_height_;
+
+    // Registry metrics decode_frames / decode_events
+    Counter frames_decoded_;
+    Counter events_decoded_;
 };
 
 } // namespace converter
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "config.hpp"
+#include "unpack_kernels.hpp"
+#include "metrics.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Kernel Dispatcher class
+ *
+ * Chooses which decode kernel FrameUnpacker uses. With
+ * UnpackKernel::Auto it benchmarks every kernel this CPU supports on
+ * synthetic frames at the configured resolution and picks the fastest.
+ * Every candidate is also cross-checked against the scalar reference;
+ * a kernel that produces different events is never selected.
+ *
+ * If kernel_reeval_interval > 0, the benchmark is re-run on a background
+ * thread every N frames at the live event density and the active kernel
+ * is swapped atomically. Decoding never waits for the re-evaluation.
+ */
+class KernelDispatcher {
+public:
+    /**
+     * Result of benchmarking one kernel
+     */
+    struct BenchResult {
+        const KernelInfo* kernel;
+        double ns_per_frame;    // Best observed time for one frame
+        bool matches_reference; // Output identical to the scalar kernel
+    };
+
+    /**
+     * Constructor
+     * @param cfg Configuration reference
+     */
+    explicit KernelDispatcher(const Config& cfg);
+
+    /**
+     * Destructor - waits for a running re-evaluation to finish
+     */
+    ~KernelDispatcher();
+
+    // Disable copy
+    KernelDispatcher(const KernelDispatcher&) = delete;
+    KernelDispatcher& operator=(const KernelDispatcher&) = delete;
+
+    /**
+     * Select the initial kernel (configured one, or startup benchmark for Auto)
+     * Logs the choice.
+     */
+    void initialize();
+
+    /**
+     * Kernel to use for the next frame (lock-free, callable from any thread)
+     * @return Active kernel
+     */
+    const KernelInfo& current() const { return *current_.load(std::memory_order_acquire); }
+
+    /**
+     * Report a decoded frame; updates the live density profile and starts a
+     * background re-evaluation every kernel_reeval_interval frames
+     * @param events Events decoded from the frame
+     * @param total_pixels Pixels in the frame
+     */
+    void observe(size_t events, int total_pixels);
+
+    /**
+     * Benchmark all available kernels on synthetic frames
+     * @param density Fraction of pixels carrying an event (0-1)
+     * @param duration_ms Time budget per kernel
+     * @return One result per available kernel
+     */
+    std::vector<BenchResult> benchmark(double density, int duration_ms) const;
+
+    /**
+     * Get smoothed live event density (fraction of pixels per frame)
+     */
+    double getLiveDensity() const { return live_density_.load(std::memory_order_relaxed); }
+
+    /**
+     * Get number of kernel switches made by re-evaluation
+     */
+    uint64_t getSwitchCount() const { return switch_count_.value(); }
+
+private:
+    /**
+     * Fastest kernel that matches the reference, or nullptr
+     */
+    static const BenchResult* fastest(const std::vector<BenchResult>& results);
+
+    /**
+     * Background re-evaluation at the live density
+     */
+    void reevaluate(double density);
+
+    const Config& config_;
+    std::atomic<const KernelInfo*> current_;
+
+    std::atomic<double> live_density_;
+    std::atomic<uint64_t> frames_since_eval_;
+    Counter switch_count_;              // kernel_switches
+
+    // reeval_running_ is cleared by the re-evaluation itself, so it does
+    // not keep two observers off reeval_thread_; reeval_mutex_ does
+    std::mutex reeval_mutex_;
+    std::thread reeval_thread_;
+    std::atomic<bool> reeval_running_;
+};
+
+} // namespace converter
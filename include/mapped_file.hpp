@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Read-only memory mapping of a whole file (mmap / MapViewOfFile)
+ *
+ * Shared by the file input (FileReceiver) and batch conversion
+ * (BatchConverter). Frames are decoded straight from the mapping; the
+ * page cache does the reading, steered with advise().
+ */
+class MappedFile {
+public:
+    /**
+     * Paging hints for a byte range (madvise on POSIX, no-op elsewhere)
+     */
+    enum class Access {
+        Sequential,     // Read front to back: aggressive read-ahead
+        WillNeed,       // Read soon: start reading now
+        DontNeed        // Done: drop the pages from this mapping
+    };
+
+    MappedFile() = default;
+
+    /**
+     * Destructor - unmaps the file
+     */
+    ~MappedFile();
+
+    // Disable copy (owns the mapping)
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Open and map a file (an open one is closed first)
+     * @return false if it cannot be opened or mapped (error printed)
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Unmap and close
+     */
+    void close();
+
+    /**
+     * Check if a file is mapped
+     */
+    bool isOpen() const { return open_; }
+
+    /**
+     * Start of the mapping (nullptr for an empty file)
+     */
+    const uint8_t* data() const { return data_; }
+
+    /**
+     * Size of the file in bytes
+     */
+    uint64_t size() const { return size_; }
+
+    /**
+     * Hint how a byte range will be used next; the range is widened to
+     * whole pages (DontNeed: narrowed, so neighbours are kept)
+     */
+    void advise(uint64_t offset, uint64_t length, Access access) const;
+
+private:
+    bool open_ = false;
+    const uint8_t* data_ = nullptr;
+    uint64_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;          // HANDLE
+    void* mapping_ = nullptr;       // HANDLE
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace converter
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "config.hpp"
+#include "thread_slots.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+class MetricsRegistry;
+
+/**
+ * Monotonic counter handle (cheap to copy)
+ *
+ * add() goes to the calling thread's own shard of the registry, so
+ * threads counting the same metric never touch a shared cache line.
+ */
+class Counter {
+public:
+    Counter() = default;
+
+    /**
+     * Add to the counter (any thread, lock-free)
+     */
+    void add(uint64_t n = 1) const;
+
+    /**
+     * Current total over all threads (any thread, lock-free)
+     */
+    uint64_t value() const;
+
+private:
+    friend class MetricsRegistry;
+    explicit Counter(uint32_t id) : id_(id) {}
+    uint32_t id_ = 0;       // 0 = unregistered (writes go to a discarded slot)
+};
+
+/**
+ * Gauge handle: last value written wins (queue depth, buffers in use)
+ * Each gauge has its own cache line.
+ */
+class Gauge {
+public:
+    Gauge() = default;
+
+    void set(int64_t v) const;
+    void add(int64_t delta) const;
+    int64_t value() const;
+
+private:
+    friend class MetricsRegistry;
+    explicit Gauge(uint32_t id) : id_(id) {}
+    uint32_t id_ = 0;
+};
+
+/**
+ * Point-in-time copy of all metrics
+ */
+struct MetricsSnapshot {
+    enum class Kind : uint8_t { Counter, Gauge };
+
+    struct Value {
+        std::string name;
+        Kind kind;
+        int64_t value;
+    };
+
+    std::chrono::steady_clock::time_point time;
+    std::vector<Value> values;      // In registration order
+
+    /**
+     * Value of a metric by name
+     * @return Value, or 0 if no such metric
+     */
+    int64_t get(const std::string& name) const;
+
+    /**
+     * Write one "name value" line per metric
+     */
+    void writeText(std::ostream& out) const;
+};
+
+/**
+ * Process-wide registry of counters and gauges
+ *
+ * Components register their metrics once (usually in the constructor)
+ * and keep the handles:
+ *
+ *   Counter bytes = MetricsRegistry::global().counter(metricName(cfg, "rx_bytes"));
+ *   bytes.add(received);                           // hot path
+ *   auto snap = MetricsRegistry::global().snapshot();   // any thread
+ *
+ * Counters are sharded per thread: each thread that counts gets its own
+ * cache-line-aligned block of counter slots, and a counter's value is
+ * the sum over all blocks. Registering the same name again returns the
+ * same metric, so components that restart keep counting where they were.
+ * snapshot() and value() read with relaxed atomic loads and never block
+ * writers; a snapshot is consistent per metric, not across metrics.
+ */
+class MetricsRegistry {
+public:
+    static constexpr size_t kMaxCounters = 255;
+    static constexpr size_t kMaxGauges = 127;
+    static constexpr size_t kMaxShards = 128;
+
+    /**
+     * The registry used by all DVBridge components
+     */
+    static MetricsRegistry& global();
+
+    /**
+     * Register (or look up) a counter
+     * Beyond kMaxCounters, a warning is printed and an unregistered
+     * handle returned.
+     */
+    Counter counter(const std::string& name);
+
+    /**
+     * Register (or look up) a gauge
+     */
+    Gauge gauge(const std::string& name);
+
+    /**
+     * Copy all current values (lock-free)
+     */
+    MetricsSnapshot snapshot() const;
+
+private:
+    friend class Counter;
+    friend class Gauge;
+
+    /**
+     * One thread's counter slots; slot 0 absorbs unregistered handles
+     */
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, kMaxCounters + 1> values{};
+        std::atomic<bool> in_use{false};
+    };
+
+    struct alignas(64) GaugeSlot {
+        std::atomic<int64_t> value{0};
+    };
+
+    struct Entry {
+        std::string name;
+        MetricsSnapshot::Kind kind;
+        uint32_t id;
+    };
+
+    MetricsRegistry();
+    ~MetricsRegistry() = default;
+
+    /**
+     * Shard of the calling thread (claimed on first use, released when
+     * the thread exits so the next thread can reuse it)
+     */
+    Shard& localShard();
+
+    uint64_t counterValue(uint32_t id) const;
+
+    std::mutex register_mutex_;         // Registration only
+    std::array<Entry, kMaxCounters + kMaxGauges> entries_;
+    std::atomic<size_t> entry_count_;   // Published with release after the entry is written
+    uint32_t counter_count_;
+    uint32_t gauge_count_;
+
+    ThreadSlots<Shard, kMaxShards> shards_;
+    Shard overflow_shard_;              // Shared by threads beyond kMaxShards
+
+    std::array<GaugeSlot, kMaxGauges + 1> gauges_;
+};
+
+/**
+ * Metric name with the configured prefix (metrics_prefix), so pipelines
+ * for different cameras keep separate metrics
+ */
+std::string metricName(const Config& cfg, const char* name);
+
+} // namespace converter
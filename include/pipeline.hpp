@@ -0,0 +1,482 @@
+#pragma once
+
+#include "config.hpp"
+#include "tcp_receiver.hpp"
+#include "udp_receiver.hpp"
+#include "file_receiver.hpp"
+#include "frame_unpacker.hpp"
+#include "buffer_pool.hpp"
+#include "event_soa.hpp"
+#include "decode_scheduler.hpp"
+#include "reorder_buffer.hpp"
+#include "task.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include "event_limiter.hpp"
+#include "tile_activity.hpp"
+#include <dv-processing/core/event.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <variant>
+#include <cstdint>
+
+namespace converter {
+
+class EventLoop;
+
+/**
+ * One decoded frame delivered by Pipeline
+ *
+ * The event storage comes from the pipeline's buffer pool and is shared,
+ * not copied: copies of `events` or `soa` keep the buffer out of the pool
+ * until they are destroyed.
+ */
+struct EventFrame {
+    uint64_t frame_number = 0;
+    int64_t timestamp = 0;                          // Microseconds (camera clock with v1 headers)
+    dv::EventStore events;                          // pipeline_soa = false
+    std::shared_ptr<const EventFrameSoA> soa;       // pipeline_soa = true
+    std::chrono::steady_clock::time_point received; // Last byte received
+    int decimation = 1;                             // Decoded 1 in N pixels (decimation_enabled)
+    std::shared_ptr<const TileActivity> tiles;      // Events per tile (tile_activity, active subscriptions)
+
+    // Rows [row_begin, row_end) covered by this delivery. With stream_rows
+    // a frame arrives as several parts sharing its frame_number, in row
+    // order; frame_end marks the last. Otherwise one part with all rows
+    int row_begin = 0;
+    int row_end = 0;
+    bool frame_end = true;
+};
+
+using EventFramePtr = std::shared_ptr<const EventFrame>;
+
+/**
+ * In-process receive + decode pipeline (libdvbridge)
+ *
+ * Runs the receiver (TCP, UDP or file, per Config::protocol) and FrameUnpacker
+ * on a background thread and hands decoded frames straight to the
+ * application, without AEDAT4 encoding or a network hop:
+ *
+ *   converter::Pipeline pipeline(cfg);
+ *   pipeline.setCallback([](const converter::EventFramePtr& frame) { ... });
+ *   pipeline.start();
+ *
+ * or pull-based:
+ *
+ *   pipeline.start();
+ *   while (auto frame = pipeline.next(100)) { ... }
+ *
+ * With a callback set, frames go only to the callback, which runs on the
+ * pipeline thread and must not block for long. Otherwise frames are
+ * queued (pipeline_queue_depth, oldest dropped first) for next().
+ *
+ * Decoded events live in pooled buffers (pipeline_pool_size). If the
+ * application holds on to every buffer, new frames are dropped and
+ * counted rather than allocating more.
+ *
+ * Counters are registered in MetricsRegistry under metrics_prefix; give
+ * each camera's Config its own prefix to keep their statistics apart.
+ * With decimation_enabled, frames that would overload delivery (event
+ * count over budget, or a backlog of queued / decoding frames) are decoded
+ * subsampled; EventFrame::decimation tells the application by how much.
+ *
+ * Consumers that only need part of the image subscribe to tiles (32x32
+ * pixels): fixed ones, or per frame the "active" ones with at least
+ * tile_active_threshold events. Only the union of all subscriptions is
+ * decoded; bytes of other tiles are not even read by the decoder:
+ *
+ *   converter::TileSelection left_half;
+ *   for (uint32_t t = 0; t < 920; t++) if (t % 40 < 20) left_half.tiles.push_back(t);
+ *   int id = pipeline.subscribeTiles(left_half);
+ *
+ * With tile_activity, every frame carries its per-tile event counts
+ * (EventFrame::tiles) as a cheap summary of where the scene is moving.
+ *
+ * Stage timings go to the TraceRecorder; a frame slower than
+ * trace_latency_threshold_us requests a dump, which the application
+ * writes with TraceRecorder::global().dumpIfRequested().
+ *
+ * Connection loss is handled like the converter does: disconnect, wait
+ * a second, reconnect. The pipeline stops if reconnecting fails.
+ *
+ * File input (protocol = file) is lossless instead of real-time: when
+ * decoders or the consumer fall behind, reading waits for them rather than
+ * dropping frames or skipping them in the reorder stage, and the pipeline
+ * stops at end of file (inputFinished()). It always reads on a thread of
+ * its own, as waiting would stall a shared event loop.
+ *
+ * With pipeline_async (Linux), receiving runs as a coroutine on an
+ * EventLoop instead of blocking a thread. Several pipelines (cameras) can
+ * share one loop, and with it one thread:
+ *
+ *   auto loop = std::make_shared<converter::EventLoop>();
+ *   loop->open();
+ *   converter::Pipeline left(left_cfg, loop), right(right_cfg, loop);
+ *   left.start(); right.start();
+ *   std::thread io([&] { loop->run(); });
+ *
+ * Callbacks then run on the loop thread.
+ *
+ * With decode_threads > 0 (or a DecodeScheduler passed in, which several
+ * pipelines may share), frames are decoded by a work-stealing pool
+ * instead of the receive thread, optionally split into row bands
+ * (decode_band_rows). Frames are still delivered one at a time and in
+ * frame-number order through a bounded reorder stage (reorder_window,
+ * reorder_max_wait_ms) that skips and counts a frame that does not show
+ * up in time; the callback runs on whichever thread completes the next
+ * frame in sequence.
+ *
+ * With stream_rows (TCP / UDP), decoding does not wait for the whole
+ * frame: every stream_rows rows are decoded on the receive thread as soon
+ * as their bytes are in and delivered as a part of the frame (see
+ * EventFrame::row_begin, frame_end), so the first events of a frame leave
+ * while the rest is still on the wire. Frame counters count whole frames.
+ * The CRC trailer comes after the payload, so a mismatch can only be
+ * counted (rx_crc_errors), not withdrawn; a frame cut off by a lost
+ * connection ends without a frame_end part.
+ */
+class Pipeline {
+public:
+    using FrameCallback = std::function<void(const EventFramePtr&)>;
+
+    /**
+     * Constructor
+     * @param cfg Configuration reference (must outlive the pipeline)
+     * @param loop Event loop to receive on (Linux). nullptr: with
+     *             pipeline_async, the pipeline runs a loop of its own;
+     *             otherwise it uses a blocking receive thread
+     * @param scheduler Decode workers to share with other pipelines.
+     *             nullptr: a scheduler of its own if decode_threads > 0,
+     *             otherwise frames are decoded on the receive thread
+     */
+    explicit Pipeline(const Config& cfg,
+                      std::shared_ptr<EventLoop> loop = nullptr,
+                      std::shared_ptr<DecodeScheduler> scheduler = nullptr);
+
+    /**
+     * Destructor - stops the pipeline thread
+     */
+    ~Pipeline();
+
+    // Disable copy
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /**
+     * Deliver frames to a callback instead of the pull queue
+     * Must be called before start().
+     * @param callback Called on the pipeline thread for every frame
+     */
+    void setCallback(FrameCallback callback);
+
+    /**
+     * Start receiving (connects the receiver in the background)
+     * On a shared event loop the receive task starts once the loop runs.
+     * @return true if started (false if already running or the
+     *         configuration fails validateConfig())
+     */
+    bool start();
+
+    /**
+     * Stop the pipeline thread / task and disconnect the receiver
+     * Safe to call from any thread except the callback (or, on a shared
+     * event loop, the loop thread).
+     */
+    void stop();
+
+    /**
+     * Check if the pipeline thread is running
+     * @return false after stop() or an unrecoverable receive error
+     */
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * Check if the pipeline stopped at the end of its input file
+     * @return true once input_file has been read to the end
+     */
+    bool inputFinished() const { return input_finished_.load(std::memory_order_acquire); }
+
+    /**
+     * Decode only the selected tiles (any thread, applies from the next
+     * frame). With several subscriptions, the union is decoded; a
+     * selection of all tiles turns tile skipping off.
+     * @return Subscription id for unsubscribeTiles(), or -1 if a tile is
+     *         outside the frame (nothing subscribed)
+     */
+    int subscribeTiles(TileSelection selection);
+
+    /**
+     * Remove a subscription; without any, whole frames are decoded again
+     */
+    void unsubscribeTiles(int id);
+
+    /**
+     * Get the next queued frame (pull mode)
+     * @param timeout_ms Maximum wait in milliseconds (negative = forever)
+     * @return Frame, or nullptr on timeout or once stopped and drained
+     */
+    EventFramePtr next(int timeout_ms);
+
+    /**
+     * Get the unpacker (kernel name, resolution)
+     */
+    const FrameUnpacker& getUnpacker() const { return unpacker_; }
+
+    /**
+     * Get the decode scheduler (nullptr when decoding on the receive thread)
+     */
+    const DecodeScheduler* getScheduler() const { return scheduler_.get(); }
+
+    /**
+     * Get frames decoded and delivered
+     */
+    uint64_t getFramesDelivered() const { return frames_delivered_.value(); }
+
+    /**
+     * Get frames dropped (buffer pool exhausted or pull queue full; never
+     * with file input)
+     */
+    uint64_t getFramesDropped() const { return frames_dropped_.value(); }
+
+    /**
+     * Get frames that failed the CRC32C check (verify_crc; also counted
+     * as dropped)
+     */
+    uint64_t getCrcErrors() const { return crc_errors_.value(); }
+
+    /**
+     * Get frames skipped by the reorder stage (never completed in time)
+     */
+    uint64_t getFramesSkipped() const { return frames_skipped_.value(); }
+
+    /**
+     * Get total events delivered
+     */
+    uint64_t getEventsDelivered() const { return events_delivered_.value(); }
+
+    /**
+     * Get total bytes received from the camera
+     */
+    uint64_t getTotalBytesReceived() const;
+
+private:
+    /**
+     * Pipeline thread: receive, decode, deliver
+     */
+    void run();
+
+    /**
+     * run() as an EventLoop task
+     */
+    Task<void> runAsync();
+
+    /**
+     * Decode and deliver one received frame, here or on the scheduler
+     * @param buffer Received frame; with a scheduler, its storage may be
+     *               swapped for a recycled one
+     * @param payload The frame's bytes: buffer's, or mapped socket pages
+     *                (tcp_zerocopy, only without a scheduler)
+     */
+    void handleFrame(std::vector<uint8_t>& buffer, const uint8_t* payload, size_t payload_size,
+                     uint64_t frame_number, std::chrono::steady_clock::time_point received);
+
+    /**
+     * What the receive thread decided about a frame before decoding
+     */
+    struct FrameInfo {
+        std::chrono::steady_clock::time_point received;
+        int64_t timestamp = 0;                                  // Event time (camera clock or frame number)
+        std::optional<uint32_t> crc;                            // Expected CRC32C (verify_crc)
+        int decimation = 1;
+        std::shared_ptr<const TileActivity> tiles;
+        std::shared_ptr<const std::vector<ByteRange>> ranges;  // Subscribed tiles (nullptr = all)
+    };
+
+    /**
+     * Rebuild the union of the tile subscriptions if they changed
+     */
+    void refreshTileUnion();
+
+    /**
+     * Byte ranges of the subscribed tiles for a frame
+     * @param activity Tile counts of the frame (needed for "active")
+     * @return nullptr to decode the whole frame
+     */
+    std::shared_ptr<const std::vector<ByteRange>> selectTiles(const TileActivity* activity);
+
+    /**
+     * Received frame handed to the decode workers (pooled)
+     */
+    struct RawFrame {
+        std::vector<uint8_t> data;
+        FrameInfo info;
+        std::vector<std::vector<dv::Event>> bands;  // Band outputs (decode_band_rows)
+        std::vector<size_t> band_counts;
+        std::vector<uint32_t> band_crcs;            // CRC32C of each band's bytes (info.crc set)
+        std::atomic<size_t> bands_left{0};
+        std::atomic<bool> band_failed{false};
+    };
+
+    /**
+     * Queue decode jobs for a frame (whole, or one per row band)
+     */
+    void scheduleFrame(std::vector<uint8_t>& buffer, uint64_t frame_number, FrameInfo info);
+
+    /**
+     * Decode job for one row band; the last band to finish assembles the frame
+     */
+    void decodeBand(RawFrame& raw, uint64_t frame_number, size_t band, size_t band_count);
+
+    /**
+     * Pass a decoded frame (nullptr = dropped) through the reorder buffer
+     * and deliver everything now in sequence
+     */
+    void complete(uint64_t frame_number, EventFramePtr frame);
+
+    /**
+     * Deliver what the reorder buffer releases (reorder_mutex_ held)
+     * @param flush Also skip gaps that have not timed out (shutdown)
+     */
+    void drainReorder(std::unique_lock<std::mutex>& lock, bool flush = false);
+
+    /**
+     * Mark one scheduled frame done (wakes finish())
+     */
+    void jobDone();
+
+    /**
+     * Disconnect and mark the pipeline stopped (end of run / runAsync)
+     */
+    void finish();
+
+    /**
+     * Check if a failed receive was the end of the input file
+     */
+    bool receiverAtEnd() const;
+
+    /**
+     * Decode one received frame into pooled buffers
+     * @return Frame, or nullptr if no buffer was free
+     */
+    EventFramePtr decodeFrame(FrameUnpacker& unpacker, const uint8_t* data, size_t size, uint64_t frame_number,
+                              const FrameInfo& info);
+
+    /**
+     * Payload handler for cut-through decode (stream_rows): decode and
+     * deliver the rows received since the last call
+     */
+    void streamPayload(const uint8_t* payload, size_t size, size_t received);
+
+    /**
+     * End a streamed frame once the receiver has all of it (CRC check,
+     * decode metrics)
+     */
+    void finishStream(uint64_t frame_number);
+
+    /**
+     * Count a frame whose payload does not match its CRC32C trailer
+     */
+    void crcFailed(uint64_t frame_number, uint32_t expected, uint32_t actual);
+
+    /**
+     * Hand a frame to the callback or the pull queue
+     */
+    void deliver(EventFramePtr frame);
+
+    /**
+     * Request a trace dump if the frame exceeded trace_latency_threshold_us
+     * (at most one request per second)
+     */
+    void checkLatency(const EventFrame& frame);
+
+    const Config& config_;
+
+    using ReceiverVariant = std::variant<TcpReceiver, UdpReceiver, FileReceiver>;
+    std::unique_ptr<ReceiverVariant> receiver_;
+    std::mutex receiver_mutex_;         // disconnect() vs interrupt() from stop()
+    FrameUnpacker unpacker_;
+    EventLimiter limiter_;              // Receive thread only
+
+    // Tile subscriptions (tiles_mutex_); the receive thread keeps the
+    // union in the tile_* members below and refreshes it on a new version
+    std::mutex tiles_mutex_;
+    std::map<int, TileSelection> tile_subscriptions_;
+    int next_subscription_;
+    std::atomic<uint64_t> tiles_version_;
+    uint64_t tile_union_version_;
+    TileGrid tile_grid_;
+    bool tile_all_;                     // Some subscriber wants whole frames (or there are none)
+    bool tile_active_;                  // Some subscriber wants active tiles
+    std::vector<uint8_t> tile_fixed_;   // Union of fixed tiles, per tile
+    std::shared_ptr<const std::vector<ByteRange>> tile_fixed_ranges_;   // Cached when !tile_active_
+
+    BufferPool<dv::EventPacket> packet_pool_;
+    BufferPool<EventFrameSoA> soa_pool_;
+
+    FrameCallback callback_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::condition_variable queue_space_cv_;   // next() made room (file input)
+    std::deque<EventFramePtr> queue_;
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> stop_requested_;
+    std::atomic<bool> input_finished_;
+    const bool lossless_;               // File input: wait instead of dropping
+
+    // Registry metrics (metrics.hpp); the getters above read these
+    Counter frames_delivered_;          // pipeline_frames
+    Counter frames_dropped_;            // pipeline_dropped
+    Counter frames_skipped_;            // pipeline_skipped
+    Counter events_delivered_;          // pipeline_events
+    Gauge queue_depth_;                 // pipeline_queue
+    Gauge frames_in_flight_gauge_;      // pipeline_in_flight
+    Counter latency_breaches_;          // pipeline_latency_breaches
+    Gauge tiles_active_;                // tiles_active
+    Counter tiles_skipped_;             // decode_tiles_skipped
+    Counter crc_errors_;                // rx_crc_errors
+
+    // Cut-through decode (stream_rows); receive thread / loop only
+    struct StreamState {
+        bool active = false;            // A frame is partly delivered
+        uint64_t frame_number = 0;      // Set by the receive loop
+        FrameInfo info;
+        size_t received = 0;            // Payload bytes seen so far
+        size_t decoded = 0;             // Frame bytes decoded so far
+        size_t events = 0;
+        uint32_t crc = 0;               // Running CRC32C of the payload
+        bool dropped = false;           // A part found no free buffer
+        std::vector<dv::Event> scratch; // Decode target, kept across frames
+    };
+    StreamState stream_;
+
+    // Last latency-triggered dump request (deliveries are serialized)
+    std::chrono::steady_clock::time_point last_trace_request_;
+
+    // Async receive (pipeline_async or a shared loop)
+    std::shared_ptr<EventLoop> loop_;
+    bool owns_loop_;
+
+    // Parallel decode (decode_threads or a shared scheduler)
+    std::vector<std::unique_ptr<FrameUnpacker>> worker_unpackers_;   // One per worker
+    BufferPool<RawFrame> raw_pool_;
+    std::mutex reorder_mutex_;
+    std::condition_variable reorder_cv_;
+    ReorderBuffer<EventFramePtr> reorder_;
+    bool delivering_;                   // A thread is draining reorder_
+    size_t frames_in_flight_;           // Scheduled, not yet completed
+    std::shared_ptr<DecodeScheduler> scheduler_;    // Last: workers stop before the rest is destroyed
+};
+
+} // namespace converter
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "config.hpp"
+
+#include <dv-processing/core/event.hpp>
+#include <dv-processing/io/mono_camera_writer.hpp>
+
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * One AEDAT4 file of a recording and the frames it holds
+ */
+struct RecordingSegment {
+    std::string path;
+    uint64_t first_frame = 0;
+    uint64_t frames = 0;
+    int64_t begin_us = 0;       // Timestamp of the first frame
+    int64_t end_us = 0;         // Exclusive: last frame's timestamp + frame_interval_us
+    uint64_t events = 0;
+};
+
+/**
+ * Sidecar index of a recording (<output_file>.index)
+ *
+ * Maps frame and time ranges to the segment files of a recording, so a
+ * time range is extracted by opening only the segments that overlap it;
+ * inside a segment, the AEDAT4 packet table seeks to the first packet
+ * (tools/extract_range.py). Text, one line per segment, appended and
+ * flushed as each segment is closed, so an interrupted recording is
+ * indexed up to its last complete segment:
+ *
+ *   # DVBridge recording index 1
+ *   # width=1280 height=720 frame_interval_us=10000
+ *   # path first_frame frames begin_us end_us events
+ *   capture.00000.aedat4 0 6000 0 60000000 48213377
+ *
+ * Lines may be out of frame order (batch conversion finishes chunks in
+ * any order); readers sort by first_frame.
+ */
+class RecordingIndex {
+public:
+    /**
+     * Index file of an output file (output_file + ".index")
+     */
+    static std::string indexPath(const std::string& output_file);
+
+    /**
+     * Path of segment `index` of an output file: the index is inserted
+     * before the extension (out.aedat4 -> out.00003.aedat4)
+     */
+    static std::string segmentPath(const std::string& output_file, size_t index);
+
+    /**
+     * Create (truncate) the index of output_file and write its header
+     * @return false if it cannot be written (error printed)
+     */
+    bool create(const Config& cfg);
+
+    /**
+     * Append a segment (thread-safe); only the file name of segment.path
+     * is stored, as segments are written next to the index
+     */
+    void add(const RecordingSegment& segment);
+
+    /**
+     * Read an index
+     * @param path Index file
+     * @param segments Segments sorted by first_frame, paths resolved
+     *                 against the index location
+     * @return false if it cannot be read or is not an index (error printed)
+     */
+    static bool load(const std::string& path, std::vector<RecordingSegment>& segments);
+
+private:
+    std::mutex mutex_;
+    std::ofstream out_;
+};
+
+/**
+ * AEDAT4 recording sink of the converter (output_file)
+ *
+ * Writes frames to output_file, or with output_segment_frames > 0 to a new
+ * segment file every N frames (out.00000.aedat4, out.00001.aedat4, ...),
+ * and keeps the recording's RecordingIndex up to date. Segment N holds
+ * frames [N x output_segment_frames, (N + 1) x output_segment_frames),
+ * so segment boundaries fall on the same frames in every recording.
+ *
+ * Not thread-safe; called from the pipeline callback.
+ */
+class RecordingWriter {
+public:
+    /**
+     * Constructor
+     * @param cfg Configuration reference (must outlive the writer)
+     */
+    explicit RecordingWriter(const Config& cfg);
+
+    /**
+     * Destructor - closes the last segment
+     */
+    ~RecordingWriter();
+
+    // Disable copy
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+    /**
+     * Create the index and the first segment
+     * @return false if either cannot be created (error printed)
+     */
+    bool open();
+
+    /**
+     * Write a frame's events (frames in increasing frame_number order;
+     * empty frames still advance the segment)
+     * @param timestamp Frame timestamp (us), for the index
+     */
+    void write(uint64_t frame_number, int64_t timestamp, const dv::EventStore& events);
+
+    /**
+     * Close the current segment and add it to the index
+     */
+    void close();
+
+private:
+    /**
+     * Open the segment starting at `first_frame`
+     * @return false if the file cannot be created (error printed)
+     */
+    bool startSegment(uint64_t first_frame);
+
+    /**
+     * Close the current segment, ending before `end_frame`
+     */
+    void finishSegment(uint64_t end_frame);
+
+    const Config& config_;
+    RecordingIndex index_;
+    std::unique_ptr<dv::io::MonoCameraWriter> writer_;
+    RecordingSegment segment_;
+    uint64_t next_frame_;       // One past the last frame written
+    bool failed_;               // A segment could not be created; stop writing
+};
+
+} // namespace converter
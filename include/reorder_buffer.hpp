@@ -0,0 +1,173 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <optional>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Restores sequence order of results that complete out of order
+ *
+ * Results are inserted with their sequence number (frame number) in any
+ * order; pop() hands them out in sequence, holding back everything after
+ * a gap until the missing one arrives. A gap is given up on (skipped and
+ * counted) once it has blocked output for `max_wait`, or once `capacity`
+ * results are held behind it, so neither latency nor memory grow without
+ * bound. Results arriving after their slot was released or skipped are
+ * rejected and counted as late.
+ *
+ *   ReorderBuffer<EventFramePtr> reorder(32, std::chrono::milliseconds(50));
+ *   reorder.insert(frame_number, frame);
+ *   while (auto next = reorder.pop()) { deliver(*next); }
+ *
+ * Waiting is only checked in pop(); callers that need the timeout to
+ * fire without new arrivals call pop() again around nextDeadline().
+ *
+ * Not thread-safe; callers serialize access.
+ */
+template <typename T>
+class ReorderBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructor
+     * @param capacity Results held behind a gap before it is skipped
+     * @param max_wait Time a gap may block output before it is skipped
+     * @param first Sequence number released first
+     */
+    explicit ReorderBuffer(size_t capacity = 64,
+                           Clock::duration max_wait = Clock::duration::max(),
+                           uint64_t first = 0)
+        : capacity_(capacity > 0 ? capacity : 1)
+        , max_wait_(max_wait)
+        , next_(first)
+        , skipped_(0)
+        , late_(0)
+    {
+    }
+
+    /**
+     * Add a result
+     * @return false if `sequence` was already released or skipped (counted
+     *         as late), or is a duplicate
+     */
+    bool insert(uint64_t sequence, T value)
+    {
+        if (sequence < next_) {
+            late_++;
+            return false;
+        }
+        return pending_.emplace(sequence, std::move(value)).second;
+    }
+
+    /**
+     * Take the next result in sequence
+     * Skips the missing sequence numbers before the oldest held result if
+     * the gap has waited max_wait or capacity results are held.
+     * @param now Current time
+     * @return Result, or std::nullopt if it has not arrived (and the gap
+     *         is not given up yet)
+     */
+    std::optional<T> pop(Clock::time_point now = Clock::now())
+    {
+        auto it = pending_.begin();
+        if (it == pending_.end()) {
+            return std::nullopt;
+        }
+        if (it->first != next_) {
+            if (!blocked_since_) {
+                blocked_since_ = now;
+            }
+            const bool timed_out = max_wait_ != Clock::duration::max() && now - *blocked_since_ >= max_wait_;
+            if (!timed_out && pending_.size() < capacity_) {
+                return std::nullopt;
+            }
+            skipped_ += it->first - next_;
+            next_ = it->first;
+        }
+        return release(it);
+    }
+
+    /**
+     * Take the oldest held result, skipping any gap before it (shutdown)
+     * @return Result, or std::nullopt if nothing is held
+     */
+    std::optional<T> popAny()
+    {
+        auto it = pending_.begin();
+        if (it == pending_.end()) {
+            return std::nullopt;
+        }
+        skipped_ += it->first - next_;
+        next_ = it->first;
+        return release(it);
+    }
+
+    /**
+     * Time at which the current gap will be skipped
+     * @return Deadline, or std::nullopt if output is not blocked by a gap
+     *         (or there is no max_wait)
+     */
+    std::optional<Clock::time_point> nextDeadline() const
+    {
+        if (!blocked_since_ || max_wait_ == Clock::duration::max()) {
+            return std::nullopt;
+        }
+        return *blocked_since_ + max_wait_;
+    }
+
+    /**
+     * Drop everything held and restart at `first` (counters are kept)
+     */
+    void reset(uint64_t first = 0)
+    {
+        pending_.clear();
+        blocked_since_.reset();
+        next_ = first;
+    }
+
+    /**
+     * Get the sequence number released next
+     */
+    uint64_t next() const { return next_; }
+
+    /**
+     * Get the number of results held back
+     */
+    size_t size() const { return pending_.size(); }
+
+    /**
+     * Get the number of sequence numbers given up on
+     */
+    uint64_t getSkipped() const { return skipped_; }
+
+    /**
+     * Get the number of results that arrived after their slot was gone
+     */
+    uint64_t getLate() const { return late_; }
+
+private:
+    std::optional<T> release(typename std::map<uint64_t, T>::iterator it)
+    {
+        std::optional<T> value(std::move(it->second));
+        pending_.erase(it);
+        next_++;
+        blocked_since_.reset();
+        return value;
+    }
+
+    std::map<uint64_t, T> pending_;
+    size_t capacity_;
+    Clock::duration max_wait_;
+    uint64_t next_;
+    std::optional<Clock::time_point> blocked_since_;   // Output blocked by a gap since
+    uint64_t skipped_;
+    uint64_t late_;
+};
+
+} // namespace converter
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "shm_ring.hpp"
+#include "event_soa.hpp"
+#include <string>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Shared Memory Reader class (Linux only)
+ *
+ * Consumer side of the converter's shared-memory event output. Maps the
+ * ring created by SharedMemoryWriter and hands out zero-copy views of
+ * event packets. Has no dependency on dv-processing, so it can be linked
+ * into any local consumer.
+ *
+ * Usage:
+ *   converter::SharedMemoryReader reader("/dvbridge_events");
+ *   reader.open();
+ *   converter::SharedMemoryReader::Packet packet;
+ *   while (reader.next(packet, 100) != converter::SharedMemoryReader::Status::Closed) {
+ *       // ... use packet.events[0 .. packet.count) ...
+ *       // (or packet.x / y / polarity if reader.isSoA())
+ *       if (!reader.isValid(packet)) { discard results, writer lapped us }
+ *   }
+ *
+ * The writer never waits for readers. A reader that falls more than
+ * slot_count packets behind skips ahead and counts the lost packets.
+ */
+class SharedMemoryReader {
+public:
+    /**
+     * Zero-copy view of one packet inside the ring
+     */
+    struct Packet {
+        const shm::PackedEvent* events = nullptr;   // kLayoutEvents rings
+
+        // kLayoutSoA rings: all events share `timestamp`,
+        // polarity of event i is polarityAt(polarity, i)
+        const int16_t* x = nullptr;
+        const int16_t* y = nullptr;
+        const uint64_t* polarity = nullptr;
+
+        uint32_t count = 0;
+        uint32_t flags = 0;             // shm::kFlagContinued if the frame continues
+        uint64_t frame_number = 0;
+        int64_t timestamp = 0;          // Frame timestamp (us)
+        uint64_t index = 0;             // Packet index in the stream
+    };
+
+    enum class Status {
+        Ok,         // Packet filled in
+        Timeout,    // Nothing published within timeout
+        Closed      // Writer shut down (or ring not open)
+    };
+
+    /**
+     * Constructor
+     * @param name Shared memory object name (Config::shm_name on the writer)
+     */
+    explicit SharedMemoryReader(std::string name);
+
+    /**
+     * Destructor - unmaps the ring
+     */
+    ~SharedMemoryReader();
+
+    // Disable copy
+    SharedMemoryReader(const SharedMemoryReader&) = delete;
+    SharedMemoryReader& operator=(const SharedMemoryReader&) = delete;
+
+    /**
+     * Map the ring and start reading at the newest packet
+     * @return true if the writer's ring was found and mapped
+     */
+    bool open();
+
+    /**
+     * Unmap the ring
+     */
+    void close();
+
+    /**
+     * Check if the ring is mapped
+     * @return true if open
+     */
+    bool isOpen() const { return region_ != nullptr; }
+
+    /**
+     * Get the next packet, waiting up to timeout_ms (futex, no spinning)
+     * @param packet Output view (valid until the writer laps this slot)
+     * @param timeout_ms Maximum wait in milliseconds (negative = forever)
+     * @return Read status
+     */
+    Status next(Packet& packet, int timeout_ms);
+
+    /**
+     * Check that a packet returned by next() was not overwritten while in use
+     * Call after consuming packet.events; if false, discard what was read.
+     * @param packet Packet previously returned by next()
+     * @return true if the events were stable for the whole read
+     */
+    bool isValid(const Packet& packet) const;
+
+    /**
+     * Get number of packets skipped because this reader fell behind
+     * @return Overrun packet count
+     */
+    uint64_t getOverrunPackets() const { return overrun_packets_; }
+
+    /**
+     * Get sensor width published by the writer
+     */
+    int getWidth() const { return region_ ? region_->width : 0; }
+
+    /**
+     * Get sensor height published by the writer
+     */
+    int getHeight() const { return region_ ? region_->height : 0; }
+
+    /**
+     * Check if the writer publishes structure-of-arrays slots (shm_soa)
+     * @return true for the SoA layout, false for PackedEvent records
+     */
+    bool isSoA() const { return region_ && region_->layout == shm::kLayoutSoA; }
+
+private:
+    std::string name_;
+    int fd_;
+    const shm::RingHeader* region_;     // Whole ring, read-only
+    shm::RingHeader* control_;          // First page, read-write (waiter count)
+    size_t mapped_size_;
+    size_t control_size_;
+    uint64_t read_index_;
+    uint64_t overrun_packets_;
+};
+
+} // namespace converter
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace converter {
+namespace shm {
+
+/**
+ * Shared-memory event ring layout
+ *
+ * Shared between SharedMemoryWriter (converter side) and SharedMemoryReader
+ * (consumer side). Everything here lives inside one POSIX shared memory
+ * object and must stay trivially mappable across processes:
+ *
+ *   [RingHeader][Slot 0][Slot 1]...[Slot N-1]
+ *
+ *   Slot = [SlotHeader][PackedEvent x slot_capacity]            (kLayoutEvents)
+ *   Slot = [SlotHeader][int16 x[cap]][int16 y[cap]][uint64 polarity[cap/64]]
+ *                                                               (kLayoutSoA)
+ *
+ * In the SoA layout slot_capacity is a multiple of 64, so every array
+ * starts on a cache line and polarity bits of a packet start at bit 0.
+ * All events of a packet share the slot timestamp.
+ *
+ * Protocol (single writer, any number of readers):
+ *   - Packet n is written into slot (n % slot_count)
+ *   - Writer sets slot.sequence = 2n+1 (writing), copies events,
+ *     then sets slot.sequence = 2n+2 (complete) and bumps write_index
+ *   - Readers never block the writer. A reader that falls more than
+ *     slot_count packets behind is overrun and skips ahead
+ *   - Readers validate slot.sequence before AND after reading the events
+ *     (seqlock). If it changed, the writer lapped them mid-read
+ *   - Wakeups use a futex on wake_counter; the writer only issues the
+ *     wake syscall when waiter_count > 0
+ */
+
+constexpr uint32_t kMagic = 0x52425644;   // "DVBR" little-endian
+constexpr uint32_t kVersion = 2;
+constexpr size_t kCacheLine = 64;
+
+// Packet flag: events of this frame continue in the next packet
+constexpr uint32_t kFlagContinued = 1u << 0;
+
+// Slot layouts (RingHeader::layout)
+constexpr uint32_t kLayoutEvents = 0;   // PackedEvent records
+constexpr uint32_t kLayoutSoA = 1;      // Separate x / y / bit-packed polarity arrays
+
+/**
+ * One event as stored in shared memory
+ * Layout-compatible with dv::Event (16 bytes, 8-byte aligned) so the
+ * writer can copy dv::EventStore contents without conversion.
+ */
+struct PackedEvent {
+    int64_t timestamp;      // Microseconds
+    int16_t x;
+    int16_t y;
+    uint8_t polarity;       // 1 = positive, 0 = negative
+    uint8_t reserved[3];
+};
+static_assert(sizeof(PackedEvent) == 16, "PackedEvent must be 16 bytes");
+
+struct alignas(kCacheLine) RingHeader {
+    // Immutable after creation
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_capacity;     // Events per slot
+    uint64_t slot_stride;       // Bytes per slot (header + events)
+    int32_t width;
+    int32_t height;
+    uint32_t layout;            // kLayoutEvents or kLayoutSoA
+    uint32_t reserved;
+
+    // Writer-owned, own cache line so readers polling it don't share with
+    // the immutable fields above
+    alignas(kCacheLine) std::atomic<uint64_t> write_index;  // Packets published
+
+    // Futex word (must be 32-bit) and waiter count
+    alignas(kCacheLine) std::atomic<uint32_t> wake_counter;
+    std::atomic<uint32_t> waiter_count;
+};
+
+struct alignas(kCacheLine) SlotHeader {
+    std::atomic<uint64_t> sequence;     // 2n+1 = writing packet n, 2n+2 = packet n complete
+    uint64_t frame_number;
+    int64_t timestamp;                  // Frame timestamp (us)
+    uint32_t event_count;
+    uint32_t flags;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory ring requires lock-free 64-bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "shared-memory ring requires lock-free 32-bit atomics");
+
+/**
+ * Bytes of event data in one slot with the given capacity and layout
+ */
+inline uint64_t slotPayload(uint32_t slot_capacity, uint32_t layout) {
+    if (layout == kLayoutSoA) {
+        return static_cast<uint64_t>(slot_capacity) * 2 * sizeof(int16_t)
+             + (static_cast<uint64_t>(slot_capacity) + 63) / 64 * sizeof(uint64_t);
+    }
+    return static_cast<uint64_t>(slot_capacity) * sizeof(PackedEvent);
+}
+
+/**
+ * Bytes needed for one slot with the given event capacity
+ */
+inline uint64_t slotStride(uint32_t slot_capacity, uint32_t layout = kLayoutEvents) {
+    uint64_t bytes = sizeof(SlotHeader) + slotPayload(slot_capacity, layout);
+    return (bytes + kCacheLine - 1) & ~static_cast<uint64_t>(kCacheLine - 1);
+}
+
+/**
+ * Total size of the shared memory object
+ */
+inline uint64_t regionSize(uint32_t slot_count, uint32_t slot_capacity, uint32_t layout = kLayoutEvents) {
+    return sizeof(RingHeader) + static_cast<uint64_t>(slot_count) * slotStride(slot_capacity, layout);
+}
+
+inline SlotHeader* slotAt(RingHeader* header, uint64_t packet_index) {
+    auto* base = reinterpret_cast<uint8_t*>(header) + sizeof(RingHeader);
+    return reinterpret_cast<SlotHeader*>(base + (packet_index % header->slot_count) * header->slot_stride);
+}
+
+inline const SlotHeader* slotAt(const RingHeader* header, uint64_t packet_index) {
+    auto* base = reinterpret_cast<const uint8_t*>(header) + sizeof(RingHeader);
+    return reinterpret_cast<const SlotHeader*>(base + (packet_index % header->slot_count) * header->slot_stride);
+}
+
+inline PackedEvent* slotEvents(SlotHeader* slot) {
+    return reinterpret_cast<PackedEvent*>(slot + 1);
+}
+
+inline const PackedEvent* slotEvents(const SlotHeader* slot) {
+    return reinterpret_cast<const PackedEvent*>(slot + 1);
+}
+
+// SoA layout arrays; capacity is RingHeader::slot_capacity
+inline int16_t* slotX(SlotHeader* slot) {
+    return reinterpret_cast<int16_t*>(slot + 1);
+}
+
+inline const int16_t* slotX(const SlotHeader* slot) {
+    return reinterpret_cast<const int16_t*>(slot + 1);
+}
+
+inline int16_t* slotY(SlotHeader* slot, uint32_t capacity) {
+    return slotX(slot) + capacity;
+}
+
+inline const int16_t* slotY(const SlotHeader* slot, uint32_t capacity) {
+    return slotX(slot) + capacity;
+}
+
+inline uint64_t* slotPolarity(SlotHeader* slot, uint32_t capacity) {
+    return reinterpret_cast<uint64_t*>(slotY(slot, capacity) + capacity);
+}
+
+inline const uint64_t* slotPolarity(const SlotHeader* slot, uint32_t capacity) {
+    return reinterpret_cast<const uint64_t*>(slotY(slot, capacity) + capacity);
+}
+
+/**
+ * Block until *word != expected, a wake arrives or the timeout expires.
+ * Not FUTEX_PRIVATE: writer and readers live in different processes.
+ */
+inline void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected,
+            timeout_ms >= 0 ? &ts : nullptr, nullptr, 0);
+}
+
+inline void futexWakeAll(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace shm
+} // namespace converter
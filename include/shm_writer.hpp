@@ -0,0 +1,124 @@
+#pragma once
+
+#include "config.hpp"
+#include "shm_ring.hpp"
+#include "event_soa.hpp"
+#include "metrics.hpp"
+#include <dv-processing/core/event.hpp>
+#include <string>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Shared Memory Writer class (Linux only)
+ *
+ * Publishes unpacked events into a POSIX shared memory ring so consumers
+ * on the same host can map them directly, skipping the loopback TCP hop
+ * and the AEDAT4 encode/decode of NetworkWriter.
+ *
+ * Slots hold either PackedEvent records or, with shm_soa, separate
+ * x / y / polarity arrays. Both write functions accept either input and
+ * convert to the ring's layout as they copy.
+ *
+ * Single writer: only the converter main loop may call writeEvents() /
+ * writeFrame().
+ * See shm_ring.hpp for the memory layout and reader protocol, and
+ * SharedMemoryReader for the consumer side.
+ */
+class SharedMemoryWriter {
+public:
+    /**
+     * Constructor
+     * @param cfg Configuration reference (shm_name, shm_slot_count, shm_slot_events, shm_soa)
+     */
+    explicit SharedMemoryWriter(const Config& cfg);
+
+    /**
+     * Destructor - unmaps and unlinks the shared memory object
+     */
+    ~SharedMemoryWriter();
+
+    // Disable copy
+    SharedMemoryWriter(const SharedMemoryWriter&) = delete;
+    SharedMemoryWriter& operator=(const SharedMemoryWriter&) = delete;
+
+    /**
+     * Create (or recreate) the shared memory object and initialize the ring
+     * @return true if the ring is ready for writing
+     */
+    bool open();
+
+    /**
+     * Unmap and unlink the shared memory object
+     */
+    void close();
+
+    /**
+     * Check if the ring is mapped
+     * @return true if open
+     */
+    bool isOpen() const { return header_ != nullptr; }
+
+    /**
+     * Publish one frame worth of events
+     *
+     * Frames larger than one slot are split over consecutive packets;
+     * all but the last carry shm::kFlagContinued.
+     *
+     * @param events Events to publish
+     * @param frame_number Frame sequence number
+     * @param timestamp Frame timestamp in microseconds
+     * @return Number of packets published
+     */
+    size_t writeEvents(const dv::EventStore& events, uint64_t frame_number, int64_t timestamp);
+
+    /**
+     * Publish one frame from structure-of-arrays form
+     * Split over packets like writeEvents(); in the SoA layout this is a
+     * plain copy of each array.
+     *
+     * @param frame Frame from FrameUnpacker::unpackSoA()
+     * @return Number of packets published
+     */
+    size_t writeFrame(const EventFrameSoA& frame);
+
+    /**
+     * Get total packets published since open()
+     * @return Packet count
+     */
+    uint64_t getPacketsWritten() const { return next_packet_; }
+
+private:
+    /**
+     * Mark the slot for next_packet_ as being written
+     * @return Slot header
+     */
+    shm::SlotHeader* beginPacket();
+
+    /**
+     * Complete the current packet and wake waiting readers
+     */
+    void commitPacket(shm::SlotHeader* slot, uint32_t count, uint64_t frame_number,
+                      int64_t timestamp, uint32_t flags);
+
+    /**
+     * Split `total` events into packets; fill(slot, first, n) copies events
+     * [first, first + n) into the slot in the ring's layout
+     */
+    template <typename Fill>
+    size_t publish(size_t total, uint64_t frame_number, int64_t timestamp, Fill&& fill);
+
+    const Config& config_;
+    std::string name_;
+    int fd_;
+    shm::RingHeader* header_;
+    size_t mapped_size_;
+    uint64_t next_packet_;
+
+    // Registry metrics shm_packets / shm_events
+    Counter packets_written_;
+    Counter events_written_;
+};
+
+} // namespace converter
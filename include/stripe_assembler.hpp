@@ -0,0 +1,119 @@
+#pragma once
+
+#include "metrics.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace converter {
+
+/**
+ * Puts frames striped across several TCP connections back in order
+ * (tcp_connections > 1)
+ *
+ * The camera sends each frame whole on one of K connections, each with a
+ * v1 header whose counter is the frame id. One reader thread per
+ * connection push()es frames as they complete; the receive thread pop()s
+ * them in counter order.
+ *
+ * Every connection carries increasing counters, so a missing counter is
+ * known to be lost (not just late) once every open connection has
+ * delivered a later one; it is then skipped and counted in rx_frames_lost
+ * without waiting. A connection that goes quiet only holds output up for
+ * max_wait. At most `capacity` frames are held; readers block beyond
+ * that, which pushes back on the camera through TCP flow control.
+ *
+ * The sequence starts at the frame with the CounterReset flag; without
+ * one, at the first frame pushed or up to K-1 frames before it (other
+ * connections may still deliver those). Counters skipped before the first
+ * frame is handed out are not counted as lost.
+ */
+class StripeAssembler {
+public:
+    /**
+     * A complete frame from one connection
+     */
+    struct Frame {
+        uint32_t counter = 0;
+        bool counter_reset = false;
+        int64_t timestamp = -1;                 // Camera clock (us)
+        std::optional<uint32_t> crc;            // CRC32C trailer, if sent
+        std::vector<uint8_t> data;              // Payload
+    };
+
+    /**
+     * Constructor
+     * @param connections Number of connections (K)
+     * @param capacity Frames held before readers block
+     * @param max_wait Time a gap may hold up output while a connection is quiet
+     * @param frames_lost Counter for skipped counters (rx_frames_lost)
+     */
+    StripeAssembler(size_t connections, size_t capacity, std::chrono::milliseconds max_wait, Counter frames_lost);
+
+    /**
+     * Get a payload buffer for a reader (recycled from popped frames)
+     */
+    std::vector<uint8_t> takeBuffer();
+
+    /**
+     * Add a frame received on `connection` (reader threads)
+     * Blocks while `capacity` frames are held.
+     * @return false once the assembler is closed (the reader should exit)
+     */
+    bool push(size_t connection, Frame frame);
+
+    /**
+     * Mark a connection ended (reader exit): its gaps no longer hold up
+     * output, and pop() fails once the frames in order are out
+     */
+    void closeConnection(size_t connection);
+
+    /**
+     * Take the next frame in counter order (receive thread)
+     * @param frame Output; its previous payload buffer is recycled
+     * @return false once a connection has ended and everything before the
+     *         end was handed out, or after close()
+     */
+    bool pop(Frame& frame);
+
+    /**
+     * Wake and fail pop() and push() (shutdown)
+     */
+    void close();
+
+private:
+    /**
+     * Sequence number of a counter, unwrapped around next_ (lock held)
+     */
+    uint64_t sequence(uint32_t counter) const;
+
+    /**
+     * Check if the sequence number next_ can still arrive (lock held)
+     */
+    bool mayArrive() const;
+
+    const size_t capacity_;
+    const std::chrono::milliseconds max_wait_;
+    Counter frames_lost_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;      // A frame arrived / connection ended
+    std::condition_variable space_cv_;      // A frame was popped
+    std::map<uint64_t, Frame> pending_;
+    std::vector<std::optional<uint64_t>> last_;     // Last sequence per connection
+    std::vector<bool> open_;
+    std::vector<std::vector<uint8_t>> free_buffers_;
+    uint64_t next_;
+    bool started_;
+    bool released_;                         // pop() handed out a frame
+    bool ended_;                            // Some connection ended
+    bool closed_;
+};
+
+} // namespace converter
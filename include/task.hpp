@@ -0,0 +1,153 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace converter {
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+/**
+ * Resumes whoever awaited the task once it finishes (symmetric transfer,
+ * so long await chains do not grow the stack)
+ */
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+    {
+        if (auto continuation = h.promise().continuation) {
+            return continuation;
+        }
+        return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+    void return_value(T v) { value = std::move(v); }
+
+    T result()
+    {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+
+    void result()
+    {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * Lazily started coroutine returning T
+ *
+ *   Task<bool> receive(EventLoop& loop) { co_await loop.readable(fd); ... co_return true; }
+ *   bool ok = co_await receive(loop);
+ *
+ * Nothing runs until the task is awaited (or handed to EventLoop::spawn);
+ * the awaiting coroutine resumes when it completes. Exceptions propagate
+ * to the awaiter. The Task object owns the coroutine frame.
+ */
+template <typename T = void>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+    explicit Task(Handle h) noexcept : handle_(h) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+
+    // Awaiting starts the task and suspends the caller until it finishes
+    bool await_ready() const noexcept { return done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+    {
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+
+    T await_resume() { return handle_.promise().result(); }
+
+    /**
+     * Underlying coroutine (used by EventLoop::spawn)
+     */
+    Handle handle() const noexcept { return handle_; }
+
+private:
+    Handle handle_ = nullptr;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+} // namespace converter
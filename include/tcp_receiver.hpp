@@ -1,8 +1,17 @@
 #pragma once
 
 #include "config.hpp"
+#include "metrics.hpp"
+#include "frame_header.hpp"
+#include "stripe_assembler.hpp"
+#include "tcp_zerocopy.hpp"
+#ifdef __linux__
+    #include "event_loop.hpp"
+#endif
 #include <vector>
 #include <string>
+#include <memory>
+#include <thread>
 #include <cstdint>
 #include <stdexcept>
 
@@ -32,7 +41,20 @@ namespace converter {
  * 
  * Listens for incoming TCP connections from the FPGA/camera.
  * The FPGA acts as client and connects to this server.
- * Handles partial reads and optional frame headers.
+ * Handles partial reads and optional frame headers (length only, or
+ * versioned with counter and camera timestamp, see frame_header.hpp).
+ *
+ * With tcp_connections = K > 1 the camera stripes frames across K
+ * connections to the same port. connect() accepts all K and starts a
+ * reader thread per connection; receiveFrame() hands out their frames in
+ * header counter order (StripeAssembler). Each connection's bytes and
+ * frames are counted as rx_conn<i>_bytes / rx_conn<i>_frames.
+ *
+ * With tcp_zerocopy the connection's received pages are mapped instead of
+ * copied (TcpZeroCopy); receiveFrameInPlace() then hands out a payload
+ * that was mapped whole without copying it (rx_zerocopy_frames). A
+ * payload handler reads the buffer, so with one set the payload is always
+ * copied there.
  */
 class TcpReceiver {
 public:
@@ -65,6 +87,13 @@ public:
      * Disconnect and close sockets
      */
     void disconnect();
+
+    /**
+     * Wake a connect() or receiveFrame() blocked in another thread
+     * Shuts the sockets down without closing them; the blocked call then
+     * fails and the owning thread calls disconnect() as usual.
+     */
+    void interrupt();
     
     /**
      * Check if a client is connected
@@ -78,24 +107,76 @@ public:
      * @return true if frame received successfully, false on error/disconnect
      */
     bool receiveFrame(std::vector<uint8_t>& buffer);
+
+    /**
+     * Receive one complete frame, leaving the payload in mapped socket
+     * pages when possible (tcp_zerocopy); otherwise like receiveFrame()
+     * @param buffer Holds the payload if it was copied
+     * @param payload Output: the payload, in buffer or in mapped pages;
+     *                valid until the next receive
+     * @param size Output: payload bytes
+     * @return true if frame received successfully, false on error/disconnect
+     */
+    bool receiveFrameInPlace(std::vector<uint8_t>& buffer, const uint8_t*& payload, size_t& size);
+
+#ifdef __linux__
+    /**
+     * connect() for an EventLoop task: listens, then awaits the FPGA's
+     * connection instead of blocking in accept(). The connection is
+     * non-blocking; receive from it with receiveFrameAsync().
+     * @param loop Event loop the calling task runs on
+     * @return true if connection accepted successfully
+     */
+    Task<bool> connectAsync(EventLoop& loop);
+
+    /**
+     * receiveFrame() for an EventLoop task: awaits socket readiness
+     * instead of blocking in recv()
+     * @param loop Event loop the calling task runs on
+     * @param buffer Output buffer (will be resized to frame size)
+     * @return true if frame received successfully, false on error/disconnect
+     */
+    Task<bool> receiveFrameAsync(EventLoop& loop, std::vector<uint8_t>& buffer);
+#endif
     
     /**
      * Get the expected frame size (without header)
      * @return Frame size in bytes
      */
     int getFrameSize() const;
+
+    /**
+     * Camera timestamp (us) of the last frame received, -1 without
+     * versioned headers (header_format = v1)
+     */
+    int64_t getFrameTimestamp() const { return assembler_ ? striped_frame_.timestamp : header_.timestamp(); }
+
+    /**
+     * CRC32C sent with the last frame (v1 header with FrameFlags::Crc32c)
+     */
+    std::optional<uint32_t> getFrameCrc() const { return assembler_ ? striped_frame_.crc : header_.crc(); }
+
+    /**
+     * Report payload progress while a frame arrives (cut-through decode,
+     * stream_rows): the handler runs on the receiving thread (or loop)
+     * after every chunk_bytes of payload and at its end, before the CRC
+     * trailer is read
+     * @param chunk_bytes Payload bytes between calls
+     * @param handler nullptr to receive whole frames again
+     */
+    void setPayloadHandler(size_t chunk_bytes, PayloadHandler handler);
     
     /**
      * Get total bytes received
-     * @return Total bytes received since connection
+     * @return Total bytes received (all connections, see metrics.hpp)
      */
-    uint64_t getTotalBytesReceived() const { return total_bytes_received_; }
+    uint64_t getTotalBytesReceived() const { return bytes_received_.value(); }
     
     /**
      * Get total frames received
-     * @return Total frames received since connection
+     * @return Total frames received (all connections, see metrics.hpp)
      */
-    uint64_t getTotalFramesReceived() const { return total_frames_received_; }
+    uint64_t getTotalFramesReceived() const { return frames_received_.value(); }
 
 private:
     /**
@@ -105,7 +186,73 @@ private:
      * @return true if all bytes received, false on error
      */
     bool receiveExact(uint8_t* buffer, size_t size);
-    
+
+#ifdef __linux__
+    /**
+     * receiveExact() on a non-blocking socket
+     */
+    Task<bool> receiveExactAsync(EventLoop& loop, uint8_t* buffer, size_t size);
+#endif
+
+    /**
+     * Receive `size` bytes through the zero-copy window (tcp_zerocopy)
+     * @param copy Storage for bytes that were not mapped as one run
+     * @param data Output: the bytes, mapped or in `copy`
+     * @param expected Bytes expected to follow in total (a header and its
+     *                 payload), waited for before mapping
+     */
+    bool receiveMapped(uint8_t* copy, size_t size, const uint8_t*& data, size_t expected = 0);
+
+    /**
+     * receiveExact(), through the zero-copy window if there is one
+     */
+    bool receiveBytes(uint8_t* buffer, size_t size, size_t expected = 0);
+
+    /**
+     * Count a complete frame
+     */
+    void frameReceived(size_t frame_size);
+
+    /**
+     * Create the listening socket (bind + listen on camera_port)
+     * @return true on success
+     */
+    bool listenSocket();
+
+    /**
+     * Configure an accepted FPGA connection and mark it connected
+     */
+    void setupClient(const struct sockaddr_in& client_addr);
+
+    /**
+     * Log an accepted connection and set its socket options
+     */
+    void configureSocket(socket_t socket, const struct sockaddr_in& client_addr);
+
+    /**
+     * Accept the tcp_connections connections of a striped stream and
+     * start their reader threads
+     * @return true once all are connected
+     */
+    bool acceptStripes();
+
+    /**
+     * One connection of a striped stream (tcp_connections > 1)
+     */
+    struct Stripe {
+        socket_t socket = INVALID_SOCK;
+        std::thread thread;
+        Counter bytes;      // rx_conn<i>_bytes
+        Counter frames;     // rx_conn<i>_frames
+    };
+
+    /**
+     * Reader thread of one striped connection: frames into the assembler
+     * until the connection fails or the assembler is closed
+     */
+    static void readStripe(const Config& cfg, Stripe& stripe, size_t index, StripeAssembler& assembler,
+                           Counter total_bytes);
+
     /**
      * Initialize socket library (Windows only)
      */
@@ -120,9 +267,23 @@ private:
     socket_t server_socket_;   // Listening socket
     socket_t client_socket_;   // Connected client (FPGA)
     bool connected_;
+    FrameHeaderParser header_;  // Per connection (counter continuity)
+    PayloadHandler payload_handler_;
+    size_t payload_chunk_;
+
+    // Striped stream (tcp_connections > 1); empty otherwise
+    std::vector<std::unique_ptr<Stripe>> stripes_;
+    std::unique_ptr<StripeAssembler> assembler_;
+    StripeAssembler::Frame striped_frame_;     // Last frame handed out
+
+    // Zero-copy receive (tcp_zerocopy); null if off or unsupported
+    std::unique_ptr<TcpZeroCopy> zerocopy_;
+    Counter zerocopy_bytes_;    // rx_zerocopy_bytes
+    Counter zerocopy_frames_;   // rx_zerocopy_frames
     
-    uint64_t total_bytes_received_;
-    uint64_t total_frames_received_;
+    // Registry metrics rx_bytes / rx_frames (readable from any thread)
+    Counter bytes_received_;
+    Counter frames_received_;
     
     static bool socket_lib_initialized_;
 };
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Zero-copy TCP receive (tcp_zerocopy, Linux)
+ *
+ * Maps received payload pages of a TCP socket into a read-only window
+ * with getsockopt(TCP_ZEROCOPY_RECEIVE) instead of copying them in
+ * recv(). Only whole pages whose data the NIC (or loopback) placed page
+ * aligned can be mapped; the kernel reports the bytes before the next
+ * mappable page as a skip hint, which the caller reads with recv() as
+ * usual. The stream order is: mapped bytes of the last map(), then the
+ * skip hint, then the next map().
+ *
+ * The window is a ring of three times the bytes one map() maps at most.
+ * Each map() places its pages right after the previous ones, so a frame
+ * that arrived over several map() calls with no skip hint in between is
+ * one contiguous run of memory (the kernel can only map the last, partial
+ * page of a frame once the next frame fills it). Bytes taken within the
+ * last map_bytes stay mapped until the ring comes round again.
+ *
+ *   while (want > 0) {
+ *       if (size_t n = zc.take(want, data)) { ... use data, want -= n ... }
+ *       else if (size_t n = min(zc.skipHint(), want)) { recv(n); zc.skipped(n); ... }
+ *       else if (!zc.map(want)) { ... recv() the rest, reports the error ... }
+ *   }
+ */
+class TcpZeroCopy {
+public:
+    /**
+     * Constructor
+     * @param map_bytes Bytes mapped per map() at most (rounded up to pages)
+     */
+    explicit TcpZeroCopy(size_t map_bytes);
+
+    /**
+     * Destructor - unmaps the window
+     */
+    ~TcpZeroCopy();
+
+    TcpZeroCopy(const TcpZeroCopy&) = delete;
+    TcpZeroCopy& operator=(const TcpZeroCopy&) = delete;
+
+    /**
+     * Map the window over a connected TCP socket
+     * @return false if the kernel does not support it (recv() only)
+     */
+    bool attach(int socket);
+
+    /**
+     * Unmap the window (connection closed)
+     */
+    void detach();
+
+    /**
+     * Check if a socket is attached
+     */
+    bool isAttached() const { return window_ != nullptr; }
+
+    /**
+     * Take up to `max` mapped bytes in stream order
+     * @param data Output: the bytes; they follow the last bytes taken in
+     *             memory unless a skip hint or the ring's end came between
+     * @return Bytes taken (0 if everything mapped was taken)
+     */
+    size_t take(size_t max, const uint8_t*& data);
+
+    /**
+     * Bytes to read with recv() before the next map()
+     */
+    size_t skipHint() const { return skip_; }
+
+    /**
+     * Account for `bytes` of the skip hint read with recv()
+     */
+    void skipped(size_t bytes) { skip_ -= bytes < skip_ ? bytes : skip_; }
+
+    /**
+     * Map the next received pages
+     * Waits until `want` bytes are queued (SO_RCVLOWAT), so that what the
+     * caller needs next is mapped as one run rather than as far as it had
+     * arrived. Call only once take() returns 0 and skipHint() is 0.
+     * @param want Bytes the caller will read next (at least 1)
+     * @return false on a socket error or end of stream (recv() reports it)
+     */
+    bool map(size_t want);
+
+private:
+    static constexpr size_t kRingMaps = 3;
+
+    int socket_;
+    size_t map_bytes_;          // Bytes per map() at most (page multiple)
+    uint8_t* window_;           // kRingMaps * map_bytes_ bytes, PROT_READ
+    size_t next_;               // Window offset of the next map()
+    const uint8_t* mapped_;     // Untaken mapped bytes
+    size_t mapped_size_;
+    size_t skip_;
+    size_t low_water_;          // SO_RCVLOWAT set on the socket (0 = default)
+};
+
+} // namespace converter
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+
+namespace converter {
+
+/**
+ * Per-thread slots: each thread claims one on first use and gives it back
+ * at exit, so the next thread reuses it instead of growing the set
+ *
+ * Owners write their slot without locks; readers walk slots [0, count()).
+ * Slots are created on demand and deleted with the set. T needs a
+ * `std::atomic<bool> in_use` member.
+ *
+ *   ThreadSlots<Shard, 128> shards_;
+ *
+ *   static thread_local ThreadSlotLease<Shard> lease;
+ *   Shard* shard = lease.get([&]() { return shards_.claim([]() { return new Shard(); }); });
+ */
+template <typename T, size_t N>
+class ThreadSlots {
+public:
+    ThreadSlots()
+        : count_(0)
+    {
+        for (auto& slot : slots_) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadSlots()
+    {
+        for (auto& slot : slots_) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Disable copy
+    ThreadSlots(const ThreadSlots&) = delete;
+    ThreadSlots& operator=(const ThreadSlots&) = delete;
+
+    /**
+     * Get number of slots created so far (none of them null)
+     */
+    size_t count() const { return count_.load(std::memory_order_acquire); }
+
+    const T& operator[](size_t index) const { return *slots_[index].load(std::memory_order_acquire); }
+
+    /**
+     * Claim a slot no thread holds, or a new one from make() if all are
+     * taken
+     * @return nullptr once all N slots are held
+     */
+    template <typename Make>
+    T* claim(Make&& make)
+    {
+        // Reuse the slot of a thread that has exited
+        const size_t n = count();
+        for (size_t i = 0; i < n; i++) {
+            T* slot = slots_[i].load(std::memory_order_acquire);
+            bool expected = false;
+            if (slot->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t index = count_.load(std::memory_order_relaxed);
+        if (index >= N) {
+            return nullptr;
+        }
+        T* slot = make();
+        slot->in_use.store(true, std::memory_order_relaxed);
+        slots_[index].store(slot, std::memory_order_release);
+        count_.store(index + 1, std::memory_order_release);
+        return slot;
+    }
+
+private:
+    std::mutex mutex_;                  // Slot creation only
+    std::array<std::atomic<T*>, N> slots_;
+    std::atomic<size_t> count_;         // Published with release after the slot is stored
+};
+
+/**
+ * The calling thread's claim on a ThreadSlots slot, given back at thread
+ * exit (declare thread_local)
+ */
+template <typename T>
+class ThreadSlotLease {
+public:
+    ThreadSlotLease() = default;
+
+    ~ThreadSlotLease()
+    {
+        if (owned_) {
+            slot_->in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    // Disable copy
+    ThreadSlotLease(const ThreadSlotLease&) = delete;
+    ThreadSlotLease& operator=(const ThreadSlotLease&) = delete;
+
+    /**
+     * Slot of the calling thread, from claim() on the first call
+     * @param claim Returns a slot marked in_use, or nullptr
+     * @param fallback Returned from then on if claim() found none (not
+     *                 released at exit)
+     */
+    template <typename Claim>
+    T* get(Claim&& claim, T* fallback = nullptr)
+    {
+        if (!claimed_) {
+            claimed_ = true;
+            slot_ = claim();
+            owned_ = slot_ != nullptr;
+            if (!owned_) {
+                slot_ = fallback;
+            }
+        }
+        return slot_;
+    }
+
+private:
+    T* slot_ = nullptr;
+    bool claimed_ = false;
+    bool owned_ = false;
+};
+
+} // namespace converter
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Event counts per 32x32 pixel tile of one frame
+ *
+ * Tiles are numbered row-major: tile = (y / 32) * tiles_x + x / 32. The
+ * last tile column / row is narrower when width / height are not
+ * multiples of 32.
+ */
+struct TileActivity {
+    static constexpr int kTileSize = 32;
+
+    int tiles_x = 0;
+    int tiles_y = 0;
+    std::vector<uint32_t> counts;   // tiles_x * tiles_y
+    size_t total = 0;               // Sum of counts (events in the frame)
+
+    /**
+     * Number of tiles with at least `threshold` events
+     */
+    size_t active(uint32_t threshold = 1) const;
+};
+
+/**
+ * Byte range [begin, end) of a packed frame
+ */
+struct ByteRange {
+    size_t begin;
+    size_t end;
+};
+
+/**
+ * Tiles a consumer wants decoded (see Pipeline::subscribeTiles)
+ *
+ * active_only selects, per frame, the tiles with at least
+ * tile_active_threshold events; `tiles` lists fixed tile indices. Both
+ * may be combined. A selection with neither means the whole frame.
+ */
+struct TileSelection {
+    bool active_only = false;
+    std::vector<uint32_t> tiles;
+
+    bool all() const { return !active_only && tiles.empty(); }
+};
+
+/**
+ * Parse a tile selection: "active", a comma-separated list of tile
+ * indices and ranges ("0,5-9,40"), or both ("active,3")
+ * @param tile_count Tiles of the frame (TileGrid::tileCount()); indices
+ *                   must be below it
+ * @return false on a malformed entry or a tile outside the frame (error printed)
+ */
+bool parseTileSelection(const std::string& text, size_t tile_count, TileSelection& selection);
+
+/**
+ * Tile layout of a frame resolution; counts tiles and turns tile sets
+ * into byte ranges to decode
+ *
+ * With width a multiple of 4 (every supported camera), rows start on a
+ * byte boundary and tile edges are exact. Otherwise a byte straddling two
+ * tiles counts towards the tile of its first pixel, and a selected tile
+ * may bring along up to 3 pixels of its neighbours.
+ */
+class TileGrid {
+public:
+    /**
+     * Rebuild for a resolution (no-op if unchanged)
+     */
+    void resize(int width, int height);
+
+    int tilesX() const { return tiles_x_; }
+    int tilesY() const { return tiles_y_; }
+    size_t tileCount() const { return static_cast<size_t>(tiles_x_) * static_cast<size_t>(tiles_y_); }
+
+    /**
+     * Tiles of a resolution, without building the grid
+     */
+    static size_t tileCount(int width, int height)
+    {
+        const int size = TileActivity::kTileSize;
+        return static_cast<size_t>((width + size - 1) / size) * static_cast<size_t>((height + size - 1) / size);
+    }
+
+    /**
+     * Count the events of each tile
+     * Scans 64-bit words and skips all-zero words, so the cost follows
+     * the event density; out.total equals countEvents() of the frame.
+     * @param data Packed frame
+     * @param size Bytes to scan (at most the frame size)
+     * @param out Activity (storage reused)
+     */
+    void count(const uint8_t* data, size_t size, TileActivity& out) const;
+
+    /**
+     * Byte ranges covering the selected tiles, in frame order, merged
+     * where adjacent
+     * @param selected One flag per tile (tileCount() entries)
+     * @param out Ranges (cleared first)
+     */
+    void ranges(const std::vector<uint8_t>& selected, std::vector<ByteRange>& out) const;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int tiles_x_ = 0;
+    int tiles_y_ = 0;
+    std::vector<uint32_t> byte_tile_;   // Tile of each byte's first pixel
+};
+
+} // namespace converter
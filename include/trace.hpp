@@ -0,0 +1,218 @@
+#pragma once
+
+#include "config.hpp"
+#include "thread_slots.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Pipeline stages recorded in the trace
+ * The numeric values are part of the dump format; append only.
+ */
+enum class TraceStage : uint8_t {
+    Receive = 0,        // Waiting for and reading one frame from the socket
+    Decode = 1,         // Decoding a whole frame
+    DecodeBand = 2,     // Decoding one row band (decode_band_rows)
+    Reorder = 3,        // Decoded, held until its turn (async span)
+    Queue = 4,          // In the pull queue until next() (async span)
+    Publish = 5,        // Callback / outputs for one frame
+    Count
+};
+
+/**
+ * Begin/End pair on one thread; AsyncBegin/AsyncEnd may be on different
+ * threads and are matched by stage and frame number
+ */
+enum class TracePhase : uint8_t {
+    Begin = 0,
+    End = 1,
+    AsyncBegin = 2,
+    AsyncEnd = 3
+};
+
+/**
+ * Name of a stage as written to the dump ("receive", "decode", ...)
+ */
+const char* traceStageName(TraceStage stage);
+
+/**
+ * Always-on binary trace of pipeline timing
+ *
+ * Every thread that records gets its own ring of the last
+ * trace_ring_events records (timestamp, stage, phase, frame number).
+ * Recording is a few relaxed stores into the thread's own ring - no locks,
+ * no shared cache lines - so it stays enabled in production. When
+ * something goes wrong, dump() writes all rings to a file for post-mortem
+ * analysis (tools/trace_to_chrome.py turns it into Chrome trace / Perfetto
+ * JSON):
+ *
+ *   TraceScope scope(TraceStage::Decode, frame_number);    // hot path
+ *   TraceRecorder::global().requestDump();                 // any thread, signal handler
+ *   TraceRecorder::global().dumpIfRequested(cfg.trace_path);   // e.g. main loop
+ *
+ * The converter requests a dump on SIGUSR1 (POSIX) and when a frame takes
+ * longer than trace_latency_threshold_us from receive to delivery.
+ *
+ * Rings of exited threads are reused by new threads; their older records
+ * remain until overwritten. dump() runs concurrently with recording and
+ * leaves out records that were overwritten while it copied them.
+ *
+ * Dump format (native byte order, little-endian on all supported targets):
+ *   header:  char magic[8] = "DVTRACE1", uint32 version, uint32 ring count,
+ *            int64 steady-clock ns and int64 system-clock ns at dump time,
+ *            uint32 stage count, then per stage: uint8 length + name
+ *   per ring: uint32 ring index, char name[16], uint64 record count,
+ *            records of { uint64 time_ns, uint64 frame, uint8 stage,
+ *            uint8 phase, 6 bytes zero }, oldest first
+ */
+class TraceRecorder {
+public:
+    static constexpr size_t kMaxThreads = 128;
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kThreadNameSize = 16;
+
+    /**
+     * The recorder used by all DVBridge components
+     */
+    static TraceRecorder& global();
+
+    /**
+     * Apply trace_enabled and trace_ring_events
+     * The ring size applies to rings created afterwards, so configure
+     * before the pipeline starts.
+     */
+    void configure(const Config& cfg);
+
+    /**
+     * Check if recording is enabled
+     */
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Append a record to the calling thread's ring (lock-free)
+     */
+    void record(TraceStage stage, TracePhase phase, uint64_t frame)
+    {
+        if (enabled()) {
+            append(stage, phase, frame);
+        }
+    }
+
+    /**
+     * Name the calling thread in the dump (first 15 characters)
+     */
+    void setThreadName(const char* name);
+
+    /**
+     * Ask for a dump (async-signal-safe; the dump itself happens in
+     * dumpIfRequested())
+     */
+    void requestDump() { dump_requested_.store(true, std::memory_order_relaxed); }
+
+    /**
+     * Write all rings to `path`
+     * @return true on success
+     */
+    bool dump(const std::string& path);
+
+    /**
+     * Dump if requestDump() was called since the last dump
+     * Dumps go to `path` with a sequence suffix (trace.bin.1, trace.bin.2, ...)
+     * so repeated dumps do not overwrite each other.
+     * @return true if a dump was written
+     */
+    bool dumpIfRequested(const std::string& path);
+
+    /**
+     * Timestamp used for records (steady clock, nanoseconds)
+     */
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    /**
+     * One record slot; fields are relaxed atomics so that dump() may read
+     * while the owning thread writes
+     */
+    struct Slot {
+        std::atomic<uint64_t> time{0};
+        std::atomic<uint64_t> frame{0};
+        std::atomic<uint64_t> meta{0};      // stage | phase << 8
+    };
+
+    /**
+     * One thread's ring; head counts records ever written, started the
+     * records begun (one ahead of head while a slot is being written)
+     */
+    struct alignas(64) Ring {
+        std::unique_ptr<Slot[]> slots;
+        size_t mask = 0;
+        std::atomic<uint64_t> head{0};
+        std::atomic<uint64_t> started{0};
+        std::atomic<bool> in_use{false};
+        std::array<std::atomic<char>, kThreadNameSize> name{};
+    };
+
+    TraceRecorder();
+    ~TraceRecorder() = default;
+
+    void append(TraceStage stage, TracePhase phase, uint64_t frame);
+
+    /**
+     * Ring of the calling thread (claimed on first use, released when the
+     * thread exits); nullptr beyond kMaxThreads
+     */
+    Ring* localRing();
+
+    std::atomic<bool> enabled_;
+    std::atomic<size_t> ring_size_;     // Records per new ring (power of two)
+    std::atomic<bool> dump_requested_;
+    std::mutex mutex_;                  // Dumps
+    uint64_t dump_count_;
+
+    ThreadSlots<Ring, kMaxThreads> rings_;
+};
+
+/**
+ * Records Begin on construction and End on destruction
+ *
+ *   {
+ *       TraceScope scope(TraceStage::Publish, frame->frame_number);
+ *       callback_(frame);
+ *   }
+ */
+class TraceScope {
+public:
+    TraceScope(TraceStage stage, uint64_t frame)
+        : stage_(stage)
+        , frame_(frame)
+    {
+        TraceRecorder::global().record(stage_, TracePhase::Begin, frame_);
+    }
+
+    ~TraceScope()
+    {
+        TraceRecorder::global().record(stage_, TracePhase::End, frame_);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    TraceStage stage_;
+    uint64_t frame_;
+};
+
+} // namespace converter
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "config.hpp"
+#include "metrics.hpp"
+#include "frame_header.hpp"
+#ifdef __linux__
+    #include "event_loop.hpp"
+#endif
 #include <vector>
 #include <string>
 #include <cstdint>
@@ -34,7 +39,10 @@ namespace converter {
  * 2. Multiple datagrams per frame with sequence numbers (for fragmented frames)
  *
  * The FPGA sends raw frame data without headers, so we accumulate data
- * until we have a complete frame.
+ * until we have a complete frame. With versioned headers (has_header,
+ * header_format = v1) each frame is preceded by a FrameHeader that starts
+ * a datagram; after a lost datagram the receiver skips to the next valid
+ * header and the counter gap shows up in rx_frames_lost.
  */
 class UdpReceiver {
 public:
@@ -68,6 +76,13 @@ public:
      */
     void disconnect();
 
+    /**
+     * Wake a receiveFrame() blocked in another thread
+     * Shuts the socket down without closing it; the blocked call then
+     * fails and the owning thread calls disconnect() as usual.
+     */
+    void interrupt();
+
     /**
      * Check if socket is bound and ready
      * @return true if ready to receive
@@ -86,25 +101,99 @@ public:
      */
     bool receiveFrame(std::vector<uint8_t>& buffer);
 
+#ifdef __linux__
+    /**
+     * connect() for an EventLoop task (binding does not block)
+     * @return true if bound successfully
+     */
+    Task<bool> connectAsync(EventLoop& loop);
+
+    /**
+     * receiveFrame() for an EventLoop task: awaits datagrams instead of
+     * blocking in recvfrom()
+     * @param loop Event loop the calling task runs on
+     * @param buffer Output buffer (will be resized to frame size)
+     * @return true if frame received successfully, false on error
+     */
+    Task<bool> receiveFrameAsync(EventLoop& loop, std::vector<uint8_t>& buffer);
+#endif
+
     /**
      * Get the expected frame size (without header)
      * @return Frame size in bytes
      */
     int getFrameSize() const;
 
+    /**
+     * Camera timestamp (us) of the last frame received, -1 without
+     * versioned headers (header_format = v1)
+     */
+    int64_t getFrameTimestamp() const { return header_.timestamp(); }
+
+    /**
+     * CRC32C sent with the last frame (v1 header with FrameFlags::Crc32c)
+     */
+    std::optional<uint32_t> getFrameCrc() const { return header_.crc(); }
+
+    /**
+     * Report payload progress while a frame arrives (cut-through decode,
+     * stream_rows): the handler runs on the receiving thread (or loop)
+     * after every chunk_bytes of payload and at its end, before the CRC
+     * trailer is read
+     * @param chunk_bytes Payload bytes between calls
+     * @param handler nullptr to receive whole frames again
+     */
+    void setPayloadHandler(size_t chunk_bytes, PayloadHandler handler);
+
     /**
      * Get total bytes received
-     * @return Total bytes received since connection
+     * @return Total bytes received (all connections, see metrics.hpp)
      */
-    uint64_t getTotalBytesReceived() const { return total_bytes_received_; }
+    uint64_t getTotalBytesReceived() const { return bytes_received_.value(); }
 
     /**
      * Get total frames received
-     * @return Total frames received since connection
+     * @return Total frames received (all connections, see metrics.hpp)
      */
-    uint64_t getTotalFramesReceived() const { return total_frames_received_; }
+    uint64_t getTotalFramesReceived() const { return frames_received_.value(); }
 
 private:
+    /**
+     * Start a frame with bytes left over from the previous datagram
+     * @return Bytes copied into frame
+     */
+    size_t takeLeftover(uint8_t* frame, size_t frame_size);
+
+    /**
+     * Append a datagram from packet_buffer_ to the frame, keeping any
+     * bytes past the frame end for the next one
+     */
+    void addPacket(size_t received, const struct sockaddr_in& sender_addr,
+                   uint8_t* frame, size_t frame_size, size_t& accumulated_bytes);
+
+    /**
+     * Receive exactly `size` bytes of the datagram stream
+     * @return false on socket error
+     */
+    bool receiveBytes(uint8_t* out, size_t size);
+
+#ifdef __linux__
+    /**
+     * receiveBytes() on a non-blocking socket
+     */
+    Task<bool> receiveBytesAsync(EventLoop& loop, uint8_t* out, size_t size);
+#endif
+
+    /**
+     * Drop the rest of the current datagram after an invalid header
+     */
+    void resync();
+
+    /**
+     * Count a complete frame
+     */
+    void frameReceived(size_t frame_size);
+
     /**
      * Initialize socket library (Windows only)
      */
@@ -126,8 +215,13 @@ private:
     std::vector<uint8_t> leftover_buffer_;
     size_t leftover_bytes_;
 
-    uint64_t total_bytes_received_;
-    uint64_t total_frames_received_;
+    FrameHeaderParser header_;
+    PayloadHandler payload_handler_;
+    size_t payload_chunk_;
+
+    // Registry metrics rx_bytes / rx_frames (readable from any thread)
+    Counter bytes_received_;
+    Counter frames_received_;
 
     static bool socket_lib_initialized_;
 };
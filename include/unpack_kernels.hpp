@@ -0,0 +1,214 @@
+#pragma once
+
+#include "config.hpp"
+#include "event_soa.hpp"
+#include <dv-processing/core/event.hpp>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace converter {
+
+/**
+ * Frame decode kernels
+ *
+ * All kernels turn a range of 2-bit packed bytes into dv::Event records
+ * and must produce exactly the same events in the same order as the
+ * scalar reference. They differ only in how they find non-zero bytes
+ * (bit by bit, word skipping, SSE2/AVX2/AVX-512 compares) and how they
+ * expand a byte into events (shifts, lookup table, or AVX-512 compress of
+ * coordinate vectors).
+ *
+ * Kernels write into a caller-provided buffer with room for at least
+ * 4 * (end - begin) events and never allocate.
+ *
+ * The SoA kernels at the end of this file decode the same events into
+ * separate x / y / bit-packed polarity arrays (see EventFrameSoA).
+ */
+
+/**
+ * Per-frame parameters shared by all kernels
+ */
+struct UnpackContext {
+    const uint8_t* data = nullptr;  // Start of the frame
+    size_t begin = 0;               // First byte to decode
+    size_t end = 0;                 // One past the last byte to decode
+    int width = 0;                  // Frame width in pixels
+    int total_pixels = 0;           // width * height (reference kernel bound)
+    const int16_t* byte_x = nullptr;    // x of the first pixel in each byte
+    const int16_t* byte_y = nullptr;    // y of the first pixel in each byte
+    int64_t timestamp = 0;          // Timestamp for all events of the frame
+};
+
+/**
+ * Kernel entry point
+ * @param ctx Frame parameters
+ * @param out Output buffer (capacity >= 4 * (ctx.end - ctx.begin))
+ * @return Number of events written
+ */
+using UnpackKernelFn = size_t (*)(const UnpackContext& ctx, dv::Event* out);
+
+/**
+ * Registry entry for one kernel
+ */
+struct KernelInfo {
+    UnpackKernel id;
+    const char* name;
+    UnpackKernelFn fn;
+    bool full_bytes_only;   // Requires every byte in [begin, end) to hold 4 real pixels
+};
+
+/**
+ * Decoded form of one packed byte
+ * Pixels with value 00 (no event) and 11 (unused) are dropped.
+ */
+struct ByteDecode {
+    uint8_t count;          // Events in this byte (0-4)
+    uint8_t offset[4];      // Pixel offset within the byte (0-3)
+    uint8_t polarity[4];    // 1 = positive (01), 0 = negative (10)
+    uint8_t polarity_bits;  // Bit i = polarity[i], for bit-packed output
+};
+
+/**
+ * Build the lookup table for all 256 byte values (compile time)
+ */
+constexpr std::array<ByteDecode, 256> makeByteDecodeTable()
+{
+    std::array<ByteDecode, 256> t{};
+    for (int value = 0; value < 256; value++) {
+        ByteDecode& d = t[value];
+        // MSB first: bits 7-6 = pixel 0 ... bits 1-0 = pixel 3
+        for (int px = 0; px < 4; px++) {
+            int pixel_val = (value >> (6 - px * 2)) & 0x03;
+            if (pixel_val == 1 || pixel_val == 2) {
+                d.offset[d.count] = static_cast<uint8_t>(px);
+                d.polarity[d.count] = (pixel_val == 1) ? 1 : 0;
+                d.polarity_bits |= static_cast<uint8_t>(d.polarity[d.count] << d.count);
+                d.count++;
+            }
+        }
+    }
+    return t;
+}
+
+inline constexpr std::array<ByteDecode, 256> kByteDecodeTable = makeByteDecodeTable();
+
+/**
+ * Kernels compiled into this binary AND supported by this CPU,
+ * scalar reference first
+ */
+const std::vector<KernelInfo>& availableKernels();
+
+/**
+ * Find a kernel by id
+ * @return Kernel info, or nullptr if not compiled in / not supported
+ */
+const KernelInfo* findKernel(UnpackKernel id);
+
+/**
+ * Build the per-byte coordinate tables used by the table-driven kernels
+ * @param width Frame width in pixels
+ * @param frame_size Frame size in bytes
+ * @param byte_x Output: x of the first pixel in each byte
+ * @param byte_y Output: y of the first pixel in each byte
+ */
+void buildCoordinateTables(int width, int frame_size,
+                           std::vector<int16_t>& byte_x, std::vector<int16_t>& byte_y);
+
+/**
+ * Count the events in packed bytes without decoding them
+ * A pixel holds an event when its two bits differ (01 or 10), so this is
+ * one XOR and a popcount per 64-bit word - cheap enough to run on every
+ * frame before deciding how to decode it.
+ */
+size_t countEvents(const uint8_t* data, size_t size);
+
+/**
+ * Build the subsampling mask for a decimation factor
+ * Pixel (x, y) is kept (both bits set in the mask) when
+ * (x + step * y) % factor == 0, with step ~ sqrt(factor): kept pixels form
+ * an even lattice, 1 in `factor`, instead of whole rows or columns.
+ * @param factor Keep 1 pixel in `factor` (1 = all)
+ * @param mask Output: one mask byte per frame byte
+ */
+void buildDecimationMask(int width, int total_pixels, int frame_size, int factor, std::vector<uint8_t>& mask);
+
+/**
+ * Emit the events of one non-zero byte using the lookup table
+ * Shared by the table-driven kernels once they have located a non-zero byte.
+ */
+inline dv::Event* emitByte(const UnpackContext& ctx, size_t byte_idx, uint8_t byte_val, dv::Event* out)
+{
+    const ByteDecode& d = kByteDecodeTable[byte_val];
+    const int base_x = ctx.byte_x[byte_idx];
+    const int base_y = ctx.byte_y[byte_idx];
+
+    for (int i = 0; i < d.count; i++) {
+        int x = base_x + d.offset[i];
+        int y = base_y;
+        // A byte can straddle two rows when width is not a multiple of 4
+        if (x >= ctx.width) {
+            x -= ctx.width;
+            y++;
+        }
+        *out++ = dv::Event(ctx.timestamp, static_cast<int16_t>(x), static_cast<int16_t>(y), d.polarity[i]);
+    }
+    return out;
+}
+
+// Kernel implementations (unpack_kernels.cpp, unpack_kernels_x86.cpp, unpack_kernels_neon.cpp)
+size_t unpackScalar(const UnpackContext& ctx, dv::Event* out);
+size_t unpackLut(const UnpackContext& ctx, dv::Event* out);
+#if defined(__x86_64__) || defined(_M_X64)
+size_t unpackSse2(const UnpackContext& ctx, dv::Event* out);
+size_t unpackAvx2(const UnpackContext& ctx, dv::Event* out);
+size_t unpackAvx512(const UnpackContext& ctx, dv::Event* out);
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+size_t unpackNeon(const UnpackContext& ctx, dv::Event* out);
+#endif
+
+// =========================================================================
+// Structure-of-arrays kernels
+// =========================================================================
+
+/**
+ * SoA output arrays, filled from index `count` onwards
+ * x and y need room for 4 * (end - begin) + EventFrameSoA::kPadding entries
+ * past count, polarity for the matching number of bits.
+ */
+struct SoaOutput {
+    int16_t* x = nullptr;
+    int16_t* y = nullptr;
+    uint64_t* polarity = nullptr;
+    size_t count = 0;               // Events already in the arrays (advanced by the kernel)
+};
+
+/**
+ * SoA kernel entry point
+ * @param ctx Frame parameters (timestamp unused, stored once per frame)
+ * @param out Output arrays; out.count is advanced by the events written
+ * @return Number of events written
+ */
+using UnpackSoaKernelFn = size_t (*)(const UnpackContext& ctx, SoaOutput& out);
+
+/**
+ * Pick the SoA kernel for a configured unpack_kernel
+ * scalar and lut map to their SoA counterparts; anything else gets the
+ * best one this CPU supports (AVX-512 VBMI2 compress, else LUT).
+ * @param preference Config::unpack_kernel
+ * @param name Output: kernel name for logging (optional)
+ */
+UnpackSoaKernelFn selectSoaKernel(UnpackKernel preference, const char** name = nullptr);
+
+// Reference SoA kernel: bounds-checked per-pixel loop (any byte range)
+size_t unpackSoaScalar(const UnpackContext& ctx, SoaOutput& out);
+// LUT SoA kernel (full bytes only)
+size_t unpackSoaLut(const UnpackContext& ctx, SoaOutput& out);
+#if defined(__x86_64__) || defined(_M_X64)
+// AVX-512 VBMI2 SoA kernel (full bytes only)
+size_t unpackSoaAvx512(const UnpackContext& ctx, SoaOutput& out);
+#endif
+
+} // namespace converter
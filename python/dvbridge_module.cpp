@@ -0,0 +1,296 @@
+/**
+ * Python bindings for the DVBridge frame decoder (module `dvbridge`)
+ *
+ * Exposes FrameUnpacker and the 2-bit packing so offline analysis and the
+ * camera simulators run at C++ speed:
+ *
+ *   import dvbridge
+ *   unpacker = dvbridge.Unpacker(1280, 720)
+ *   events = unpacker.unpack(frame_bytes, frame_number)     # structured array
+ *   soa = unpacker.unpack_soa(frame_bytes, frame_number)    # dict of arrays
+ *   raw = dvbridge.pack(x, y, polarity, 1280, 720)          # FPGA frame
+ *
+ * Returned arrays are views of buffers allocated and filled by C++; a
+ * capsule owning the buffer is the array base, so nothing is copied into
+ * Python memory and the buffer lives as long as any view of it.
+ */
+
+#include "config.hpp"
+#include "config_loader.hpp"
+#include "frame_unpacker.hpp"
+#include "frame_packer.hpp"
+#include "unpack_kernels.hpp"
+#include "event_soa.hpp"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace py = pybind11;
+
+namespace converter {
+namespace {
+
+/**
+ * Raw view of a contiguous Python buffer (bytes, bytearray, mmap, ndarray)
+ * The buffer_info keeps the exporter's buffer alive while it is held.
+ */
+struct ByteView {
+    py::buffer_info info;
+    const uint8_t* data;
+    size_t size;
+};
+
+ByteView requestBytes(const py::buffer& buffer)
+{
+    py::buffer_info info = buffer.request();
+    py::ssize_t expected = info.itemsize;
+    for (py::ssize_t i = info.ndim - 1; i >= 0; --i) {
+        if (info.shape[i] > 1 && info.strides[i] != expected) {
+            throw py::value_error("frame data must be a C-contiguous buffer");
+        }
+        expected *= info.shape[i];
+    }
+    const auto* data = static_cast<const uint8_t*>(info.ptr);
+    const size_t size = static_cast<size_t>(info.size * info.itemsize);
+    return ByteView{std::move(info), data, size};
+}
+
+/**
+ * NumPy dtype matching dv::Event (16 bytes, flatbuffers layout)
+ */
+py::dtype eventDtype()
+{
+    static_assert(sizeof(dv::Event) == 16, "dv::Event layout changed");
+    py::list names, formats, offsets;
+    names.append("timestamp"); formats.append("<i8"); offsets.append(0);
+    names.append("x");         formats.append("<i2"); offsets.append(8);
+    names.append("y");         formats.append("<i2"); offsets.append(10);
+    names.append("polarity");  formats.append("u1");  offsets.append(12);
+
+    py::dict spec;
+    spec["names"] = names;
+    spec["formats"] = formats;
+    spec["offsets"] = offsets;
+    spec["itemsize"] = 16;
+    return py::dtype::from_args(spec);
+}
+
+/**
+ * Structured array viewing a heap-allocated packet (takes ownership)
+ */
+py::array packetArray(std::unique_ptr<dv::EventPacket> packet)
+{
+    const auto count = static_cast<py::ssize_t>(packet->elements.size());
+    const dv::Event* data = packet->elements.data();
+    py::capsule owner(packet.release(), [](void* p) {
+        delete static_cast<dv::EventPacket*>(p);
+    });
+    return py::array(eventDtype(), {count}, {static_cast<py::ssize_t>(sizeof(dv::Event))}, data, owner);
+}
+
+/**
+ * Python-facing unpacker: owns its Config (FrameUnpacker keeps a reference)
+ *
+ * Decoding runs with the GIL released, so threads decoding with different
+ * Unpackers run in parallel. FrameUnpacker itself is not thread-safe
+ * (scratch buffers, table rebuilds, dispatcher statistics), so calls on
+ * the same Unpacker are serialized by mutex_, taken after the GIL is
+ * released: a thread waiting for it does not block other Python threads.
+ */
+class PyUnpacker {
+public:
+    PyUnpacker(int width, int height, int64_t frame_interval_us, const std::string& kernel)
+        : config_(std::make_unique<Config>())
+    {
+        config_->width = width;
+        config_->height = height;
+        config_->frame_interval_us = frame_interval_us;
+        if (width <= 0 || height <= 0 || width > INT16_MAX || height > INT16_MAX) {
+            throw py::value_error("width and height must be between 1 and 32767");
+        }
+        if (!applyConfigOption("unpack_kernel", kernel, *config_)) {
+            throw py::value_error("unknown kernel '" + kernel + "'");
+        }
+        unpacker_ = std::make_unique<FrameUnpacker>(*config_);
+    }
+
+    py::array unpack(const py::buffer& frame, uint64_t frame_number)
+    {
+        ByteView bytes = requestBytes(frame);
+        checkFrameSize(bytes.size);
+
+        auto packet = std::make_unique<dv::EventPacket>();
+        {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(mutex_);
+            unpacker_->unpack(bytes.data, bytes.size, frame_number, *packet);
+        }
+        return packetArray(std::move(packet));
+    }
+
+    py::dict unpackSoA(const py::buffer& frame, uint64_t frame_number)
+    {
+        ByteView bytes = requestBytes(frame);
+        checkFrameSize(bytes.size);
+
+        auto soa = std::make_unique<EventFrameSoA>();
+        {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(mutex_);
+            unpacker_->unpackSoA(bytes.data, bytes.size, frame_number, *soa);
+        }
+
+        // One capsule owns the frame; all three arrays keep it alive
+        const EventFrameSoA* frame_ptr = soa.get();
+        py::capsule owner(soa.release(), [](void* p) {
+            delete static_cast<EventFrameSoA*>(p);
+        });
+        const auto count = static_cast<py::ssize_t>(frame_ptr->count);
+        const auto words = static_cast<py::ssize_t>(polarityWords(frame_ptr->count));
+
+        py::dict out;
+        out["frame_number"] = frame_ptr->frame_number;
+        out["timestamp"] = frame_ptr->timestamp;
+        out["count"] = frame_ptr->count;
+        out["x"] = py::array_t<int16_t>({count}, {sizeof(int16_t)}, frame_ptr->x.data(), owner);
+        out["y"] = py::array_t<int16_t>({count}, {sizeof(int16_t)}, frame_ptr->y.data(), owner);
+        out["polarity_bits"] = py::array_t<uint64_t>({words}, {sizeof(uint64_t)}, frame_ptr->polarity.data(), owner);
+        return out;
+    }
+
+    py::array unpackStream(const py::buffer& data, uint64_t first_frame)
+    {
+        ByteView bytes = requestBytes(data);
+        const size_t frame_size = static_cast<size_t>(config_->frame_size());
+        if (bytes.size % frame_size != 0) {
+            throw py::value_error("stream length " + std::to_string(bytes.size) +
+                                  " is not a multiple of the frame size " + std::to_string(frame_size));
+        }
+
+        auto packet = std::make_unique<dv::EventPacket>();
+        {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(mutex_);
+            dv::EventPacket frame_events;
+            for (size_t offset = 0; offset < bytes.size; offset += frame_size) {
+                const uint64_t frame_number = first_frame + offset / frame_size;
+                unpacker_->unpack(bytes.data + offset, frame_size, frame_number, frame_events);
+                packet->elements.insert(packet->elements.end(),
+                                        frame_events.elements.begin(), frame_events.elements.end());
+            }
+        }
+        return packetArray(std::move(packet));
+    }
+
+    int frameSize() const { return config_->frame_size(); }
+    int width() const { return config_->width; }
+    int height() const { return config_->height; }
+    const char* kernelName() const { return unpacker_->getKernelName(); }
+
+private:
+    void checkFrameSize(size_t size) const
+    {
+        if (size < static_cast<size_t>(config_->frame_size())) {
+            throw py::value_error("frame too short: " + std::to_string(size) +
+                                  " bytes, expected " + std::to_string(config_->frame_size()));
+        }
+    }
+
+    std::unique_ptr<Config> config_;
+    std::unique_ptr<FrameUnpacker> unpacker_;
+    std::mutex mutex_;              // One decode at a time per unpacker_
+};
+
+/**
+ * Pack events into one 2-bit FPGA frame with FramePacker
+ * Later events overwrite earlier ones at the same pixel.
+ */
+py::array_t<uint8_t> pack(
+    const py::array_t<int16_t, py::array::c_style | py::array::forcecast>& x,
+    const py::array_t<int16_t, py::array::c_style | py::array::forcecast>& y,
+    const py::array_t<uint8_t, py::array::c_style | py::array::forcecast>& polarity,
+    int width,
+    int height)
+{
+    if (width <= 0 || height <= 0) {
+        throw py::value_error("width and height must be positive");
+    }
+    const py::ssize_t n = x.size();
+    if (y.size() != n || polarity.size() != n) {
+        throw py::value_error("x, y and polarity must have the same length");
+    }
+
+    const int16_t* xs = x.data();
+    const int16_t* ys = y.data();
+    const uint8_t* ps = polarity.data();
+    for (py::ssize_t i = 0; i < n; ++i) {
+        if (xs[i] < 0 || xs[i] >= width || ys[i] < 0 || ys[i] >= height) {
+            throw py::value_error("event " + std::to_string(i) + " is outside the frame");
+        }
+    }
+
+    Config cfg;
+    cfg.width = width;
+    cfg.height = height;
+    auto frame = std::make_unique<std::vector<uint8_t>>();
+    {
+        py::gil_scoped_release release;
+        FramePacker packer(cfg);
+        packer.pack(xs, ys, ps, static_cast<size_t>(n), *frame);
+    }
+    const size_t frame_size = frame->size();
+
+    const uint8_t* data = frame->data();
+    py::capsule owner(frame.release(), [](void* p) {
+        delete static_cast<std::vector<uint8_t>*>(p);
+    });
+    return py::array_t<uint8_t>({static_cast<py::ssize_t>(frame_size)}, {1}, data, owner);
+}
+
+} // namespace
+} // namespace converter
+
+PYBIND11_MODULE(dvbridge, m)
+{
+    using converter::PyUnpacker;
+
+    m.doc() = "DVBridge FPGA frame decoder (2-bit packed pixels to events)";
+
+    py::class_<PyUnpacker>(m, "Unpacker")
+        .def(py::init<int, int, int64_t, const std::string&>(),
+             py::arg("width") = 1280, py::arg("height") = 720,
+             py::arg("frame_interval_us") = 10000, py::arg("kernel") = "auto",
+             "Create a decoder; kernel is auto, scalar, lut, sse2, avx2, avx512 or neon. "
+             "Decoding releases the GIL; calls on one Unpacker from several threads run one "
+             "at a time, so use one Unpacker per thread for parallel decoding")
+        .def("unpack", &PyUnpacker::unpack, py::arg("frame"), py::arg("frame_number") = 0,
+             "Decode one frame into a structured array (timestamp, x, y, polarity)")
+        .def("unpack_soa", &PyUnpacker::unpackSoA, py::arg("frame"), py::arg("frame_number") = 0,
+             "Decode one frame into separate x / y arrays and bit-packed polarity")
+        .def("unpack_stream", &PyUnpacker::unpackStream, py::arg("data"), py::arg("first_frame") = 0,
+             "Decode a raw capture of back-to-back frames into one structured array")
+        .def_property_readonly("frame_size", &PyUnpacker::frameSize)
+        .def_property_readonly("width", &PyUnpacker::width)
+        .def_property_readonly("height", &PyUnpacker::height)
+        .def_property_readonly("kernel_name", &PyUnpacker::kernelName);
+
+    m.def("pack", &converter::pack,
+          py::arg("x"), py::arg("y"), py::arg("polarity"),
+          py::arg("width") = 1280, py::arg("height") = 720,
+          "Pack events into one 2-bit FPGA frame (uint8 array)");
+
+    m.def("kernels", []() {
+        std::vector<std::string> names;
+        for (const auto& k : converter::availableKernels()) {
+            names.emplace_back(k.name);
+        }
+        return names;
+    }, "Decode kernels supported by this CPU");
+}
@@ -0,0 +1,160 @@
+#include "batch_converter.hpp"
+#include "trace.hpp"
+
+#include <dv-processing/io/mono_camera_writer.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+namespace converter {
+
+BatchConverter::BatchConverter(const Config& cfg)
+    : config_(cfg)
+    , frame_count_(0)
+    , chunk_count_(0)
+    , next_chunk_(0)
+    , chunks_running_(0)
+    , chunks_completed_(0)
+    , stop_requested_(false)
+    , frames_converted_(MetricsRegistry::global().counter(metricName(cfg, "convert_frames")))
+    , events_converted_(MetricsRegistry::global().counter(metricName(cfg, "convert_events")))
+    , bytes_converted_(MetricsRegistry::global().counter(metricName(cfg, "convert_bytes")))
+    , segments_written_(MetricsRegistry::global().counter(metricName(cfg, "convert_segments")))
+    , scheduler_(std::make_unique<DecodeScheduler>(cfg))
+{
+    // FrameUnpacker is single-threaded: one per worker, sharing one kernel choice
+    unpackers_.push_back(std::make_unique<FrameUnpacker>(config_));
+    for (size_t i = 1; i < scheduler_->workerCount(); i++) {
+        unpackers_.push_back(std::make_unique<FrameUnpacker>(config_, unpackers_[0]->getDispatcher()));
+    }
+}
+
+BatchConverter::~BatchConverter()
+{
+    stop();
+}
+
+bool BatchConverter::start()
+{
+    if (!input_.open(config_.input_file) || !index_.create(config_)) {
+        return false;
+    }
+    const uint64_t frame_size = static_cast<uint64_t>(config_.frame_size());
+    frame_count_ = input_.size() / frame_size;
+    if (input_.size() % frame_size != 0) {
+        std::cerr << "Ignoring " << input_.size() % frame_size << " trailing bytes of " << config_.input_file
+                  << " (incomplete frame)" << std::endl;
+    }
+    const uint64_t chunk_frames = static_cast<uint64_t>(config_.convert_chunk_frames);
+    chunk_count_ = static_cast<size_t>((frame_count_ + chunk_frames - 1) / chunk_frames);
+
+    std::cout << "Converting " << config_.input_file << " (" << frame_count_ << " frames) into "
+              << chunk_count_ << " segments on " << scheduler_->workerCount() << " threads" << std::endl;
+
+    std::lock_guard<std::mutex> lock(chunk_mutex_);
+    stop_requested_ = false;
+    next_chunk_ = 0;
+    chunks_completed_ = 0;
+    // One chunk per worker; each finished chunk starts the next, so
+    // segments are produced (and the file read) roughly in order
+    for (size_t i = 0; i < scheduler_->workerCount(); i++) {
+        submitNext();
+    }
+    return true;
+}
+
+void BatchConverter::submitNext()
+{
+    if (next_chunk_ >= chunk_count_ || stop_requested_) {
+        return;
+    }
+    const size_t chunk = next_chunk_++;
+    chunks_running_++;
+    scheduler_->submit([this, chunk]() { convertChunk(chunk); });
+}
+
+void BatchConverter::stop()
+{
+    stop_requested_ = true;
+    std::unique_lock<std::mutex> lock(chunk_mutex_);
+    chunk_cv_.wait(lock, [this]() { return chunks_running_ == 0; });
+}
+
+bool BatchConverter::isRunning() const
+{
+    std::lock_guard<std::mutex> lock(chunk_mutex_);
+    return chunks_running_ > 0;
+}
+
+bool BatchConverter::isComplete() const
+{
+    std::lock_guard<std::mutex> lock(chunk_mutex_);
+    return chunks_completed_ == chunk_count_;
+}
+
+void BatchConverter::convertChunk(size_t chunk)
+{
+    const uint64_t frame_size = static_cast<uint64_t>(config_.frame_size());
+    const uint64_t chunk_frames = static_cast<uint64_t>(config_.convert_chunk_frames);
+    const uint64_t first = static_cast<uint64_t>(chunk) * chunk_frames;
+    const uint64_t last = std::min(first + chunk_frames, frame_count_);
+    RecordingSegment segment;
+    segment.path = RecordingIndex::segmentPath(config_.output_file, chunk);
+    segment.first_frame = first;
+
+    FrameUnpacker& unpacker = *unpackers_[static_cast<size_t>(scheduler_->currentWorker())];
+    input_.advise(first * frame_size, (last - first) * frame_size, MappedFile::Access::WillNeed);
+
+    bool completed = false;
+    try {
+        // Compression happens in writeEvents(), on this worker
+        dv::io::MonoCameraWriter writer(segment.path, dv::io::MonoCameraWriter::EventOnlyConfig(
+            "DVBridge", unpacker.getResolution()));
+        auto packet = std::make_shared<dv::EventPacket>();
+        uint64_t frame = first;
+        for (; frame < last && !stop_requested_; frame++) {
+            TraceScope trace(TraceStage::Decode, frame);
+            // The writer may keep the last packet; only reuse it if not
+            if (packet.use_count() > 1) {
+                packet = std::make_shared<dv::EventPacket>();
+            }
+            // Decoded straight from the mapping, no copy
+            const size_t events = unpacker.unpack(input_.data() + frame * frame_size, static_cast<size_t>(frame_size),
+                                                  frame, *packet);
+            if (events > 0) {
+                writer.writeEvents(dv::EventStore(std::shared_ptr<const dv::EventPacket>(packet)));
+            }
+            segment.events += events;
+            frames_converted_.add();
+            events_converted_.add(events);
+            bytes_converted_.add(frame_size);
+        }
+        completed = frame == last;
+        segment.frames = frame - first;
+    } catch (const std::exception& e) {
+        std::cerr << "BatchConverter: writing " << segment.path << " failed: " << e.what() << std::endl;
+    }
+    // The writer is closed (file complete) here
+    if (segment.frames > 0) {
+        segment.begin_us = static_cast<int64_t>(first) * config_.frame_interval_us;
+        segment.end_us = static_cast<int64_t>(first + segment.frames) * config_.frame_interval_us;
+        index_.add(segment);
+        segments_written_.add();
+    }
+
+    // Done with these pages; the next chunks need the memory
+    input_.advise(first * frame_size, (last - first) * frame_size, MappedFile::Access::DontNeed);
+
+    {
+        std::lock_guard<std::mutex> lock(chunk_mutex_);
+        if (completed) {
+            chunks_completed_++;
+        }
+        chunks_running_--;
+        submitNext();
+    }
+    chunk_cv_.notify_all();
+}
+
+} // namespace converter
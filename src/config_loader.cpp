@@ -0,0 +1,601 @@
+#include "config_loader.hpp"
+#include "tile_activity.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <variant>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+
+namespace converter {
+
+namespace {
+
+// Config member this option maps to
+using Member = std::variant<
+    int Config::*,
+    int64_t Config::*,
+    double Config::*,
+    bool Config::*,
+    std::string Config::*,
+    Protocol Config::*,
+    UnpackKernel Config::*,
+    HeaderFormat Config::*
+>;
+
+// How writeConfig() and --help print an option's value
+enum class Display {
+    Default,
+    Octal       // Permission bits: 0660, as they are usually written
+};
+
+struct OptionDef {
+    const char* name;
+    Member member;
+    const char* help;
+    Display display = Display::Default;
+};
+
+/**
+ * All runtime options. Add new Config fields here to make them settable
+ * from the config file and command line.
+ */
+const std::vector<OptionDef>& options()
+{
+    static const std::vector<OptionDef> defs = {
+        // Frame
+        {"width",               &Config::width,               "Frame width in pixels"},
+        {"height",              &Config::height,              "Frame height in pixels"},
+        // Protocol / input
+        {"protocol",            &Config::protocol,            "Input protocol: tcp, udp or file"},
+        {"camera_ip",           &Config::camera_ip,           "UDP bind address"},
+        {"camera_port",         &Config::camera_port,         "Port to listen on for the FPGA"},
+        {"recv_buffer_size",    &Config::recv_buffer_size,    "Socket receive buffer size (bytes)"},
+        {"tcp_connections",     &Config::tcp_connections,     "Parallel TCP connections frames are striped across"},
+        {"tcp_zerocopy",        &Config::tcp_zerocopy,        "Map received TCP payload pages instead of copying (Linux)"},
+        {"udp_packet_size",     &Config::udp_packet_size,     "Maximum UDP datagram size (bytes)"},
+        {"input_file",          &Config::input_file,          "Raw frame file to convert (protocol = file)"},
+        {"convert_chunk_frames", &Config::convert_chunk_frames, "Batch-convert input_file in chunks of N frames (0 = off)"},
+        // Output
+        {"aedat_port",          &Config::aedat_port,          "AEDAT4 TCP output port"},
+        {"aedat_tcp_enabled",   &Config::aedat_tcp_enabled,   "Serve AEDAT4 over TCP"},
+        {"aedat_socket_path",   &Config::aedat_socket_path,   "Also serve AEDAT4 on this Unix socket"},
+        {"output_file",         &Config::output_file,         "Also write AEDAT4 to this file"},
+        {"output_segment_frames", &Config::output_segment_frames, "New output_file segment every N frames (0 = one file)"},
+        {"shm_enabled",         &Config::shm_enabled,         "Publish events to shared memory (Linux)"},
+        {"shm_name",            &Config::shm_name,            "Shared memory object name"},
+        {"shm_mode",            &Config::shm_mode,            "Shared memory permissions (octal, e.g. 0660)", Display::Octal},
+        {"shm_slot_count",      &Config::shm_slot_count,      "Shared memory ring slots"},
+        {"shm_slot_events",     &Config::shm_slot_events,     "Events per shared memory slot"},
+        {"shm_soa",             &Config::shm_soa,             "Shared memory slots as x/y/polarity arrays"},
+        // Frame header
+        {"has_header",          &Config::has_header,          "Frames are preceded by a header"},
+        {"header_format",       &Config::header_format,       "Header layout: length (TCP, file) or v1 (TCP, UDP, file)"},
+        {"header_size",         &Config::header_size,         "Length header size in bytes"},
+        {"verify_crc",          &Config::verify_crc,          "Check CRC32C frame trailers (v1 headers)"},
+        // Timing
+        {"frame_interval_us",   &Config::frame_interval_us,   "Microseconds between frames"},
+        // Decode
+        {"unpack_kernel",       &Config::unpack_kernel,       "Decode kernel: auto, scalar, lut, sse2, avx2, avx512, neon"},
+        {"kernel_bench_density", &Config::kernel_bench_density, "Event density of startup benchmark frames (0-1)"},
+        {"kernel_bench_ms",     &Config::kernel_bench_ms,     "Benchmark time per kernel (ms)"},
+        {"kernel_reeval_interval", &Config::kernel_reeval_interval, "Re-benchmark kernels every N frames (0 = off)"},
+        {"decode_threads",      &Config::decode_threads,      "Work-stealing decode threads (0 = receive thread)"},
+        {"decode_band_rows",    &Config::decode_band_rows,    "Rows per parallel decode job (0 = whole frames)"},
+        {"reorder_window",      &Config::reorder_window,      "Frames held behind a missing one before skipping it"},
+        {"reorder_max_wait_ms", &Config::reorder_max_wait_ms, "Wait for a missing frame before skipping it (ms)"},
+        {"decimation_enabled",  &Config::decimation_enabled,  "Subsample events of frames that would overload delivery"},
+        {"decimation_event_budget", &Config::decimation_event_budget, "Events per frame before subsampling"},
+        {"decimation_backlog_frames", &Config::decimation_backlog_frames, "Frames waiting for delivery that count as overload"},
+        {"decimation_max_factor", &Config::decimation_max_factor, "Strongest subsampling (keep 1 pixel in N, power of two)"},
+        // Pipeline
+        {"pipeline_pool_size",  &Config::pipeline_pool_size,  "Decoded frame buffers (library pipeline)"},
+        {"pipeline_queue_depth", &Config::pipeline_queue_depth, "Frames queued for pull delivery"},
+        {"pipeline_soa",        &Config::pipeline_soa,        "Deliver SoA frames instead of dv::EventStore"},
+        {"stream_rows",         &Config::stream_rows,         "Deliver frames in parts of N rows as they arrive (0 = whole frames)"},
+        {"pipeline_async",      &Config::pipeline_async,      "Receive on an epoll coroutine loop (Linux)"},
+        {"tile_activity",       &Config::tile_activity,       "Count events per 32x32 tile of every frame"},
+        {"tile_active_threshold", &Config::tile_active_threshold, "Events that make a tile active"},
+        {"tile_subscription",   &Config::tile_subscription,   "Decode only these tiles: active, N, N-M (comma-separated)"},
+        // Debug
+        {"stats_interval",      &Config::stats_interval,      "Print statistics every N frames (0 = off)"},
+        {"verbose",             &Config::verbose,             "Print verbose debug messages"},
+        {"metrics_prefix",      &Config::metrics_prefix,      "Prefix of all metric names"},
+        {"trace_enabled",       &Config::trace_enabled,       "Record stage timings in per-thread trace rings"},
+        {"trace_ring_events",   &Config::trace_ring_events,   "Trace records kept per thread"},
+        {"trace_path",          &Config::trace_path,          "Trace dump file (SIGUSR1 or latency threshold)"},
+        {"trace_latency_threshold_us", &Config::trace_latency_threshold_us, "Dump the trace when a frame's latency exceeds this (us, 0 = off)"},
+    };
+    return defs;
+}
+
+std::string trim(const std::string& s)
+{
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+std::string toLower(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+bool parseValue(const std::string& text, int64_t& out)
+{
+    try {
+        size_t pos = 0;
+        long long v = std::stoll(text, &pos, 0);
+        if (pos != text.size()) {
+            return false;
+        }
+        out = static_cast<int64_t>(v);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool parseValue(const std::string& text, int& out)
+{
+    int64_t v = 0;
+    if (!parseValue(text, v) || v < INT_MIN || v > INT_MAX) {
+        return false;
+    }
+    out = static_cast<int>(v);
+    return true;
+}
+
+bool parseValue(const std::string& text, double& out)
+{
+    try {
+        size_t pos = 0;
+        out = std::stod(text, &pos);
+        return pos == text.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool parseValue(const std::string& text, bool& out)
+{
+    std::string v = toLower(text);
+    if (v == "true" || v == "yes" || v == "on" || v == "1") {
+        out = true;
+        return true;
+    }
+    if (v == "false" || v == "no" || v == "off" || v == "0") {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+bool parseValue(const std::string& text, std::string& out)
+{
+    // Allow optional quotes in config files: shm_name = "/dvbridge_events"
+    if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+        out = text.substr(1, text.size() - 2);
+    } else {
+        out = text;
+    }
+    return true;
+}
+
+bool parseValue(const std::string& text, Protocol& out)
+{
+    std::string v = toLower(text);
+    if (v == "tcp") {
+        out = Protocol::TCP;
+        return true;
+    }
+    if (v == "udp") {
+        out = Protocol::UDP;
+        return true;
+    }
+    if (v == "file") {
+        out = Protocol::File;
+        return true;
+    }
+    return false;
+}
+
+bool parseValue(const std::string& text, UnpackKernel& out)
+{
+    std::string v = toLower(text);
+    for (UnpackKernel k : {UnpackKernel::Auto, UnpackKernel::Scalar, UnpackKernel::Lut,
+                           UnpackKernel::Sse2, UnpackKernel::Avx2, UnpackKernel::Avx512,
+                           UnpackKernel::Neon}) {
+        if (v == kernelToString(k)) {
+            out = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseValue(const std::string& text, HeaderFormat& out)
+{
+    std::string v = toLower(text);
+    for (HeaderFormat f : {HeaderFormat::Length, HeaderFormat::V1}) {
+        if (v == headerFormatToString(f)) {
+            out = f;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string formatValue(int v) { return std::to_string(v); }
+std::string formatValue(int64_t v) { return std::to_string(v); }
+std::string formatValue(double v)
+{
+    std::ostringstream ss;
+    ss << v;
+    return ss.str();
+}
+std::string formatValue(bool v) { return v ? "true" : "false"; }
+std::string formatValue(const std::string& v) { return "\"" + v + "\""; }
+std::string formatValue(Protocol v)
+{
+    switch (v) {
+        case Protocol::UDP: return "udp";
+        case Protocol::File: return "file";
+        default: return "tcp";
+    }
+}
+std::string formatValue(UnpackKernel v) { return kernelToString(v); }
+std::string formatValue(HeaderFormat v) { return headerFormatToString(v); }
+
+std::string formatOption(const OptionDef& def, const Config& cfg)
+{
+    if (def.display == Display::Octal) {
+        if (const auto* member = std::get_if<int Config::*>(&def.member)) {
+            // Leading 0, so parseValue() reads it back as octal
+            std::ostringstream out;
+            out << std::showbase << std::oct << cfg.**member;
+            return out.str();
+        }
+    }
+    return std::visit([&](auto member) { return formatValue(cfg.*member); }, def.member);
+}
+
+const OptionDef* findOption(const std::string& key)
+{
+    for (const auto& def : options()) {
+        if (key == def.name) {
+            return &def;
+        }
+    }
+    return nullptr;
+}
+
+bool isBoolOption(const OptionDef& def)
+{
+    return std::holds_alternative<bool Config::*>(def.member);
+}
+
+} // namespace
+
+bool applyConfigOption(const std::string& key, const std::string& value, Config& cfg)
+{
+    // Accept both "recv_buffer_size" and "recv-buffer-size"
+    std::string name = key;
+    std::replace(name.begin(), name.end(), '-', '_');
+
+    const OptionDef* def = findOption(name);
+    if (def == nullptr) {
+        std::cerr << "Unknown option: " << key << std::endl;
+        return false;
+    }
+
+    bool ok = std::visit([&](auto member) { return parseValue(value, cfg.*member); }, def->member);
+    if (!ok) {
+        std::cerr << "Invalid value for " << name << ": '" << value << "'" << std::endl;
+    }
+    return ok;
+}
+
+bool loadConfigFile(const std::string& path, Config& cfg)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open config file: " << path << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    std::string line;
+    int line_number = 0;
+
+    while (std::getline(file, line)) {
+        line_number++;
+
+        // Strip comments (outside of quoted strings)
+        bool in_quotes = false;
+        for (size_t i = 0; i < line.size(); i++) {
+            if (line[i] == '"') {
+                in_quotes = !in_quotes;
+            } else if (line[i] == '#' && !in_quotes) {
+                line.erase(i);
+                break;
+            }
+        }
+
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << path << ":" << line_number << ": expected 'key = value'" << std::endl;
+            ok = false;
+            continue;
+        }
+
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        if (!applyConfigOption(key, value, cfg)) {
+            std::cerr << "  (" << path << ":" << line_number << ")" << std::endl;
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+ParseResult parseCommandLine(int argc, char* argv[], Config& cfg)
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    // Pass 1: help / config file, so command line options override the file
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "-h" || args[i] == "--help") {
+            printUsage(argv[0]);
+            return ParseResult::Exit;
+        }
+        if (args[i] == "--config" || args[i] == "-c") {
+            if (i + 1 >= args.size()) {
+                std::cerr << "Missing value for " << args[i] << std::endl;
+                return ParseResult::Error;
+            }
+            if (!loadConfigFile(args[i + 1], cfg)) {
+                return ParseResult::Error;
+            }
+        } else if (args[i].rfind("--config=", 0) == 0) {
+            if (!loadConfigFile(args[i].substr(9), cfg)) {
+                return ParseResult::Error;
+            }
+        }
+    }
+
+    // Pass 2: individual options
+    bool dump_config = false;
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+
+        if (arg == "--config" || arg == "-c") {
+            i++;
+            continue;
+        }
+        if (arg.rfind("--config=", 0) == 0) {
+            continue;
+        }
+        if (arg == "--dump-config") {
+            dump_config = true;
+            continue;
+        }
+        if (arg.rfind("--", 0) != 0) {
+            std::cerr << "Unexpected argument: " << arg << std::endl;
+            return ParseResult::Error;
+        }
+
+        std::string key = arg.substr(2);
+        std::string value;
+        size_t eq = key.find('=');
+
+        if (eq != std::string::npos) {
+            value = key.substr(eq + 1);
+            key = key.substr(0, eq);
+        } else {
+            std::string name = key;
+            std::replace(name.begin(), name.end(), '-', '_');
+            const OptionDef* def = findOption(name);
+
+            // Bare boolean flag: --verbose
+            bool next_is_value = i + 1 < args.size() && args[i + 1].rfind("--", 0) != 0;
+            if (def != nullptr && isBoolOption(*def) && !next_is_value) {
+                value = "true";
+            } else if (next_is_value) {
+                value = args[++i];
+            } else {
+                std::cerr << "Missing value for --" << key << std::endl;
+                return ParseResult::Error;
+            }
+        }
+
+        if (!applyConfigOption(key, value, cfg)) {
+            return ParseResult::Error;
+        }
+    }
+
+    if (dump_config) {
+        writeConfig(cfg, std::cout);
+        return ParseResult::Exit;
+    }
+
+    return ParseResult::Ok;
+}
+
+bool validateConfig(const Config& cfg)
+{
+    bool ok = true;
+    auto fail = [&](const std::string& msg) {
+        std::cerr << "Invalid configuration: " << msg << std::endl;
+        ok = false;
+    };
+
+    if (cfg.width < 4 || cfg.height <= 0) {
+        fail("width must be at least 4 and height positive");
+    } else if (cfg.width > INT16_MAX + 1 || cfg.height > INT16_MAX + 1) {
+        fail("width and height must fit event coordinates (<= 32768)");
+    }
+    if (cfg.camera_port <= 0 || cfg.camera_port > 65535) {
+        fail("camera_port must be 1-65535");
+    }
+    if (cfg.aedat_tcp_enabled && (cfg.aedat_port <= 0 || cfg.aedat_port > 65535)) {
+        fail("aedat_port must be 1-65535");
+    }
+    if (cfg.recv_buffer_size <= 0) {
+        fail("recv_buffer_size must be positive");
+    }
+    if (cfg.udp_packet_size <= 0 || cfg.udp_packet_size > 65535) {
+        fail("udp_packet_size must be 1-65535");
+    }
+    if (cfg.tcp_connections < 1 || cfg.tcp_connections > 16) {
+        fail("tcp_connections must be 1-16");
+    } else if (cfg.tcp_connections > 1) {
+        if (cfg.protocol != Protocol::TCP || !cfg.has_header || cfg.header_format != HeaderFormat::V1) {
+            fail("tcp_connections > 1 needs protocol = tcp and header_format = v1 (the counter orders frames)");
+        }
+        if (cfg.pipeline_async || cfg.stream_rows > 0) {
+            fail("tcp_connections > 1 receives on threads: not with pipeline_async or stream_rows");
+        }
+    }
+    if (cfg.tcp_zerocopy) {
+        if (cfg.protocol != Protocol::TCP) {
+            fail("tcp_zerocopy needs protocol = tcp");
+        }
+        if (cfg.tcp_connections > 1 || cfg.pipeline_async || cfg.stream_rows > 0) {
+            fail("tcp_zerocopy does not work with tcp_connections > 1, pipeline_async or stream_rows");
+        }
+    }
+    if (cfg.protocol == Protocol::File && cfg.input_file.empty()) {
+        fail("protocol = file needs input_file");
+    }
+    if (cfg.convert_chunk_frames < 0) {
+        fail("convert_chunk_frames must be >= 0");
+    } else if (cfg.convert_chunk_frames > 0 &&
+               (cfg.protocol != Protocol::File || cfg.output_file.empty() || cfg.has_header)) {
+        fail("convert_chunk_frames needs protocol = file, output_file and has_header = false");
+    }
+    if (cfg.output_segment_frames < 0) {
+        fail("output_segment_frames must be >= 0");
+    }
+    if (cfg.has_header && cfg.header_format == HeaderFormat::Length) {
+        if (cfg.header_size <= 0 || cfg.header_size > 4) {
+            fail("header_size must be 1-4 bytes");
+        }
+        if (cfg.protocol == Protocol::UDP) {
+            fail("UDP frame headers need header_format = v1");
+        }
+    }
+    if (cfg.frame_interval_us <= 0) {
+        fail("frame_interval_us must be positive");
+    }
+    if (cfg.kernel_bench_density < 0.0 || cfg.kernel_bench_density > 1.0) {
+        fail("kernel_bench_density must be between 0 and 1");
+    }
+    if (cfg.kernel_bench_ms <= 0 || cfg.kernel_reeval_interval < 0) {
+        fail("kernel_bench_ms must be positive and kernel_reeval_interval >= 0");
+    }
+    if (cfg.decode_threads < 0 || cfg.decode_threads > 256 || cfg.decode_band_rows < 0) {
+        fail("decode_threads must be 0-256 and decode_band_rows >= 0");
+    }
+    if (cfg.reorder_window <= 0 || cfg.reorder_max_wait_ms <= 0) {
+        fail("reorder_window and reorder_max_wait_ms must be positive");
+    }
+    if (cfg.decimation_event_budget <= 0 || cfg.decimation_backlog_frames <= 0) {
+        fail("decimation_event_budget and decimation_backlog_frames must be positive");
+    }
+    if (cfg.decimation_max_factor < 1 || cfg.decimation_max_factor > 64 ||
+        (cfg.decimation_max_factor & (cfg.decimation_max_factor - 1)) != 0) {
+        fail("decimation_max_factor must be a power of two from 1 to 64");
+    }
+    if (cfg.tile_active_threshold <= 0) {
+        fail("tile_active_threshold must be positive");
+    }
+    if (cfg.width > 0 && cfg.height > 0) {
+        TileSelection tiles;
+        if (!parseTileSelection(cfg.tile_subscription, TileGrid::tileCount(cfg.width, cfg.height), tiles)) {
+            fail("tile_subscription is invalid");
+        }
+    }
+    if (cfg.trace_ring_events <= 0 || cfg.trace_ring_events > (1 << 24)) {
+        fail("trace_ring_events must be between 1 and 16777216");
+    }
+    if (cfg.trace_latency_threshold_us < 0) {
+        fail("trace_latency_threshold_us must be >= 0");
+    }
+    if (cfg.shm_enabled && (cfg.shm_slot_count <= 0 || cfg.shm_slot_events <= 0)) {
+        fail("shm_slot_count and shm_slot_events must be positive");
+    }
+    if (cfg.shm_mode < 0 || (cfg.shm_mode & ~0777) != 0) {
+        fail("shm_mode must be permission bits between 0 and 0777");
+    }
+    if (cfg.pipeline_pool_size <= 0 || cfg.pipeline_queue_depth <= 0) {
+        fail("pipeline_pool_size and pipeline_queue_depth must be positive");
+    }
+    if (cfg.stream_rows < 0 || cfg.stream_rows > cfg.height) {
+        fail("stream_rows must be between 0 and height");
+    } else if (cfg.stream_rows > 0) {
+        if (cfg.protocol == Protocol::File) {
+            fail("stream_rows needs TCP or UDP input (file input is read whole)");
+        }
+        if (cfg.decode_threads > 0 || cfg.pipeline_soa || cfg.decimation_enabled || cfg.tile_activity) {
+            fail("stream_rows does not work with decode_threads, pipeline_soa, decimation_enabled or tile_activity");
+        }
+    }
+#ifndef __linux__
+    if (cfg.pipeline_async) {
+        fail("pipeline_async is only supported on Linux");
+    }
+    if (cfg.tcp_zerocopy) {
+        fail("tcp_zerocopy is only supported on Linux");
+    }
+#endif
+
+    return ok;
+}
+
+void writeConfig(const Config& cfg, std::ostream& out)
+{
+    out << "# DVBridge configuration" << std::endl;
+    for (const auto& def : options()) {
+        out << def.name << " = " << formatOption(def, cfg) << "    # " << def.help << std::endl;
+    }
+}
+
+void printUsage(const char* program)
+{
+    const Config defaults;
+
+    std::cout << "Usage: " << program << " [--config FILE] [--option=value ...]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  -c, --config FILE     Load settings from FILE (key = value lines)" << std::endl;
+    std::cout << "  --dump-config         Print the effective configuration and exit" << std::endl;
+    std::cout << "  -h, --help            Show this help" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options (default in brackets):" << std::endl;
+
+    for (const auto& def : options()) {
+        const std::string value = formatOption(def, defaults);
+        std::string flag = std::string("  --") + def.name;
+        if (flag.size() < 24) {
+            flag.resize(24, ' ');
+        } else {
+            flag += ' ';
+        }
+        std::cout << flag << def.help << " [" << value << "]" << std::endl;
+    }
+}
+
+} // namespace converter
@@ -0,0 +1,74 @@
+#include "cpu_features.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #include <immintrin.h>
+#endif
+#if defined(__aarch64__) && defined(__linux__)
+    #include <sys/auxv.h>
+    #ifndef HWCAP_CRC32
+        #define HWCAP_CRC32 (1 << 7)
+    #endif
+#endif
+
+namespace converter {
+
+namespace {
+
+CpuFeatures detect()
+{
+    CpuFeatures f;
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // libgcc also checks XCR0, so AVX features imply OS support
+    __builtin_cpu_init();
+    f.sse2 = __builtin_cpu_supports("sse2");
+    f.sse42 = __builtin_cpu_supports("sse4.2");
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.bmi2 = __builtin_cpu_supports("bmi2");
+    f.avx512f = __builtin_cpu_supports("avx512f");
+    f.avx512bw = __builtin_cpu_supports("avx512bw");
+    f.avx512vbmi2 = __builtin_cpu_supports("avx512vbmi2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int regs[4];
+    __cpuid(regs, 0);
+    const int max_leaf = regs[0];
+
+    __cpuid(regs, 1);
+    f.sse2 = (regs[3] & (1 << 26)) != 0;
+    f.sse42 = (regs[2] & (1 << 20)) != 0;
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool ymm_enabled = (xcr0 & 0x6) == 0x6;
+    const bool zmm_enabled = (xcr0 & 0xE6) == 0xE6;
+
+    if (max_leaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        f.avx2 = ymm_enabled && (regs[1] & (1 << 5)) != 0;
+        f.bmi2 = (regs[1] & (1 << 8)) != 0;
+        f.avx512f = zmm_enabled && (regs[1] & (1 << 16)) != 0;
+        f.avx512bw = zmm_enabled && (regs[1] & (1 << 30)) != 0;
+        f.avx512vbmi2 = zmm_enabled && (regs[2] & (1 << 6)) != 0;
+    }
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    f.neon = true;
+  #if defined(__linux__)
+    f.crc32 = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+  #else
+    // Optional in ARMv8.0, but every Apple and Windows on ARM CPU has it
+    f.crc32 = true;
+  #endif
+#endif
+
+    return f;
+}
+
+} // namespace
+
+const CpuFeatures& cpuFeatures()
+{
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+} // namespace converter
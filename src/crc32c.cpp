@@ -0,0 +1,275 @@
+#include "crc32c.hpp"
+#include "cpu_features.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <nmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <arm_acle.h>
+    #endif
+#endif
+
+// GCC/Clang: compile single functions for the CRC instructions without
+// raising the baseline of the whole binary (see unpack_kernels_x86.cpp)
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    #define DVBRIDGE_TARGET_SSE42 __attribute__((target("sse4.2")))
+#elif defined(__clang__) && defined(__aarch64__)
+    #define DVBRIDGE_TARGET_CRC __attribute__((target("crc")))
+#elif defined(__GNUC__) && defined(__aarch64__)
+    #define DVBRIDGE_TARGET_CRC __attribute__((target("+crc")))
+#endif
+#ifndef DVBRIDGE_TARGET_SSE42
+    #define DVBRIDGE_TARGET_SSE42
+#endif
+#ifndef DVBRIDGE_TARGET_CRC
+    #define DVBRIDGE_TARGET_CRC
+#endif
+
+namespace converter {
+
+namespace {
+
+constexpr uint32_t kPoly = 0x82F63B78;  // Reflected Castagnoli polynomial
+
+/**
+ * a x b modulo the polynomial (reflected: bit 31 is x^0)
+ */
+uint32_t multModP(uint32_t a, uint32_t b)
+{
+    uint32_t m = 1u << 31;
+    uint32_t p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) {
+                break;
+            }
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ kPoly : b >> 1;
+    }
+    return p;
+}
+
+/**
+ * x^(8 n) modulo the polynomial: the operator that appends n zero bytes
+ */
+uint32_t zerosOperator(size_t n)
+{
+    // x^(2^k) for k = 0..31, by repeated squaring
+    static const std::array<uint32_t, 32> x2n = []() {
+        std::array<uint32_t, 32> table{};
+        uint32_t p = 1u << 30;      // x^1
+        table[0] = p;
+        for (size_t k = 1; k < table.size(); k++) {
+            table[k] = p = multModP(p, p);
+        }
+        return table;
+    }();
+
+    uint32_t p = 1u << 31;          // x^0
+    size_t k = 3;                   // 8 bits per byte
+    while (n != 0) {
+        if (n & 1) {
+            p = multModP(x2n[k & 31], p);
+        }
+        n >>= 1;
+        k++;
+    }
+    return p;
+}
+
+/**
+ * Block sizes of the interleaved hardware loop and their shift operators
+ * Long blocks for the bulk of a frame, short ones for the tail.
+ */
+struct Stride {
+    size_t bytes;
+    uint32_t shift;     // zerosOperator(bytes)
+};
+
+const std::array<Stride, 2>& strides()
+{
+    static const std::array<Stride, 2> table = {{
+        {8192, zerosOperator(8192)},
+        {256, zerosOperator(256)},
+    }};
+    return table;
+}
+
+inline uint64_t load64(const uint8_t* p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Slicing-by-8 tables: table[k][b] = CRC of byte b followed by k zero bytes
+using Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+const Tables& tables()
+{
+    static const Tables t = []() {
+        Tables table{};
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t c = b;
+            for (int i = 0; i < 8; i++) {
+                c = (c & 1) ? (c >> 1) ^ kPoly : c >> 1;
+            }
+            table[0][b] = c;
+        }
+        for (uint32_t b = 0; b < 256; b++) {
+            for (size_t k = 1; k < table.size(); k++) {
+                const uint32_t prev = table[k - 1][b];
+                table[k][b] = (prev >> 8) ^ table[0][prev & 0xFF];
+            }
+        }
+        return table;
+    }();
+    return t;
+}
+
+uint32_t crc32cTable(const uint8_t* p, size_t n, uint32_t crc)
+{
+    const Tables& t = tables();
+    uint32_t c = ~crc;
+    // Little-endian word loads (all supported targets)
+    while (n >= 8) {
+        const uint64_t w = load64(p) ^ c;
+        c = t[7][w & 0xFF] ^ t[6][(w >> 8) & 0xFF] ^ t[5][(w >> 16) & 0xFF] ^ t[4][(w >> 24) & 0xFF] ^
+            t[3][(w >> 32) & 0xFF] ^ t[2][(w >> 40) & 0xFF] ^ t[1][(w >> 48) & 0xFF] ^ t[0][w >> 56];
+        p += 8;
+        n -= 8;
+    }
+    while (n-- > 0) {
+        c = t[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+    }
+    return ~c;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+DVBRIDGE_TARGET_SSE42 uint32_t crc32cSse42(const uint8_t* p, size_t n, uint32_t crc)
+{
+    uint64_t c = ~crc;
+    while (n > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+        c = _mm_crc32_u8(static_cast<uint32_t>(c), *p++);
+        n--;
+    }
+    // crc32 has a latency of 3 and a throughput of 1 per cycle: three
+    // independent streams over adjacent blocks, then shifted together
+    for (const Stride& s : strides()) {
+        while (n >= 3 * s.bytes) {
+            uint64_t c1 = 0;
+            uint64_t c2 = 0;
+            const uint8_t* end = p + s.bytes;
+            do {
+                c = _mm_crc32_u64(c, load64(p));
+                c1 = _mm_crc32_u64(c1, load64(p + s.bytes));
+                c2 = _mm_crc32_u64(c2, load64(p + 2 * s.bytes));
+                p += 8;
+            } while (p < end);
+            c = multModP(s.shift, static_cast<uint32_t>(c)) ^ static_cast<uint32_t>(c1);
+            c = multModP(s.shift, static_cast<uint32_t>(c)) ^ static_cast<uint32_t>(c2);
+            p += 2 * s.bytes;
+            n -= 3 * s.bytes;
+        }
+    }
+    while (n >= 8) {
+        c = _mm_crc32_u64(c, load64(p));
+        p += 8;
+        n -= 8;
+    }
+    while (n-- > 0) {
+        c = _mm_crc32_u8(static_cast<uint32_t>(c), *p++);
+    }
+    return ~static_cast<uint32_t>(c);
+}
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+DVBRIDGE_TARGET_CRC uint32_t crc32cArm(const uint8_t* p, size_t n, uint32_t crc)
+{
+    uint32_t c = ~crc;
+    while (n > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+        c = __crc32cb(c, *p++);
+        n--;
+    }
+    // Same three-stream interleave as on x86
+    for (const Stride& s : strides()) {
+        while (n >= 3 * s.bytes) {
+            uint32_t c1 = 0;
+            uint32_t c2 = 0;
+            const uint8_t* end = p + s.bytes;
+            do {
+                c = __crc32cd(c, load64(p));
+                c1 = __crc32cd(c1, load64(p + s.bytes));
+                c2 = __crc32cd(c2, load64(p + 2 * s.bytes));
+                p += 8;
+            } while (p < end);
+            c = multModP(s.shift, c) ^ c1;
+            c = multModP(s.shift, c) ^ c2;
+            p += 2 * s.bytes;
+            n -= 3 * s.bytes;
+        }
+    }
+    while (n >= 8) {
+        c = __crc32cd(c, load64(p));
+        p += 8;
+        n -= 8;
+    }
+    while (n-- > 0) {
+        c = __crc32cb(c, *p++);
+    }
+    return ~c;
+}
+
+#endif
+
+using Crc32cFn = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+
+struct Implementation {
+    Crc32cFn fn;
+    const char* name;
+};
+
+const Implementation& implementation()
+{
+    static const Implementation impl = []() -> Implementation {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (cpuFeatures().sse42) {
+            return {crc32cSse42, "sse4.2"};
+        }
+#elif defined(__aarch64__) || defined(_M_ARM64)
+        if (cpuFeatures().crc32) {
+            return {crc32cArm, "armv8"};
+        }
+#endif
+        return {crc32cTable, "table"};
+    }();
+    return impl;
+}
+
+} // namespace
+
+uint32_t crc32c(const uint8_t* data, size_t size, uint32_t crc)
+{
+    return implementation().fn(data, size, crc);
+}
+
+uint32_t crc32cCombine(uint32_t crc_a, uint32_t crc_b, size_t size_b)
+{
+    return multModP(zerosOperator(size_b), crc_a) ^ crc_b;
+}
+
+const char* crc32cImplementation()
+{
+    return implementation().name;
+}
+
+} // namespace converter
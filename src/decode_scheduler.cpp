@@ -0,0 +1,176 @@
+#include "decode_scheduler.hpp"
+#include "trace.hpp"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+    #include <csignal>
+    #include <pthread.h>
+#endif
+
+namespace converter {
+
+namespace {
+
+// Scheduler and worker index of the calling thread (set in workerLoop)
+thread_local const DecodeScheduler* tls_scheduler = nullptr;
+thread_local int tls_worker = -1;
+
+} // namespace
+
+DecodeScheduler::DecodeScheduler(const Config& cfg)
+    : next_worker_(0)
+    , queued_(0)
+    , sleepers_(0)
+    , stopping_(false)
+    , jobs_executed_(MetricsRegistry::global().counter(metricName(cfg, "decode_jobs")))
+    , jobs_stolen_(MetricsRegistry::global().counter(metricName(cfg, "decode_steals")))
+{
+    size_t count = cfg.decode_threads > 0 ? static_cast<size_t>(cfg.decode_threads)
+                                          : std::thread::hardware_concurrency();
+    if (count == 0) {
+        count = 1;
+    }
+
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+
+#ifndef _WIN32
+    // Workers leave SIGINT/SIGTERM to the application's threads
+    sigset_t blocked, previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+#endif
+    for (size_t i = 0; i < count; i++) {
+        workers_[i]->thread = std::thread(&DecodeScheduler::workerLoop, this, i);
+    }
+#ifndef _WIN32
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#endif
+
+    if (cfg.verbose) {
+        std::cout << "DecodeScheduler: " << count << " worker threads" << std::endl;
+    }
+}
+
+DecodeScheduler::~DecodeScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    sleep_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+int DecodeScheduler::currentWorker() const
+{
+    return tls_scheduler == this ? tls_worker : -1;
+}
+
+void DecodeScheduler::submit(Job job)
+{
+    const int self = currentWorker();
+    const size_t index = self >= 0 ? static_cast<size_t>(self)
+                                   : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    push(index, std::move(job));
+}
+
+void DecodeScheduler::push(size_t index, Job job)
+{
+    // Counted before it is visible, so a worker never sleeps on a queued
+    // job (at worst one searches a moment too early)
+    queued_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->jobs.push_back(std::move(job));
+    }
+    // A worker counts itself as a sleeper before it checks queued_, so
+    // either it sees this job or this sees the sleeper
+    if (sleepers_.load() > 0) {
+        {
+            // Until it really waits, or the notify would be lost
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        sleep_cv_.notify_one();
+    }
+}
+
+bool DecodeScheduler::takeJob(size_t index, Job& job)
+{
+    {
+        // Own deque: newest first (its data is most likely still in cache)
+        Worker& own = *workers_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest job, starting with the next worker so that thieves
+    // spread over victims
+    const size_t count = workers_.size();
+    for (size_t n = 1; n < count; n++) {
+        Worker& victim = *workers_[(index + n) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            jobs_stolen_.add();
+            return true;
+        }
+    }
+    return false;
+}
+
+void DecodeScheduler::workerLoop(size_t index)
+{
+    tls_scheduler = this;
+    tls_worker = static_cast<int>(index);
+    TraceRecorder::global().setThreadName(("decode-" + std::to_string(index)).c_str());
+
+    Job job;
+    while (true) {
+        if (takeJob(index, job)) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            try {
+                job();
+            } catch (const std::exception& e) {
+                std::cerr << "DecodeScheduler: job failed: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "DecodeScheduler: job failed" << std::endl;
+            }
+            job = nullptr;
+            jobs_executed_.add();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleepers_.fetch_add(1);
+        sleep_cv_.wait(lock, [this]() {
+            return queued_.load() > 0 || stopping_;
+        });
+        sleepers_.fetch_sub(1);
+        if (stopping_ && queued_.load(std::memory_order_relaxed) <= 0) {
+            break;
+        }
+    }
+
+    tls_scheduler = nullptr;
+    tls_worker = -1;
+}
+
+} // namespace converter
@@ -0,0 +1,50 @@
+#include "event_limiter.hpp"
+
+#include <algorithm>
+
+namespace converter {
+
+EventLimiter::EventLimiter(const Config& cfg)
+    : config_(cfg)
+    , pressure_(0)
+    , factor_(1)
+    , factor_gauge_(MetricsRegistry::global().gauge(metricName(cfg, "decimation_factor")))
+    , frames_decimated_(MetricsRegistry::global().counter(metricName(cfg, "decimation_frames")))
+    , events_dropped_(MetricsRegistry::global().counter(metricName(cfg, "decimation_events_dropped")))
+{
+    factor_gauge_.set(1);
+}
+
+int EventLimiter::choose(size_t frame_events, size_t backlog)
+{
+    const int max_factor = std::max(1, config_.decimation_max_factor);
+
+    // Backlog: escalate one step per frame while delivery is behind,
+    // relax one step per frame once it has caught up
+    int max_pressure = 0;
+    while ((1 << max_pressure) < max_factor) {
+        max_pressure++;
+    }
+    if (backlog >= static_cast<size_t>(config_.decimation_backlog_frames)) {
+        pressure_ = std::min(pressure_ + 1, max_pressure);
+    } else if (backlog == 0 && pressure_ > 0) {
+        pressure_--;
+    }
+
+    // Event budget: smallest power of two that fits this frame
+    int factor = 1;
+    const size_t budget = static_cast<size_t>(std::max(1, config_.decimation_event_budget));
+    while (factor < max_factor && frame_events > budget * static_cast<size_t>(factor)) {
+        factor <<= 1;
+    }
+
+    factor_ = std::min(factor << pressure_, max_factor);
+    factor_gauge_.set(factor_);
+    if (factor_ > 1) {
+        frames_decimated_.add();
+        events_dropped_.add(frame_events - frame_events / static_cast<size_t>(factor_));
+    }
+    return factor_;
+}
+
+} // namespace converter
@@ -0,0 +1,240 @@
+#include "event_loop.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace converter {
+
+EventLoop::EventLoop()
+    : epoll_fd_(-1)
+    , wake_fd_(-1)
+    , stop_requested_(false)
+    , loop_thread_(std::thread::id())
+    , timer_sequence_(0)
+{
+}
+
+EventLoop::~EventLoop()
+{
+    // Suspended tasks are destroyed here, before the fds they wait on
+    tasks_.clear();
+    spawned_.clear();
+
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+}
+
+bool EventLoop::open()
+{
+    if (epoll_fd_ >= 0) {
+        return true;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        std::cerr << "EventLoop: epoll_create1 failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        std::cerr << "EventLoop: eventfd failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // data.ptr == nullptr marks the wake-up fd; I/O waiters store their awaiter
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) < 0) {
+        std::cerr << "EventLoop: failed to watch eventfd: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::spawn(Task<void> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        spawned_.push_back(std::move(task));
+    }
+    wake();
+}
+
+void EventLoop::post(std::function<void()> fn)
+{
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        posted_.push_back(std::move(fn));
+    }
+    wake();
+}
+
+void EventLoop::stop()
+{
+    stop_requested_ = true;
+    wake();
+}
+
+void EventLoop::wake()
+{
+    if (wake_fd_ >= 0) {
+        const uint64_t one = 1;
+        // EAGAIN only if the counter is saturated, which still wakes run()
+        [[maybe_unused]] ssize_t n = write(wake_fd_, &one, sizeof(one));
+    }
+}
+
+EventLoop::IoAwaiter EventLoop::readable(int fd)
+{
+    return IoAwaiter(*this, fd, EPOLLIN | EPOLLRDHUP);
+}
+
+EventLoop::IoAwaiter EventLoop::writable(int fd)
+{
+    return IoAwaiter(*this, fd, EPOLLOUT);
+}
+
+bool EventLoop::IoAwaiter::await_suspend(std::coroutine_handle<> h)
+{
+    handle_ = h;
+    // Not suspending (ok_ stays false) if the fd cannot be watched
+    return loop_.arm(*this);
+}
+
+bool EventLoop::arm(IoAwaiter& awaiter)
+{
+    // One-shot: the registration goes quiet after firing and is re-armed by
+    // the next await, so a stale awaiter pointer is never delivered
+    epoll_event ev{};
+    ev.events = awaiter.events_ | EPOLLONESHOT;
+    ev.data.ptr = &awaiter;
+
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, awaiter.fd_, &ev) == 0) {
+        return true;
+    }
+    if (errno == ENOENT && epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, awaiter.fd_, &ev) == 0) {
+        return true;
+    }
+    std::cerr << "EventLoop: cannot watch fd " << awaiter.fd_ << ": " << std::strerror(errno) << std::endl;
+    return false;
+}
+
+void EventLoop::TimerAwaiter::await_suspend(std::coroutine_handle<> h)
+{
+    loop_.timers_.push(Timer{deadline_, loop_.timer_sequence_++, h});
+}
+
+int EventLoop::nextTimeoutMs() const
+{
+    if (timers_.empty()) {
+        return -1;
+    }
+    const auto wait = timers_.top().deadline - Clock::now();
+    if (wait <= Clock::duration::zero()) {
+        return 0;
+    }
+    // Round up so the timer is due when epoll_wait returns
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(wait).count());
+}
+
+void EventLoop::runPosted()
+{
+    std::vector<std::function<void()>> posted;
+    std::vector<Task<void>> spawned;
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        posted.swap(posted_);
+        spawned.swap(spawned_);
+    }
+
+    for (auto& task : spawned) {
+        auto handle = task.handle();
+        tasks_.push_back(std::move(task));
+        handle.resume();
+    }
+    for (auto& fn : posted) {
+        fn();
+    }
+}
+
+void EventLoop::reapFinished()
+{
+    for (size_t i = 0; i < tasks_.size();) {
+        if (!tasks_[i].done()) {
+            i++;
+            continue;
+        }
+        try {
+            tasks_[i].handle().promise().result();
+        } catch (const std::exception& e) {
+            std::cerr << "EventLoop: task failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "EventLoop: task failed" << std::endl;
+        }
+        tasks_[i] = std::move(tasks_.back());
+        tasks_.pop_back();
+    }
+}
+
+void EventLoop::run()
+{
+    if (epoll_fd_ < 0 && !open()) {
+        return;
+    }
+    loop_thread_ = std::this_thread::get_id();
+
+    constexpr int kMaxEvents = 64;
+    epoll_event events[kMaxEvents];
+
+    runPosted();
+    reapFinished();
+
+    while (!stop_requested_) {
+        const int n = epoll_wait(epoll_fd_, events, kMaxEvents, nextTimeoutMs());
+        if (n < 0 && errno != EINTR) {
+            std::cerr << "EventLoop: epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.ptr == nullptr) {
+                uint64_t count;
+                [[maybe_unused]] ssize_t r = read(wake_fd_, &count, sizeof(count));
+                continue;
+            }
+            auto* awaiter = static_cast<IoAwaiter*>(events[i].data.ptr);
+            awaiter->ok_ = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+            awaiter->handle_.resume();
+        }
+
+        // Due timers; ones added by resumed tasks wait for the next round
+        const auto now = Clock::now();
+        std::vector<std::coroutine_handle<>> due;
+        while (!timers_.empty() && timers_.top().deadline <= now) {
+            due.push_back(timers_.top().handle);
+            timers_.pop();
+        }
+        for (auto h : due) {
+            h.resume();
+        }
+
+        runPosted();
+        reapFinished();
+    }
+
+    stop_requested_ = false;
+    loop_thread_ = std::thread::id();
+}
+
+} // namespace converter
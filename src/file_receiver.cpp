@@ -0,0 +1,154 @@
+#include "file_receiver.hpp"
+#include <iostream>
+#include <cstring>
+
+namespace converter {
+
+namespace {
+
+// Consumed pages are dropped from the mapping in steps of this size
+constexpr uint64_t kReleaseChunk = 64ull * 1024 * 1024;
+
+} // namespace
+
+FileReceiver::FileReceiver(const Config& cfg)
+    : config_(cfg)
+    , offset_(0)
+    , released_(0)
+    , at_end_(false)
+    , interrupted_(false)
+    , header_(cfg)
+    , bytes_received_(MetricsRegistry::global().counter(metricName(cfg, "rx_bytes")))
+    , frames_received_(MetricsRegistry::global().counter(metricName(cfg, "rx_frames")))
+{
+}
+
+FileReceiver::~FileReceiver()
+{
+    disconnect();
+}
+
+bool FileReceiver::connect()
+{
+    offset_ = 0;
+    released_ = 0;
+    at_end_ = false;
+    interrupted_ = false;
+    header_.reset();
+
+    if (config_.input_file.empty()) {
+        std::cerr << "No input_file set for protocol = file" << std::endl;
+        return false;
+    }
+    if (!file_.open(config_.input_file)) {
+        return false;
+    }
+    // Read-ahead well past the default window; frames are consumed
+    // strictly in order
+    file_.advise(0, file_.size(), MappedFile::Access::Sequential);
+
+    std::cout << "Reading " << config_.input_file << " (" << file_.size() << " bytes, ~"
+              << file_.size() / (static_cast<uint64_t>(getFrameSize()) + header_.size())
+              << " frames)" << std::endl;
+    return true;
+}
+
+void FileReceiver::disconnect()
+{
+    file_.close();
+}
+
+void FileReceiver::interrupt()
+{
+    interrupted_ = true;
+}
+
+bool FileReceiver::isConnected() const
+{
+    return file_.isOpen();
+}
+
+int FileReceiver::getFrameSize() const
+{
+    return config_.frame_size();
+}
+
+bool FileReceiver::read(uint8_t* out, size_t size)
+{
+    if (file_.size() - offset_ < size) {
+        return false;
+    }
+    std::memcpy(out, file_.data() + offset_, size);
+    offset_ += size;
+    return true;
+}
+
+void FileReceiver::releaseConsumed()
+{
+    if (offset_ - released_ < kReleaseChunk) {
+        return;
+    }
+    // The pages stay in the page cache; only this mapping lets go of them
+    file_.advise(released_, offset_ - released_, MappedFile::Access::DontNeed);
+    released_ = offset_;
+}
+
+bool FileReceiver::receiveFrame(std::vector<uint8_t>& buffer)
+{
+    if (!isConnected() || interrupted_) {
+        return false;
+    }
+
+    size_t frame_size = static_cast<size_t>(getFrameSize());
+    if (header_.size() > 0) {
+        uint8_t header[kMaxFrameHeaderSize];
+        if (!read(header, header_.size())) {
+            at_end_ = true;
+            return false;
+        }
+        if (!header_.parse(header, frame_size)) {
+            // Corrupt capture: nothing after this point can be trusted
+            std::cerr << "Invalid frame header at offset " << offset_ - header_.size() << " of "
+                      << config_.input_file << ", stopping" << std::endl;
+            at_end_ = true;
+            return false;
+        }
+    }
+
+    buffer.resize(frame_size);
+    if (!read(buffer.data(), frame_size)) {
+        if (offset_ < file_.size()) {
+            std::cerr << "Ignoring " << file_.size() - offset_ << " trailing bytes of " << config_.input_file
+                      << " (incomplete frame)" << std::endl;
+        }
+        at_end_ = true;
+        return false;
+    }
+    if (header_.trailerSize() > 0) {
+        uint8_t trailer[kFrameTrailerSize];
+        if (!read(trailer, header_.trailerSize())) {
+            at_end_ = true;
+            return false;
+        }
+        header_.parseTrailer(trailer);
+    }
+    releaseConsumed();
+
+    bytes_received_.add(frame_size);
+    frames_received_.add();
+    return true;
+}
+
+#ifdef __linux__
+Task<bool> FileReceiver::connectAsync(EventLoop&)
+{
+    co_return connect();
+}
+
+Task<bool> FileReceiver::receiveFrameAsync(EventLoop&, std::vector<uint8_t>& buffer)
+{
+    co_return receiveFrame(buffer);
+}
+#endif
+
+} // namespace converter
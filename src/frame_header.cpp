@@ -0,0 +1,227 @@
+#include "frame_header.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace converter {
+
+namespace {
+
+// Same sanity limit as the length-only header
+constexpr uint32_t kMaxPayload = 100000000;
+
+uint64_t loadLE(const uint8_t* data, size_t size)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < size; i++) {
+        v |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return v;
+}
+
+void storeLE(uint64_t v, uint8_t* out, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        out[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+} // namespace
+
+bool decodeFrameHeader(const uint8_t* data, FrameHeader& header)
+{
+    if (loadLE(data, 4) != kFrameHeaderMagic || data[4] != kFrameHeaderVersion) {
+        return false;
+    }
+    header.version = data[4];
+    header.format = data[5];
+    header.flags = static_cast<uint16_t>(loadLE(data + 6, 2));
+    header.counter = static_cast<uint32_t>(loadLE(data + 8, 4));
+    header.length = static_cast<uint32_t>(loadLE(data + 12, 4));
+    header.timestamp = static_cast<int64_t>(loadLE(data + 16, 8));
+    return true;
+}
+
+void encodeFrameHeader(const FrameHeader& header, uint8_t* out)
+{
+    storeLE(kFrameHeaderMagic, out, 4);
+    out[4] = kFrameHeaderVersion;
+    out[5] = header.format;
+    storeLE(header.flags, out + 6, 2);
+    storeLE(header.counter, out + 8, 4);
+    storeLE(header.length, out + 12, 4);
+    storeLE(static_cast<uint64_t>(header.timestamp), out + 16, 8);
+}
+
+FrameHeaderParser::FrameHeaderParser(const Config& cfg, bool count_gaps)
+    : config_(cfg)
+    , size_(!cfg.has_header ? 0
+            : cfg.header_format == HeaderFormat::V1 ? kFrameHeaderSize
+            : static_cast<size_t>(cfg.header_size))
+    , versioned_(cfg.has_header && cfg.header_format == HeaderFormat::V1)
+    , count_gaps_(count_gaps)
+    , timestamp_(-1)
+    , counter_(0)
+    , flags_(0)
+    , trailer_size_(0)
+    , next_counter_(0)
+    , counter_valid_(false)
+    , frames_lost_(MetricsRegistry::global().counter(metricName(cfg, "rx_frames_lost")))
+    , header_errors_(MetricsRegistry::global().counter(metricName(cfg, "rx_header_errors")))
+{
+}
+
+FrameHeaderParser& FrameHeaderParser::operator=(const FrameHeaderParser& other)
+{
+    timestamp_ = other.timestamp_;
+    counter_ = other.counter_;
+    flags_ = other.flags_;
+    trailer_size_ = other.trailer_size_;
+    crc_ = other.crc_;
+    next_counter_ = other.next_counter_;
+    counter_valid_ = other.counter_valid_;
+    frames_lost_ = other.frames_lost_;
+    header_errors_ = other.header_errors_;
+    return *this;
+}
+
+void FrameHeaderParser::reset()
+{
+    counter_valid_ = false;
+    timestamp_ = -1;
+    trailer_size_ = 0;
+    crc_.reset();
+}
+
+void FrameHeaderParser::parseTrailer(const uint8_t* data)
+{
+    crc_ = static_cast<uint32_t>(loadLE(data, kFrameTrailerSize));
+}
+
+bool FrameHeaderParser::parse(const uint8_t* data, size_t& payload_size)
+{
+    payload_size = static_cast<size_t>(config_.frame_size());
+    if (size_ == 0) {
+        return true;
+    }
+
+    if (!versioned_) {
+        // Length only; an implausible value falls back to the configured size
+        const uint64_t length = loadLE(data, size_);
+        if (length > 0 && length < kMaxPayload) {
+            payload_size = static_cast<size_t>(length);
+        }
+        if (config_.verbose) {
+            std::cout << "Frame header: size = " << payload_size << " bytes" << std::endl;
+        }
+        return true;
+    }
+
+    FrameHeader header;
+    if (!decodeFrameHeader(data, header) || header.format != static_cast<uint8_t>(FrameFormat::Packed2Bit) ||
+        header.length == 0 || header.length >= kMaxPayload) {
+        header_errors_.add();
+        counter_valid_ = false;
+        return false;
+    }
+    payload_size = header.length;
+    timestamp_ = header.timestamp;
+    counter_ = header.counter;
+    flags_ = header.flags;
+    trailer_size_ = (header.flags & FrameFlags::Crc32c) ? kFrameTrailerSize : 0;
+    crc_.reset();
+
+    // Wrapping difference; a counter going backwards (camera restarted
+    // without setting CounterReset) is not counted as a gap
+    const uint32_t missing = header.counter - next_counter_;
+    if (count_gaps_ && counter_valid_ && missing != 0 && missing < 0x80000000u && !(header.flags & FrameFlags::CounterReset)) {
+        frames_lost_.add(missing);
+        if (config_.verbose) {
+            std::cout << "Frame counter " << header.counter << ": " << missing << " frames lost" << std::endl;
+        }
+    }
+    next_counter_ = header.counter + 1;
+    counter_valid_ = true;
+
+    if (config_.verbose) {
+        std::cout << "Frame header: counter = " << header.counter << ", timestamp = " << header.timestamp
+                  << " us, size = " << payload_size << " bytes" << std::endl;
+    }
+    return true;
+}
+
+FrameReader::FrameReader(FrameHeaderParser& header, std::vector<uint8_t>& buffer, size_t frame_size,
+                         const PayloadHandler* handler, size_t chunk)
+    : header_(header)
+    , buffer_(buffer)
+    , handler_(handler && *handler ? handler : nullptr)
+    , chunk_(std::max<size_t>(chunk, 1))
+    , part_(Part::Header)
+    , payload_size_(frame_size)
+    , payload_received_(0)
+{
+    if (header_.size() == 0) {
+        startPayload();
+    }
+}
+
+void FrameReader::startPayload()
+{
+    buffer_.resize(payload_size_);
+    payload_received_ = 0;
+    part_ = payload_size_ > 0 ? Part::Payload : header_.trailerSize() > 0 ? Part::Trailer : Part::Done;
+}
+
+bool FrameReader::next(Step& step)
+{
+    step.part = part_;
+    switch (part_) {
+        case Part::Header:
+            step.data = head_;
+            step.size = header_.size();
+            return true;
+        case Part::Payload:
+            step.data = buffer_.data() + payload_received_;
+            step.size = payload_size_ - payload_received_;
+            if (handler_) {
+                step.size = std::min(step.size, chunk_);
+            }
+            return true;
+        case Part::Trailer:
+            step.data = trailer_;
+            step.size = header_.trailerSize();
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool FrameReader::received(const Step& step)
+{
+    switch (step.part) {
+        case Part::Header:
+            if (!header_.parse(head_, payload_size_)) {
+                return false;
+            }
+            startPayload();
+            break;
+        case Part::Payload:
+            payload_received_ += step.size;
+            if (handler_) {
+                (*handler_)(buffer_.data(), payload_size_, payload_received_);
+            }
+            if (payload_received_ == payload_size_) {
+                part_ = header_.trailerSize() > 0 ? Part::Trailer : Part::Done;
+            }
+            break;
+        case Part::Trailer:
+            header_.parseTrailer(trailer_);
+            part_ = Part::Done;
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+} // namespace converter
@@ -0,0 +1,268 @@
+#include "frame_packer.hpp"
+#include "cpu_features.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define DVBRIDGE_TARGET_AVX2 __attribute__((target("avx2")))
+    #else
+        #define DVBRIDGE_TARGET_AVX2
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #ifdef _MSC_VER
+        #include <arm64_neon.h>
+    #else
+        #include <arm_neon.h>
+    #endif
+#endif
+
+namespace converter {
+
+namespace {
+
+inline uint8_t packFour(const uint8_t* c)
+{
+    return static_cast<uint8_t>((c[0] << 6) | (c[1] << 4) | (c[2] << 2) | c[3]);
+}
+
+/**
+ * Reference: 4 codes per output byte
+ */
+void packPlaneScalar(const uint8_t* codes, size_t pixels, uint8_t* out)
+{
+    const size_t bytes = (pixels + 3) / 4;
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = packFour(codes + i * 4);
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+/**
+ * Each 32-bit lane holds 4 codes (c0 in the low byte); move them to
+ * c0<<6 | c1<<4 | c2<<2 | c3 in the low byte of the lane
+ */
+inline __m128i packLanes(__m128i v)
+{
+    const __m128i b0 = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x03)), 6);
+    const __m128i b1 = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi32(0x30));
+    const __m128i b2 = _mm_and_si128(_mm_srli_epi32(v, 14), _mm_set1_epi32(0x0C));
+    const __m128i b3 = _mm_srli_epi32(v, 24);
+    return _mm_or_si128(_mm_or_si128(b0, b1), _mm_or_si128(b2, b3));
+}
+
+/**
+ * SSE2: 64 codes -> 16 bytes per iteration
+ */
+void packPlaneSse2(const uint8_t* codes, size_t pixels, uint8_t* out)
+{
+    const size_t bytes = (pixels + 3) / 4;
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        const uint8_t* c = codes + i * 4;
+        const __m128i a = packLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c)));
+        const __m128i b = packLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c + 16)));
+        const __m128i d = packLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c + 32)));
+        const __m128i e = packLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c + 48)));
+        // Lanes are < 256: saturating packs keep the values
+        const __m128i ab = _mm_packs_epi32(a, b);
+        const __m128i de = _mm_packs_epi32(d, e);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(ab, de));
+    }
+    for (; i < bytes; i++) {
+        out[i] = packFour(codes + i * 4);
+    }
+}
+
+DVBRIDGE_TARGET_AVX2
+inline __m256i packLanesAvx2(__m256i v)
+{
+    const __m256i b0 = _mm256_slli_epi32(_mm256_and_si256(v, _mm256_set1_epi32(0x03)), 6);
+    const __m256i b1 = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi32(0x30));
+    const __m256i b2 = _mm256_and_si256(_mm256_srli_epi32(v, 14), _mm256_set1_epi32(0x0C));
+    const __m256i b3 = _mm256_srli_epi32(v, 24);
+    return _mm256_or_si256(_mm256_or_si256(b0, b1), _mm256_or_si256(b2, b3));
+}
+
+/**
+ * AVX2: 128 codes -> 32 bytes per iteration
+ */
+DVBRIDGE_TARGET_AVX2
+void packPlaneAvx2(const uint8_t* codes, size_t pixels, uint8_t* out)
+{
+    const size_t bytes = (pixels + 3) / 4;
+    // The 256-bit packs work per 128-bit half; this restores dword order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        const uint8_t* c = codes + i * 4;
+        const __m256i a = packLanesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c)));
+        const __m256i b = packLanesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 32)));
+        const __m256i d = packLanesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 64)));
+        const __m256i e = packLanesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + 96)));
+        const __m256i ab = _mm256_packs_epi32(a, b);
+        const __m256i de = _mm256_packs_epi32(d, e);
+        const __m256i packed = _mm256_packus_epi16(ab, de);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permutevar8x32_epi32(packed, order));
+    }
+    for (; i < bytes; i++) {
+        out[i] = packFour(codes + i * 4);
+    }
+}
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+/**
+ * NEON: de-interleaving load splits 64 codes into c0..c3 vectors
+ */
+void packPlaneNeon(const uint8_t* codes, size_t pixels, uint8_t* out)
+{
+    const size_t bytes = (pixels + 3) / 4;
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        const uint8x16x4_t c = vld4q_u8(codes + i * 4);
+        uint8x16_t v = vshlq_n_u8(c.val[0], 6);
+        v = vorrq_u8(v, vshlq_n_u8(c.val[1], 4));
+        v = vorrq_u8(v, vshlq_n_u8(c.val[2], 2));
+        v = vorrq_u8(v, c.val[3]);
+        vst1q_u8(out + i, v);
+    }
+    for (; i < bytes; i++) {
+        out[i] = packFour(codes + i * 4);
+    }
+}
+
+#endif
+
+} // namespace
+
+const std::vector<PackKernelInfo>& availablePackKernels()
+{
+    static const std::vector<PackKernelInfo> kernels = []() {
+        std::vector<PackKernelInfo> k;
+        k.push_back({"scalar", packPlaneScalar});
+#if defined(__x86_64__) || defined(_M_X64)
+        k.push_back({"sse2", packPlaneSse2});
+        if (cpuFeatures().avx2) {
+            k.push_back({"avx2", packPlaneAvx2});
+        }
+#elif defined(__aarch64__) || defined(_M_ARM64)
+        k.push_back({"neon", packPlaneNeon});
+#endif
+        return k;
+    }();
+    return kernels;
+}
+
+FramePacker::FramePacker(const Config& cfg)
+    : config_(cfg)
+    , plane_kernel_(availablePackKernels().back())
+{
+}
+
+void FramePacker::setKernel(const PackKernelInfo& kernel)
+{
+    plane_kernel_ = kernel;
+}
+
+int FramePacker::getFrameSize() const
+{
+    return config_.frame_size();
+}
+
+const char* FramePacker::getKernelName() const
+{
+    return plane_kernel_.name;
+}
+
+template <typename Source>
+size_t FramePacker::packEvents(size_t count, const Source& source, std::vector<uint8_t>& frame)
+{
+    const int width = config_.width;
+    const int height = config_.height;
+    const size_t pixels = static_cast<size_t>(config_.total_pixels());
+    frame.resize(static_cast<size_t>(config_.frame_size()));
+
+    int x = 0;
+    int y = 0;
+    bool positive = false;
+    size_t packed = 0;
+
+    if (count * kBulkDivisor >= pixels) {
+        // Bulk: codes into the plane (zero past the last pixel), then SIMD pack
+        plane_.assign((pixels + 63) & ~size_t(63), 0);
+        uint8_t* plane = plane_.data();
+        for (size_t i = 0; i < count; i++) {
+            source(i, x, y, positive);
+            if (x < 0 || x >= width || y < 0 || y >= height) {
+                continue;
+            }
+            plane[static_cast<size_t>(y) * width + x] = positive ? 1 : 2;
+            packed++;
+        }
+        plane_kernel_.fn(plane, pixels, frame.data());
+        return packed;
+    }
+
+    // Sparse: overwrite the 2 bits of each event's pixel
+    std::fill(frame.begin(), frame.end(), 0);
+    uint8_t* out = frame.data();
+    for (size_t i = 0; i < count; i++) {
+        source(i, x, y, positive);
+        if (x < 0 || x >= width || y < 0 || y >= height) {
+            continue;
+        }
+        const size_t pixel = static_cast<size_t>(y) * width + x;
+        const unsigned shift = 6 - 2 * (pixel & 3);
+        const unsigned code = positive ? 1u : 2u;
+        out[pixel >> 2] = static_cast<uint8_t>((out[pixel >> 2] & ~(3u << shift)) | (code << shift));
+        packed++;
+    }
+    return packed;
+}
+
+size_t FramePacker::pack(const dv::EventStore& events, std::vector<uint8_t>& frame)
+{
+    // EventStore is split into packets internally; walk it by iterator
+    auto it = events.begin();
+    return packEvents(events.size(), [&it](size_t, int& x, int& y, bool& positive) {
+        x = it->x();
+        y = it->y();
+        positive = it->polarity();
+        ++it;
+    }, frame);
+}
+
+size_t FramePacker::pack(const dv::Event* events, size_t count, std::vector<uint8_t>& frame)
+{
+    return packEvents(count, [events](size_t i, int& x, int& y, bool& positive) {
+        x = events[i].x();
+        y = events[i].y();
+        positive = events[i].polarity();
+    }, frame);
+}
+
+size_t FramePacker::pack(const EventFrameSoA& events, std::vector<uint8_t>& frame)
+{
+    const int16_t* xs = events.x.data();
+    const int16_t* ys = events.y.data();
+    const uint64_t* polarity = events.polarity.data();
+    return packEvents(events.count, [=](size_t i, int& x, int& y, bool& positive) {
+        x = xs[i];
+        y = ys[i];
+        positive = polarityAt(polarity, i);
+    }, frame);
+}
+
+size_t FramePacker::pack(const int16_t* x, const int16_t* y, const uint8_t* polarity, size_t count,
+                         std::vector<uint8_t>& frame)
+{
+    return packEvents(count, [=](size_t i, int& ex, int& ey, bool& positive) {
+        ex = x[i];
+        ey = y[i];
+        positive = polarity[i] != 0;
+    }, frame);
+}
+
+} // namespace converter
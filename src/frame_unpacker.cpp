@@ -1,18 +1,47 @@
 #include "frame_unpacker.hpp"
+#include <algorithm>
+#include <bit>
 #include <iostream>
 #include <stdexcept>
 
 namespace converter {
 
-FrameUnpacker::FrameUnpacker(const Config& cfg)
+FrameUnpacker::FrameUnpacker(const Config& cfg, std::shared_ptr<KernelDispatcher> dispatcher)
     : config_(cfg)
+    , dispatcher_(std::move(dispatcher))
+    , soa_kernel_(selectSoaKernel(cfg.unpack_kernel))
+    , decimation_(1)
+    , timestamp_(-1)
+    , table_width_(0)
+    , table_height_(0)
+    , frames_decoded_(MetricsRegistry::global().counter(metricName(cfg, "decode_frames")))
+    , events_decoded_(MetricsRegistry::global().counter(metricName(cfg, "decode_events")))
 {
-    // Pre-compute base pixel index for each byte
+    if (!dispatcher_) {
+        dispatcher_ = std::make_shared<KernelDispatcher>(config_);
+        dispatcher_->initialize();
+    }
+    rebuildTables();
+}
+
+void FrameUnpacker::rebuildTables()
+{
+    // Pre-compute (x, y) of the first pixel of each byte
     int frame_size = config_.frame_size();
-    byte_to_base_pixel_.resize(frame_size);
-    
-    for (int byte_idx = 0; byte_idx < frame_size; byte_idx++) {
-        byte_to_base_pixel_[byte_idx] = byte_idx * 4;  // 4 pixels per byte
+    buildCoordinateTables(config_.width, frame_size, byte_x_, byte_y_);
+
+    // Worst case: every pixel carries an event
+    scratch_.resize(static_cast<size_t>(frame_size) * 4);
+
+    for (auto& mask : decimation_masks_) {
+        mask.clear();
+    }
+
+    table_width_ = config_.width;
+    table_height_ = config_.height;
+
+    if (config_.verbose) {
+        std::cout << "FrameUnpacker: tables built for " << table_width_ << " x " << table_height_ << std::endl;
     }
 }
 
@@ -26,6 +55,11 @@ cv::Size FrameUnpacker::getResolution() const
     return cv::Size(config_.width, config_.height);
 }
 
+const char* FrameUnpacker::getKernelName() const
+{
+    return dispatcher_->current().name;
+}
+
 size_t FrameUnpacker::unpack(
     const std::vector<uint8_t>& frame_data,
     uint64_t frame_number,
@@ -34,82 +68,257 @@ size_t FrameUnpacker::unpack(
     return unpack(frame_data.data(), frame_data.size(), frame_number, events);
 }
 
-size_t FrameUnpacker::unpack(
-    const uint8_t* frame_data,
-    size_t data_size,
-    uint64_t frame_number,
-    dv::EventStore& events)
+void FrameUnpacker::setDecimation(int factor)
+{
+    if (factor < 1 || factor > 64 || (factor & (factor - 1)) != 0) {
+        std::cerr << "FrameUnpacker: invalid decimation factor " << factor << ", decoding every pixel" << std::endl;
+        factor = 1;
+    }
+    decimation_ = factor;
+}
+
+const uint8_t* FrameUnpacker::decimate(const uint8_t* frame_data, size_t begin, size_t end)
+{
+    if (decimation_ == 1) {
+        return frame_data;
+    }
+
+    std::vector<uint8_t>& mask = decimation_masks_[std::countr_zero(static_cast<unsigned>(decimation_))];
+    if (mask.empty()) {
+        buildDecimationMask(config_.width, config_.total_pixels(), config_.frame_size(), decimation_, mask);
+    }
+    if (masked_.size() < mask.size()) {
+        masked_.resize(mask.size());
+    }
+    // Plain AND loop; compilers vectorize it
+    for (size_t i = begin; i < end; i++) {
+        masked_[i] = frame_data[i] & mask[i];
+    }
+    return masked_.data();
+}
+
+size_t FrameUnpacker::decodeSelected(UnpackContext& ctx, const uint8_t* frame_data, size_t begin, size_t end, dv::Event* out)
+{
+    if (!ranges_) {
+        ctx.data = decimate(frame_data, begin, end);
+        return decodeBytes(ctx, begin, end, out);
+    }
+
+    size_t count = 0;
+    for (const ByteRange& range : *ranges_) {
+        const size_t b = std::max(range.begin, begin);
+        const size_t e = std::min(range.end, end);
+        if (b < e) {
+            ctx.data = decimate(frame_data, b, e);
+            count += decodeBytes(ctx, b, e, out + count);
+        }
+    }
+    return count;
+}
+
+void FrameUnpacker::decodeSelectedSoA(UnpackContext& ctx, const uint8_t* frame_data, size_t begin, size_t end, SoaOutput& out)
+{
+    // As decodeBytes(): full bytes to the kernel, a padded last byte to the reference
+    const size_t full_bytes = static_cast<size_t>(ctx.total_pixels / 4);
+    auto decode = [&](size_t b, size_t e) {
+        ctx.data = decimate(frame_data, b, e);
+        ctx.begin = b;
+        ctx.end = std::min(e, std::max(b, full_bytes));
+        if (ctx.end > ctx.begin) {
+            soa_kernel_(ctx, out);
+        }
+        if (ctx.end < e) {
+            ctx.begin = ctx.end;
+            ctx.end = e;
+            unpackSoaScalar(ctx, out);
+        }
+    };
+
+    if (!ranges_) {
+        decode(begin, end);
+        return;
+    }
+    for (const ByteRange& range : *ranges_) {
+        const size_t b = std::max(range.begin, begin);
+        const size_t e = std::min(range.end, end);
+        if (b < e) {
+            decode(b, e);
+        }
+    }
+}
+
+bool FrameUnpacker::prepare(size_t data_size)
 {
     // Validate frame size
     int expected_size = getExpectedFrameSize();
     if (static_cast<int>(data_size) < expected_size) {
         std::cerr << "Warning: Frame data size (" << data_size
                   << ") is smaller than expected (" << expected_size << ")" << std::endl;
+        return false;
+    }
+
+    // Config may have been reloaded with a different resolution
+    if (config_.width != table_width_ || config_.height != table_height_) {
+        rebuildTables();
+    }
+    return true;
+}
+
+size_t FrameUnpacker::decodeBytes(UnpackContext& ctx, size_t begin, size_t end, dv::Event* out) const
+{
+    // Bytes holding 4 real pixels go to the selected kernel; a trailing
+    // partially-padded byte (total_pixels % 4 != 0) to the bounds-checked reference
+    const size_t full_bytes = static_cast<size_t>(ctx.total_pixels / 4);
+    const KernelInfo& kernel = dispatcher_->current();
+    size_t count = 0;
+
+    ctx.begin = begin;
+    ctx.end = kernel.full_bytes_only ? std::min(end, std::max(begin, full_bytes)) : end;
+    if (ctx.end > ctx.begin) {
+        count = kernel.fn(ctx, out);
+    }
+
+    if (ctx.end < end) {
+        ctx.begin = ctx.end;
+        ctx.end = end;
+        count += unpackScalar(ctx, out + count);
+    }
+    return count;
+}
+
+bool FrameUnpacker::decode(const uint8_t* frame_data, size_t data_size, uint64_t frame_number, size_t& count)
+{
+    count = 0;
+    if (!prepare(data_size)) {
+        return false;
+    }
+
+    UnpackContext ctx;
+    ctx.width = config_.width;
+    ctx.total_pixels = config_.total_pixels();
+    ctx.byte_x = byte_x_.data();
+    ctx.byte_y = byte_y_.data();
+    // Calculate timestamp for this frame
+    ctx.timestamp = frameTimestamp(frame_number);
+
+    count = decodeSelected(ctx, frame_data, 0, static_cast<size_t>(getExpectedFrameSize()), scratch_.data());
+    recordFrame(count);
+
+    if (config_.verbose) {
+        std::cout << "Frame " << frame_number << ": unpacked " << count << " events" << std::endl;
+    }
+
+    return true;
+}
+
+void FrameUnpacker::recordFrame(size_t events)
+{
+    dispatcher_->observe(events, config_.total_pixels());
+    frames_decoded_.add();
+    events_decoded_.add(events);
+}
+
+size_t FrameUnpacker::unpackRange(
+    const uint8_t* frame_data,
+    size_t data_size,
+    uint64_t frame_number,
+    size_t begin,
+    size_t end,
+    dv::Event* out)
+{
+    if (!prepare(data_size)) {
+        return 0;
+    }
+    end = std::min(end, static_cast<size_t>(getExpectedFrameSize()));
+    if (begin >= end) {
         return 0;
     }
 
+    UnpackContext ctx;
+    ctx.width = config_.width;
+    ctx.total_pixels = config_.total_pixels();
+    ctx.byte_x = byte_x_.data();
+    ctx.byte_y = byte_y_.data();
+    ctx.timestamp = frameTimestamp(frame_number);
+
+    return decodeSelected(ctx, frame_data, begin, end, out);
+}
+
+size_t FrameUnpacker::unpack(
+    const uint8_t* frame_data,
+    size_t data_size,
+    uint64_t frame_number,
+    dv::EventStore& events)
+{
     // Clear output
     events = dv::EventStore();
 
-    // Calculate timestamp for this frame
-    int64_t timestamp = static_cast<int64_t>(frame_number) * config_.frame_interval_us;
-
-    const int width = config_.width;
-    const int height = config_.height;
-    const int total_pixels = config_.total_pixels();
-
-    // Process each byte (4 pixels per byte)
-    // FPGA format: bits 7-6 = pixel 0, bits 5-4 = pixel 1, bits 3-2 = pixel 2, bits 1-0 = pixel 3
-    // Values: 00 = no event, 01 = positive (p=1), 10 = negative (p=0), 11 = unused
-    
-    for (int byte_idx = 0; byte_idx < expected_size; byte_idx++) {
-        uint8_t byte_val = frame_data[byte_idx];
-        
-        // Skip zero bytes entirely - no events in this byte
-        // This is a key optimization for sparse event data
-        if (byte_val == 0) {
-            continue;
-        }
-        
-        // Base pixel index for this byte
-        int base_pixel = byte_to_base_pixel_[byte_idx];
-        
-        // Extract 4 pixels from this byte (MSB first, as per FPGA format)
-        // shift = 6, 4, 2, 0 for pixels 0, 1, 2, 3
-        for (int px_in_byte = 0; px_in_byte < 4; px_in_byte++) {
-            int shift = 6 - (px_in_byte * 2);
-            uint8_t pixel_val = (byte_val >> shift) & 0x03;
-            
-            // Skip if no event (00) or unused (11)
-            if (pixel_val == 0 || pixel_val == 3) {
-                continue;
-            }
-            
-            // Calculate pixel index
-            int pixel_idx = base_pixel + px_in_byte;
-            
-            // Bounds check (handle last byte which may have padding)
-            if (pixel_idx >= total_pixels) {
-                continue;
-            }
-            
-            // Calculate x, y coordinates (row-major order)
-            int16_t x = static_cast<int16_t>(pixel_idx % width);
-            int16_t y = static_cast<int16_t>(pixel_idx / width);
-            
-            // Determine polarity: 01 = positive (true), 10 = negative (false)
-            bool polarity = (pixel_val == 1);
-            
-            // Add event
-            events.emplace_back(timestamp, x, y, polarity);
-        }
+    size_t count = 0;
+    if (decode(frame_data, data_size, frame_number, count) && count > 0) {
+        auto packet = std::make_shared<dv::EventPacket>();
+        packet->elements.assign(scratch_.begin(), scratch_.begin() + static_cast<std::ptrdiff_t>(count));
+        events = dv::EventStore(std::shared_ptr<const dv::EventPacket>(std::move(packet)));
     }
 
+    return events.size();
+}
+
+size_t FrameUnpacker::unpack(
+    const uint8_t* frame_data,
+    size_t data_size,
+    uint64_t frame_number,
+    dv::EventPacket& packet)
+{
+    size_t count = 0;
+    if (!decode(frame_data, data_size, frame_number, count)) {
+        packet.elements.clear();
+        return 0;
+    }
+
+    // assign() keeps the capacity from earlier frames
+    packet.elements.assign(scratch_.begin(), scratch_.begin() + static_cast<std::ptrdiff_t>(count));
+    return packet.elements.size();
+}
+
+size_t FrameUnpacker::unpackSoA(
+    const uint8_t* frame_data,
+    size_t data_size,
+    uint64_t frame_number,
+    EventFrameSoA& frame)
+{
+    frame.frame_number = frame_number;
+    frame.timestamp = frameTimestamp(frame_number);
+    frame.count = 0;
+
+    if (!prepare(data_size)) {
+        return 0;
+    }
+    const int expected_size = getExpectedFrameSize();
+
+    frame.reserve(static_cast<size_t>(config_.total_pixels()));
+
+    UnpackContext ctx;
+    ctx.width = config_.width;
+    ctx.total_pixels = config_.total_pixels();
+    ctx.byte_x = byte_x_.data();
+    ctx.byte_y = byte_y_.data();
+    ctx.timestamp = frame.timestamp;
+
+    SoaOutput out;
+    out.x = frame.x.data();
+    out.y = frame.y.data();
+    out.polarity = frame.polarity.data();
+
+    decodeSelectedSoA(ctx, frame_data, 0, static_cast<size_t>(expected_size), out);
+
+    frame.count = out.count;
+    recordFrame(frame.count);
+
     if (config_.verbose) {
-        std::cout << "Frame " << frame_number << ": unpacked " << events.size() << " events" << std::endl;
+        std::cout << "Frame " << frame_number << ": unpacked " << frame.count << " events (SoA)" << std::endl;
     }
 
-    return events.size();
+    return frame.count;
 }
 
 } // namespace converter
@@ -0,0 +1,228 @@
+#include "kernel_dispatcher.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+
+namespace converter {
+
+namespace {
+
+// A new kernel must beat the active one by this margin before switching,
+// so measurement noise does not make the dispatcher flip-flop
+constexpr double kSwitchMargin = 0.95;
+
+// Weight of the newest frame in the live density average
+constexpr double kDensitySmoothing = 0.05;
+
+/**
+ * Synthetic 2-bit packed frame with events at uniformly random pixels
+ */
+std::vector<uint8_t> makeSyntheticFrame(int total_pixels, int frame_size, double density)
+{
+    std::vector<uint8_t> frame(frame_size, 0);
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    for (int pixel_idx = 0; pixel_idx < total_pixels; pixel_idx++) {
+        if (chance(rng) < density) {
+            uint8_t v = (rng() & 1) ? 0b01 : 0b10;
+            int shift = (3 - (pixel_idx & 3)) * 2;
+            frame[pixel_idx >> 2] |= static_cast<uint8_t>(v << shift);
+        }
+    }
+    return frame;
+}
+
+bool sameEvents(const dv::Event* a, const dv::Event* b, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (a[i].timestamp() != b[i].timestamp() || a[i].x() != b[i].x()
+            || a[i].y() != b[i].y() || a[i].polarity() != b[i].polarity()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+KernelDispatcher::KernelDispatcher(const Config& cfg)
+    : config_(cfg)
+    , current_(&availableKernels().front())
+    , live_density_(cfg.kernel_bench_density)
+    , frames_since_eval_(0)
+    , switch_count_(MetricsRegistry::global().counter(metricName(cfg, "kernel_switches")))
+    , reeval_running_(false)
+{
+}
+
+KernelDispatcher::~KernelDispatcher()
+{
+    std::lock_guard<std::mutex> lock(reeval_mutex_);
+    if (reeval_thread_.joinable()) {
+        reeval_thread_.join();
+    }
+}
+
+void KernelDispatcher::initialize()
+{
+    if (config_.unpack_kernel != UnpackKernel::Auto) {
+        const KernelInfo* kernel = findKernel(config_.unpack_kernel);
+        if (kernel != nullptr) {
+            current_.store(kernel, std::memory_order_release);
+            std::cout << "Unpack kernel: " << kernel->name << " (configured)" << std::endl;
+            return;
+        }
+        std::cerr << "Warning: Unpack kernel '" << kernelToString(config_.unpack_kernel)
+                  << "' is not supported on this CPU, selecting automatically" << std::endl;
+    }
+
+    auto results = benchmark(config_.kernel_bench_density, config_.kernel_bench_ms);
+    const BenchResult* best = fastest(results);
+    if (best != nullptr) {
+        current_.store(best->kernel, std::memory_order_release);
+    }
+
+    std::cout << "Unpack kernel: " << current().name << " (auto, "
+              << std::fixed << std::setprecision(1) << config_.kernel_bench_density * 100.0
+              << "% density:";
+    for (const auto& r : results) {
+        std::cout << " " << r.kernel->name << "=" << std::setprecision(3) << r.ns_per_frame / 1e6 << "ms";
+        if (!r.matches_reference) {
+            std::cout << "(MISMATCH)";
+        }
+    }
+    std::cout << ")" << std::endl;
+}
+
+std::vector<KernelDispatcher::BenchResult> KernelDispatcher::benchmark(double density, int duration_ms) const
+{
+    const int width = config_.width;
+    const int total_pixels = config_.total_pixels();
+    const int frame_size = config_.frame_size();
+
+    std::vector<uint8_t> frame = makeSyntheticFrame(total_pixels, frame_size, std::clamp(density, 0.0, 1.0));
+    std::vector<int16_t> byte_x, byte_y;
+    buildCoordinateTables(width, frame_size, byte_x, byte_y);
+
+    UnpackContext ctx;
+    ctx.data = frame.data();
+    ctx.begin = 0;
+    ctx.end = static_cast<size_t>(total_pixels / 4);  // Full bytes: valid for every kernel
+    ctx.width = width;
+    ctx.total_pixels = total_pixels;
+    ctx.byte_x = byte_x.data();
+    ctx.byte_y = byte_y.data();
+    ctx.timestamp = 1;
+
+    const size_t capacity = ctx.end * 4;
+    std::vector<dv::Event> reference(capacity);
+    std::vector<dv::Event> output(capacity);
+    const size_t reference_count = unpackScalar(ctx, reference.data());
+
+    std::vector<BenchResult> results;
+    for (const auto& kernel : availableKernels()) {
+        BenchResult r{&kernel, 0.0, false};
+
+        size_t count = kernel.fn(ctx, output.data());
+        r.matches_reference = (count == reference_count) && sameEvents(output.data(), reference.data(), count);
+
+        // Best of repeated runs within the time budget (at least 3)
+        const auto budget = std::chrono::milliseconds(std::max(duration_ms, 1));
+        const auto start = std::chrono::steady_clock::now();
+        double best_ns = 0.0;
+        for (int iter = 0; iter < 3 || std::chrono::steady_clock::now() - start < budget; iter++) {
+            auto t0 = std::chrono::steady_clock::now();
+            kernel.fn(ctx, output.data());
+            auto t1 = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+            if (iter == 0 || ns < best_ns) {
+                best_ns = ns;
+            }
+        }
+        r.ns_per_frame = best_ns;
+        results.push_back(r);
+    }
+
+    return results;
+}
+
+const KernelDispatcher::BenchResult* KernelDispatcher::fastest(const std::vector<BenchResult>& results)
+{
+    const BenchResult* best = nullptr;
+    for (const auto& r : results) {
+        if (!r.matches_reference) {
+            std::cerr << "Warning: Unpack kernel " << r.kernel->name
+                      << " does not match the scalar reference, not using it" << std::endl;
+            continue;
+        }
+        if (best == nullptr || r.ns_per_frame < best->ns_per_frame) {
+            best = &r;
+        }
+    }
+    return best;
+}
+
+void KernelDispatcher::observe(size_t events, int total_pixels)
+{
+    if (total_pixels > 0) {
+        double density = static_cast<double>(events) / total_pixels;
+        double smoothed = live_density_.load(std::memory_order_relaxed);
+        live_density_.store(smoothed + kDensitySmoothing * (density - smoothed), std::memory_order_relaxed);
+    }
+
+    if (config_.unpack_kernel != UnpackKernel::Auto || config_.kernel_reeval_interval <= 0) {
+        return;
+    }
+
+    uint64_t frames = frames_since_eval_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (frames < static_cast<uint64_t>(config_.kernel_reeval_interval)) {
+        return;
+    }
+
+    // Only one re-evaluation at a time; frames keep using the current kernel
+    bool expected = false;
+    if (!reeval_running_.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    frames_since_eval_.store(0, std::memory_order_relaxed);
+
+    // Another observer may still be starting the previous run
+    std::lock_guard<std::mutex> lock(reeval_mutex_);
+    if (reeval_thread_.joinable()) {
+        reeval_thread_.join();  // Previous run already finished
+    }
+    reeval_thread_ = std::thread(&KernelDispatcher::reevaluate, this, getLiveDensity());
+}
+
+void KernelDispatcher::reevaluate(double density)
+{
+    auto results = benchmark(density, config_.kernel_bench_ms);
+    const BenchResult* best = fastest(results);
+    const KernelInfo* active = current_.load(std::memory_order_acquire);
+
+    if (best != nullptr && best->kernel != active) {
+        double active_ns = 0.0;
+        for (const auto& r : results) {
+            if (r.kernel == active) {
+                active_ns = r.ns_per_frame;
+            }
+        }
+
+        if (best->ns_per_frame < active_ns * kSwitchMargin) {
+            current_.store(best->kernel, std::memory_order_release);
+            switch_count_.add();
+            std::cout << "Unpack kernel: " << active->name << " -> " << best->kernel->name
+                      << " (live density " << std::fixed << std::setprecision(2) << density * 100.0 << "%, "
+                      << std::setprecision(3) << active_ns / 1e6 << "ms -> "
+                      << best->ns_per_frame / 1e6 << "ms)" << std::endl;
+        }
+    }
+
+    reeval_running_.store(false, std::memory_order_release);
+}
+
+} // namespace converter
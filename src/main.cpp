@@ -1,7 +1,14 @@
 #include "config.hpp"
-#include "tcp_receiver.hpp"
-#include "udp_receiver.hpp"
-#include "frame_unpacker.hpp"
+#include "config_loader.hpp"
+#include "pipeline.hpp"
+#include "batch_converter.hpp"
+#include "recording.hpp"
+#include "metrics.hpp"
+#include "trace.hpp"
+#include "crc32c.hpp"
+#ifdef __linux__
+#include "shm_writer.hpp"
+#endif
 
 #include <dv-processing/io/network_writer.hpp>
 #include <dv-processing/io/stream.hpp>
@@ -10,11 +17,12 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <ctime>
 #include <thread>
 #include <csignal>
 #include <atomic>
 #include <memory>
-#include <variant>
+#include <filesystem>
 
 // Global flag for graceful shutdown
 std::atomic<bool> running{true};
@@ -25,14 +33,23 @@ void signalHandler(int signum)
     running = false;
 }
 
+#ifndef _WIN32
+void traceSignalHandler(int)
+{
+    // Only sets a flag; the main loop writes the file
+    converter::TraceRecorder::global().requestDump();
+}
+#endif
+
 void printStats(
-    uint64_t frame_count,
-    uint64_t total_events,
-    uint64_t total_bytes,
+    const converter::MetricsSnapshot& snapshot,
+    const converter::Config& config,
     std::chrono::steady_clock::time_point start_time)
 {
-    auto now = std::chrono::steady_clock::now();
-    double elapsed = std::chrono::duration<double>(now - start_time).count();
+    const uint64_t frame_count = static_cast<uint64_t>(snapshot.get(converter::metricName(config, "pipeline_frames")));
+    const uint64_t total_events = static_cast<uint64_t>(snapshot.get(converter::metricName(config, "pipeline_events")));
+    const uint64_t total_bytes = static_cast<uint64_t>(snapshot.get(converter::metricName(config, "rx_bytes")));
+    double elapsed = std::chrono::duration<double>(snapshot.time - start_time).count();
     
     if (elapsed > 0) {
         double fps = frame_count / elapsed;
@@ -46,7 +63,59 @@ void printStats(
                   << " | MEv/s: " << std::setprecision(2) << meps
                   << " | Throughput: " << std::setprecision(1) << mbps << " Mbps"
                   << std::endl;
+
+        // Striped TCP: one line per connection shows an unbalanced link
+        for (int i = 0; config.tcp_connections > 1 && i < config.tcp_connections; i++) {
+            const std::string prefix = "rx_conn" + std::to_string(i);
+            const double conn_bytes = static_cast<double>(snapshot.get(converter::metricName(config, (prefix + "_bytes").c_str())));
+            std::cout << "  Connection " << i << ": "
+                      << snapshot.get(converter::metricName(config, (prefix + "_frames").c_str())) << " frames | "
+                      << std::setprecision(1) << (conn_bytes * 8.0) / (elapsed * 1000000.0) << " Mbps" << std::endl;
+        }
+    }
+}
+
+/**
+ * Batch mode (convert_chunk_frames > 0): convert input_file into AEDAT4
+ * segments on all decode threads, instead of running the pipeline
+ */
+int runBatchConversion(const converter::Config& config)
+{
+    converter::BatchConverter batch(config);
+    const auto start_time = std::chrono::steady_clock::now();
+    if (!batch.start()) {
+        return 1;
+    }
+    std::cout << "Press Ctrl+C to stop." << std::endl;
+
+    auto last_report = start_time;
+    while (running && batch.isRunning()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+        if (config.stats_interval > 0 && now - last_report >= std::chrono::seconds(5)) {
+            last_report = now;
+            const double seconds = std::chrono::duration<double>(now - start_time).count();
+            std::cout << "Converted " << batch.getFramesConverted() << " / " << batch.getFrameCount() << " frames | "
+                      << std::fixed << std::setprecision(2) << batch.getBytesConverted() / 1e9 / seconds << " GB/s"
+                      << std::endl;
+        }
+    }
+    batch.stop();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    const double gigabytes = static_cast<double>(batch.getBytesConverted()) / 1e9;
+    std::cout << std::endl;
+    std::cout << "============================================" << std::endl;
+    std::cout << "Converted " << batch.getFramesConverted() << " frames, " << batch.getEventsConverted()
+              << " events into " << batch.getSegmentCount() << " segments ("
+              << converter::RecordingIndex::segmentPath(config.output_file, 0) << ", ...)" << std::endl;
+    std::cout << "Input: " << std::fixed << std::setprecision(2) << gigabytes << " GB in " << seconds << " s ("
+              << (seconds > 0 ? gigabytes / seconds : 0.0) << " GB/s)" << std::endl;
+    if (!batch.isComplete()) {
+        std::cout << "Stopped before end of file; the last segments are incomplete or missing" << std::endl;
     }
+    std::cout << "============================================" << std::endl;
+    return batch.isComplete() || !running ? 0 : 1;
 }
 
 int main(int argc, char* argv[])
@@ -58,10 +127,42 @@ int main(int argc, char* argv[])
     // Setup signal handler for graceful shutdown
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+#ifndef _WIN32
+    std::signal(SIGUSR1, traceSignalHandler);
+#endif
 
-    // Use global config (modify in config.hpp or add command line parsing)
+    // Global config: compile-time defaults from config.hpp, overridden by
+    // --config FILE and then by individual --option=value arguments
     converter::Config& config = converter::config;
 
+    converter::ParseResult parse_result = converter::parseCommandLine(argc, argv, config);
+    if (parse_result == converter::ParseResult::Exit) {
+        return 0;
+    }
+    if (parse_result == converter::ParseResult::Error) {
+        std::cerr << "Run with --help for available options." << std::endl;
+        return 1;
+    }
+
+    // Without AEDAT4 outputs nobody needs dv::Event records: decode straight
+    // into structure-of-arrays form for the shared-memory ring. Decided
+    // before validation, which rejects pipeline_soa with stream_rows
+    bool aedat_output = config.aedat_tcp_enabled || !config.output_file.empty();
+#ifndef _WIN32
+    aedat_output = aedat_output || !config.aedat_socket_path.empty();
+#endif
+    if (config.pipeline_soa && aedat_output) {
+        std::cerr << "Invalid configuration: pipeline_soa does not work with AEDAT4 outputs, "
+                  << "which need dv::Event records" << std::endl;
+        return 1;
+    }
+    if (!aedat_output && config.stream_rows == 0) {
+        config.pipeline_soa = true;
+    }
+    if (!converter::validateConfig(config)) {
+        return 1;
+    }
+
     // Print configuration
     std::cout << "\nConfiguration:" << std::endl;
     std::cout << "  Protocol: " << converter::protocolToString(config.protocol) << std::endl;
@@ -69,134 +170,281 @@ int main(int argc, char* argv[])
     std::cout << "  Frame data size: " << config.frame_size() << " bytes" << std::endl;
     if (config.protocol == converter::Protocol::TCP) {
         std::cout << "  TCP Server port: " << config.camera_port << " (FPGA connects here)" << std::endl;
+    } else if (config.protocol == converter::Protocol::File) {
+        std::cout << "  Input file: " << config.input_file << std::endl;
     } else {
         std::cout << "  UDP Listen port: " << config.camera_port << std::endl;
         std::cout << "  UDP packet size: " << config.udp_packet_size << " bytes" << std::endl;
     }
-    std::cout << "  AEDAT4 output port: " << config.aedat_port << std::endl;
+    if (config.aedat_tcp_enabled) {
+        std::cout << "  AEDAT4 output port: " << config.aedat_port << std::endl;
+    }
+    if (!config.aedat_socket_path.empty()) {
+        std::cout << "  AEDAT4 output socket: " << config.aedat_socket_path << std::endl;
+    }
+    if (config.shm_enabled) {
+        std::cout << "  Shared memory output: " << config.shm_name << std::endl;
+    }
+    if (!config.output_file.empty()) {
+        std::cout << "  AEDAT4 output file: " << config.output_file << std::endl;
+    }
     std::cout << "  Frame interval: " << config.frame_interval_us << " us" << std::endl;
-    if (config.protocol == converter::Protocol::TCP) {
-        std::cout << "  Has header: " << (config.has_header ? "yes" : "no") << std::endl;
+    std::cout << "  Has header: " << (config.has_header ? "yes" : "no");
+    if (config.has_header) {
+        std::cout << " (" << converter::headerFormatToString(config.header_format) << ")";
+    }
+    std::cout << std::endl;
+    if (config.has_header && config.header_format == converter::HeaderFormat::V1) {
+        std::cout << "  CRC32C check: "
+                  << (config.verify_crc ? converter::crc32cImplementation() : "off") << std::endl;
     }
     std::cout << "  Pixel format: 2-bit packed (FPGA format)" << std::endl;
+    if (config.decode_threads > 0) {
+        std::cout << "  Decode threads: " << config.decode_threads;
+        if (config.decode_band_rows > 0) {
+            std::cout << " (bands of " << config.decode_band_rows << " rows)";
+        }
+        std::cout << std::endl;
+    }
+    if (config.tcp_zerocopy) {
+        std::cout << "  TCP receive: zero-copy (TCP_ZEROCOPY_RECEIVE, copy fallback)" << std::endl;
+    }
+    if (config.stream_rows > 0) {
+        std::cout << "  Cut-through decode: parts of " << config.stream_rows << " rows as they arrive" << std::endl;
+    }
+    if (config.convert_chunk_frames > 0) {
+        std::cout << "  Batch conversion: chunks of " << config.convert_chunk_frames << " frames" << std::endl;
+    }
+    if (config.decimation_enabled) {
+        std::cout << "  Decimation: over " << config.decimation_event_budget << " events/frame or "
+                  << config.decimation_backlog_frames << " frames backlog (up to 1/" << config.decimation_max_factor
+                  << ")" << std::endl;
+    }
+    if (!config.tile_subscription.empty()) {
+        std::cout << "  Decoded tiles (32x32): " << config.tile_subscription << std::endl;
+    }
+    if (config.trace_enabled) {
+        std::cout << "  Trace: " << config.trace_path << " (dump with SIGUSR1";
+        if (config.trace_latency_threshold_us > 0) {
+            std::cout << " or on latency > " << config.trace_latency_threshold_us << " us";
+        }
+        std::cout << ")" << std::endl;
+    }
     std::cout << std::endl;
 
-    // Create receiver based on protocol
-    using ReceiverVariant = std::variant<converter::TcpReceiver, converter::UdpReceiver>;
-    std::unique_ptr<ReceiverVariant> receiver_ptr;
-
-    if (config.protocol == converter::Protocol::TCP) {
-        receiver_ptr = std::make_unique<ReceiverVariant>(std::in_place_type<converter::TcpReceiver>, config);
-    } else {
-        receiver_ptr = std::make_unique<ReceiverVariant>(std::in_place_type<converter::UdpReceiver>, config);
+    if (config.convert_chunk_frames > 0) {
+        return runBatchConversion(config);
     }
 
-    // Helper lambdas to work with the variant
-    auto connect_receiver = [&]() -> bool {
-        return std::visit([](auto& r) { return r.connect(); }, *receiver_ptr);
-    };
-
-    auto disconnect_receiver = [&]() {
-        std::visit([](auto& r) { r.disconnect(); }, *receiver_ptr);
-    };
-
-    auto receive_frame = [&](std::vector<uint8_t>& buffer) -> bool {
-        return std::visit([&buffer](auto& r) { return r.receiveFrame(buffer); }, *receiver_ptr);
-    };
+    cv::Size resolution(config.width, config.height);
 
-    auto get_total_bytes = [&]() -> uint64_t {
-        return std::visit([](auto& r) { return r.getTotalBytesReceived(); }, *receiver_ptr);
-    };
+    // Create event stream for the NetworkWriter
+    dv::io::Stream eventStream = dv::io::Stream::EventStream(0, "events", "DVS", resolution);
 
-    converter::FrameUnpacker unpacker(config);
-    
     // Create AEDAT4 TCP server (DV viewer connects here)
-    std::cout << "Starting AEDAT4 server on port " << config.aedat_port << "..." << std::endl;
-    cv::Size resolution = unpacker.getResolution();
+    std::unique_ptr<dv::io::NetworkWriter> tcp_writer;
+    if (config.aedat_tcp_enabled) {
+        std::cout << "Starting AEDAT4 server on port " << config.aedat_port << "..." << std::endl;
+        tcp_writer = std::make_unique<dv::io::NetworkWriter>(
+            "0.0.0.0",
+            static_cast<uint16_t>(config.aedat_port),
+            eventStream
+        );
+        std::cout << "AEDAT4 server started. DV viewer can connect to port " << config.aedat_port << std::endl;
+    }
 
-    // Create event stream for the NetworkWriter
-    dv::io::Stream eventStream = dv::io::Stream::EventStream(0, "events", "DVS", resolution);
+    // Optional AEDAT4 server on a Unix domain socket (same-host DV software,
+    // no TCP checksum/stack overhead)
+    std::unique_ptr<dv::io::NetworkWriter> unix_writer;
+    if (!config.aedat_socket_path.empty()) {
+#ifdef _WIN32
+        std::cerr << "Warning: AEDAT4 Unix socket output is not supported on Windows, ignoring" << std::endl;
+#else
+        std::cout << "Starting AEDAT4 server on socket " << config.aedat_socket_path << "..." << std::endl;
+        // Remove a stale socket file left by a previous run
+        std::error_code ec;
+        std::filesystem::remove(config.aedat_socket_path, ec);
+        unix_writer = std::make_unique<dv::io::NetworkWriter>(
+            std::filesystem::path(config.aedat_socket_path),
+            eventStream
+        );
+        std::cout << "AEDAT4 server started. DV viewer can connect to " << config.aedat_socket_path << std::endl;
+#endif
+    }
 
-    dv::io::NetworkWriter writer(
-        "0.0.0.0",
-        static_cast<uint16_t>(config.aedat_port),
-        eventStream
-    );
-    
-    std::cout << "AEDAT4 server started. DV viewer can connect to port " << config.aedat_port << std::endl;
-    std::cout << std::endl;
-    
-    // Connect/bind to receive data
-    if (config.protocol == converter::Protocol::TCP) {
-        std::cout << "Starting TCP server (waiting for FPGA connection)..." << std::endl;
-    } else {
-        std::cout << "Binding UDP socket..." << std::endl;
+    // Optional AEDAT4 recording (offline conversion of input_file), with
+    // its index for time-range extraction
+    std::unique_ptr<converter::RecordingWriter> file_writer;
+    if (!config.output_file.empty()) {
+        file_writer = std::make_unique<converter::RecordingWriter>(config);
+        if (!file_writer->open()) {
+            std::cerr << "Failed to create AEDAT4 output file. Exiting." << std::endl;
+            return 1;
+        }
+        std::cout << "Writing AEDAT4 to " << config.output_file;
+        if (config.output_segment_frames > 0) {
+            std::cout << " (segments of " << config.output_segment_frames << " frames)";
+        }
+        std::cout << ", index " << converter::RecordingIndex::indexPath(config.output_file) << std::endl;
+    }
+
+#ifdef __linux__
+    // Optional shared-memory output for same-host consumers
+    std::unique_ptr<converter::SharedMemoryWriter> shm_writer;
+    if (config.shm_enabled) {
+        shm_writer = std::make_unique<converter::SharedMemoryWriter>(config);
+        if (!shm_writer->open()) {
+            std::cerr << "Failed to create shared memory output. Exiting." << std::endl;
+            return 1;
+        }
+    }
+    const bool shm_output = static_cast<bool>(shm_writer);
+#else
+    if (config.shm_enabled) {
+        std::cerr << "Warning: Shared memory output is only supported on Linux, ignoring" << std::endl;
     }
+    const bool shm_output = false;
+#endif
 
-    if (!connect_receiver()) {
-        std::cerr << "Failed to initialize receiver. Exiting." << std::endl;
+    if (!aedat_output && !shm_output) {
+        std::cerr << "No output enabled (aedat_tcp_enabled = false, no aedat_socket_path or output_file, shm_enabled = false). Exiting." << std::endl;
         return 1;
     }
-    
-    std::cout << std::endl;
-    std::cout << "Starting main loop. Press Ctrl+C to stop." << std::endl;
-    std::cout << "============================================" << std::endl;
     std::cout << std::endl;
-    
-    // Main loop variables
-    std::vector<uint8_t> frame_buffer;
-    dv::EventStore events;
-    uint64_t frame_count = 0;
-    uint64_t total_events = 0;
+
+    // Receive + decode run on the pipeline thread; the callback below
+    // forwards every frame to the enabled outputs
+    converter::Pipeline pipeline(config);
+    converter::MetricsRegistry& metrics = converter::MetricsRegistry::global();
+    const converter::Counter aedat_events = metrics.counter(converter::metricName(config, "aedat_events"));
     auto start_time = std::chrono::steady_clock::now();
-    
-    // Main loop
-    while (running) {
-        // Receive frame from camera
-        if (!receive_frame(frame_buffer)) {
-            if (running) {
-                std::cerr << "Failed to receive frame. Reconnecting..." << std::endl;
-                disconnect_receiver();
-
-                // Wait a bit before reconnecting
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-
-                if (!connect_receiver()) {
-                    std::cerr << "Reconnection failed. Exiting." << std::endl;
-                    break;
-                }
+    const std::clock_t start_cpu = std::clock();
+
+    pipeline.setCallback([&](const converter::EventFramePtr& frame) {
+        if (frame->soa) {
+#ifdef __linux__
+            if (frame->soa->count > 0) {
+                shm_writer->writeFrame(*frame->soa);
             }
-            continue;
+#endif
+        } else if (!frame->events.isEmpty()) {
+            if (tcp_writer) {
+                tcp_writer->writeEvents(frame->events);
+            }
+            if (unix_writer) {
+                unix_writer->writeEvents(frame->events);
+            }
+            aedat_events.add(frame->events.size());
+#ifdef __linux__
+            if (shm_writer) {
+                shm_writer->writeEvents(frame->events, frame->frame_number, frame->timestamp);
+            }
+#endif
         }
-        
-        // Unpack frame to events
-        size_t num_events = unpacker.unpack(frame_buffer, frame_count, events);
-        
-        // Send events to AEDAT4 stream
-        if (num_events > 0) {
-            writer.writeEvents(events);
+        // Every frame, empty ones included, so segments end on their frames
+        if (file_writer) {
+            file_writer->write(frame->frame_number, frame->timestamp, frame->events);
         }
-        
-        // Update counters
-        frame_count++;
-        total_events += num_events;
-        
-        // Print statistics periodically
-        if (config.stats_interval > 0 && frame_count % config.stats_interval == 0) {
-            printStats(frame_count, total_events, get_total_bytes(), start_time);
+
+        // Print statistics periodically (once per frame with stream_rows parts)
+        const uint64_t frames = pipeline.getFramesDelivered();
+        if (config.stats_interval > 0 && frame->frame_end && frames % config.stats_interval == 0) {
+            printStats(metrics.snapshot(), config, start_time);
         }
+    });
+
+    // Connect/bind to receive data
+    if (config.protocol == converter::Protocol::TCP) {
+        std::cout << "Starting TCP server (waiting for FPGA connection)..." << std::endl;
+    } else if (config.protocol == converter::Protocol::File) {
+        std::cout << "Converting " << config.input_file << "..." << std::endl;
+    } else {
+        std::cout << "Binding UDP socket..." << std::endl;
     }
+    std::cout << "Press Ctrl+C to stop." << std::endl;
+    std::cout << "============================================" << std::endl;
+    std::cout << std::endl;
+
+    pipeline.start();
+
+    // Main loop: wait for Ctrl+C, the end of the input file, or for the
+    // receiver to give up
+    converter::TraceRecorder& tracer = converter::TraceRecorder::global();
+    while (running && pipeline.isRunning()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        tracer.dumpIfRequested(config.trace_path);
+    }
+    const bool receiver_failed = running && !pipeline.isRunning() && !pipeline.inputFinished();
+    pipeline.stop();
+    if (file_writer) {
+        file_writer->close();
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+    tracer.dumpIfRequested(config.trace_path);
 
     // Final statistics
     std::cout << std::endl;
     std::cout << "============================================" << std::endl;
     std::cout << "Final Statistics:" << std::endl;
-    printStats(frame_count, total_events, get_total_bytes(), start_time);
+    const converter::MetricsSnapshot snapshot = metrics.snapshot();
+    printStats(snapshot, config, start_time);
+    if (config.protocol == converter::Protocol::File) {
+        // Disk + decode rate of the offline conversion
+        const double gigabytes = static_cast<double>(snapshot.get(converter::metricName(config, "rx_bytes"))) / 1e9;
+        const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+        std::cout << "Input: " << std::fixed << std::setprecision(2) << gigabytes << " GB in "
+                  << seconds << " s (" << (seconds > 0 ? gigabytes / seconds : 0.0) << " GB/s)"
+                  << (pipeline.inputFinished() ? "" : ", stopped before end of file") << std::endl;
+    }
+    if (config.protocol != converter::Protocol::File) {
+        // Whole process (receive, decode, outputs): compare receive backends
+        const double gigabytes = static_cast<double>(snapshot.get(converter::metricName(config, "rx_bytes"))) / 1e9;
+        const double cpu_seconds = static_cast<double>(std::clock() - start_cpu) / CLOCKS_PER_SEC;
+        if (gigabytes > 0) {
+            std::cout << "CPU time: " << std::fixed << std::setprecision(2) << cpu_seconds << " s ("
+                      << cpu_seconds / gigabytes << " s per GB received)" << std::endl;
+        }
+    }
+    if (config.tcp_zerocopy) {
+        const int64_t received = snapshot.get(converter::metricName(config, "rx_bytes"));
+        const int64_t mapped = snapshot.get(converter::metricName(config, "rx_zerocopy_bytes"));
+        std::cout << "Zero-copy receive: " << std::fixed << std::setprecision(1)
+                  << (received > 0 ? 100.0 * static_cast<double>(mapped) / static_cast<double>(received) : 0.0)
+                  << "% of bytes mapped, " << snapshot.get(converter::metricName(config, "rx_zerocopy_frames"))
+                  << " frames decoded in place" << std::endl;
+    }
+    if (const int64_t dropped = snapshot.get(converter::metricName(config, "pipeline_dropped"))) {
+        std::cout << "Dropped frames: " << dropped << std::endl;
+    }
+    if (const int64_t lost = snapshot.get(converter::metricName(config, "rx_frames_lost"))) {
+        std::cout << "Frames lost before the converter (counter gaps): " << lost << std::endl;
+    }
+    if (const int64_t errors = snapshot.get(converter::metricName(config, "rx_header_errors"))) {
+        std::cout << "Invalid frame headers: " << errors << std::endl;
+    }
+    if (const int64_t errors = snapshot.get(converter::metricName(config, "rx_crc_errors"))) {
+        std::cout << "CRC32C mismatches: " << errors << std::endl;
+    }
+    if (const int64_t skipped = snapshot.get(converter::metricName(config, "pipeline_skipped"))) {
+        std::cout << "Skipped frames (never decoded in time): " << skipped << std::endl;
+    }
+    if (const int64_t decimated = snapshot.get(converter::metricName(config, "decimation_frames"))) {
+        std::cout << "Decimated frames: " << decimated << " (~"
+                  << snapshot.get(converter::metricName(config, "decimation_events_dropped")) << " events dropped)" << std::endl;
+    }
+    if (pipeline.getScheduler()) {
+        std::cout << "Decode jobs: " << snapshot.get(converter::metricName(config, "decode_jobs"))
+                  << " (stolen: " << snapshot.get(converter::metricName(config, "decode_steals")) << ")" << std::endl;
+    }
+    if (const int64_t breaches = snapshot.get(converter::metricName(config, "pipeline_latency_breaches"))) {
+        std::cout << "Frames over trace latency threshold: " << breaches << std::endl;
+    }
+    if (config.verbose) {
+        std::cout << "Metrics:" << std::endl;
+        snapshot.writeText(std::cout);
+    }
     std::cout << "============================================" << std::endl;
 
-    // Cleanup
-    disconnect_receiver();
-    
     std::cout << "Shutdown complete." << std::endl;
-    return 0;
+    return receiver_failed ? 1 : 0;
 }
@@ -0,0 +1,158 @@
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace converter {
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open " << path << " (error " << GetLastError() << ")" << std::endl;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        std::cerr << "Failed to get the size of " << path << " (error " << GetLastError() << ")" << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+    file_ = file;
+    size_ = static_cast<uint64_t>(size.QuadPart);
+    open_ = true;
+
+    // Empty files cannot be mapped
+    if (size_ > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            std::cerr << "Failed to map " << path << " (error " << GetLastError() << ")" << std::endl;
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+            close();
+            return false;
+        }
+        mapping_ = mapping;
+        data_ = static_cast<const uint8_t*>(view);
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_) {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+    }
+    if (mapping_) {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+        mapping_ = nullptr;
+    }
+    if (file_) {
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = nullptr;
+    }
+    size_ = 0;
+    open_ = false;
+}
+
+void MappedFile::advise(uint64_t, uint64_t, Access) const
+{
+    // FILE_FLAG_SEQUENTIAL_SCAN covers read-ahead; no per-range hints
+}
+
+#else
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        std::cerr << "Failed to stat " << path << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    size_ = static_cast<uint64_t>(st.st_size);
+    open_ = true;
+
+    // Empty files cannot be mapped
+    if (size_ > 0) {
+        void* map = mmap(nullptr, static_cast<size_t>(size_), PROT_READ, MAP_SHARED, fd_, 0);
+        if (map == MAP_FAILED) {
+            std::cerr << "Failed to map " << path << ": " << std::strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        data_ = static_cast<const uint8_t*>(map);
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+    open_ = false;
+}
+
+void MappedFile::advise(uint64_t offset, uint64_t length, Access access) const
+{
+    if (!data_ || offset >= size_) {
+        return;
+    }
+    const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t begin = offset / page * page;
+    uint64_t end = std::min(offset + length, size_);
+    int advice = MADV_SEQUENTIAL;
+    if (access == Access::WillNeed) {
+        advice = MADV_WILLNEED;
+    } else if (access == Access::DontNeed) {
+        // Only pages entirely inside the range
+        advice = MADV_DONTNEED;
+        begin = (offset + page - 1) / page * page;
+        if (end < size_) {
+            end = end / page * page;
+        }
+    }
+    if (end <= begin) {
+        return;
+    }
+    madvise(const_cast<uint8_t*>(data_ + begin), static_cast<size_t>(end - begin), advice);
+}
+
+#endif
+
+} // namespace converter
@@ -0,0 +1,145 @@
+#include "metrics.hpp"
+
+#include <iostream>
+
+namespace converter {
+
+MetricsRegistry& MetricsRegistry::global()
+{
+    // Never destroyed: threads may still count during static destruction
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+MetricsRegistry::MetricsRegistry()
+    : entry_count_(0)
+    , counter_count_(0)
+    , gauge_count_(0)
+{
+}
+
+Counter MetricsRegistry::counter(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    const size_t count = entry_count_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; i++) {
+        if (entries_[i].name == name && entries_[i].kind == MetricsSnapshot::Kind::Counter) {
+            return Counter(entries_[i].id);
+        }
+    }
+    if (counter_count_ >= kMaxCounters) {
+        std::cerr << "Metrics: too many counters, '" << name << "' is not recorded" << std::endl;
+        return Counter();
+    }
+
+    // Slot 0 is the discard slot of unregistered handles
+    const uint32_t id = ++counter_count_;
+    entries_[count] = Entry{name, MetricsSnapshot::Kind::Counter, id};
+    entry_count_.store(count + 1, std::memory_order_release);
+    return Counter(id);
+}
+
+Gauge MetricsRegistry::gauge(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    const size_t count = entry_count_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; i++) {
+        if (entries_[i].name == name && entries_[i].kind == MetricsSnapshot::Kind::Gauge) {
+            return Gauge(entries_[i].id);
+        }
+    }
+    if (gauge_count_ >= kMaxGauges) {
+        std::cerr << "Metrics: too many gauges, '" << name << "' is not recorded" << std::endl;
+        return Gauge();
+    }
+
+    const uint32_t id = ++gauge_count_;
+    entries_[count] = Entry{name, MetricsSnapshot::Kind::Gauge, id};
+    entry_count_.store(count + 1, std::memory_order_release);
+    return Gauge(id);
+}
+
+MetricsRegistry::Shard& MetricsRegistry::localShard()
+{
+    // A shard given back by an exited thread keeps its counts
+    static thread_local ThreadSlotLease<Shard> lease;
+    return *lease.get([this]() { return shards_.claim([]() { return new Shard(); }); }, &overflow_shard_);
+}
+
+uint64_t MetricsRegistry::counterValue(uint32_t id) const
+{
+    uint64_t total = overflow_shard_.values[id].load(std::memory_order_relaxed);
+    const size_t count = shards_.count();
+    for (size_t i = 0; i < count; i++) {
+        total += shards_[i].values[id].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const
+{
+    MetricsSnapshot snap;
+    snap.time = std::chrono::steady_clock::now();
+
+    const size_t count = entry_count_.load(std::memory_order_acquire);
+    snap.values.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const Entry& entry = entries_[i];
+        const int64_t value = entry.kind == MetricsSnapshot::Kind::Counter
+            ? static_cast<int64_t>(counterValue(entry.id))
+            : gauges_[entry.id].value.load(std::memory_order_relaxed);
+        snap.values.push_back(MetricsSnapshot::Value{entry.name, entry.kind, value});
+    }
+    return snap;
+}
+
+void Counter::add(uint64_t n) const
+{
+    // Only this thread writes its shard's slot; the atomic add keeps the
+    // shared overflow shard correct and costs no cache-line transfers
+    MetricsRegistry::global().localShard().values[id_].fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const
+{
+    return id_ == 0 ? 0 : MetricsRegistry::global().counterValue(id_);
+}
+
+void Gauge::set(int64_t v) const
+{
+    MetricsRegistry::global().gauges_[id_].value.store(v, std::memory_order_relaxed);
+}
+
+void Gauge::add(int64_t delta) const
+{
+    MetricsRegistry::global().gauges_[id_].value.fetch_add(delta, std::memory_order_relaxed);
+}
+
+int64_t Gauge::value() const
+{
+    return id_ == 0 ? 0 : MetricsRegistry::global().gauges_[id_].value.load(std::memory_order_relaxed);
+}
+
+int64_t MetricsSnapshot::get(const std::string& name) const
+{
+    for (const auto& v : values) {
+        if (v.name == name) {
+            return v.value;
+        }
+    }
+    return 0;
+}
+
+void MetricsSnapshot::writeText(std::ostream& out) const
+{
+    for (const auto& v : values) {
+        out << v.name << " " << v.value << "\n";
+    }
+}
+
+std::string metricName(const Config& cfg, const char* name)
+{
+    return cfg.metrics_prefix + name;
+}
+
+} // namespace converter
@@ -0,0 +1,951 @@
+#include "pipeline.hpp"
+#include "config_loader.hpp"
+#include "crc32c.hpp"
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <chrono>
+
+#ifdef __linux__
+    #include "event_loop.hpp"
+#endif
+
+#ifndef _WIN32
+    #include <csignal>
+    #include <pthread.h>
+#endif
+
+namespace converter {
+
+Pipeline::Pipeline(const Config& cfg,
+                   std::shared_ptr<EventLoop> loop,
+                   std::shared_ptr<DecodeScheduler> scheduler)
+    : config_(cfg)
+    , unpacker_(cfg)
+    , limiter_(cfg)
+    , next_subscription_(1)
+    , tiles_version_(0)
+    , tile_union_version_(UINT64_MAX)
+    , tile_all_(true)
+    , tile_active_(false)
+    , packet_pool_(static_cast<size_t>(cfg.pipeline_pool_size))
+    , soa_pool_(static_cast<size_t>(cfg.pipeline_pool_size))
+    , running_(false)
+    , stop_requested_(false)
+    , input_finished_(false)
+    , lossless_(cfg.protocol == Protocol::File)
+    , frames_delivered_(MetricsRegistry::global().counter(metricName(cfg, "pipeline_frames")))
+    , frames_dropped_(MetricsRegistry::global().counter(metricName(cfg, "pipeline_dropped")))
+    , frames_skipped_(MetricsRegistry::global().counter(metricName(cfg, "pipeline_skipped")))
+    , events_delivered_(MetricsRegistry::global().counter(metricName(cfg, "pipeline_events")))
+    , queue_depth_(MetricsRegistry::global().gauge(metricName(cfg, "pipeline_queue")))
+    , frames_in_flight_gauge_(MetricsRegistry::global().gauge(metricName(cfg, "pipeline_in_flight")))
+    , latency_breaches_(MetricsRegistry::global().counter(metricName(cfg, "pipeline_latency_breaches")))
+    , tiles_active_(MetricsRegistry::global().gauge(metricName(cfg, "tiles_active")))
+    , tiles_skipped_(MetricsRegistry::global().counter(metricName(cfg, "decode_tiles_skipped")))
+    , crc_errors_(MetricsRegistry::global().counter(metricName(cfg, "rx_crc_errors")))
+    , loop_(std::move(loop))
+    , owns_loop_(false)
+    , raw_pool_(static_cast<size_t>(cfg.pipeline_pool_size))
+    , reorder_(lossless_ ? static_cast<size_t>(std::max(cfg.reorder_window, cfg.pipeline_pool_size))
+                         : static_cast<size_t>(cfg.reorder_window),
+               lossless_ ? ReorderBuffer<EventFramePtr>::Clock::duration::max()
+                         : std::chrono::milliseconds(cfg.reorder_max_wait_ms))
+    , delivering_(false)
+    , frames_in_flight_(0)
+    , scheduler_(std::move(scheduler))
+{
+    TraceRecorder::global().configure(config_);
+
+    if (config_.protocol == Protocol::TCP) {
+        receiver_ = std::make_unique<ReceiverVariant>(std::in_place_type<TcpReceiver>, config_);
+    } else if (config_.protocol == Protocol::UDP) {
+        receiver_ = std::make_unique<ReceiverVariant>(std::in_place_type<UdpReceiver>, config_);
+    } else {
+        receiver_ = std::make_unique<ReceiverVariant>(std::in_place_type<FileReceiver>, config_);
+    }
+
+    if (config_.stream_rows > 0) {
+        // Rounded down like decode bands; the last part takes the rest
+        const size_t chunk = static_cast<size_t>(config_.stream_rows) * static_cast<size_t>(config_.width) / 4;
+        auto handler = [this](const uint8_t* payload, size_t size, size_t received) {
+            streamPayload(payload, size, received);
+        };
+        if (auto* tcp = std::get_if<TcpReceiver>(receiver_.get())) {
+            tcp->setPayloadHandler(chunk, handler);
+        } else if (auto* udp = std::get_if<UdpReceiver>(receiver_.get())) {
+            udp->setPayloadHandler(chunk, handler);
+        }
+    }
+
+    if (lossless_ && (loop_ || config_.pipeline_async)) {
+        // Waiting for decoders would stall everything else on the loop
+        std::cerr << "Pipeline: file input uses a receive thread, not the event loop" << std::endl;
+        loop_.reset();
+    }
+
+#ifdef __linux__
+    if (!loop_ && config_.pipeline_async && !lossless_) {
+        loop_ = std::make_shared<EventLoop>();
+        owns_loop_ = true;
+    }
+#else
+    if (loop_ || config_.pipeline_async) {
+        std::cerr << "Pipeline: async receive needs Linux, using a receive thread" << std::endl;
+        loop_.reset();
+    }
+#endif
+
+    TileSelection selection;
+    const size_t tile_count = TileGrid::tileCount(config_.width, config_.height);
+    if (parseTileSelection(config_.tile_subscription, tile_count, selection) && !selection.all()) {
+        subscribeTiles(std::move(selection));
+    }
+
+    if (!scheduler_ && config_.decode_threads > 0) {
+        scheduler_ = std::make_shared<DecodeScheduler>(config_);
+    }
+    if (scheduler_) {
+        // FrameUnpacker is single-threaded: one per worker, all sharing
+        // the kernel choice of unpacker_
+        for (size_t i = 0; i < scheduler_->workerCount(); i++) {
+            worker_unpackers_.push_back(std::make_unique<FrameUnpacker>(config_, unpacker_.getDispatcher()));
+        }
+    }
+}
+
+Pipeline::~Pipeline()
+{
+    stop();
+}
+
+void Pipeline::setCallback(FrameCallback callback)
+{
+    if (running_) {
+        std::cerr << "Pipeline: setCallback() ignored while running" << std::endl;
+        return;
+    }
+    callback_ = std::move(callback);
+}
+
+bool Pipeline::start()
+{
+    if (running_) {
+        return false;
+    }
+    // main() validates too, but library users may not: an out-of-range
+    // header_size alone would overrun the receivers' header buffers
+    if (!validateConfig(config_)) {
+        return false;
+    }
+    // Previous run ended on its own (receive error)
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    stop_requested_ = false;
+    input_finished_ = false;
+    running_ = true;
+    reorder_.reset(0);
+
+#ifdef __linux__
+    if (loop_) {
+        if (!loop_->open()) {
+            running_ = false;
+            return false;
+        }
+        loop_->spawn(runAsync());
+        if (!owns_loop_) {
+            return true;
+        }
+    }
+#endif
+
+#ifndef _WIN32
+    // Leave SIGINT/SIGTERM to the application's threads; the pipeline
+    // thread inherits this mask and is woken by stop() instead
+    sigset_t blocked, previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+#endif
+#ifdef __linux__
+    if (loop_) {
+        thread_ = std::thread([loop = loop_]() { loop->run(); });
+    } else
+#endif
+    thread_ = std::thread(&Pipeline::run, this);
+#ifndef _WIN32
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+#endif
+    return true;
+}
+
+void Pipeline::stop()
+{
+    if (!thread_.joinable() && !running_) {
+        return;
+    }
+
+    stop_requested_ = true;
+
+#ifdef __linux__
+    if (loop_) {
+        // interrupt() runs on the loop thread, between the task's awaits,
+        // so one wake-up is enough; the loop must be running to finish
+        loop_->post([this]() {
+            std::visit([](auto& r) { r.interrupt(); }, *receiver_);
+        });
+        while (running_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+#endif
+
+    // The thread may be between its stop check and a blocking accept/recv,
+    // so keep interrupting until it has noticed
+    while (running_) {
+        {
+            std::lock_guard<std::mutex> lock(receiver_mutex_);
+            std::visit([](auto& r) { r.interrupt(); }, *receiver_);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+#ifdef __linux__
+    if (loop_ && owns_loop_) {
+        loop_->stop();
+    }
+#endif
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    queue_cv_.notify_all();
+}
+
+uint64_t Pipeline::getTotalBytesReceived() const
+{
+    // Receiver counters live in the metrics registry; safe from any thread
+    return std::visit([](const auto& r) { return r.getTotalBytesReceived(); }, *receiver_);
+}
+
+int Pipeline::subscribeTiles(TileSelection selection)
+{
+    const size_t tile_count = TileGrid::tileCount(config_.width, config_.height);
+    for (uint32_t tile : selection.tiles) {
+        if (tile >= tile_count) {
+            std::cerr << "Pipeline: tile " << tile << " is outside the frame (" << tile_count
+                      << " tiles), subscription ignored" << std::endl;
+            return -1;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(tiles_mutex_);
+    const int id = next_subscription_++;
+    tile_subscriptions_.emplace(id, std::move(selection));
+    tiles_version_.fetch_add(1, std::memory_order_release);
+    return id;
+}
+
+void Pipeline::unsubscribeTiles(int id)
+{
+    std::lock_guard<std::mutex> lock(tiles_mutex_);
+    if (tile_subscriptions_.erase(id) > 0) {
+        tiles_version_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void Pipeline::refreshTileUnion()
+{
+    // Subscriptions rarely change: rebuild the union only on a new version
+    // (or resolution)
+    const uint64_t version = tiles_version_.load(std::memory_order_acquire);
+    tile_grid_.resize(config_.width, config_.height);
+    if (version != tile_union_version_ || tile_fixed_.size() != tile_grid_.tileCount()) {
+        std::lock_guard<std::mutex> lock(tiles_mutex_);
+        tile_union_version_ = tiles_version_.load(std::memory_order_relaxed);
+        tile_all_ = tile_subscriptions_.empty();
+        tile_active_ = false;
+        tile_fixed_.assign(tile_grid_.tileCount(), 0);
+        for (const auto& [id, selection] : tile_subscriptions_) {
+            tile_all_ = tile_all_ || selection.all();
+            tile_active_ = tile_active_ || selection.active_only;
+            // subscribeTiles() checked them against the grid
+            for (uint32_t tile : selection.tiles) {
+                tile_fixed_[tile] = 1;
+            }
+        }
+        tile_fixed_ranges_.reset();
+        if (!tile_all_ && !tile_active_) {
+            auto ranges = std::make_shared<std::vector<ByteRange>>();
+            tile_grid_.ranges(tile_fixed_, *ranges);
+            tile_fixed_ranges_ = std::move(ranges);
+        }
+    }
+}
+
+std::shared_ptr<const std::vector<ByteRange>> Pipeline::selectTiles(const TileActivity* activity)
+{
+    if (tile_all_) {
+        return nullptr;
+    }
+    if (!tile_active_) {
+        tiles_skipped_.add(static_cast<uint64_t>(std::count(tile_fixed_.begin(), tile_fixed_.end(), 0)));
+        return tile_fixed_ranges_;
+    }
+
+    // Fixed tiles plus this frame's active ones
+    std::vector<uint8_t> selected = tile_fixed_;
+    const uint32_t threshold = static_cast<uint32_t>(config_.tile_active_threshold);
+    for (size_t tile = 0; tile < selected.size() && activity && tile < activity->counts.size(); tile++) {
+        if (activity->counts[tile] >= threshold) {
+            selected[tile] = 1;
+        }
+    }
+    tiles_skipped_.add(static_cast<uint64_t>(std::count(selected.begin(), selected.end(), 0)));
+    auto ranges = std::make_shared<std::vector<ByteRange>>();
+    tile_grid_.ranges(selected, *ranges);
+    return ranges;
+}
+
+EventFramePtr Pipeline::next(int timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    auto ready = [this]() { return !queue_.empty() || !running_; };
+
+    if (timeout_ms < 0) {
+        queue_cv_.wait(lock, ready);
+    } else {
+        queue_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+    }
+
+    if (queue_.empty()) {
+        return nullptr;
+    }
+    EventFramePtr frame = std::move(queue_.front());
+    queue_.pop_front();
+    queue_depth_.set(static_cast<int64_t>(queue_.size()));
+    TraceRecorder::global().record(TraceStage::Queue, TracePhase::AsyncEnd, frame->frame_number);
+    lock.unlock();
+    queue_space_cv_.notify_one();
+    return frame;
+}
+
+EventFramePtr Pipeline::decodeFrame(FrameUnpacker& unpacker, const uint8_t* data, size_t size, uint64_t frame_number,
+                                    const FrameInfo& info)
+{
+    TraceScope trace(TraceStage::Decode, frame_number);
+
+    // Checked right before decoding, on the thread that decodes, while
+    // the payload is about to be read anyway
+    if (info.crc) {
+        const uint32_t actual = crc32c(data, size);
+        if (actual != *info.crc) {
+            crcFailed(frame_number, *info.crc, actual);
+            return nullptr;
+        }
+    }
+
+    auto frame = std::make_shared<EventFrame>();
+    frame->frame_number = frame_number;
+    frame->timestamp = info.timestamp;
+    frame->row_end = config_.height;
+    frame->received = info.received;
+    frame->decimation = info.decimation;
+    frame->tiles = info.tiles;
+    unpacker.setDecimation(info.decimation);
+    unpacker.setRanges(info.ranges);
+    unpacker.setTimestamp(info.timestamp);
+
+    if (config_.pipeline_soa) {
+        auto soa = soa_pool_.acquire();
+        if (!soa && lossless_) {
+            // The consumer holds every pooled buffer; file input must not drop
+            soa = std::make_shared<EventFrameSoA>();
+        }
+        if (!soa) {
+            return nullptr;
+        }
+        unpacker.unpackSoA(data, size, frame_number, *soa);
+        frame->soa = std::move(soa);
+    } else {
+        auto packet = packet_pool_.acquire();
+        if (!packet && lossless_) {
+            packet = std::make_shared<dv::EventPacket>();
+        }
+        if (!packet) {
+            return nullptr;
+        }
+        // Decoded straight into the pooled packet; the EventStore shares it
+        if (unpacker.unpack(data, size, frame_number, *packet) > 0) {
+            frame->events = dv::EventStore(std::shared_ptr<const dv::EventPacket>(std::move(packet)));
+        }
+    }
+
+    return frame;
+}
+
+void Pipeline::deliver(EventFramePtr frame)
+{
+    const size_t count = frame->soa ? frame->soa->count : frame->events.size();
+    if (frame->frame_end) {
+        frames_delivered_.add();
+    }
+    events_delivered_.add(count);
+
+    if (callback_) {
+        {
+            TraceScope trace(TraceStage::Publish, frame->frame_number);
+            callback_(frame);
+        }
+        checkLatency(*frame);
+        return;
+    }
+
+    TraceRecorder& tracer = TraceRecorder::global();
+    checkLatency(*frame);
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        while (lossless_ && queue_.size() >= static_cast<size_t>(config_.pipeline_queue_depth) && !stop_requested_) {
+            // File input: wait for next() instead of dropping the oldest
+            queue_space_cv_.wait_for(lock, std::chrono::milliseconds(20));
+        }
+        if (queue_.size() >= static_cast<size_t>(config_.pipeline_queue_depth)) {
+            tracer.record(TraceStage::Queue, TracePhase::AsyncEnd, queue_.front()->frame_number);
+            queue_.pop_front();
+            frames_dropped_.add();
+        }
+        tracer.record(TraceStage::Queue, TracePhase::AsyncBegin, frame->frame_number);
+        queue_.push_back(std::move(frame));
+        queue_depth_.set(static_cast<int64_t>(queue_.size()));
+    }
+    queue_cv_.notify_one();
+}
+
+void Pipeline::checkLatency(const EventFrame& frame)
+{
+    if (config_.trace_latency_threshold_us <= 0) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - frame.received <= std::chrono::microseconds(config_.trace_latency_threshold_us)) {
+        return;
+    }
+    latency_breaches_.add();
+    // The rings still hold the breach a second later; more dumps would
+    // only repeat it
+    if (now - last_trace_request_ >= std::chrono::seconds(1)) {
+        last_trace_request_ = now;
+        TraceRecorder::global().requestDump();
+    }
+}
+
+void Pipeline::run()
+{
+    auto connect = [this]() {
+        return std::visit([](auto& r) { return r.connect(); }, *receiver_);
+    };
+    auto disconnect = [this]() {
+        // Sockets must not be closed under a concurrent interrupt()
+        std::lock_guard<std::mutex> lock(receiver_mutex_);
+        std::visit([](auto& r) { r.disconnect(); }, *receiver_);
+    };
+    // tcp_zerocopy: decoded straight from the mapped socket pages. Decode
+    // workers get the frame's buffer, so with a scheduler it is copied
+    TcpReceiver* in_place = config_.tcp_zerocopy && !scheduler_ ? std::get_if<TcpReceiver>(receiver_.get()) : nullptr;
+    const uint8_t* payload = nullptr;
+    size_t payload_size = 0;
+    auto receive = [this, in_place, &payload, &payload_size](std::vector<uint8_t>& buffer) {
+        if (in_place) {
+            return in_place->receiveFrameInPlace(buffer, payload, payload_size);
+        }
+        if (!std::visit([&buffer](auto& r) { return r.receiveFrame(buffer); }, *receiver_)) {
+            return false;
+        }
+        payload = buffer.data();
+        payload_size = buffer.size();
+        return true;
+    };
+
+    std::vector<uint8_t> buffer;
+    uint64_t frame_number = 0;
+    TraceRecorder& tracer = TraceRecorder::global();
+    tracer.setThreadName("receive");
+
+    if (!connect()) {
+        if (!stop_requested_) {
+            std::cerr << "Pipeline: failed to initialize receiver" << std::endl;
+        }
+    } else {
+        while (!stop_requested_) {
+            tracer.record(TraceStage::Receive, TracePhase::Begin, frame_number);
+            stream_.frame_number = frame_number;
+            const bool received = receive(buffer);
+            tracer.record(TraceStage::Receive, TracePhase::End, frame_number);
+            if (!received) {
+                if (stop_requested_) {
+                    break;
+                }
+                if (receiverAtEnd()) {
+                    input_finished_ = true;
+                    break;
+                }
+                std::cerr << "Failed to receive frame. Reconnecting..." << std::endl;
+                disconnect();
+
+                // Wait a bit before reconnecting
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+
+                if (stop_requested_ || !connect()) {
+                    if (!stop_requested_) {
+                        std::cerr << "Reconnection failed." << std::endl;
+                    }
+                    break;
+                }
+                continue;
+            }
+            handleFrame(buffer, payload, payload_size, frame_number++, std::chrono::steady_clock::now());
+        }
+    }
+
+    finish();
+}
+
+void Pipeline::handleFrame(std::vector<uint8_t>& buffer, const uint8_t* payload, size_t payload_size,
+                           uint64_t frame_number, std::chrono::steady_clock::time_point received)
+{
+    if (config_.stream_rows > 0) {
+        // Decoded and delivered while it arrived
+        finishStream(frame_number);
+        return;
+    }
+
+    FrameInfo info;
+    info.received = received;
+    // The camera's clock with versioned headers, else the frame clock
+    const int64_t camera_timestamp = std::visit([](const auto& r) { return r.getFrameTimestamp(); }, *receiver_);
+    info.timestamp = camera_timestamp >= 0 ? camera_timestamp
+                                           : static_cast<int64_t>(frame_number) * config_.frame_interval_us;
+    if (config_.verify_crc) {
+        info.crc = std::visit([](const auto& r) { return r.getFrameCrc(); }, *receiver_);
+    }
+    const size_t size = std::min(payload_size, static_cast<size_t>(config_.frame_size()));
+    refreshTileUnion();
+
+    // The tile scan also counts the frame's events, so decimation
+    // reuses its total instead of a second pass
+    const bool need_tiles = config_.tile_activity || (tile_active_ && !tile_all_);
+    if (need_tiles) {
+        auto activity = std::make_shared<TileActivity>();
+        tile_grid_.count(payload, size, *activity);
+        tiles_active_.set(static_cast<int64_t>(activity->active(static_cast<uint32_t>(config_.tile_active_threshold))));
+        info.tiles = std::move(activity);
+    }
+    info.ranges = selectTiles(info.tiles.get());
+
+    if (config_.decimation_enabled) {
+        // Frames waiting for delivery: pull queue, plus frames still
+        // decoding or held for reordering
+        const int64_t backlog = queue_depth_.value() + frames_in_flight_gauge_.value();
+        const size_t events = info.tiles ? info.tiles->total : countEvents(payload, size);
+        info.decimation = limiter_.choose(events, static_cast<size_t>(std::max<int64_t>(backlog, 0)));
+    }
+
+    if (scheduler_) {
+        scheduleFrame(buffer, frame_number, std::move(info));
+        return;
+    }
+
+    // Frame numbers advance for dropped frames too, so timestamps
+    // stay tied to the camera's frame clock
+    EventFramePtr frame = decodeFrame(unpacker_, payload, payload_size, frame_number, info);
+    if (!frame) {
+        frames_dropped_.add();
+        return;
+    }
+    deliver(std::move(frame));
+}
+
+void Pipeline::scheduleFrame(std::vector<uint8_t>& buffer, uint64_t frame_number, FrameInfo info)
+{
+    auto raw = raw_pool_.acquire();
+    while (!raw && lossless_ && !stop_requested_) {
+        // File input: wait for the decoders instead of dropping. A job
+        // returns its buffer just after jobDone(), hence the timeout
+        std::unique_lock<std::mutex> lock(reorder_mutex_);
+        reorder_cv_.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+            return frames_in_flight_ < raw_pool_.capacity();
+        });
+        lock.unlock();
+        raw = raw_pool_.acquire();
+    }
+    if (!raw) {
+        // Decoders are pipeline_pool_size frames behind
+        complete(frame_number, nullptr);
+        return;
+    }
+    // The receiver continues with the recycled buffer; no copy
+    raw->data.swap(buffer);
+    raw->info = std::move(info);
+
+    {
+        std::unique_lock<std::mutex> lock(reorder_mutex_);
+        frames_in_flight_++;
+        frames_in_flight_gauge_.set(static_cast<int64_t>(frames_in_flight_));
+        // A gap times out here too, not only when a decoder completes
+        const auto deadline = reorder_.nextDeadline();
+        if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+            drainReorder(lock);
+        }
+    }
+
+    const size_t band_rows = static_cast<size_t>(config_.decode_band_rows);
+    const size_t band_count = band_rows > 0 && !config_.pipeline_soa
+        ? (static_cast<size_t>(config_.height) + band_rows - 1) / band_rows
+        : 1;
+
+    if (band_count <= 1) {
+        scheduler_->submit([this, raw, frame_number]() {
+            FrameUnpacker& unpacker = *worker_unpackers_[scheduler_->currentWorker()];
+            EventFramePtr frame;
+            try {
+                frame = decodeFrame(unpacker, raw->data.data(), raw->data.size(), frame_number, raw->info);
+            } catch (const std::exception& e) {
+                // Still completed (as dropped) so the reorder stage does not wait for it
+                std::cerr << "Pipeline: decoding frame " << frame_number << " failed: " << e.what() << std::endl;
+            }
+            complete(frame_number, std::move(frame));
+            jobDone();
+        });
+        return;
+    }
+
+    raw->bands.resize(band_count);
+    raw->band_counts.assign(band_count, 0);
+    raw->band_crcs.assign(raw->info.crc ? band_count : 0, 0);
+    raw->bands_left.store(band_count, std::memory_order_relaxed);
+    for (size_t band = 0; band < band_count; band++) {
+        scheduler_->submit([this, raw, frame_number, band, band_count]() {
+            decodeBand(*raw, frame_number, band, band_count);
+        });
+    }
+}
+
+void Pipeline::decodeBand(RawFrame& raw, uint64_t frame_number, size_t band, size_t band_count)
+{
+    // Band boundaries in bytes; rounding down keeps every byte in exactly
+    // one band when rows do not end on a byte boundary
+    const size_t band_pixels = static_cast<size_t>(config_.decode_band_rows) * static_cast<size_t>(config_.width);
+    const size_t begin = band * band_pixels / 4;
+    const size_t end = band + 1 == band_count ? static_cast<size_t>(config_.frame_size())
+                                              : (band + 1) * band_pixels / 4;
+    // CRC ranges cover the whole payload, including any bytes past the
+    // decoded frame, so the last band's runs to the end of the data
+    const size_t size = raw.data.size();
+    const auto crcBegin = [&](size_t b) { return std::min(b * band_pixels / 4, size); };
+    const auto crcEnd = [&](size_t b) { return b + 1 == band_count ? size : crcBegin(b + 1); };
+
+    FrameUnpacker& unpacker = *worker_unpackers_[scheduler_->currentWorker()];
+    bool failed = false;
+    TraceRecorder::global().record(TraceStage::DecodeBand, TracePhase::Begin, frame_number);
+    try {
+        unpacker.setDecimation(raw.info.decimation);
+        unpacker.setRanges(raw.info.ranges);
+        unpacker.setTimestamp(raw.info.timestamp);
+        std::vector<dv::Event>& out = raw.bands[band];
+        if (out.size() < 4 * (end - begin)) {
+            out.resize(4 * (end - begin));
+        }
+        if (raw.info.crc) {
+            raw.band_crcs[band] = crc32c(raw.data.data() + crcBegin(band), crcEnd(band) - crcBegin(band));
+        }
+        raw.band_counts[band] = unpacker.unpackRange(raw.data.data(), raw.data.size(), frame_number,
+                                                     begin, end, out.data());
+    } catch (const std::exception& e) {
+        std::cerr << "Pipeline: decoding frame " << frame_number << " failed: " << e.what() << std::endl;
+        failed = true;
+    }
+    TraceRecorder::global().record(TraceStage::DecodeBand, TracePhase::End, frame_number);
+    if (failed) {
+        raw.band_failed.store(true, std::memory_order_relaxed);
+    }
+
+    if (raw.bands_left.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    // Last band: check the combined CRC, stitch the bands together in order
+    EventFramePtr result;
+    bool band_failed = raw.band_failed.exchange(false, std::memory_order_relaxed);
+    if (raw.info.crc && !band_failed) {
+        uint32_t actual = raw.band_crcs[0];
+        for (size_t i = 1; i < band_count; i++) {
+            actual = crc32cCombine(actual, raw.band_crcs[i], crcEnd(i) - crcBegin(i));
+        }
+        if (actual != *raw.info.crc) {
+            crcFailed(frame_number, *raw.info.crc, actual);
+            band_failed = true;
+        }
+    }
+    auto packet = band_failed ? nullptr : packet_pool_.acquire();
+    if (!packet && !band_failed && lossless_) {
+        packet = std::make_shared<dv::EventPacket>();
+    }
+    if (packet) {
+        auto frame = std::make_shared<EventFrame>();
+        frame->frame_number = frame_number;
+        frame->timestamp = raw.info.timestamp;
+        frame->row_end = config_.height;
+        frame->received = raw.info.received;
+        frame->decimation = raw.info.decimation;
+        frame->tiles = raw.info.tiles;
+
+        packet->elements.clear();
+        for (size_t i = 0; i < band_count; i++) {
+            packet->elements.insert(packet->elements.end(), raw.bands[i].begin(),
+                                    raw.bands[i].begin() + static_cast<std::ptrdiff_t>(raw.band_counts[i]));
+        }
+        unpacker.recordFrame(packet->elements.size());
+        if (!packet->elements.empty()) {
+            frame->events = dv::EventStore(std::shared_ptr<const dv::EventPacket>(std::move(packet)));
+        }
+        result = std::move(frame);
+    }
+    complete(frame_number, std::move(result));
+    jobDone();
+}
+
+void Pipeline::streamPayload(const uint8_t* payload, size_t size, size_t received)
+{
+    if (!stream_.active || received <= stream_.received) {
+        // First part of a frame (or of the retry after a lost connection)
+        stream_.active = true;
+        stream_.received = 0;
+        stream_.decoded = 0;
+        stream_.events = 0;
+        stream_.crc = 0;
+        stream_.dropped = false;
+        const int64_t camera_timestamp = std::visit([](const auto& r) { return r.getFrameTimestamp(); }, *receiver_);
+        stream_.info.timestamp = camera_timestamp >= 0
+            ? camera_timestamp
+            : static_cast<int64_t>(stream_.frame_number) * config_.frame_interval_us;
+        refreshTileUnion();
+        // Active tiles are only known once the whole frame is in
+        stream_.info.ranges = tile_active_ ? nullptr : selectTiles(nullptr);
+        unpacker_.setDecimation(1);
+        unpacker_.setRanges(stream_.info.ranges);
+        unpacker_.setTimestamp(stream_.info.timestamp);
+    }
+    if (config_.verify_crc && config_.has_header && config_.header_format == HeaderFormat::V1) {
+        // While the bytes are still in cache; checked in finishStream()
+        stream_.crc = crc32c(payload + stream_.received, received - stream_.received, stream_.crc);
+    }
+    stream_.received = received;
+
+    const size_t frame_size = static_cast<size_t>(config_.frame_size());
+    const bool last = received >= size;
+    const size_t begin = stream_.decoded;
+    const size_t end = last ? frame_size : std::min(received, frame_size);
+    if (end <= begin && !last) {
+        return;
+    }
+    stream_.decoded = std::max(begin, end);
+
+    const uint64_t frame_number = stream_.frame_number;
+    TraceScope trace(TraceStage::Decode, frame_number);
+    auto frame = std::make_shared<EventFrame>();
+    frame->frame_number = frame_number;
+    frame->timestamp = stream_.info.timestamp;
+    frame->received = std::chrono::steady_clock::now();
+    frame->row_begin = static_cast<int>(begin * 4 / static_cast<size_t>(config_.width));
+    frame->row_end = last ? config_.height
+                          : static_cast<int>((end * 4 + static_cast<size_t>(config_.width) - 1) /
+                                             static_cast<size_t>(config_.width));
+    frame->frame_end = last;
+
+    if (end > begin) {
+        auto packet = packet_pool_.acquire();
+        if (!packet) {
+            // The part's events are lost; the frame still ends with frame_end
+            stream_.dropped = true;
+            if (!last) {
+                return;
+            }
+        } else {
+            if (stream_.scratch.size() < 4 * (end - begin)) {
+                stream_.scratch.resize(4 * (end - begin));
+            }
+            const size_t count = unpacker_.unpackRange(payload, size, frame_number, begin, end,
+                                                       stream_.scratch.data());
+            stream_.events += count;
+            packet->elements.assign(stream_.scratch.begin(),
+                                    stream_.scratch.begin() + static_cast<std::ptrdiff_t>(count));
+            if (count > 0) {
+                frame->events = dv::EventStore(std::shared_ptr<const dv::EventPacket>(std::move(packet)));
+            }
+        }
+    }
+    deliver(std::move(frame));
+}
+
+void Pipeline::finishStream(uint64_t frame_number)
+{
+    if (!stream_.active) {
+        return;
+    }
+    stream_.active = false;
+    unpacker_.recordFrame(stream_.events);
+    if (stream_.dropped) {
+        frames_dropped_.add();
+    }
+    const std::optional<uint32_t> expected = std::visit([](const auto& r) { return r.getFrameCrc(); }, *receiver_);
+    if (config_.verify_crc && expected && *expected != stream_.crc) {
+        // Already delivered: counted only
+        crcFailed(frame_number, *expected, stream_.crc);
+    }
+}
+
+void Pipeline::crcFailed(uint64_t frame_number, uint32_t expected, uint32_t actual)
+{
+    crc_errors_.add();
+    if (config_.verbose) {
+        std::cout << "Frame " << frame_number << ": CRC32C mismatch (expected " << std::hex << expected
+                  << ", got " << actual << std::dec << ")" << std::endl;
+    }
+}
+
+void Pipeline::complete(uint64_t frame_number, EventFramePtr frame)
+{
+    std::unique_lock<std::mutex> lock(reorder_mutex_);
+    if (reorder_.insert(frame_number, std::move(frame))) {
+        TraceRecorder::global().record(TraceStage::Reorder, TracePhase::AsyncBegin, frame_number);
+    } else {
+        // Its slot was skipped already
+        frames_dropped_.add();
+    }
+    drainReorder(lock);
+}
+
+void Pipeline::drainReorder(std::unique_lock<std::mutex>& lock, bool flush)
+{
+    // One thread at a time delivers; others just leave their frame behind
+    // for it, so callbacks never run concurrently or out of order
+    if (delivering_) {
+        return;
+    }
+    delivering_ = true;
+    while (true) {
+        const uint64_t skipped = reorder_.getSkipped();
+        std::optional<EventFramePtr> next = flush ? reorder_.popAny() : reorder_.pop();
+        if (reorder_.getSkipped() != skipped) {
+            frames_skipped_.add(reorder_.getSkipped() - skipped);
+        }
+        if (!next) {
+            break;
+        }
+        TraceRecorder::global().record(TraceStage::Reorder, TracePhase::AsyncEnd, reorder_.next() - 1);
+        lock.unlock();
+        if (*next) {
+            deliver(std::move(*next));
+        } else {
+            frames_dropped_.add();
+        }
+        lock.lock();
+    }
+    delivering_ = false;
+}
+
+void Pipeline::jobDone()
+{
+    {
+        std::lock_guard<std::mutex> lock(reorder_mutex_);
+        frames_in_flight_--;
+        frames_in_flight_gauge_.set(static_cast<int64_t>(frames_in_flight_));
+    }
+    reorder_cv_.notify_all();
+}
+
+bool Pipeline::receiverAtEnd() const
+{
+    const FileReceiver* file = std::get_if<FileReceiver>(receiver_.get());
+    return file && file->atEnd();
+}
+
+void Pipeline::finish()
+{
+    if (scheduler_) {
+        // Decode jobs reference this pipeline; let them deliver first
+        std::unique_lock<std::mutex> lock(reorder_mutex_);
+        reorder_cv_.wait(lock, [this]() { return frames_in_flight_ == 0; });
+        drainReorder(lock, true);
+    }
+
+    {
+        // Sockets must not be closed under a concurrent interrupt()
+        std::lock_guard<std::mutex> lock(receiver_mutex_);
+        std::visit([](auto& r) { r.disconnect(); }, *receiver_);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+}
+
+#ifdef __linux__
+Task<void> Pipeline::runAsync()
+{
+    EventLoop& loop = *loop_;
+    auto connect = [this, &loop]() {
+        return std::visit([&loop](auto& r) { return r.connectAsync(loop); }, *receiver_);
+    };
+    auto receive = [this, &loop](std::vector<uint8_t>& buffer) {
+        return std::visit([&loop, &buffer](auto& r) { return r.receiveFrameAsync(loop, buffer); }, *receiver_);
+    };
+
+    // Same flow as run(); only the waits differ. interrupt() is posted to
+    // this loop by stop(), so it never races disconnect() here.
+    std::vector<uint8_t> buffer;
+    uint64_t frame_number = 0;
+    TraceRecorder& tracer = TraceRecorder::global();
+
+    if (!co_await connect()) {
+        if (!stop_requested_) {
+            std::cerr << "Pipeline: failed to initialize receiver" << std::endl;
+        }
+    } else {
+        while (!stop_requested_) {
+            // Async span: other tasks on this loop record in between
+            tracer.record(TraceStage::Receive, TracePhase::AsyncBegin, frame_number);
+            stream_.frame_number = frame_number;
+            const bool received = co_await receive(buffer);
+            tracer.record(TraceStage::Receive, TracePhase::AsyncEnd, frame_number);
+            if (!received) {
+                if (stop_requested_) {
+                    break;
+                }
+                std::cerr << "Failed to receive frame. Reconnecting..." << std::endl;
+                std::visit([](auto& r) { r.disconnect(); }, *receiver_);
+
+                // Wait a bit before reconnecting
+                co_await loop.sleepFor(std::chrono::seconds(1));
+
+                if (stop_requested_ || !co_await connect()) {
+                    if (!stop_requested_) {
+                        std::cerr << "Reconnection failed." << std::endl;
+                    }
+                    break;
+                }
+                continue;
+            }
+            handleFrame(buffer, buffer.data(), buffer.size(), frame_number++, std::chrono::steady_clock::now());
+        }
+    }
+
+    finish();
+}
+#endif
+
+} // namespace converter
@@ -0,0 +1,172 @@
+#include "recording.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace converter {
+
+namespace {
+
+constexpr const char* kIndexMagic = "# DVBridge recording index";
+constexpr int kIndexVersion = 1;
+
+} // namespace
+
+std::string RecordingIndex::indexPath(const std::string& output_file)
+{
+    return output_file + ".index";
+}
+
+std::string RecordingIndex::segmentPath(const std::string& output_file, size_t index)
+{
+    char number[16];
+    std::snprintf(number, sizeof(number), ".%05zu", index);
+    const std::filesystem::path path(output_file);
+    std::filesystem::path segment = path;
+    segment.replace_filename(path.stem().string() + number + path.extension().string());
+    return segment.string();
+}
+
+bool RecordingIndex::create(const Config& cfg)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string path = indexPath(cfg.output_file);
+    out_.open(path, std::ios::trunc);
+    if (!out_) {
+        std::cerr << "Failed to create " << path << std::endl;
+        return false;
+    }
+    out_ << kIndexMagic << " " << kIndexVersion << "\n"
+         << "# width=" << cfg.width << " height=" << cfg.height << " frame_interval_us=" << cfg.frame_interval_us << "\n"
+         << "# path first_frame frames begin_us end_us events" << std::endl;
+    return true;
+}
+
+void RecordingIndex::add(const RecordingSegment& segment)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Flushed per line: an interrupted recording keeps its index
+    out_ << std::filesystem::path(segment.path).filename().string() << " " << segment.first_frame << " "
+         << segment.frames << " " << segment.begin_us << " " << segment.end_us << " " << segment.events << std::endl;
+}
+
+bool RecordingIndex::load(const std::string& path, std::vector<RecordingSegment>& segments)
+{
+    segments.clear();
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line) || line.rfind(kIndexMagic, 0) != 0) {
+        std::cerr << path << " is not a DVBridge recording index" << std::endl;
+        return false;
+    }
+
+    const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        RecordingSegment segment;
+        std::string name;
+        if (!(fields >> name >> segment.first_frame >> segment.frames >> segment.begin_us >> segment.end_us
+                     >> segment.events)) {
+            std::cerr << path << ": malformed line '" << line << "'" << std::endl;
+            return false;
+        }
+        segment.path = (directory / name).string();
+        segments.push_back(std::move(segment));
+    }
+    std::sort(segments.begin(), segments.end(), [](const RecordingSegment& a, const RecordingSegment& b) {
+        return a.first_frame < b.first_frame;
+    });
+    return true;
+}
+
+RecordingWriter::RecordingWriter(const Config& cfg)
+    : config_(cfg)
+    , next_frame_(0)
+    , failed_(false)
+{
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    close();
+}
+
+bool RecordingWriter::open()
+{
+    failed_ = false;
+    next_frame_ = 0;
+    return index_.create(config_) && startSegment(0);
+}
+
+bool RecordingWriter::startSegment(uint64_t first_frame)
+{
+    const uint64_t segment_frames = static_cast<uint64_t>(config_.output_segment_frames);
+    segment_ = RecordingSegment();
+    segment_.path = segment_frames > 0
+        ? RecordingIndex::segmentPath(config_.output_file, static_cast<size_t>(first_frame / segment_frames))
+        : config_.output_file;
+    segment_.first_frame = first_frame;
+    // Replaced by the frames' timestamps once written
+    segment_.begin_us = static_cast<int64_t>(first_frame) * config_.frame_interval_us;
+    segment_.end_us = segment_.begin_us;
+    try {
+        writer_ = std::make_unique<dv::io::MonoCameraWriter>(
+            segment_.path,
+            dv::io::MonoCameraWriter::EventOnlyConfig("DVBridge", cv::Size(config_.width, config_.height))
+        );
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create " << segment_.path << ": " << e.what() << std::endl;
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+void RecordingWriter::finishSegment(uint64_t end_frame)
+{
+    // Closing the writer completes the file (packet table)
+    writer_.reset();
+    segment_.frames = end_frame - segment_.first_frame;
+    index_.add(segment_);
+}
+
+void RecordingWriter::write(uint64_t frame_number, int64_t timestamp, const dv::EventStore& events)
+{
+    if (failed_) {
+        return;
+    }
+    const uint64_t segment_frames = static_cast<uint64_t>(config_.output_segment_frames);
+    if (segment_frames > 0 && frame_number >= segment_.first_frame + segment_frames) {
+        // Frames lost across the boundary still count towards the old segment
+        finishSegment(segment_.first_frame + segment_frames);
+        if (!startSegment(frame_number / segment_frames * segment_frames)) {
+            return;
+        }
+    }
+    if (next_frame_ <= segment_.first_frame) {
+        // First frame of the segment
+        segment_.begin_us = timestamp;
+    }
+    segment_.end_us = timestamp + config_.frame_interval_us;
+    if (!events.isEmpty()) {
+        writer_->writeEvents(events);
+        segment_.events += events.size();
+    }
+    next_frame_ = frame_number + 1;
+}
+
+void RecordingWriter::close()
+{
+    if (writer_) {
+        finishSegment(std::max(next_frame_, segment_.first_frame));
+    }
+}
+
+} // namespace converter
@@ -0,0 +1,204 @@
+#include "shm_reader.hpp"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace converter {
+
+SharedMemoryReader::SharedMemoryReader(std::string name)
+    : name_(std::move(name))
+    , fd_(-1)
+    , region_(nullptr)
+    , control_(nullptr)
+    , mapped_size_(0)
+    , control_size_(0)
+    , read_index_(0)
+    , overrun_packets_(0)
+{
+}
+
+SharedMemoryReader::~SharedMemoryReader()
+{
+    close();
+}
+
+bool SharedMemoryReader::open()
+{
+    if (region_ != nullptr) {
+        return true;
+    }
+
+    fd_ = shm_open(name_.c_str(), O_RDWR, 0);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open shared memory " << name_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(shm::RingHeader)) {
+        std::cerr << "Shared memory " << name_ << " is not initialized" << std::endl;
+        close();
+        return false;
+    }
+
+    // Event data is mapped read-only; only the control page (waiter count)
+    // is writable, so a buggy consumer cannot corrupt the ring
+    void* region = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd_, 0);
+    if (region == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    region_ = static_cast<const shm::RingHeader*>(region);
+    mapped_size_ = static_cast<size_t>(st.st_size);
+
+    control_size_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* control = mmap(nullptr, control_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (control == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory control page: " << std::strerror(errno) << std::endl;
+        control_size_ = 0;
+        close();
+        return false;
+    }
+    control_ = static_cast<shm::RingHeader*>(control);
+
+    if (region_->magic != shm::kMagic || region_->version != shm::kVersion) {
+        std::cerr << "Shared memory " << name_ << " has unknown format (magic 0x" << std::hex
+                  << region_->magic << std::dec << ", version " << region_->version << ")" << std::endl;
+        close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (region_->layout != shm::kLayoutEvents && region_->layout != shm::kLayoutSoA) {
+        std::cerr << "Shared memory " << name_ << " has unknown slot layout " << region_->layout << std::endl;
+        close();
+        return false;
+    }
+
+    if (mapped_size_ < shm::regionSize(region_->slot_count, region_->slot_capacity, region_->layout)) {
+        std::cerr << "Shared memory " << name_ << " is smaller than its header claims" << std::endl;
+        close();
+        return false;
+    }
+
+    // Start at the live tail rather than replaying stale slots
+    read_index_ = region_->write_index.load(std::memory_order_acquire);
+    overrun_packets_ = 0;
+    return true;
+}
+
+void SharedMemoryReader::close()
+{
+    if (control_ != nullptr) {
+        munmap(control_, control_size_);
+        control_ = nullptr;
+        control_size_ = 0;
+    }
+    if (region_ != nullptr) {
+        munmap(const_cast<shm::RingHeader*>(region_), mapped_size_);
+        region_ = nullptr;
+        mapped_size_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+SharedMemoryReader::Status SharedMemoryReader::next(Packet& packet, int timeout_ms)
+{
+    if (region_ == nullptr) {
+        return Status::Closed;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    const uint64_t slot_count = region_->slot_count;
+
+    while (true) {
+        if (region_->magic != shm::kMagic) {
+            return Status::Closed;
+        }
+
+        const uint64_t written = region_->write_index.load(std::memory_order_acquire);
+
+        // Writer lapped us: jump to the oldest packet that can still be intact
+        if (written > read_index_ + slot_count) {
+            overrun_packets_ += written - slot_count - read_index_;
+            read_index_ = written - slot_count;
+        }
+
+        if (read_index_ < written) {
+            const shm::SlotHeader* slot = shm::slotAt(region_, read_index_);
+            const uint64_t expected = 2 * read_index_ + 2;
+
+            if (slot->sequence.load(std::memory_order_acquire) == expected) {
+                if (region_->layout == shm::kLayoutSoA) {
+                    packet.events = nullptr;
+                    packet.x = shm::slotX(slot);
+                    packet.y = shm::slotY(slot, region_->slot_capacity);
+                    packet.polarity = shm::slotPolarity(slot, region_->slot_capacity);
+                } else {
+                    packet.events = shm::slotEvents(slot);
+                    packet.x = nullptr;
+                    packet.y = nullptr;
+                    packet.polarity = nullptr;
+                }
+                packet.count = slot->event_count;
+                packet.flags = slot->flags;
+                packet.frame_number = slot->frame_number;
+                packet.timestamp = slot->timestamp;
+                packet.index = read_index_;
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot->sequence.load(std::memory_order_relaxed) == expected) {
+                    read_index_++;
+                    return Status::Ok;
+                }
+            }
+
+            // Slot was recycled between the index load and the read
+            overrun_packets_++;
+            read_index_++;
+            continue;
+        }
+
+        // Nothing new: sleep on the futex until the writer publishes
+        const uint32_t wake = region_->wake_counter.load(std::memory_order_acquire);
+        if (region_->write_index.load(std::memory_order_acquire) != written) {
+            continue;
+        }
+
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                return Status::Timeout;
+            }
+            wait_ms = static_cast<int>(remaining);
+        }
+
+        control_->waiter_count.fetch_add(1, std::memory_order_seq_cst);
+        shm::futexWait(&control_->wake_counter, wake, wait_ms);
+        control_->waiter_count.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+bool SharedMemoryReader::isValid(const Packet& packet) const
+{
+    if (region_ == nullptr) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const shm::SlotHeader* slot = shm::slotAt(region_, packet.index);
+    return slot->sequence.load(std::memory_order_relaxed) == 2 * packet.index + 2;
+}
+
+} // namespace converter
@@ -0,0 +1,243 @@
+#include "shm_writer.hpp"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace converter {
+
+static_assert(sizeof(dv::Event) == sizeof(shm::PackedEvent),
+              "dv::Event layout no longer matches shm::PackedEvent");
+
+SharedMemoryWriter::SharedMemoryWriter(const Config& cfg)
+    : config_(cfg)
+    , name_(cfg.shm_name)
+    , fd_(-1)
+    , header_(nullptr)
+    , mapped_size_(0)
+    , next_packet_(0)
+    , packets_written_(MetricsRegistry::global().counter(metricName(cfg, "shm_packets")))
+    , events_written_(MetricsRegistry::global().counter(metricName(cfg, "shm_events")))
+{
+}
+
+SharedMemoryWriter::~SharedMemoryWriter()
+{
+    close();
+}
+
+bool SharedMemoryWriter::open()
+{
+    if (header_ != nullptr) {
+        return true;
+    }
+
+    if (config_.shm_slot_count <= 0 || config_.shm_slot_events <= 0) {
+        std::cerr << "Invalid shared memory ring size: " << config_.shm_slot_count
+                  << " slots x " << config_.shm_slot_events << " events" << std::endl;
+        return false;
+    }
+
+    name_ = config_.shm_name;
+    const uint32_t layout = config_.shm_soa ? shm::kLayoutSoA : shm::kLayoutEvents;
+    const auto slot_count = static_cast<uint32_t>(config_.shm_slot_count);
+    auto slot_capacity = static_cast<uint32_t>(config_.shm_slot_events);
+    if (layout == shm::kLayoutSoA) {
+        // Whole polarity words per packet
+        slot_capacity = (slot_capacity + 63) & ~63u;
+    }
+    const uint64_t size = shm::regionSize(slot_count, slot_capacity, layout);
+
+    // Remove a stale object left by a crashed run so readers never see an
+    // old header with a different geometry
+    shm_unlink(name_.c_str());
+
+    const auto mode = static_cast<mode_t>(config_.shm_mode);
+    fd_ = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, mode);
+    if (fd_ < 0) {
+        std::cerr << "Failed to create shared memory " << name_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // shm_open() applies the umask; set exactly what was configured
+    if (fchmod(fd_, mode) < 0) {
+        std::cerr << "Failed to set shared memory permissions: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    if (ftruncate(fd_, static_cast<off_t>(size)) < 0) {
+        std::cerr << "Failed to size shared memory to " << size << " bytes: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    mapped_size_ = size;
+
+    // Fresh ftruncate'd pages are zero, so all sequences start at 0 (empty)
+    header_ = static_cast<shm::RingHeader*>(addr);
+    header_->version = shm::kVersion;
+    header_->slot_count = slot_count;
+    header_->slot_capacity = slot_capacity;
+    header_->slot_stride = shm::slotStride(slot_capacity, layout);
+    header_->width = config_.width;
+    header_->height = config_.height;
+    header_->layout = layout;
+    header_->write_index.store(0, std::memory_order_relaxed);
+    header_->wake_counter.store(0, std::memory_order_relaxed);
+    header_->waiter_count.store(0, std::memory_order_relaxed);
+    next_packet_ = 0;
+
+    // Magic last: readers treat the ring as initialized only once it is set
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = shm::kMagic;
+
+    std::cout << "Shared memory output: " << name_ << " (" << slot_count << " slots x "
+              << slot_capacity << " events, " << (layout == shm::kLayoutSoA ? "SoA, " : "")
+              << (size / (1024 * 1024)) << " MB)" << std::endl;
+    return true;
+}
+
+void SharedMemoryWriter::close()
+{
+    if (header_ != nullptr) {
+        // Wake blocked readers so they notice the writer went away
+        header_->magic = 0;
+        header_->wake_counter.fetch_add(1, std::memory_order_release);
+        shm::futexWakeAll(&header_->wake_counter);
+        munmap(header_, mapped_size_);
+        header_ = nullptr;
+        mapped_size_ = 0;
+    }
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+        shm_unlink(name_.c_str());
+    }
+}
+
+shm::SlotHeader* SharedMemoryWriter::beginPacket()
+{
+    shm::SlotHeader* slot = shm::slotAt(header_, next_packet_);
+    slot->sequence.store(2 * next_packet_ + 1, std::memory_order_relaxed);
+    // Order the odd sequence before any event stores
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot;
+}
+
+void SharedMemoryWriter::commitPacket(shm::SlotHeader* slot, uint32_t count, uint64_t frame_number,
+                                      int64_t timestamp, uint32_t flags)
+{
+    slot->frame_number = frame_number;
+    slot->timestamp = timestamp;
+    slot->event_count = count;
+    slot->flags = flags;
+    slot->sequence.store(2 * next_packet_ + 2, std::memory_order_release);
+
+    next_packet_++;
+    header_->write_index.store(next_packet_, std::memory_order_release);
+    packets_written_.add();
+    events_written_.add(count);
+    header_->wake_counter.fetch_add(1, std::memory_order_seq_cst);
+
+    // Skip the syscall entirely when nobody is sleeping. seq_cst pairs with
+    // the reader's waiter_count increment so a wakeup can't be lost
+    if (header_->waiter_count.load(std::memory_order_seq_cst) > 0) {
+        shm::futexWakeAll(&header_->wake_counter);
+    }
+}
+
+template <typename Fill>
+size_t SharedMemoryWriter::publish(size_t total, uint64_t frame_number, int64_t timestamp, Fill&& fill)
+{
+    const size_t capacity = header_->slot_capacity;
+    size_t packets = 0;
+    size_t first = 0;
+
+    // An empty frame still takes one packet. The converter skips empty
+    // frames before publishing, but library callers may publish them
+    do {
+        const size_t n = std::min(capacity, total - first);
+        shm::SlotHeader* slot = beginPacket();
+        fill(slot, first, n);
+        first += n;
+        commitPacket(slot, static_cast<uint32_t>(n), frame_number, timestamp,
+                     first < total ? shm::kFlagContinued : 0);
+        packets++;
+    } while (first < total);
+
+    return packets;
+}
+
+size_t SharedMemoryWriter::writeEvents(const dv::EventStore& events, uint64_t frame_number, int64_t timestamp)
+{
+    if (header_ == nullptr) {
+        return 0;
+    }
+
+    const uint32_t capacity = header_->slot_capacity;
+    const bool soa = header_->layout == shm::kLayoutSoA;
+    auto it = events.begin();
+
+    return publish(events.size(), frame_number, timestamp, [&](shm::SlotHeader* slot, size_t, size_t n) {
+        if (soa) {
+            int16_t* xs = shm::slotX(slot);
+            int16_t* ys = shm::slotY(slot, capacity);
+            PolarityPacker polarity(shm::slotPolarity(slot, capacity), 0);
+            for (size_t i = 0; i < n; i++, ++it) {
+                xs[i] = it->x();
+                ys[i] = it->y();
+                polarity.push(it->polarity() ? 1 : 0, 1);
+            }
+            polarity.flush();
+        } else {
+            shm::PackedEvent* dst = shm::slotEvents(slot);
+            for (size_t i = 0; i < n; i++, ++it) {
+                std::memcpy(&dst[i], &*it, sizeof(shm::PackedEvent));
+            }
+        }
+    });
+}
+
+size_t SharedMemoryWriter::writeFrame(const EventFrameSoA& frame)
+{
+    if (header_ == nullptr) {
+        return 0;
+    }
+
+    const uint32_t capacity = header_->slot_capacity;
+    const bool soa = header_->layout == shm::kLayoutSoA;
+
+    return publish(frame.count, frame.frame_number, frame.timestamp, [&](shm::SlotHeader* slot, size_t first, size_t n) {
+        if (soa) {
+            // Capacity is a multiple of 64, so first is word aligned
+            std::memcpy(shm::slotX(slot), frame.x.data() + first, n * sizeof(int16_t));
+            std::memcpy(shm::slotY(slot, capacity), frame.y.data() + first, n * sizeof(int16_t));
+            std::memcpy(shm::slotPolarity(slot, capacity), frame.polarity.data() + first / 64,
+                        polarityWords(n) * sizeof(uint64_t));
+        } else {
+            shm::PackedEvent* dst = shm::slotEvents(slot);
+            for (size_t i = 0; i < n; i++) {
+                dst[i].timestamp = frame.timestamp;
+                dst[i].x = frame.x[first + i];
+                dst[i].y = frame.y[first + i];
+                dst[i].polarity = frame.positive(first + i) ? 1 : 0;
+                std::memset(dst[i].reserved, 0, sizeof(dst[i].reserved));
+            }
+        }
+    });
+}
+
+} // namespace converter
@@ -0,0 +1,156 @@
+#include "stripe_assembler.hpp"
+
+#include <algorithm>
+
+namespace converter {
+
+namespace {
+
+// Unwrapped sequence numbers start here, so "K-1 frames before the
+// first" never goes below zero
+constexpr uint64_t kSequenceBase = uint64_t(1) << 32;
+
+} // namespace
+
+StripeAssembler::StripeAssembler(size_t connections, size_t capacity, std::chrono::milliseconds max_wait,
+                                 Counter frames_lost)
+    : capacity_(std::max<size_t>(capacity, 1))
+    , max_wait_(max_wait)
+    , frames_lost_(frames_lost)
+    , last_(connections)
+    , open_(connections, true)
+    , next_(0)
+    , started_(false)
+    , released_(false)
+    , ended_(false)
+    , closed_(false)
+{
+}
+
+std::vector<uint8_t> StripeAssembler::takeBuffer()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_buffers_.empty()) {
+        return {};
+    }
+    std::vector<uint8_t> buffer = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    return buffer;
+}
+
+uint64_t StripeAssembler::sequence(uint32_t counter) const
+{
+    // Counters wrap at 2^32; anything within 2^31 of next_ is unambiguous
+    const int32_t delta = static_cast<int32_t>(counter - static_cast<uint32_t>(next_));
+    return next_ + static_cast<uint64_t>(static_cast<int64_t>(delta));
+}
+
+bool StripeAssembler::push(size_t connection, Frame frame)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_cv_.wait(lock, [this]() { return closed_ || pending_.size() < capacity_; });
+    if (closed_) {
+        return false;
+    }
+
+    if (!started_) {
+        started_ = true;
+        next_ = kSequenceBase + frame.counter - (frame.counter_reset ? 0 : last_.size() - 1);
+    }
+    const uint64_t seq = sequence(frame.counter);
+    if (frame.counter_reset && !released_ && seq > next_) {
+        // The stream starts here; earlier sequence numbers never existed
+        next_ = seq;
+        pending_.erase(pending_.begin(), pending_.lower_bound(seq));
+    }
+    if (connection < last_.size()) {
+        last_[connection] = seq;
+    }
+    if (seq >= next_) {
+        pending_.emplace(seq, std::move(frame));
+    }
+    // else: its slot was skipped already; dropped (counted as lost then)
+    lock.unlock();
+    ready_cv_.notify_one();
+    return true;
+}
+
+void StripeAssembler::closeConnection(size_t connection)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (connection < open_.size()) {
+            open_[connection] = false;
+        }
+        ended_ = true;
+    }
+    ready_cv_.notify_all();
+}
+
+void StripeAssembler::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    ready_cv_.notify_all();
+    space_cv_.notify_all();
+}
+
+bool StripeAssembler::mayArrive() const
+{
+    for (size_t i = 0; i < last_.size(); i++) {
+        if (open_[i] && (!last_[i] || *last_[i] < next_)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StripeAssembler::pop(Frame& frame)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::optional<std::chrono::steady_clock::time_point> blocked_since;
+    while (!closed_) {
+        auto it = pending_.begin();
+        if (it != pending_.end()) {
+            bool release = it->first == next_;
+            if (!release) {
+                // Gap: give up on it once it cannot arrive any more, the
+                // stream ended, the readers are blocked, or it waited long
+                const auto now = std::chrono::steady_clock::now();
+                if (!blocked_since) {
+                    blocked_since = now;
+                }
+                release = !mayArrive() || ended_ || pending_.size() >= capacity_ ||
+                          now - *blocked_since >= max_wait_;
+                // Before the first frame, next_ is a guess (up to K-1 early
+                // without CounterReset): skipped slots may never have existed
+                if (release && released_) {
+                    frames_lost_.add(it->first - next_);
+                }
+            }
+            if (release) {
+                if (frame.data.capacity() > 0 && free_buffers_.size() < capacity_) {
+                    free_buffers_.push_back(std::move(frame.data));
+                }
+                frame = std::move(it->second);
+                next_ = it->first + 1;
+                released_ = true;
+                pending_.erase(it);
+                lock.unlock();
+                space_cv_.notify_one();
+                return true;
+            }
+            ready_cv_.wait_until(lock, *blocked_since + max_wait_);
+            continue;
+        }
+        if (ended_) {
+            return false;
+        }
+        ready_cv_.wait(lock);
+    }
+    return false;
+}
+
+} // namespace converter
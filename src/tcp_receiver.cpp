@@ -1,6 +1,11 @@
 #include "tcp_receiver.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cstring>
+#include <cerrno>
+#ifdef __linux__
+    #include <fcntl.h>
+#endif
 
 // Windows doesn't define ssize_t
 #ifdef _WIN32
@@ -17,8 +22,12 @@ TcpReceiver::TcpReceiver(const Config& cfg)
     , server_socket_(INVALID_SOCK)
     , client_socket_(INVALID_SOCK)
     , connected_(false)
-    , total_bytes_received_(0)
-    , total_frames_received_(0)
+    , header_(cfg)
+    , payload_chunk_(1)
+    , zerocopy_bytes_(MetricsRegistry::global().counter(metricName(cfg, "rx_zerocopy_bytes")))
+    , zerocopy_frames_(MetricsRegistry::global().counter(metricName(cfg, "rx_zerocopy_frames")))
+    , bytes_received_(MetricsRegistry::global().counter(metricName(cfg, "rx_bytes")))
+    , frames_received_(MetricsRegistry::global().counter(metricName(cfg, "rx_frames")))
 {
     initSocketLib();
 }
@@ -33,8 +42,17 @@ TcpReceiver::TcpReceiver(TcpReceiver&& other) noexcept
     , server_socket_(other.server_socket_)
     , client_socket_(other.client_socket_)
     , connected_(other.connected_)
-    , total_bytes_received_(other.total_bytes_received_)
-    , total_frames_received_(other.total_frames_received_)
+    , header_(other.header_)
+    , payload_handler_(std::move(other.payload_handler_))
+    , payload_chunk_(other.payload_chunk_)
+    , stripes_(std::move(other.stripes_))
+    , assembler_(std::move(other.assembler_))
+    , striped_frame_(std::move(other.striped_frame_))
+    , zerocopy_(std::move(other.zerocopy_))
+    , zerocopy_bytes_(other.zerocopy_bytes_)
+    , zerocopy_frames_(other.zerocopy_frames_)
+    , bytes_received_(other.bytes_received_)
+    , frames_received_(other.frames_received_)
 {
     other.server_socket_ = INVALID_SOCK;
     other.client_socket_ = INVALID_SOCK;
@@ -48,8 +66,18 @@ TcpReceiver& TcpReceiver::operator=(TcpReceiver&& other) noexcept
         server_socket_ = other.server_socket_;
         client_socket_ = other.client_socket_;
         connected_ = other.connected_;
-        total_bytes_received_ = other.total_bytes_received_;
-        total_frames_received_ = other.total_frames_received_;
+        header_ = other.header_;
+        payload_handler_ = std::move(other.payload_handler_);
+        payload_chunk_ = other.payload_chunk_;
+        // Reader threads hold the stripes and the assembler, not the receiver
+        stripes_ = std::move(other.stripes_);
+        assembler_ = std::move(other.assembler_);
+        striped_frame_ = std::move(other.striped_frame_);
+        zerocopy_ = std::move(other.zerocopy_);
+        zerocopy_bytes_ = other.zerocopy_bytes_;
+        zerocopy_frames_ = other.zerocopy_frames_;
+        bytes_received_ = other.bytes_received_;
+        frames_received_ = other.frames_received_;
         other.server_socket_ = INVALID_SOCK;
         other.client_socket_ = INVALID_SOCK;
         other.connected_ = false;
@@ -83,16 +111,8 @@ void TcpReceiver::cleanupSocketLib()
 #endif
 }
 
-bool TcpReceiver::connect()
+bool TcpReceiver::listenSocket()
 {
-    if (connected_) {
-        std::cerr << "Already connected" << std::endl;
-        return true;
-    }
-    
-    // Close any existing sockets
-    disconnect();
-    
     // Create server socket
     server_socket_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
     if (server_socket_ == INVALID_SOCK) {
@@ -123,8 +143,8 @@ bool TcpReceiver::connect()
         return false;
     }
     
-    // Listen for connections
-    if (listen(server_socket_, 1) < 0) {
+    // Listen for connections (all of a striped stream at once)
+    if (listen(server_socket_, config_.tcp_connections) < 0) {
         std::cerr << "Failed to listen: " << SOCKET_ERROR_CODE << std::endl;
         disconnect();
         return false;
@@ -132,18 +152,11 @@ bool TcpReceiver::connect()
     
     std::cout << "Listening on port " << config_.camera_port << "..." << std::endl;
     std::cout << "Waiting for FPGA to connect..." << std::endl;
-    
-    // Accept connection from FPGA
-    struct sockaddr_in client_addr;
-    socklen_t client_len = sizeof(client_addr);
-    
-    client_socket_ = accept(server_socket_, reinterpret_cast<struct sockaddr*>(&client_addr), &client_len);
-    if (client_socket_ == INVALID_SOCK) {
-        std::cerr << "Failed to accept connection: " << SOCKET_ERROR_CODE << std::endl;
-        disconnect();
-        return false;
-    }
-    
+    return true;
+}
+
+void TcpReceiver::configureSocket(socket_t socket, const struct sockaddr_in& client_addr)
+{
     // Get client IP for logging
     char client_ip[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, sizeof(client_ip));
@@ -151,28 +164,185 @@ bool TcpReceiver::connect()
     
     // Set receive buffer size on client socket
     int rcvbuf = config_.recv_buffer_size;
-    if (setsockopt(client_socket_, SOL_SOCKET, SO_RCVBUF, 
+    if (setsockopt(socket, SOL_SOCKET, SO_RCVBUF, 
                    reinterpret_cast<const char*>(&rcvbuf), sizeof(rcvbuf)) < 0) {
         std::cerr << "Warning: Failed to set receive buffer size" << std::endl;
     }
     
     // Disable Nagle's algorithm for lower latency
     int flag = 1;
-    if (setsockopt(client_socket_, IPPROTO_TCP, TCP_NODELAY,
+    if (setsockopt(socket, IPPROTO_TCP, TCP_NODELAY,
                    reinterpret_cast<const char*>(&flag), sizeof(flag)) < 0) {
         std::cerr << "Warning: Failed to disable Nagle's algorithm" << std::endl;
     }
-    
+}
+
+void TcpReceiver::setupClient(const struct sockaddr_in& client_addr)
+{
+    configureSocket(client_socket_, client_addr);
+#ifdef __linux__
+    if (config_.tcp_zerocopy) {
+        // A few frames per mapping: frames inside one are decoded in place
+        const size_t frame_bytes = static_cast<size_t>(getFrameSize()) + kMaxFrameHeaderSize + kFrameTrailerSize;
+        zerocopy_ = std::make_unique<TcpZeroCopy>(8 * frame_bytes);
+        if (!zerocopy_->attach(client_socket_)) {
+            std::cerr << "Warning: TCP_ZEROCOPY_RECEIVE not available (" << SOCKET_ERROR_CODE
+                      << "), receiving with copies" << std::endl;
+            zerocopy_.reset();
+        }
+    }
+#endif
     connected_ = true;
-    total_bytes_received_ = 0;
-    total_frames_received_ = 0;
+    header_.reset();
     
     std::cout << "Connection established successfully!" << std::endl;
+}
+
+bool TcpReceiver::connect()
+{
+    if (connected_) {
+        std::cerr << "Already connected" << std::endl;
+        return true;
+    }
+    
+    // Close any existing sockets
+    disconnect();
+    
+    if (!listenSocket()) {
+        return false;
+    }
+    if (config_.tcp_connections > 1) {
+        return acceptStripes();
+    }
+    
+    // Accept connection from FPGA
+    struct sockaddr_in client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    
+    client_socket_ = accept(server_socket_, reinterpret_cast<struct sockaddr*>(&client_addr), &client_len);
+    if (client_socket_ == INVALID_SOCK) {
+        std::cerr << "Failed to accept connection: " << SOCKET_ERROR_CODE << std::endl;
+        disconnect();
+        return false;
+    }
+    
+    setupClient(client_addr);
+    return true;
+}
+
+bool TcpReceiver::acceptStripes()
+{
+    const size_t count = static_cast<size_t>(config_.tcp_connections);
+    std::cout << "Waiting for " << count << " striped connections..." << std::endl;
+    for (size_t i = 0; i < count; i++) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        auto stripe = std::make_unique<Stripe>();
+        stripe->socket = accept(server_socket_, reinterpret_cast<struct sockaddr*>(&client_addr), &client_len);
+        if (stripe->socket == INVALID_SOCK) {
+            std::cerr << "Failed to accept connection " << i << ": " << SOCKET_ERROR_CODE << std::endl;
+            disconnect();
+            return false;
+        }
+        configureSocket(stripe->socket, client_addr);
+        const std::string prefix = "rx_conn" + std::to_string(i);
+        stripe->bytes = MetricsRegistry::global().counter(metricName(config_, (prefix + "_bytes").c_str()));
+        stripe->frames = MetricsRegistry::global().counter(metricName(config_, (prefix + "_frames").c_str()));
+        stripes_.push_back(std::move(stripe));
+    }
+
+    assembler_ = std::make_unique<StripeAssembler>(
+        count, static_cast<size_t>(config_.reorder_window), std::chrono::milliseconds(config_.reorder_max_wait_ms),
+        MetricsRegistry::global().counter(metricName(config_, "rx_frames_lost")));
+    for (size_t i = 0; i < count; i++) {
+        Stripe& stripe = *stripes_[i];
+        stripe.thread = std::thread(readStripe, std::cref(config_), std::ref(stripe), i, std::ref(*assembler_),
+                                    bytes_received_);
+    }
+
+    connected_ = true;
+    std::cout << "Striped stream established (" << count << " connections)" << std::endl;
     return true;
 }
 
+void TcpReceiver::readStripe(const Config& cfg, Stripe& stripe, size_t index, StripeAssembler& assembler,
+                             Counter total_bytes)
+{
+    auto receive = [&](uint8_t* buffer, size_t size) {
+        size_t total_received = 0;
+        while (total_received < size) {
+            ssize_t received = recv(stripe.socket, reinterpret_cast<char*>(buffer + total_received),
+                                    size - total_received, 0);
+            if (received <= 0) {
+                if (received == 0) {
+                    std::cerr << "Connection " << index << " closed by FPGA" << std::endl;
+                } else {
+                    std::cerr << "Receive error on connection " << index << ": " << SOCKET_ERROR_CODE << std::endl;
+                }
+                return false;
+            }
+            total_received += received;
+            total_bytes.add(static_cast<uint64_t>(received));
+            stripe.bytes.add(static_cast<uint64_t>(received));
+        }
+        return true;
+    };
+
+    // Gaps are per stream, not per connection: counted by the assembler
+    FrameHeaderParser header(cfg, false);
+    auto receiveFrame = [&](std::vector<uint8_t>& data) {
+        FrameReader frame(header, data, static_cast<size_t>(cfg.frame_size()));
+        for (FrameReader::Step step; frame.next(step);) {
+            if (!receive(step.data, step.size)) {
+                return false;
+            }
+            if (!frame.received(step)) {
+                std::cerr << "Invalid frame header on connection " << index << " (stream out of sync)" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (;;) {
+        StripeAssembler::Frame frame;
+        frame.data = assembler.takeBuffer();
+        if (!receiveFrame(frame.data)) {
+            break;
+        }
+        frame.counter = header.counter();
+        frame.counter_reset = (header.flags() & FrameFlags::CounterReset) != 0;
+        frame.timestamp = header.timestamp();
+        frame.crc = header.crc();
+        stripe.frames.add();
+        if (!assembler.push(index, std::move(frame))) {
+            break;
+        }
+    }
+    assembler.closeConnection(index);
+}
+
 void TcpReceiver::disconnect()
 {
+    // Striped stream: wake the readers, then wait for them
+    if (!stripes_.empty()) {
+        interrupt();
+    }
+    for (auto& stripe : stripes_) {
+        if (stripe->thread.joinable()) {
+            stripe->thread.join();
+        }
+#ifdef _WIN32
+        closesocket(stripe->socket);
+#else
+        close(stripe->socket);
+#endif
+    }
+    stripes_.clear();
+    assembler_.reset();
+    // Unmapped before the socket closes
+    zerocopy_.reset();
+
     // Close client socket
     if (client_socket_ != INVALID_SOCK) {
 #ifdef _WIN32
@@ -196,6 +366,27 @@ void TcpReceiver::disconnect()
     connected_ = false;
 }
 
+void TcpReceiver::interrupt()
+{
+#ifdef _WIN32
+    const int how = SD_BOTH;
+#else
+    const int how = SHUT_RDWR;
+#endif
+    if (client_socket_ != INVALID_SOCK) {
+        shutdown(client_socket_, how);
+    }
+    for (auto& stripe : stripes_) {
+        shutdown(stripe->socket, how);
+    }
+    if (assembler_) {
+        assembler_->close();
+    }
+    if (server_socket_ != INVALID_SOCK) {
+        shutdown(server_socket_, how);
+    }
+}
+
 bool TcpReceiver::isConnected() const
 {
     return connected_;
@@ -222,56 +413,256 @@ bool TcpReceiver::receiveExact(uint8_t* buffer, size_t size)
         }
         
         total_received += received;
-        total_bytes_received_ += received;
+        bytes_received_.add(static_cast<uint64_t>(received));
     }
     
     return true;
 }
 
+bool TcpReceiver::receiveMapped(uint8_t* copy, size_t size, const uint8_t*& data, size_t expected)
+{
+    // Mapped bytes stay where they are while each part follows the last
+    // in memory; from the first gap on, everything goes to `copy`
+    const uint8_t* run = nullptr;
+    auto toCopy = [&](size_t done) {
+        if (run) {
+            std::memcpy(copy, run, done);
+            run = nullptr;
+        }
+    };
+
+    data = copy;
+    size_t done = 0;
+    while (done < size) {
+        const uint8_t* mapped = nullptr;
+        if (const size_t n = zerocopy_->take(size - done, mapped)) {
+            bytes_received_.add(n);
+            zerocopy_bytes_.add(n);
+            if (done == 0) {
+                run = mapped;
+            } else if (run && mapped != run + done) {
+                toCopy(done);
+            }
+            if (!run) {
+                std::memcpy(copy + done, mapped, n);
+            }
+            done += n;
+        } else if (const size_t n = std::min(zerocopy_->skipHint(), size - done)) {
+            // Not page aligned: the kernel copies these
+            toCopy(done);
+            if (!receiveExact(copy + done, n)) {
+                return false;
+            }
+            zerocopy_->skipped(n);
+            done += n;
+        } else if (!zerocopy_->map(std::max(size - done, expected))) {
+            // recv() reports the closed connection or the error
+            toCopy(done);
+            return receiveExact(copy + done, size - done);
+        }
+    }
+    if (run) {
+        data = run;
+    }
+    return true;
+}
+
+bool TcpReceiver::receiveBytes(uint8_t* buffer, size_t size, size_t expected)
+{
+    if (!zerocopy_) {
+        return receiveExact(buffer, size);
+    }
+    const uint8_t* data = nullptr;
+    if (!receiveMapped(buffer, size, data, expected)) {
+        return false;
+    }
+    if (data != buffer) {
+        std::memcpy(buffer, data, size);
+    }
+    return true;
+}
+
+void TcpReceiver::setPayloadHandler(size_t chunk_bytes, PayloadHandler handler)
+{
+    payload_chunk_ = std::max<size_t>(chunk_bytes, 1);
+    payload_handler_ = std::move(handler);
+}
+
+void TcpReceiver::frameReceived(size_t frame_size)
+{
+    frames_received_.add();
+
+    if (config_.verbose) {
+        std::cout << "Received frame " << frames_received_.value()
+                  << " (" << frame_size << " bytes)" << std::endl;
+    }
+}
+
 bool TcpReceiver::receiveFrame(std::vector<uint8_t>& buffer)
+{
+    const uint8_t* payload = nullptr;
+    size_t size = 0;
+    if (!receiveFrameInPlace(buffer, payload, size)) {
+        return false;
+    }
+    if (payload != buffer.data()) {
+        // Mapped: the caller expects its own copy
+        std::memcpy(buffer.data(), payload, size);
+    }
+    return true;
+}
+
+bool TcpReceiver::receiveFrameInPlace(std::vector<uint8_t>& buffer, const uint8_t*& payload, size_t& size)
 {
     if (!connected_) {
         std::cerr << "Not connected" << std::endl;
         return false;
     }
-    
-    int frame_size = getFrameSize();
-    
-    // If has header, read frame size from header first
-    if (config_.has_header) {
-        uint32_t header_frame_size = 0;
-        
-        if (!receiveExact(reinterpret_cast<uint8_t*>(&header_frame_size), config_.header_size)) {
+
+    if (assembler_) {
+        // Striped: the readers did the receiving; take the next in order
+        if (!assembler_->pop(striped_frame_)) {
+            connected_ = false;
             return false;
         }
-        
-        // Use header frame size if valid, otherwise use configured size
-        if (header_frame_size > 0 && header_frame_size < 100000000) {  // Sanity check: < 100MB
-            frame_size = header_frame_size;
+        buffer.swap(striped_frame_.data);
+        payload = buffer.data();
+        size = buffer.size();
+        frames_received_.add();
+        return true;
+    }
+    
+    FrameReader frame(header_, buffer, static_cast<size_t>(getFrameSize()), &payload_handler_, payload_chunk_);
+    const uint8_t* mapped = nullptr;
+    for (FrameReader::Step step; frame.next(step);) {
+        bool ok = false;
+        if (step.part == FrameReader::Part::Header) {
+            // Zero-copy: map header and payload together, so the payload
+            // can be left in place
+            ok = receiveBytes(step.data, step.size, step.size + static_cast<size_t>(getFrameSize()));
+        } else if (step.part == FrameReader::Part::Payload && zerocopy_ && !payload_handler_) {
+            // The payload handler reads the buffer, so with one every chunk
+            // is copied there
+            ok = receiveMapped(step.data, step.size, mapped);
+        } else {
+            ok = receiveBytes(step.data, step.size);
         }
-        
-        if (config_.verbose) {
-            std::cout << "Frame header: size = " << frame_size << " bytes" << std::endl;
+        if (!ok) {
+            return false;
+        }
+        if (!frame.received(step)) {
+            // No way to find the next frame in a byte stream
+            std::cerr << "Invalid frame header (stream out of sync)" << std::endl;
+            return false;
         }
     }
+    payload = buffer.data();
+    size = frame.payloadSize();
+    if (mapped && mapped != payload) {
+        payload = mapped;
+        zerocopy_frames_.add();
+    }
+    frameReceived(size);
+    return true;
+}
+
+#ifdef __linux__
+
+Task<bool> TcpReceiver::connectAsync(EventLoop& loop)
+{
+    if (connected_) {
+        std::cerr << "Already connected" << std::endl;
+        co_return true;
+    }
     
-    // Resize buffer and receive frame data
-    buffer.resize(frame_size);
+    disconnect();
     
-    if (!receiveExact(buffer.data(), frame_size)) {
-        return false;
+    if (!listenSocket()) {
+        co_return false;
     }
+    fcntl(server_socket_, F_SETFL, fcntl(server_socket_, F_GETFL) | O_NONBLOCK);
     
-    total_frames_received_++;
+    // Wait for the FPGA without blocking the loop (the accepted socket is
+    // non-blocking too: use receiveFrameAsync() on it)
+    struct sockaddr_in client_addr;
+    while (true) {
+        socklen_t client_len = sizeof(client_addr);
+        client_socket_ = accept4(server_socket_, reinterpret_cast<struct sockaddr*>(&client_addr),
+                                 &client_len, SOCK_NONBLOCK);
+        if (client_socket_ != INVALID_SOCK) {
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            std::cerr << "Failed to accept connection: " << SOCKET_ERROR_CODE << std::endl;
+            disconnect();
+            co_return false;
+        }
+        if (!co_await loop.readable(server_socket_)) {
+            std::cerr << "Listening socket failed" << std::endl;
+            disconnect();
+            co_return false;
+        }
+    }
     
-    if (config_.verbose) {
-        std::cout << "Received frame " << total_frames_received_ 
-                  << " (" << frame_size << " bytes)" << std::endl;
+    setupClient(client_addr);
+    co_return true;
+}
+
+Task<bool> TcpReceiver::receiveExactAsync(EventLoop& loop, uint8_t* buffer, size_t size)
+{
+    size_t total_received = 0;
+    
+    while (total_received < size) {
+        ssize_t received = recv(client_socket_, buffer + total_received, size - total_received, MSG_DONTWAIT);
+        
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            // Errors / hang-ups are reported by the next recv()
+            co_await loop.readable(client_socket_);
+            continue;
+        }
+        if (received <= 0) {
+            if (received == 0) {
+                std::cerr << "Connection closed by FPGA" << std::endl;
+            } else {
+                std::cerr << "Receive error: " << SOCKET_ERROR_CODE << std::endl;
+            }
+            connected_ = false;
+            co_return false;
+        }
+        
+        total_received += received;
+        bytes_received_.add(static_cast<uint64_t>(received));
     }
     
-    return true;
+    co_return true;
+}
+
+Task<bool> TcpReceiver::receiveFrameAsync(EventLoop& loop, std::vector<uint8_t>& buffer)
+{
+    if (!connected_) {
+        std::cerr << "Not connected" << std::endl;
+        co_return false;
+    }
+
+    FrameReader frame(header_, buffer, static_cast<size_t>(getFrameSize()), &payload_handler_, payload_chunk_);
+    for (FrameReader::Step step; frame.next(step);) {
+        if (!co_await receiveExactAsync(loop, step.data, step.size)) {
+            co_return false;
+        }
+        if (!frame.received(step)) {
+            std::cerr << "Invalid frame header (stream out of sync)" << std::endl;
+            co_return false;
+        }
+    }
+    frameReceived(frame.payloadSize());
+    co_return true;
 }
 
+#endif // __linux__
+
 int TcpReceiver::getFrameSize() const
 {
     return config_.frame_size();
@@ -0,0 +1,181 @@
+#include "tcp_zerocopy.hpp"
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <poll.h>
+    #include <sys/ioctl.h>
+    #include <sys/mman.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <unistd.h>
+#endif
+
+namespace converter {
+
+#ifdef __linux__
+
+namespace {
+
+#ifndef TCP_ZEROCOPY_RECEIVE
+    #define TCP_ZEROCOPY_RECEIVE 35
+#endif
+
+// Leading fields of struct tcp_zerocopy_receive (linux/tcp.h, 4.18);
+// newer kernels accept the short form. Not included from linux/tcp.h,
+// which clashes with netinet/tcp.h
+struct ZeroCopyArgs {
+    uint64_t address;
+    uint32_t length;
+    uint32_t recv_skip_hint;
+};
+
+size_t pageSize()
+{
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+} // namespace
+
+TcpZeroCopy::TcpZeroCopy(size_t map_bytes)
+    : socket_(-1)
+    , map_bytes_((map_bytes + pageSize() - 1) / pageSize() * pageSize())
+    , window_(nullptr)
+    , next_(0)
+    , mapped_(nullptr)
+    , mapped_size_(0)
+    , skip_(0)
+    , low_water_(0)
+{
+}
+
+bool TcpZeroCopy::attach(int socket)
+{
+    detach();
+    // The socket's mmap() only reserves the range; map() fills it
+    void* window = mmap(nullptr, kRingMaps * map_bytes_, PROT_READ, MAP_SHARED, socket, 0);
+    if (window == MAP_FAILED) {
+        return false;
+    }
+    socket_ = socket;
+    window_ = static_cast<uint8_t*>(window);
+    return true;
+}
+
+void TcpZeroCopy::detach()
+{
+    if (window_) {
+        munmap(window_, kRingMaps * map_bytes_);
+    }
+    socket_ = -1;
+    window_ = nullptr;
+    next_ = 0;
+    mapped_ = nullptr;
+    mapped_size_ = 0;
+    skip_ = 0;
+    low_water_ = 0;
+}
+
+bool TcpZeroCopy::map(size_t want)
+{
+    if (!window_) {
+        return false;
+    }
+
+    // Wake once the bytes are all there instead of per segment; shutdown
+    // and close wake the poll too
+    want = want < map_bytes_ ? want : map_bytes_;
+    int queued = 0;
+    if (ioctl(socket_, FIONREAD, &queued) == 0 && static_cast<size_t>(queued) < want) {
+        if (low_water_ != want) {
+            const int low_water = static_cast<int>(want);
+            setsockopt(socket_, SOL_SOCKET, SO_RCVLOWAT, &low_water, sizeof(low_water));
+            low_water_ = want;
+        }
+        pollfd fd = {socket_, POLLIN, 0};
+        poll(&fd, 1, -1);
+    }
+    // After the last mapped pages; at the ring's end, from the start (the
+    // bytes taken lately are in the last two thirds then, out of reach)
+    if (next_ + map_bytes_ > kRingMaps * map_bytes_) {
+        next_ = 0;
+    }
+    uint8_t* address = window_ + next_;
+    for (bool waited = false;;) {
+        ZeroCopyArgs args = {};
+        args.address = reinterpret_cast<uintptr_t>(address);
+        args.length = static_cast<uint32_t>(map_bytes_);
+        socklen_t length = sizeof(args);
+        if (getsockopt(socket_, IPPROTO_TCP, TCP_ZEROCOPY_RECEIVE, &args, &length) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (args.length > 0) {
+            next_ += args.length;
+            mapped_ = address;
+            mapped_size_ = args.length;
+        }
+        skip_ = args.recv_skip_hint;
+        if (args.length > 0 || skip_ > 0) {
+            return true;
+        }
+        if (waited) {
+            // Readable with nothing queued: closed or shut down
+            return false;
+        }
+        pollfd fd = {socket_, POLLIN, 0};
+        if (poll(&fd, 1, -1) < 0 && errno != EINTR) {
+            return false;
+        }
+        waited = true;
+    }
+}
+
+#else
+
+TcpZeroCopy::TcpZeroCopy(size_t map_bytes)
+    : socket_(-1)
+    , map_bytes_(map_bytes)
+    , window_(nullptr)
+    , next_(0)
+    , mapped_(nullptr)
+    , mapped_size_(0)
+    , skip_(0)
+    , low_water_(0)
+{
+}
+
+bool TcpZeroCopy::attach(int)
+{
+    return false;
+}
+
+void TcpZeroCopy::detach()
+{
+}
+
+bool TcpZeroCopy::map(size_t)
+{
+    return false;
+}
+
+#endif
+
+TcpZeroCopy::~TcpZeroCopy()
+{
+    detach();
+}
+
+size_t TcpZeroCopy::take(size_t max, const uint8_t*& data)
+{
+    const size_t n = max < mapped_size_ ? max : mapped_size_;
+    data = mapped_;
+    mapped_ += n;
+    mapped_size_ -= n;
+    return n;
+}
+
+} // namespace converter
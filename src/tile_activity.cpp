@@ -0,0 +1,156 @@
+#include "tile_activity.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <sstream>
+#include <cctype>
+#include <cstring>
+
+namespace converter {
+
+size_t TileActivity::active(uint32_t threshold) const
+{
+    return static_cast<size_t>(std::count_if(counts.begin(), counts.end(),
+                                             [threshold](uint32_t c) { return c >= threshold && c > 0; }));
+}
+
+bool parseTileSelection(const std::string& text, size_t tile_count, TileSelection& selection)
+{
+    selection = TileSelection();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) {
+            continue;
+        }
+        if (item == "active") {
+            selection.active_only = true;
+            continue;
+        }
+        if (item == "all") {
+            continue;
+        }
+
+        try {
+            size_t pos = 0;
+            const unsigned long first = std::stoul(item, &pos);
+            unsigned long last = first;
+            if (pos < item.size()) {
+                if (item[pos] != '-') {
+                    throw std::invalid_argument(item);
+                }
+                size_t pos2 = 0;
+                last = std::stoul(item.substr(pos + 1), &pos2);
+                if (pos + 1 + pos2 != item.size() || last < first) {
+                    throw std::invalid_argument(item);
+                }
+            }
+            if (last >= tile_count) {
+                std::cerr << "Tile selection entry '" << item << "' is outside the frame (tiles 0-"
+                          << (tile_count > 0 ? tile_count - 1 : 0) << ")" << std::endl;
+                return false;
+            }
+            for (unsigned long tile = first; tile <= last; tile++) {
+                selection.tiles.push_back(static_cast<uint32_t>(tile));
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid tile selection entry '" << item << "' (expected active, N or N-M)" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void TileGrid::resize(int width, int height)
+{
+    if (width == width_ && height == height_) {
+        return;
+    }
+    width_ = width;
+    height_ = height;
+    tiles_x_ = (width + TileActivity::kTileSize - 1) / TileActivity::kTileSize;
+    tiles_y_ = (height + TileActivity::kTileSize - 1) / TileActivity::kTileSize;
+
+    const size_t total_pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    byte_tile_.resize((total_pixels + 3) / 4);
+    for (size_t byte_idx = 0; byte_idx < byte_tile_.size(); byte_idx++) {
+        const size_t pixel_idx = byte_idx * 4;
+        const size_t x = pixel_idx % static_cast<size_t>(width);
+        const size_t y = pixel_idx / static_cast<size_t>(width);
+        byte_tile_[byte_idx] = static_cast<uint32_t>((y / TileActivity::kTileSize) * static_cast<size_t>(tiles_x_)
+                                                     + x / TileActivity::kTileSize);
+    }
+}
+
+void TileGrid::count(const uint8_t* data, size_t size, TileActivity& out) const
+{
+    out.tiles_x = tiles_x_;
+    out.tiles_y = tiles_y_;
+    out.counts.assign(tileCount(), 0);
+    out.total = 0;
+    size = std::min(size, byte_tile_.size());
+
+    // As countEvents(): a pixel holds an event when its two bits differ
+    constexpr uint64_t kLowBits = 0x5555555555555555ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        uint64_t events = (word ^ (word >> 1)) & kLowBits;
+        if (events == 0) {
+            continue;
+        }
+        // Little-endian: byte b of the frame is bits 8b..8b+7
+        for (size_t b = 0; b < 8 && events != 0; b++, events >>= 8) {
+            const uint32_t n = static_cast<uint32_t>(std::popcount(events & 0xFF));
+            out.counts[byte_tile_[i + b]] += n;
+            out.total += n;
+        }
+    }
+    for (; i < size; i++) {
+        const unsigned byte = data[i];
+        const uint32_t n = static_cast<uint32_t>(std::popcount((byte ^ (byte >> 1)) & 0x55u));
+        out.counts[byte_tile_[i]] += n;
+        out.total += n;
+    }
+}
+
+void TileGrid::ranges(const std::vector<uint8_t>& selected, std::vector<ByteRange>& out) const
+{
+    out.clear();
+    const size_t width = static_cast<size_t>(width_);
+    for (int ty = 0; ty < tiles_y_; ty++) {
+        const size_t y_end = std::min(static_cast<size_t>(ty + 1) * TileActivity::kTileSize, static_cast<size_t>(height_));
+        for (size_t y = static_cast<size_t>(ty) * TileActivity::kTileSize; y < y_end; y++) {
+            int tx = 0;
+            while (tx < tiles_x_) {
+                if (!selected[static_cast<size_t>(ty) * tiles_x_ + tx]) {
+                    tx++;
+                    continue;
+                }
+                // Run of selected tiles in this row
+                const int run_begin = tx;
+                while (tx < tiles_x_ && selected[static_cast<size_t>(ty) * tiles_x_ + tx]) {
+                    tx++;
+                }
+                const size_t x0 = static_cast<size_t>(run_begin) * TileActivity::kTileSize;
+                const size_t x1 = std::min(static_cast<size_t>(tx) * TileActivity::kTileSize, width);
+                const size_t begin = (y * width + x0) / 4;
+                const size_t end = (y * width + x1 + 3) / 4;
+
+                // Merge with the previous run when they touch (a row
+                // continuing into the next) or share a byte (rows not
+                // starting on a byte boundary)
+                if (!out.empty() && begin <= out.back().end) {
+                    out.back().end = std::max(out.back().end, end);
+                    continue;
+                }
+                out.push_back(ByteRange{begin, end});
+            }
+        }
+    }
+}
+
+} // namespace converter
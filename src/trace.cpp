@@ -0,0 +1,218 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+namespace converter {
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'V', 'T', 'R', 'A', 'C', 'E', '1'};
+
+const char* const kStageNames[] = {
+    "receive", "decode", "decode_band", "reorder", "queue", "publish",
+};
+static_assert(sizeof(kStageNames) / sizeof(kStageNames[0]) == static_cast<size_t>(TraceStage::Count),
+              "every TraceStage needs a name");
+
+template <typename T>
+void writeValue(std::ofstream& out, T value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+size_t roundUpPow2(size_t n)
+{
+    size_t size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+} // namespace
+
+const char* traceStageName(TraceStage stage)
+{
+    const size_t index = static_cast<size_t>(stage);
+    return index < static_cast<size_t>(TraceStage::Count) ? kStageNames[index] : "unknown";
+}
+
+TraceRecorder& TraceRecorder::global()
+{
+    // Never destroyed: threads may still record during static destruction
+    static TraceRecorder* recorder = new TraceRecorder();
+    return *recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : enabled_(true)
+    , ring_size_(roundUpPow2(static_cast<size_t>(Config{}.trace_ring_events)))
+    , dump_requested_(false)
+    , dump_count_(0)
+{
+}
+
+void TraceRecorder::configure(const Config& cfg)
+{
+    enabled_.store(cfg.trace_enabled, std::memory_order_relaxed);
+    if (cfg.trace_ring_events > 0) {
+        ring_size_.store(roundUpPow2(static_cast<size_t>(cfg.trace_ring_events)), std::memory_order_relaxed);
+    }
+}
+
+TraceRecorder::Ring* TraceRecorder::localRing()
+{
+    // nullptr beyond kMaxThreads, and no retry after that
+    static thread_local ThreadSlotLease<Ring> lease;
+    return lease.get([this]() {
+        Ring* ring = rings_.claim([this]() {
+            Ring* created = new Ring();
+            const size_t size = ring_size_.load(std::memory_order_relaxed);
+            created->slots = std::make_unique<Slot[]>(size);
+            created->mask = size - 1;
+            return created;
+        });
+        if (ring) {
+            // Possibly the ring of a thread that has exited
+            ring->name[0].store('\0', std::memory_order_relaxed);
+        }
+        return ring;
+    });
+}
+
+void TraceRecorder::append(TraceStage stage, TracePhase phase, uint64_t frame)
+{
+    Ring* ring = localRing();
+    if (!ring) {
+        return;
+    }
+    // Single writer per ring. `started` moves before the slot is
+    // overwritten so dump() can tell which slots it may have read torn;
+    // `head` publishes the finished slot
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    ring->started.store(head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = ring->slots[head & ring->mask];
+    slot.time.store(now(), std::memory_order_relaxed);
+    slot.frame.store(frame, std::memory_order_relaxed);
+    slot.meta.store(static_cast<uint64_t>(stage) | static_cast<uint64_t>(phase) << 8, std::memory_order_relaxed);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void TraceRecorder::setThreadName(const char* name)
+{
+    Ring* ring = localRing();
+    if (!ring) {
+        return;
+    }
+    size_t i = 0;
+    for (; i + 1 < kThreadNameSize && name[i] != '\0'; i++) {
+        ring->name[i].store(name[i], std::memory_order_relaxed);
+    }
+    ring->name[i].store('\0', std::memory_order_relaxed);
+}
+
+bool TraceRecorder::dump(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Trace: cannot write " << path << std::endl;
+        return false;
+    }
+
+    const size_t ring_count = rings_.count();
+    out.write(kMagic, sizeof(kMagic));
+    writeValue<uint32_t>(out, kVersion);
+    writeValue<uint32_t>(out, static_cast<uint32_t>(ring_count));
+    writeValue<int64_t>(out, static_cast<int64_t>(now()));
+    writeValue<int64_t>(out, std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    writeValue<uint32_t>(out, static_cast<uint32_t>(TraceStage::Count));
+    for (const char* name : kStageNames) {
+        const uint8_t length = static_cast<uint8_t>(std::strlen(name));
+        writeValue<uint8_t>(out, length);
+        out.write(name, length);
+    }
+
+    struct Record {
+        uint64_t time;
+        uint64_t frame;
+        uint8_t stage;
+        uint8_t phase;
+        uint8_t reserved[6];
+    };
+    static_assert(sizeof(Record) == 24, "trace record layout");
+
+    std::vector<Record> records;
+    uint64_t total = 0;
+    for (size_t i = 0; i < ring_count; i++) {
+        const Ring& ring = rings_[i];
+        const uint64_t size = ring.mask + 1;
+
+        // Copy the newest `size` records, then drop those the owner may
+        // have started overwriting meanwhile (older than started - size
+        // after the copy)
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        const uint64_t first = head > size ? head - size : 0;
+        records.clear();
+        records.reserve(static_cast<size_t>(head - first));
+        for (uint64_t n = first; n < head; n++) {
+            const Slot& slot = ring.slots[n & ring.mask];
+            const uint64_t meta = slot.meta.load(std::memory_order_relaxed);
+            Record record{};
+            record.time = slot.time.load(std::memory_order_relaxed);
+            record.frame = slot.frame.load(std::memory_order_relaxed);
+            record.stage = static_cast<uint8_t>(meta & 0xFF);
+            record.phase = static_cast<uint8_t>(meta >> 8);
+            records.push_back(record);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t started = ring.started.load(std::memory_order_relaxed);
+        const uint64_t valid_from = started > size ? started - size : 0;
+        const size_t torn = valid_from > first ? static_cast<size_t>(std::min(valid_from - first, head - first)) : 0;
+
+        char name[kThreadNameSize] = {};
+        for (size_t c = 0; c + 1 < kThreadNameSize; c++) {
+            name[c] = ring.name[c].load(std::memory_order_relaxed);
+            if (name[c] == '\0') {
+                break;
+            }
+        }
+
+        writeValue<uint32_t>(out, static_cast<uint32_t>(i));
+        out.write(name, sizeof(name));
+        writeValue<uint64_t>(out, static_cast<uint64_t>(records.size() - torn));
+        out.write(reinterpret_cast<const char*>(records.data() + torn),
+                  static_cast<std::streamsize>((records.size() - torn) * sizeof(Record)));
+        total += records.size() - torn;
+    }
+
+    out.close();
+    if (!out) {
+        std::cerr << "Trace: writing " << path << " failed" << std::endl;
+        return false;
+    }
+    std::cout << "Trace: wrote " << total << " records of " << ring_count << " threads to " << path << std::endl;
+    return true;
+}
+
+bool TraceRecorder::dumpIfRequested(const std::string& path)
+{
+    if (!dump_requested_.exchange(false, std::memory_order_relaxed)) {
+        return false;
+    }
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = ++dump_count_;
+    }
+    return dump(path + "." + std::to_string(sequence));
+}
+
+} // namespace converter
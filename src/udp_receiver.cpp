@@ -1,6 +1,8 @@
 #include "udp_receiver.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cstring>
+#include <cerrno>
 
 // Windows doesn't define ssize_t
 #ifdef _WIN32
@@ -17,8 +19,10 @@ UdpReceiver::UdpReceiver(const Config& cfg)
     , socket_(INVALID_SOCK)
     , bound_(false)
     , leftover_bytes_(0)
-    , total_bytes_received_(0)
-    , total_frames_received_(0)
+    , header_(cfg)
+    , payload_chunk_(1)
+    , bytes_received_(MetricsRegistry::global().counter(metricName(cfg, "rx_bytes")))
+    , frames_received_(MetricsRegistry::global().counter(metricName(cfg, "rx_frames")))
 {
     initSocketLib();
 
@@ -41,8 +45,11 @@ UdpReceiver::UdpReceiver(UdpReceiver&& other) noexcept
     , packet_buffer_(std::move(other.packet_buffer_))
     , leftover_buffer_(std::move(other.leftover_buffer_))
     , leftover_bytes_(other.leftover_bytes_)
-    , total_bytes_received_(other.total_bytes_received_)
-    , total_frames_received_(other.total_frames_received_)
+    , header_(other.header_)
+    , payload_handler_(std::move(other.payload_handler_))
+    , payload_chunk_(other.payload_chunk_)
+    , bytes_received_(other.bytes_received_)
+    , frames_received_(other.frames_received_)
 {
     other.socket_ = INVALID_SOCK;
     other.bound_ = false;
@@ -58,8 +65,11 @@ UdpReceiver& UdpReceiver::operator=(UdpReceiver&& other) noexcept
         packet_buffer_ = std::move(other.packet_buffer_);
         leftover_buffer_ = std::move(other.leftover_buffer_);
         leftover_bytes_ = other.leftover_bytes_;
-        total_bytes_received_ = other.total_bytes_received_;
-        total_frames_received_ = other.total_frames_received_;
+        header_ = other.header_;
+        payload_handler_ = std::move(other.payload_handler_);
+        payload_chunk_ = other.payload_chunk_;
+        bytes_received_ = other.bytes_received_;
+        frames_received_ = other.frames_received_;
         other.socket_ = INVALID_SOCK;
         other.bound_ = false;
         other.leftover_bytes_ = 0;
@@ -148,8 +158,7 @@ bool UdpReceiver::connect()
     }
 
     bound_ = true;
-    total_bytes_received_ = 0;
-    total_frames_received_ = 0;
+    header_.reset();
     leftover_bytes_ = 0;
 
     std::cout << "UDP socket bound successfully! Waiting for data on port "
@@ -171,46 +180,90 @@ void UdpReceiver::disconnect()
     leftover_bytes_ = 0;
 }
 
+void UdpReceiver::interrupt()
+{
+    if (socket_ != INVALID_SOCK) {
+        // Linux wakes blocked readers even on unconnected UDP sockets
+#ifdef _WIN32
+        shutdown(socket_, SD_BOTH);
+#else
+        shutdown(socket_, SHUT_RDWR);
+#endif
+    }
+}
+
 bool UdpReceiver::isConnected() const
 {
     return bound_;
 }
 
-bool UdpReceiver::receiveFrame(std::vector<uint8_t>& buffer)
+size_t UdpReceiver::takeLeftover(uint8_t* frame, size_t frame_size)
 {
-    if (!bound_) {
-        std::cerr << "UDP socket not bound" << std::endl;
-        return false;
+    if (leftover_bytes_ == 0) {
+        return 0;
     }
 
-    size_t frame_size = static_cast<size_t>(getFrameSize());
-    buffer.resize(frame_size);
+    size_t bytes_to_copy = std::min(leftover_bytes_, frame_size);
+    std::memcpy(frame, leftover_buffer_.data(), bytes_to_copy);
 
-    size_t accumulated_bytes = 0;
+    if (config_.verbose) {
+        std::cout << "Used " << bytes_to_copy << " leftover bytes from previous packet"
+                  << std::endl;
+    }
 
-    // First, copy any leftover bytes from previous frame
-    if (leftover_bytes_ > 0) {
-        size_t bytes_to_copy = std::min(leftover_bytes_, frame_size);
-        std::memcpy(buffer.data(), leftover_buffer_.data(), bytes_to_copy);
-        accumulated_bytes = bytes_to_copy;
+    // If there are still more leftover bytes (frame smaller than leftover), shift them
+    if (leftover_bytes_ > bytes_to_copy) {
+        size_t remaining = leftover_bytes_ - bytes_to_copy;
+        std::memmove(leftover_buffer_.data(), leftover_buffer_.data() + bytes_to_copy, remaining);
+        leftover_bytes_ = remaining;
+    } else {
+        leftover_bytes_ = 0;
+    }
+    return bytes_to_copy;
+}
 
-        if (config_.verbose) {
-            std::cout << "Used " << bytes_to_copy << " leftover bytes from previous packet"
-                      << std::endl;
-        }
+void UdpReceiver::addPacket(size_t received, const struct sockaddr_in& sender_addr,
+                            uint8_t* frame, size_t frame_size, size_t& accumulated_bytes)
+{
+    bytes_received_.add(static_cast<uint64_t>(received));
+
+    // Calculate how many bytes we need for this frame
+    size_t bytes_needed = frame_size - accumulated_bytes;
+    size_t bytes_to_copy = std::min(bytes_needed, received);
+
+    // Copy to output buffer
+    std::memcpy(frame + accumulated_bytes, packet_buffer_.data(), bytes_to_copy);
+    accumulated_bytes += bytes_to_copy;
+
+    if (config_.verbose) {
+        char sender_ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &sender_addr.sin_addr, sender_ip, sizeof(sender_ip));
+        std::cout << "Received UDP packet: " << received << " bytes from "
+                  << sender_ip << ":" << ntohs(sender_addr.sin_port)
+                  << " (accumulated: " << accumulated_bytes << "/" << frame_size << ")"
+                  << std::endl;
+    }
+
+    // Save any extra bytes for the next frame (critical for continuous streaming!)
+    if (received > bytes_needed) {
+        leftover_bytes_ = received - bytes_needed;
+        std::memcpy(leftover_buffer_.data(),
+                   packet_buffer_.data() + bytes_needed,
+                   leftover_bytes_);
 
-        // If there are still more leftover bytes (frame smaller than leftover), shift them
-        if (leftover_bytes_ > bytes_to_copy) {
-            size_t remaining = leftover_bytes_ - bytes_to_copy;
-            std::memmove(leftover_buffer_.data(), leftover_buffer_.data() + bytes_to_copy, remaining);
-            leftover_bytes_ = remaining;
-        } else {
-            leftover_bytes_ = 0;
+        if (config_.verbose) {
+            std::cout << "Saved " << leftover_bytes_ << " bytes for next frame" << std::endl;
         }
     }
+}
+
+bool UdpReceiver::receiveBytes(uint8_t* out, size_t size)
+{
+    // First, copy any leftover bytes from the previous datagram
+    size_t accumulated_bytes = takeLeftover(out, size);
 
-    // Accumulate UDP packets until we have a complete frame
-    while (accumulated_bytes < frame_size) {
+    // Accumulate UDP packets until we have all bytes
+    while (accumulated_bytes < size) {
         struct sockaddr_in sender_addr;
         socklen_t sender_len = sizeof(sender_addr);
 
@@ -233,48 +286,123 @@ bool UdpReceiver::receiveFrame(std::vector<uint8_t>& buffer)
             return false;
         }
 
-        total_bytes_received_ += static_cast<size_t>(received);
+        addPacket(static_cast<size_t>(received), sender_addr, out, size, accumulated_bytes);
+    }
+    return true;
+}
 
-        // Calculate how many bytes we need for this frame
-        size_t bytes_needed = frame_size - accumulated_bytes;
-        size_t bytes_to_copy = std::min(bytes_needed, static_cast<size_t>(received));
+void UdpReceiver::resync()
+{
+    // A lost datagram shifted the stream. Frames start on a datagram
+    // boundary, so the next header is at the start of a later datagram.
+    leftover_bytes_ = 0;
+    if (config_.verbose) {
+        std::cout << "Invalid frame header, skipping to the next datagram" << std::endl;
+    }
+}
 
-        // Copy to output buffer
-        std::memcpy(buffer.data() + accumulated_bytes, packet_buffer_.data(), bytes_to_copy);
-        accumulated_bytes += bytes_to_copy;
+void UdpReceiver::frameReceived(size_t frame_size)
+{
+    frames_received_.add();
 
-        if (config_.verbose) {
-            char sender_ip[INET_ADDRSTRLEN];
-            inet_ntop(AF_INET, &sender_addr.sin_addr, sender_ip, sizeof(sender_ip));
-            std::cout << "Received UDP packet: " << received << " bytes from "
-                      << sender_ip << ":" << ntohs(sender_addr.sin_port)
-                      << " (accumulated: " << accumulated_bytes << "/" << frame_size << ")"
-                      << std::endl;
+    if (config_.verbose) {
+        std::cout << "Received complete frame " << frames_received_.value()
+                  << " (" << frame_size << " bytes)" << std::endl;
+    }
+}
+
+void UdpReceiver::setPayloadHandler(size_t chunk_bytes, PayloadHandler handler)
+{
+    payload_chunk_ = std::max<size_t>(chunk_bytes, 1);
+    payload_handler_ = std::move(handler);
+}
+
+bool UdpReceiver::receiveFrame(std::vector<uint8_t>& buffer)
+{
+    if (!bound_) {
+        std::cerr << "UDP socket not bound" << std::endl;
+        return false;
+    }
+
+    FrameReader frame(header_, buffer, static_cast<size_t>(getFrameSize()), &payload_handler_, payload_chunk_);
+    for (FrameReader::Step step; frame.next(step);) {
+        if (!receiveBytes(step.data, step.size)) {
+            return false;
+        }
+        if (!frame.received(step)) {
+            resync();
         }
+    }
+    frameReceived(frame.payloadSize());
+    return true;
+}
+
+#ifdef __linux__
+
+Task<bool> UdpReceiver::connectAsync(EventLoop&)
+{
+    // Binding never blocks
+    co_return connect();
+}
+
+Task<bool> UdpReceiver::receiveBytesAsync(EventLoop& loop, uint8_t* out, size_t size)
+{
+    size_t accumulated_bytes = takeLeftover(out, size);
+
+    while (accumulated_bytes < size) {
+        struct sockaddr_in sender_addr;
+        socklen_t sender_len = sizeof(sender_addr);
 
-        // Save any extra bytes for the next frame (critical for continuous streaming!)
-        if (static_cast<size_t>(received) > bytes_needed) {
-            leftover_bytes_ = static_cast<size_t>(received) - bytes_needed;
-            std::memcpy(leftover_buffer_.data(),
-                       packet_buffer_.data() + bytes_needed,
-                       leftover_bytes_);
+        ssize_t received = recvfrom(socket_, packet_buffer_.data(), packet_buffer_.size(), MSG_DONTWAIT,
+                                    reinterpret_cast<struct sockaddr*>(&sender_addr), &sender_len);
 
-            if (config_.verbose) {
-                std::cout << "Saved " << leftover_bytes_ << " bytes for next frame" << std::endl;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            // A shut-down UDP socket reports a hang-up but recvfrom()
+            // keeps returning EAGAIN, so that is the closed case here
+            if (!co_await loop.readable(socket_)) {
+                std::cerr << "UDP socket closed" << std::endl;
+                bound_ = false;
+                co_return false;
             }
+            continue;
+        }
+        if (received <= 0) {
+            if (received == 0) {
+                std::cerr << "UDP socket closed" << std::endl;
+            } else {
+                std::cerr << "UDP receive error: " << SOCKET_ERROR_CODE << std::endl;
+            }
+            bound_ = false;
+            co_return false;
         }
-    }
 
-    total_frames_received_++;
+        addPacket(static_cast<size_t>(received), sender_addr, out, size, accumulated_bytes);
+    }
+    co_return true;
+}
 
-    if (config_.verbose) {
-        std::cout << "Received complete frame " << total_frames_received_
-                  << " (" << frame_size << " bytes)" << std::endl;
+Task<bool> UdpReceiver::receiveFrameAsync(EventLoop& loop, std::vector<uint8_t>& buffer)
+{
+    if (!bound_) {
+        std::cerr << "UDP socket not bound" << std::endl;
+        co_return false;
     }
 
-    return true;
+    FrameReader frame(header_, buffer, static_cast<size_t>(getFrameSize()), &payload_handler_, payload_chunk_);
+    for (FrameReader::Step step; frame.next(step);) {
+        if (!co_await receiveBytesAsync(loop, step.data, step.size)) {
+            co_return false;
+        }
+        if (!frame.received(step)) {
+            resync();
+        }
+    }
+    frameReceived(frame.payloadSize());
+    co_return true;
 }
 
+#endif // __linux__
+
 int UdpReceiver::getFrameSize() const
 {
     return config_.frame_size();
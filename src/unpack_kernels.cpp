@@ -0,0 +1,274 @@
+#include "unpack_kernels.hpp"
+#include "cpu_features.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace converter {
+
+void buildCoordinateTables(int width, int frame_size,
+                           std::vector<int16_t>& byte_x, std::vector<int16_t>& byte_y)
+{
+    byte_x.assign(frame_size, 0);
+    byte_y.assign(frame_size, 0);
+
+    for (int byte_idx = 0; byte_idx < frame_size; byte_idx++) {
+        int pixel_idx = byte_idx * 4;  // 4 pixels per byte
+        byte_x[byte_idx] = static_cast<int16_t>(pixel_idx % width);
+        byte_y[byte_idx] = static_cast<int16_t>(pixel_idx / width);
+    }
+}
+
+size_t countEvents(const uint8_t* data, size_t size)
+{
+    // Low bit of every 2-bit pixel
+    constexpr uint64_t kLowBits = 0x5555555555555555ULL;
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        count += static_cast<size_t>(std::popcount((word ^ (word >> 1)) & kLowBits));
+    }
+    for (; i < size; i++) {
+        const unsigned byte = data[i];
+        count += static_cast<size_t>(std::popcount((byte ^ (byte >> 1)) & 0x55u));
+    }
+    return count;
+}
+
+void buildDecimationMask(int width, int total_pixels, int frame_size, int factor, std::vector<uint8_t>& mask)
+{
+    mask.assign(static_cast<size_t>(frame_size), 0);
+    const int step = std::max(1, static_cast<int>(std::lround(std::sqrt(static_cast<double>(factor)))));
+
+    for (int pixel_idx = 0; pixel_idx < total_pixels; pixel_idx++) {
+        const int x = pixel_idx % width;
+        const int y = pixel_idx / width;
+        if ((x + step * (y % factor)) % factor == 0) {
+            // MSB first: pixel 0 in bits 7-6
+            mask[pixel_idx / 4] |= static_cast<uint8_t>(0x03 << (6 - (pixel_idx % 4) * 2));
+        }
+    }
+}
+
+size_t unpackScalar(const UnpackContext& ctx, dv::Event* out)
+{
+    dv::Event* start = out;
+
+    // Reference implementation: the original per-pixel loop, no tables.
+    // FPGA format: bits 7-6 = pixel 0, bits 5-4 = pixel 1, bits 3-2 = pixel 2, bits 1-0 = pixel 3
+    // Values: 00 = no event, 01 = positive (p=1), 10 = negative (p=0), 11 = unused
+    for (size_t byte_idx = ctx.begin; byte_idx < ctx.end; byte_idx++) {
+        uint8_t byte_val = ctx.data[byte_idx];
+
+        // Skip zero bytes entirely - no events in this byte
+        if (byte_val == 0) {
+            continue;
+        }
+
+        int base_pixel = static_cast<int>(byte_idx) * 4;
+
+        for (int px_in_byte = 0; px_in_byte < 4; px_in_byte++) {
+            int shift = 6 - (px_in_byte * 2);
+            uint8_t pixel_val = (byte_val >> shift) & 0x03;
+
+            // Skip if no event (00) or unused (11)
+            if (pixel_val == 0 || pixel_val == 3) {
+                continue;
+            }
+
+            int pixel_idx = base_pixel + px_in_byte;
+
+            // Bounds check (handle last byte which may have padding)
+            if (pixel_idx >= ctx.total_pixels) {
+                continue;
+            }
+
+            int16_t x = static_cast<int16_t>(pixel_idx % ctx.width);
+            int16_t y = static_cast<int16_t>(pixel_idx / ctx.width);
+            *out++ = dv::Event(ctx.timestamp, x, y, pixel_val == 1);
+        }
+    }
+
+    return static_cast<size_t>(out - start);
+}
+
+size_t unpackLut(const UnpackContext& ctx, dv::Event* out)
+{
+    dv::Event* start = out;
+    size_t byte_idx = ctx.begin;
+
+    // Skip 8 zero bytes (32 pixels) at a time
+    while (byte_idx + 8 <= ctx.end) {
+        uint64_t word;
+        std::memcpy(&word, ctx.data + byte_idx, sizeof(word));
+        if (word != 0) {
+            for (size_t i = 0; i < 8; i++) {
+                uint8_t byte_val = ctx.data[byte_idx + i];
+                if (byte_val != 0) {
+                    out = emitByte(ctx, byte_idx + i, byte_val, out);
+                }
+            }
+        }
+        byte_idx += 8;
+    }
+
+    for (; byte_idx < ctx.end; byte_idx++) {
+        uint8_t byte_val = ctx.data[byte_idx];
+        if (byte_val != 0) {
+            out = emitByte(ctx, byte_idx, byte_val, out);
+        }
+    }
+
+    return static_cast<size_t>(out - start);
+}
+
+const std::vector<KernelInfo>& availableKernels()
+{
+    static const std::vector<KernelInfo> kernels = []() {
+        std::vector<KernelInfo> k;
+        k.push_back({UnpackKernel::Scalar, "scalar", unpackScalar, false});
+        k.push_back({UnpackKernel::Lut, "lut", unpackLut, true});
+#if defined(__x86_64__) || defined(_M_X64)
+        const CpuFeatures& cpu = cpuFeatures();
+        if (cpu.sse2) {
+            k.push_back({UnpackKernel::Sse2, "sse2", unpackSse2, true});
+        }
+        if (cpu.avx2) {
+            k.push_back({UnpackKernel::Avx2, "avx2", unpackAvx2, true});
+        }
+        if (cpu.avx512f && cpu.avx512bw && cpu.avx512vbmi2 && cpu.bmi2) {
+            k.push_back({UnpackKernel::Avx512, "avx512", unpackAvx512, true});
+        }
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+        if (cpuFeatures().neon) {
+            k.push_back({UnpackKernel::Neon, "neon", unpackNeon, true});
+        }
+#endif
+        return k;
+    }();
+    return kernels;
+}
+
+const KernelInfo* findKernel(UnpackKernel id)
+{
+    for (const auto& k : availableKernels()) {
+        if (k.id == id) {
+            return &k;
+        }
+    }
+    return nullptr;
+}
+
+size_t unpackSoaScalar(const UnpackContext& ctx, SoaOutput& out)
+{
+    const size_t start = out.count;
+    size_t n = out.count;
+    PolarityPacker polarity(out.polarity, n);
+
+    for (size_t byte_idx = ctx.begin; byte_idx < ctx.end; byte_idx++) {
+        uint8_t byte_val = ctx.data[byte_idx];
+        if (byte_val == 0) {
+            continue;
+        }
+
+        int base_pixel = static_cast<int>(byte_idx) * 4;
+
+        for (int px_in_byte = 0; px_in_byte < 4; px_in_byte++) {
+            uint8_t pixel_val = (byte_val >> (6 - px_in_byte * 2)) & 0x03;
+            if (pixel_val == 0 || pixel_val == 3) {
+                continue;
+            }
+
+            int pixel_idx = base_pixel + px_in_byte;
+            if (pixel_idx >= ctx.total_pixels) {
+                continue;
+            }
+
+            out.x[n] = static_cast<int16_t>(pixel_idx % ctx.width);
+            out.y[n] = static_cast<int16_t>(pixel_idx / ctx.width);
+            polarity.push(pixel_val == 1 ? 1 : 0, 1);
+            n++;
+        }
+    }
+
+    polarity.flush();
+    out.count = n;
+    return n - start;
+}
+
+size_t unpackSoaLut(const UnpackContext& ctx, SoaOutput& out)
+{
+    const size_t start = out.count;
+    size_t n = out.count;
+    PolarityPacker polarity(out.polarity, n);
+
+    auto emit = [&](size_t byte_idx, uint8_t byte_val) {
+        const ByteDecode& d = kByteDecodeTable[byte_val];
+        const int base_x = ctx.byte_x[byte_idx];
+        const int base_y = ctx.byte_y[byte_idx];
+        for (int i = 0; i < d.count; i++) {
+            int x = base_x + d.offset[i];
+            int y = base_y;
+            if (x >= ctx.width) {
+                x -= ctx.width;
+                y++;
+            }
+            out.x[n + i] = static_cast<int16_t>(x);
+            out.y[n + i] = static_cast<int16_t>(y);
+        }
+        polarity.push(d.polarity_bits, d.count);
+        n += d.count;
+    };
+
+    size_t byte_idx = ctx.begin;
+    while (byte_idx + 8 <= ctx.end) {
+        uint64_t word;
+        std::memcpy(&word, ctx.data + byte_idx, sizeof(word));
+        if (word != 0) {
+            for (size_t i = 0; i < 8; i++) {
+                uint8_t byte_val = ctx.data[byte_idx + i];
+                if (byte_val != 0) {
+                    emit(byte_idx + i, byte_val);
+                }
+            }
+        }
+        byte_idx += 8;
+    }
+
+    for (; byte_idx < ctx.end; byte_idx++) {
+        uint8_t byte_val = ctx.data[byte_idx];
+        if (byte_val != 0) {
+            emit(byte_idx, byte_val);
+        }
+    }
+
+    polarity.flush();
+    out.count = n;
+    return n - start;
+}
+
+UnpackSoaKernelFn selectSoaKernel(UnpackKernel preference, const char** name)
+{
+    const char* unused;
+    const char*& chosen = name ? *name : unused;
+
+    if (preference == UnpackKernel::Scalar) {
+        chosen = "scalar";
+        return unpackSoaScalar;
+    }
+#if defined(__x86_64__) || defined(_M_X64)
+    const CpuFeatures& cpu = cpuFeatures();
+    if (preference != UnpackKernel::Lut && cpu.avx512f && cpu.avx512bw && cpu.avx512vbmi2 && cpu.bmi2) {
+        chosen = "avx512";
+        return unpackSoaAvx512;
+    }
+#endif
+    chosen = "lut";
+    return unpackSoaLut;
+}
+
+} // namespace converter
@@ -0,0 +1,96 @@
+#include "unpack_kernels.hpp"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+#ifdef _MSC_VER
+    #include <arm64_neon.h>
+    #include <intrin.h>
+#else
+    #include <arm_neon.h>
+#endif
+
+namespace converter {
+
+namespace {
+
+inline int countTrailingZeros64(uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, v);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+/**
+ * NEON has no movemask; narrow the byte compare instead.
+ * Returns 4 bits per input byte (byte i -> bits 4i..4i+3), 0xF if non-zero.
+ */
+inline uint64_t nonzeroNibbleMask(uint8x16_t v)
+{
+    uint8x16_t nonzero = vtstq_u8(v, v);
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(nonzero), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+inline dv::Event* emitBlock16(const UnpackContext& ctx, size_t block_start, uint8x16_t v, dv::Event* out)
+{
+    uint64_t mask = nonzeroNibbleMask(v);
+    while (mask != 0) {
+        const int b = countTrailingZeros64(mask) >> 2;
+        const size_t byte_idx = block_start + static_cast<size_t>(b);
+        out = emitByte(ctx, byte_idx, ctx.data[byte_idx], out);
+        mask &= ~(0xFULL << (b * 4));
+    }
+    return out;
+}
+
+} // namespace
+
+size_t unpackNeon(const UnpackContext& ctx, dv::Event* out)
+{
+    dv::Event* start = out;
+    size_t byte_idx = ctx.begin;
+
+    // 64 bytes (256 pixels) per iteration; one horizontal max decides
+    // whether the whole block can be skipped
+    for (; byte_idx + 64 <= ctx.end; byte_idx += 64) {
+        const uint8_t* p = ctx.data + byte_idx;
+        uint8x16_t a = vld1q_u8(p);
+        uint8x16_t b = vld1q_u8(p + 16);
+        uint8x16_t c = vld1q_u8(p + 32);
+        uint8x16_t d = vld1q_u8(p + 48);
+
+        uint8x16_t any = vorrq_u8(vorrq_u8(a, b), vorrq_u8(c, d));
+        if (vmaxvq_u8(any) == 0) {
+            continue;
+        }
+
+        out = emitBlock16(ctx, byte_idx, a, out);
+        out = emitBlock16(ctx, byte_idx + 16, b, out);
+        out = emitBlock16(ctx, byte_idx + 32, c, out);
+        out = emitBlock16(ctx, byte_idx + 48, d, out);
+    }
+
+    for (; byte_idx + 16 <= ctx.end; byte_idx += 16) {
+        uint8x16_t v = vld1q_u8(ctx.data + byte_idx);
+        if (vmaxvq_u8(v) != 0) {
+            out = emitBlock16(ctx, byte_idx, v, out);
+        }
+    }
+
+    for (; byte_idx < ctx.end; byte_idx++) {
+        uint8_t byte_val = ctx.data[byte_idx];
+        if (byte_val != 0) {
+            out = emitByte(ctx, byte_idx, byte_val, out);
+        }
+    }
+
+    return static_cast<size_t>(out - start);
+}
+
+} // namespace converter
+
+#endif // AArch64
@@ -0,0 +1,277 @@
+#include "unpack_kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+#include <cstring>
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+// GCC/Clang: compile single functions for newer ISAs without raising the
+// baseline of the whole binary. They are only called after CPU detection.
+#if defined(__GNUC__) || defined(__clang__)
+    #define DVBRIDGE_TARGET_AVX2 __attribute__((target("avx2")))
+    #define DVBRIDGE_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vbmi2,bmi,bmi2,popcnt")))
+#else
+    #define DVBRIDGE_TARGET_AVX2
+    #define DVBRIDGE_TARGET_AVX512
+#endif
+
+namespace converter {
+
+namespace {
+
+inline int countTrailingZeros(uint32_t v)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, v);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(v);
+#endif
+}
+
+inline int countTrailingZeros64(uint64_t v)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, v);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+/**
+ * Reverse the four 2-bit pixels inside every byte, so pixel 0 (bits 7-6)
+ * moves to bits 1-0. After this, bit pair k of a little-endian word is
+ * pixel k of the 8-byte chunk, and pext yields masks in pixel order.
+ */
+inline uint64_t reversePixelPairs(uint64_t w)
+{
+    return ((w & 0x0303030303030303ULL) << 6) | ((w & 0x0C0C0C0C0C0C0C0CULL) << 2)
+         | ((w >> 2) & 0x0C0C0C0C0C0C0C0CULL) | ((w >> 6) & 0x0303030303030303ULL);
+}
+
+constexpr uint64_t kLowBitOfPairs = 0x5555555555555555ULL;
+
+alignas(64) constexpr int16_t kLaneIota16[32] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+};
+
+// Emit events for every byte whose bit is set in nonzero_mask
+inline dv::Event* emitMask(const UnpackContext& ctx, size_t block_start, uint32_t nonzero_mask, dv::Event* out)
+{
+    while (nonzero_mask != 0) {
+        int b = countTrailingZeros(nonzero_mask);
+        size_t byte_idx = block_start + static_cast<size_t>(b);
+        out = emitByte(ctx, byte_idx, ctx.data[byte_idx], out);
+        nonzero_mask &= nonzero_mask - 1;
+    }
+    return out;
+}
+
+inline dv::Event* emitTail(const UnpackContext& ctx, size_t byte_idx, dv::Event* out)
+{
+    for (; byte_idx < ctx.end; byte_idx++) {
+        uint8_t byte_val = ctx.data[byte_idx];
+        if (byte_val != 0) {
+            out = emitByte(ctx, byte_idx, byte_val, out);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+size_t unpackSse2(const UnpackContext& ctx, dv::Event* out)
+{
+    dv::Event* start = out;
+    const __m128i zero = _mm_setzero_si128();
+    size_t byte_idx = ctx.begin;
+
+    // 16 bytes (64 pixels) per compare; all-zero blocks cost one branch
+    for (; byte_idx + 16 <= ctx.end; byte_idx += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctx.data + byte_idx));
+        uint32_t zero_mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)));
+        if (zero_mask != 0xFFFFu) {
+            out = emitMask(ctx, byte_idx, ~zero_mask & 0xFFFFu, out);
+        }
+    }
+
+    out = emitTail(ctx, byte_idx, out);
+    return static_cast<size_t>(out - start);
+}
+
+DVBRIDGE_TARGET_AVX2
+size_t unpackAvx2(const UnpackContext& ctx, dv::Event* out)
+{
+    dv::Event* start = out;
+    const __m256i zero = _mm256_setzero_si256();
+    size_t byte_idx = ctx.begin;
+
+    // 32 bytes (128 pixels) per compare
+    for (; byte_idx + 32 <= ctx.end; byte_idx += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ctx.data + byte_idx));
+        uint32_t zero_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)));
+        if (zero_mask != 0xFFFFFFFFu) {
+            out = emitMask(ctx, byte_idx, ~zero_mask, out);
+        }
+    }
+
+    out = emitTail(ctx, byte_idx, out);
+    return static_cast<size_t>(out - start);
+}
+
+DVBRIDGE_TARGET_AVX512
+size_t unpackAvx512(const UnpackContext& ctx, dv::Event* out)
+{
+    // A 32-pixel chunk must wrap at most once, and x + 31 must fit int16 lanes
+    if (ctx.width < 32 || ctx.width > 16384) {
+        return unpackLut(ctx, out);
+    }
+
+    static_assert(sizeof(dv::Event) == 16, "AVX-512 kernel stores 16-byte dv::Event records");
+
+    dv::Event* start = out;
+    size_t byte_idx = ctx.begin;
+
+    const __m512i iota = _mm512_load_si512(kLaneIota16);
+    const __m512i width_v = _mm512_set1_epi16(static_cast<int16_t>(ctx.width));
+    const __m512i one = _mm512_set1_epi16(1);
+    const __m512i timestamp_v = _mm512_set1_epi64(ctx.timestamp);
+    const __m512i polarity_bit = _mm512_set1_epi64(1LL << 32);
+    // Interleave [timestamp][x | y << 16 | polarity << 32] into 4 events per register
+    const __m512i interleave_lo = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+    const __m512i interleave_hi = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+
+    alignas(64) int16_t xs[32];
+    alignas(64) int16_t ys[32];
+
+    // 64 bytes (256 pixels) per block, processed as 8-byte chunks of 32 pixels
+    for (; byte_idx + 64 <= ctx.end; byte_idx += 64) {
+        __m512i block = _mm512_loadu_si512(ctx.data + byte_idx);
+        uint64_t nonzero = _mm512_test_epi8_mask(block, block);
+
+        while (nonzero != 0) {
+            const unsigned chunk = static_cast<unsigned>(countTrailingZeros64(nonzero)) >> 3;
+            nonzero &= ~(0xFFULL << (chunk * 8));
+            const size_t chunk_byte = byte_idx + chunk * 8;
+
+            uint64_t word;
+            std::memcpy(&word, ctx.data + chunk_byte, sizeof(word));
+            word = reversePixelPairs(word);
+
+            // 01 / 10 = event, 00 / 11 = none; positive = 01
+            const uint64_t lo = word & kLowBitOfPairs;
+            const uint64_t hi = (word >> 1) & kLowBitOfPairs;
+            const auto active = static_cast<uint32_t>(_pext_u64(lo ^ hi, kLowBitOfPairs));
+            if (active == 0) {
+                continue;
+            }
+            const auto positive = static_cast<uint32_t>(_pext_u64(lo & ~hi, kLowBitOfPairs));
+            const uint32_t polarity = _pext_u32(positive, active);
+            const int count = _mm_popcnt_u32(active);
+
+            // Coordinates of all 32 pixels, wrapping at most once at the row end
+            __m512i x = _mm512_add_epi16(_mm512_set1_epi16(ctx.byte_x[chunk_byte]), iota);
+            __m512i y = _mm512_set1_epi16(ctx.byte_y[chunk_byte]);
+            const __mmask32 wrap = _mm512_cmpge_epi16_mask(x, width_v);
+            x = _mm512_mask_sub_epi16(x, wrap, x, width_v);
+            y = _mm512_mask_add_epi16(y, wrap, y, one);
+
+            // Compress-store: only active pixels remain, in pixel order
+            _mm512_store_si512(xs, _mm512_maskz_compress_epi16(active, x));
+            _mm512_store_si512(ys, _mm512_maskz_compress_epi16(active, y));
+
+            // Build 8 events per iteration. Stores past count stay inside the
+            // 32 events this chunk may produce, and are overwritten later
+            for (int i = 0; i < count; i += 8) {
+                // maskz forms with an all-ones mask: same instructions, but GCC's
+                // unmasked wrappers trip -Wmaybe-uninitialized
+                __m512i x64 = _mm512_maskz_cvtepu16_epi64(0xFF, _mm_load_si128(reinterpret_cast<const __m128i*>(xs + i)));
+                __m512i y64 = _mm512_maskz_cvtepu16_epi64(0xFF, _mm_load_si128(reinterpret_cast<const __m128i*>(ys + i)));
+                __m512i pol = _mm512_maskz_mov_epi64(static_cast<__mmask8>(polarity >> i), polarity_bit);
+                __m512i meta = _mm512_or_si512(_mm512_or_si512(x64, _mm512_maskz_slli_epi64(0xFF, y64, 16)), pol);
+                _mm512_storeu_si512(out + i, _mm512_permutex2var_epi64(timestamp_v, interleave_lo, meta));
+                _mm512_storeu_si512(out + i + 4, _mm512_permutex2var_epi64(timestamp_v, interleave_hi, meta));
+            }
+            out += count;
+        }
+    }
+
+    out = emitTail(ctx, byte_idx, out);
+    return static_cast<size_t>(out - start);
+}
+
+DVBRIDGE_TARGET_AVX512
+size_t unpackSoaAvx512(const UnpackContext& ctx, SoaOutput& out)
+{
+    // Same limits as unpackAvx512
+    if (ctx.width < 32 || ctx.width > 16384) {
+        return unpackSoaLut(ctx, out);
+    }
+
+    const size_t start = out.count;
+    size_t n = out.count;
+    PolarityPacker packer(out.polarity, n);
+    size_t byte_idx = ctx.begin;
+
+    const __m512i iota = _mm512_load_si512(kLaneIota16);
+    const __m512i width_v = _mm512_set1_epi16(static_cast<int16_t>(ctx.width));
+    const __m512i one = _mm512_set1_epi16(1);
+
+    for (; byte_idx + 64 <= ctx.end; byte_idx += 64) {
+        __m512i block = _mm512_loadu_si512(ctx.data + byte_idx);
+        uint64_t nonzero = _mm512_test_epi8_mask(block, block);
+
+        while (nonzero != 0) {
+            const unsigned chunk = static_cast<unsigned>(countTrailingZeros64(nonzero)) >> 3;
+            nonzero &= ~(0xFFULL << (chunk * 8));
+            const size_t chunk_byte = byte_idx + chunk * 8;
+
+            uint64_t word;
+            std::memcpy(&word, ctx.data + chunk_byte, sizeof(word));
+            word = reversePixelPairs(word);
+
+            const uint64_t lo = word & kLowBitOfPairs;
+            const uint64_t hi = (word >> 1) & kLowBitOfPairs;
+            const auto active = static_cast<uint32_t>(_pext_u64(lo ^ hi, kLowBitOfPairs));
+            if (active == 0) {
+                continue;
+            }
+            const auto positive = static_cast<uint32_t>(_pext_u64(lo & ~hi, kLowBitOfPairs));
+            const unsigned count = static_cast<unsigned>(_mm_popcnt_u32(active));
+
+            __m512i x = _mm512_add_epi16(_mm512_set1_epi16(ctx.byte_x[chunk_byte]), iota);
+            __m512i y = _mm512_set1_epi16(ctx.byte_y[chunk_byte]);
+            const __mmask32 wrap = _mm512_cmpge_epi16_mask(x, width_v);
+            x = _mm512_mask_sub_epi16(x, wrap, x, width_v);
+            y = _mm512_mask_add_epi16(y, wrap, y, one);
+
+            // Full-width stores (the arrays carry EventFrameSoA::kPadding
+            // spare entries); faster than compress-to-memory on some cores
+            _mm512_storeu_si512(out.x + n, _mm512_maskz_compress_epi16(active, x));
+            _mm512_storeu_si512(out.y + n, _mm512_maskz_compress_epi16(active, y));
+            packer.push(_pext_u32(positive, active), count);
+            n += count;
+        }
+    }
+
+    packer.flush();
+    out.count = n;
+
+    if (byte_idx < ctx.end) {
+        UnpackContext tail = ctx;
+        tail.begin = byte_idx;
+        unpackSoaLut(tail, out);
+    }
+    return out.count - start;
+}
+
+} // namespace converter
+
+#endif // x86-64
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "config.hpp"
+#include "frame_header.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace converter {
+namespace test {
+
+/**
+ * Pixel values of the 2-bit packed format (see frame_unpacker.hpp)
+ */
+constexpr uint8_t kNoEvent = 0;
+constexpr uint8_t kPositive = 1;
+constexpr uint8_t kNegative = 2;
+constexpr uint8_t kUnused = 3;
+
+/**
+ * Small configuration for unit tests: no startup kernel benchmark, and
+ * its own metrics prefix so counters of different tests stay apart
+ */
+inline Config makeConfig(int width, int height, const std::string& metrics_prefix = "")
+{
+    Config cfg;
+    cfg.width = width;
+    cfg.height = height;
+    cfg.unpack_kernel = UnpackKernel::Scalar;
+    cfg.metrics_prefix = metrics_prefix;
+    return cfg;
+}
+
+/**
+ * Empty frame (no events) for a configuration
+ */
+inline std::vector<uint8_t> emptyFrame(const Config& cfg)
+{
+    return std::vector<uint8_t>(static_cast<size_t>(cfg.frame_size()), 0);
+}
+
+/**
+ * Set the 2-bit value of pixel (x, y), MSB first within each byte
+ */
+inline void setPixel(std::vector<uint8_t>& frame, int width, int x, int y, uint8_t value)
+{
+    const size_t pixel = static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
+    const int shift = 6 - 2 * static_cast<int>(pixel % 4);
+    uint8_t& byte = frame[pixel / 4];
+    byte = static_cast<uint8_t>((byte & ~(0x03 << shift)) | ((value & 0x03) << shift));
+}
+
+/**
+ * Frame with every pixel drawn independently: an event with probability
+ * `density` (either polarity), otherwise no event or, rarely, the unused
+ * value 11. Padding bits after the last pixel stay zero.
+ */
+inline std::vector<uint8_t> randomFrame(const Config& cfg, double density, uint32_t seed)
+{
+    std::vector<uint8_t> frame = emptyFrame(cfg);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (int y = 0; y < cfg.height; y++) {
+        for (int x = 0; x < cfg.width; x++) {
+            const double r = uniform(rng);
+            uint8_t value = kNoEvent;
+            if (r < density) {
+                value = (rng() & 1) ? kPositive : kNegative;
+            } else if (r > 0.999) {
+                value = kUnused;
+            }
+            setPixel(frame, cfg.width, x, y, value);
+        }
+    }
+    return frame;
+}
+
+/**
+ * Configuration with v1 frame headers and its own metrics prefix
+ */
+inline Config v1Config(const std::string& metrics_prefix)
+{
+    Config cfg = makeConfig(16, 2, metrics_prefix);
+    cfg.has_header = true;
+    cfg.header_format = HeaderFormat::V1;
+    return cfg;
+}
+
+/**
+ * Encoded v1 header of a packed 2-bit frame
+ */
+inline std::vector<uint8_t> encodedHeader(uint32_t counter, uint32_t length, int64_t timestamp,
+                                          uint16_t flags = 0)
+{
+    FrameHeader header;
+    header.format = static_cast<uint8_t>(FrameFormat::Packed2Bit);
+    header.flags = flags;
+    header.counter = counter;
+    header.length = length;
+    header.timestamp = timestamp;
+    std::vector<uint8_t> bytes(kFrameHeaderSize);
+    encodeFrameHeader(header, bytes.data());
+    return bytes;
+}
+
+/**
+ * Current value of a pipeline counter, e.g. "rx_frames_lost"
+ */
+inline uint64_t counterValue(const Config& cfg, const char* name)
+{
+    return MetricsRegistry::global().counter(metricName(cfg, name)).value();
+}
+
+/**
+ * Temporary file removed when the object goes out of scope
+ */
+class TempFile {
+public:
+    explicit TempFile(const std::string& name)
+        : path_(std::string(P_tmpdir) + "/dvbridge_test_" + name)
+    {
+        std::remove(path_.c_str());
+    }
+
+    ~TempFile() { std::remove(path_.c_str()); }
+
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+
+    const std::string& path() const { return path_; }
+
+    /**
+     * Write `frames` back to back (a raw capture for protocol = file)
+     */
+    bool writeFrames(const std::vector<std::vector<uint8_t>>& frames) const
+    {
+        FILE* f = std::fopen(path_.c_str(), "wb");
+        if (f == nullptr) {
+            return false;
+        }
+        bool ok = true;
+        for (const auto& frame : frames) {
+            ok = ok && std::fwrite(frame.data(), 1, frame.size(), f) == frame.size();
+        }
+        return std::fclose(f) == 0 && ok;
+    }
+
+private:
+    std::string path_;
+};
+
+#ifdef __linux__
+
+/**
+ * Camera side of a loopback TCP connection: connects once the receiver
+ * listens, then sends `frames` back to back, `piece` bytes per send()
+ * with a short pause in between (0 = whole frames)
+ */
+inline void sendFrames(int port, const std::vector<std::vector<uint8_t>>& frames, size_t piece = 0)
+{
+    const int sender = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int attempt = 0; attempt < 500; attempt++) {
+        if (::connect(sender, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (const auto& frame : frames) {
+        size_t sent = 0;
+        while (sent < frame.size()) {
+            const size_t size = piece > 0 ? std::min(piece, frame.size() - sent) : frame.size() - sent;
+            const ssize_t n = send(sender, frame.data() + sent, size, MSG_NOSIGNAL);
+            if (n <= 0) {
+                close(sender);
+                return;
+            }
+            sent += static_cast<size_t>(n);
+            if (piece > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+    close(sender);
+}
+
+#endif // __linux__
+
+} // namespace test
+} // namespace converter
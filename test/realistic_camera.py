@@ -27,6 +27,11 @@ import time
 import argparse
 from dataclasses import dataclass
 
+try:
+    import dvbridge  # C++ packing (cmake -DBUILD_PYTHON=ON), optional
+except ImportError:
+    dvbridge = None
+
 # Settings
 WIDTH = 1280
 HEIGHT = 720
@@ -431,6 +436,16 @@ class SceneGenerator:
     
     def _pack_frame(self, pos_events, neg_events):
         """Pack events into 2-bit format"""
+        if dvbridge is not None:
+            # Same packing as the converter's C++ code; negative wins on overlap
+            pos_y, pos_x = np.nonzero(pos_events)
+            neg_y, neg_x = np.nonzero(neg_events)
+            x = np.concatenate([pos_x, neg_x])
+            y = np.concatenate([pos_y, neg_y])
+            polarity = np.concatenate([np.ones(len(pos_x), dtype=np.uint8),
+                                       np.zeros(len(neg_x), dtype=np.uint8)])
+            return dvbridge.pack(x, y, polarity, self.width, self.height).tobytes()
+
         # Create pixel array: 0=none, 1=positive, 2=negative
         pixels = np.zeros((self.height, self.width), dtype=np.uint8)
         pixels[pos_events] = 1
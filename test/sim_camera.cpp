@@ -0,0 +1,792 @@
+/**
+ * FPGA camera simulator (C++)
+ *
+ * Produces 2-bit packed frames with FramePacker and sends them to the
+ * converter like the FPGA does (TCP client or UDP datagrams, per
+ * --protocol), fast enough for load tests well past what the Python
+ * simulators reach. Three modes:
+ *
+ *   generate (default)  Moving circle outlines plus random noise events
+ *   --replay FILE       Send a raw FPGA capture (back-to-back frames)
+ *   --transcode IN      Convert an AEDAT4 recording into a raw FPGA
+ *                       stream (--output FILE) for --replay; no network
+ *
+ * Converter options (--width, --height, --protocol, --camera_port,
+ * --udp_packet_size, --has_header, --header_format, --frame_interval_us,
+ * --config ...) are accepted with the same meaning as for the converter.
+ * With --header_format=v1 frames carry a counter and a timestamp from the
+ * simulator's clock; --lose_every N skips a counter value every N frames
+ * to exercise the converter's gap detection. --crc appends a CRC32C
+ * trailer, and --corrupt_every N flips a payload byte after computing it
+ * to exercise verify_crc. With --tcp_connections=K (v1 headers) frames
+ * are striped round-robin across K TCP connections. --zerocopy sends with
+ * MSG_ZEROCOPY, so the converter's tcp_zerocopy finds mappable pages even
+ * on loopback.
+ *
+ * Usage:
+ *   ./sim_camera --fps 1000 --objects 8 --noise 0.002
+ *   ./sim_camera --transcode walk.aedat4 --output walk.raw
+ *   ./sim_camera --replay walk.raw --loop --fps 0
+ */
+
+#include "config.hpp"
+#include "config_loader.hpp"
+#include "frame_packer.hpp"
+#include "frame_header.hpp"
+#include "crc32c.hpp"
+
+#include <dv-processing/io/mono_camera_recording.hpp>
+
+#include <arpa/inet.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> running{true};
+
+void signalHandler(int)
+{
+    running = false;
+}
+
+struct SimOptions {
+    std::string target = "127.0.0.1";
+    double fps = 100.0;             // 0 = as fast as possible
+    uint64_t frames = 0;            // 0 = until Ctrl+C
+    int objects = 5;
+    double noise = 0.001;           // Fraction of pixels with a noise event per frame
+    std::string replay;
+    bool loop = false;
+    std::string transcode;
+    std::string output;
+    uint64_t lose_every = 0;        // v1 headers: skip a counter value every N frames
+    bool crc = false;               // v1 headers: CRC32C trailer
+    uint64_t corrupt_every = 0;     // --crc: damage a payload every N frames
+    bool zerocopy = false;          // TCP: send with MSG_ZEROCOPY
+};
+
+void printSimUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [simulator options] [converter options]\n"
+              << "\n"
+              << "Simulator options:\n"
+              << "  --target HOST        Converter address (default 127.0.0.1)\n"
+              << "  --fps N              Frame rate, 0 = unlimited (default 100)\n"
+              << "  --frames N           Stop after N frames, 0 = run until Ctrl+C\n"
+              << "  --objects N          Moving circles in generated frames (default 5)\n"
+              << "  --noise F            Noise events per pixel and frame (default 0.001)\n"
+              << "  --replay FILE        Send a raw FPGA capture instead of generating\n"
+              << "  --loop               Restart --replay at the end of the file\n"
+              << "  --transcode FILE     Convert an AEDAT4 recording to a raw capture\n"
+              << "  --output FILE        Raw capture written by --transcode\n"
+              << "  --lose_every N       v1 headers: skip a frame counter every N frames\n"
+              << "  --crc                v1 headers: append a CRC32C of the payload\n"
+              << "  --corrupt_every N    With --crc: flip a payload byte every N frames\n"
+              << "  --zerocopy           TCP: send with MSG_ZEROCOPY from page-aligned buffers\n"
+              << "\n"
+              << "Converter options (--width, --height, --protocol, --camera_port, ...)\n"
+              << "are the ones listed by `converter --help`.\n";
+}
+
+/**
+ * Split simulator options from converter options
+ * @return false on an invalid simulator option
+ */
+bool parseSimOptions(int argc, char* argv[], SimOptions& opts, std::vector<char*>& rest, bool& help)
+{
+    rest.push_back(argv[0]);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value;
+        const size_t eq = arg.find('=');
+        if (eq != std::string::npos) {
+            value = arg.substr(eq + 1);
+            arg = arg.substr(0, eq);
+        }
+        auto takeValue = [&]() {
+            if (eq != std::string::npos) {
+                return true;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return false;
+            }
+            value = argv[++i];
+            return true;
+        };
+
+        try {
+            if (arg == "-h" || arg == "--help") {
+                help = true;
+            } else if (arg == "--loop") {
+                opts.loop = true;
+            } else if (arg == "--crc") {
+                opts.crc = true;
+            } else if (arg == "--zerocopy") {
+                opts.zerocopy = true;
+            } else if (arg == "--target") {
+                if (!takeValue()) return false;
+                opts.target = value;
+            } else if (arg == "--fps") {
+                if (!takeValue()) return false;
+                opts.fps = std::stod(value);
+            } else if (arg == "--frames") {
+                if (!takeValue()) return false;
+                opts.frames = std::stoull(value);
+            } else if (arg == "--objects") {
+                if (!takeValue()) return false;
+                opts.objects = std::stoi(value);
+            } else if (arg == "--noise") {
+                if (!takeValue()) return false;
+                opts.noise = std::stod(value);
+            } else if (arg == "--replay") {
+                if (!takeValue()) return false;
+                opts.replay = value;
+            } else if (arg == "--transcode") {
+                if (!takeValue()) return false;
+                opts.transcode = value;
+            } else if (arg == "--output") {
+                if (!takeValue()) return false;
+                opts.output = value;
+            } else if (arg == "--lose_every") {
+                if (!takeValue()) return false;
+                opts.lose_every = std::stoull(value);
+            } else if (arg == "--corrupt_every") {
+                if (!takeValue()) return false;
+                opts.corrupt_every = std::stoull(value);
+            } else {
+                rest.push_back(argv[i]);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": '" << value << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Sends frames the way the FPGA does
+ */
+class FrameSender {
+public:
+    FrameSender(const converter::Config& cfg, const SimOptions& opts)
+        : config_(cfg)
+        , target_(opts.target)
+        , fd_(-1)
+        , lose_every_(opts.lose_every)
+        , crc_(opts.crc)
+        , corrupt_every_(opts.corrupt_every)
+        , zerocopy_(opts.zerocopy)
+        , zc_sends_(0)
+        , zc_completed_(0)
+        , zc_next_slot_(0)
+        , counter_(0)
+        , sent_(0)
+        , clock_start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~FrameSender()
+    {
+        if (!zc_slots_.empty()) {
+            // The last frame's partial page
+            flushZeroCopy(true);
+        }
+        for (int fd : fds_) {
+            close(fd);
+        }
+    }
+
+    bool open()
+    {
+        std::memset(&addr_, 0, sizeof(addr_));
+        addr_.sin_family = AF_INET;
+        addr_.sin_port = htons(static_cast<uint16_t>(config_.camera_port));
+        if (inet_pton(AF_INET, target_.c_str(), &addr_.sin_addr) != 1) {
+            std::cerr << "Invalid target address: " << target_ << std::endl;
+            return false;
+        }
+
+        if (config_.protocol == converter::Protocol::UDP) {
+            fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+            if (fd_ < 0) {
+                std::cerr << "Failed to create socket: " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            fds_.push_back(fd_);
+            return true;
+        }
+
+        // The converter may start after us: retry until it accepts.
+        // tcp_connections > 1: frames are striped round-robin across them
+        std::cout << "Connecting to converter at " << target_ << ":" << config_.camera_port << "..." << std::endl;
+        while (running && fds_.size() < static_cast<size_t>(config_.tcp_connections)) {
+            fd_ = socket(AF_INET, SOCK_STREAM, 0);
+            if (fd_ < 0) {
+                std::cerr << "Failed to create socket: " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            if (connect(fd_, reinterpret_cast<sockaddr*>(&addr_), sizeof(addr_)) == 0) {
+                int flag = 1;
+                setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+                fds_.push_back(fd_);
+                continue;
+            }
+            close(fd_);
+            fd_ = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+        if (fds_.size() < static_cast<size_t>(config_.tcp_connections)) {
+            return false;
+        }
+        if (zerocopy_) {
+            int flag = 1;
+            if (fds_.size() > 1 || setsockopt(fds_[0], SOL_SOCKET, SO_ZEROCOPY, &flag, sizeof(flag)) < 0) {
+                std::cerr << "--zerocopy needs one TCP connection and SO_ZEROCOPY support" << std::endl;
+                return false;
+            }
+        }
+        std::cout << "Connected";
+        if (fds_.size() > 1) {
+            std::cout << " (" << fds_.size() << " connections)";
+        }
+        std::cout << "." << std::endl;
+        return true;
+    }
+
+    bool send(const uint8_t* frame, size_t size)
+    {
+        const uint64_t index = sent_;
+        const size_t header_size = makeHeader(size);
+        size_t trailer_size = 0;
+        if (crc_) {
+            storeCrc(converter::crc32c(frame, size));
+            trailer_size = converter::kFrameTrailerSize;
+            if (corrupt_every_ > 0 && (index + 1) % corrupt_every_ == 0 && size > 0) {
+                // Damaged in transit: the CRC was computed before
+                corrupted_.assign(frame, frame + size);
+                corrupted_[size / 2] ^= 0x40;
+                frame = corrupted_.data();
+            }
+        }
+        if (config_.protocol == converter::Protocol::UDP) {
+            if (header_size > 0) {
+                // Header, payload and trailer as one stream, so the header starts a datagram
+                message_.assign(header_, header_ + header_size);
+                message_.insert(message_.end(), frame, frame + size);
+                message_.insert(message_.end(), trailer_, trailer_ + trailer_size);
+                frame = message_.data();
+                size = message_.size();
+            }
+            // udp_packet_size defaults to the receive buffer size (65535);
+            // an IPv4 datagram carries at most 65507 bytes of payload
+            const size_t packet = std::min<size_t>(static_cast<size_t>(config_.udp_packet_size), 65507);
+            for (size_t offset = 0; offset < size; offset += packet) {
+                const size_t n = std::min(packet, size - offset);
+                if (sendto(fd_, frame + offset, n, 0, reinterpret_cast<sockaddr*>(&addr_), sizeof(addr_)) < 0) {
+                    std::cerr << "sendto failed: " << std::strerror(errno) << std::endl;
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Striped: each frame whole on the next connection
+        fd_ = fds_[index % fds_.size()];
+        if (zerocopy_) {
+            return sendZeroCopy(frame, size, header_size, trailer_size);
+        }
+        if (header_size > 0 && !sendAll(header_, header_size)) {
+            return false;
+        }
+        return sendAll(frame, size) && sendAll(trailer_, trailer_size);
+    }
+
+private:
+    /**
+     * Fill header_ for a frame of `size` bytes
+     * @return Header bytes (0 without has_header)
+     */
+    size_t makeHeader(size_t size)
+    {
+        if (!config_.has_header) {
+            return 0;
+        }
+        if (config_.header_format == converter::HeaderFormat::V1) {
+            converter::FrameHeader header;
+            header.format = static_cast<uint8_t>(converter::FrameFormat::Packed2Bit);
+            header.flags = sent_ == 0 ? converter::FrameFlags::CounterReset : 0;
+            if (crc_) {
+                header.flags |= converter::FrameFlags::Crc32c;
+            }
+            if (lose_every_ > 0 && sent_ > 0 && sent_ % lose_every_ == 0) {
+                counter_++;
+            }
+            header.counter = counter_++;
+            header.length = static_cast<uint32_t>(size);
+            header.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - clock_start_).count();
+            converter::encodeFrameHeader(header, header_);
+            sent_++;
+            return converter::kFrameHeaderSize;
+        }
+        // Little-endian frame size, zero-extended to header_size
+        const uint32_t n = static_cast<uint32_t>(size);
+        for (int i = 0; i < 4; i++) {
+            header_[i] = static_cast<uint8_t>(n >> (8 * i));
+        }
+        return static_cast<size_t>(config_.header_size);
+    }
+
+    /**
+     * Fill trailer_ with a little-endian CRC32C
+     */
+    void storeCrc(uint32_t crc)
+    {
+        for (size_t i = 0; i < converter::kFrameTrailerSize; i++) {
+            trailer_[i] = static_cast<uint8_t>(crc >> (8 * i));
+        }
+    }
+
+    /**
+     * Page-aligned stretch of the --zerocopy send stream; the kernel reads
+     * its pages until their send completes
+     */
+    struct ZeroCopySlot {
+        std::unique_ptr<uint8_t, decltype(&std::free)> data{nullptr, &std::free};
+        size_t filled = 0;          // Bytes of the stream written
+        size_t sent = 0;            // Bytes handed to send() (whole pages)
+        uint32_t last_send = 0;     // MSG_ZEROCOPY id of its last send() call
+        bool pending = false;
+    };
+
+    static constexpr size_t kZeroCopySlotBytes = 1 << 20;
+    static constexpr size_t kPageBytes = 4096;
+
+    /**
+     * Header, payload and trailer appended to the stream; every complete
+     * page goes out with MSG_ZEROCOPY. Like a hardware TCP stack sending
+     * full segments, frames are back to back across pages, so the
+     * receiver can map everything; a frame's last partial page leaves
+     * with the next frame (or at close)
+     */
+    bool sendZeroCopy(const uint8_t* frame, size_t size, size_t header_size, size_t trailer_size)
+    {
+        if (zc_slots_.empty()) {
+            zc_slots_.resize(8);
+        }
+        return appendZeroCopy(header_, header_size) && appendZeroCopy(frame, size) &&
+               appendZeroCopy(trailer_, trailer_size) && flushZeroCopy(false) && reapCompletions(false);
+    }
+
+    bool appendZeroCopy(const uint8_t* data, size_t size)
+    {
+        while (size > 0) {
+            ZeroCopySlot& slot = zc_slots_[zc_next_slot_];
+            if (slot.filled == kZeroCopySlotBytes) {
+                // Full: sent, and the stream continues in the next slot
+                if (!flushZeroCopy(false)) {
+                    return false;
+                }
+                continue;
+            }
+            if (slot.filled == 0) {
+                // Completions arrive in order: wait until its last send is done
+                while (slot.pending && static_cast<int32_t>(zc_completed_ - slot.last_send) <= 0) {
+                    if (!reapCompletions(true)) {
+                        return false;
+                    }
+                }
+                slot.pending = false;
+                slot.sent = 0;
+                if (!slot.data) {
+                    slot.data.reset(static_cast<uint8_t*>(std::aligned_alloc(kPageBytes, kZeroCopySlotBytes)));
+                    if (!slot.data) {
+                        std::cerr << "Out of memory" << std::endl;
+                        return false;
+                    }
+                }
+            }
+            const size_t n = std::min(size, kZeroCopySlotBytes - slot.filled);
+            std::memcpy(slot.data.get() + slot.filled, data, n);
+            slot.filled += n;
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    /**
+     * Send the complete pages of the current slot (all bytes if `all`)
+     */
+    bool flushZeroCopy(bool all)
+    {
+        ZeroCopySlot& slot = zc_slots_[zc_next_slot_];
+        const size_t end = all ? slot.filled : slot.filled / kPageBytes * kPageBytes;
+        while (slot.sent < end) {
+            const ssize_t n = ::send(fd_, slot.data.get() + slot.sent, end - slot.sent, MSG_ZEROCOPY | MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == ENOBUFS && reapCompletions(true)) {
+                    // Too many notifications queued
+                    continue;
+                }
+                std::cerr << "Connection lost (converter disconnected)" << std::endl;
+                return false;
+            }
+            slot.last_send = zc_sends_++;
+            slot.pending = true;
+            slot.sent += static_cast<size_t>(n);
+        }
+        if (slot.filled == kZeroCopySlotBytes) {
+            slot.filled = 0;
+            zc_next_slot_ = (zc_next_slot_ + 1) % zc_slots_.size();
+        }
+        return true;
+    }
+
+    /**
+     * Collect MSG_ZEROCOPY completions from the socket's error queue
+     * @param wait Block until at least one arrives
+     */
+    bool reapCompletions(bool wait)
+    {
+        if (wait) {
+            pollfd fd = {fd_, 0, 0};    // POLLERR is always reported
+            if (poll(&fd, 1, 1000) < 0 && errno != EINTR) {
+                return false;
+            }
+        }
+        while (true) {
+            char control[128];
+            msghdr msg = {};
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            if (recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+            for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+                const auto* err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cm));
+                if (err->ee_errno == 0 && err->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+                    // Sends ee_info..ee_data are done
+                    zc_completed_ = err->ee_data + 1;
+                }
+            }
+        }
+    }
+
+    bool sendAll(const uint8_t* data, size_t size)
+    {
+        while (size > 0) {
+            const ssize_t n = ::send(fd_, data, size, MSG_NOSIGNAL);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "Connection lost (converter disconnected)" << std::endl;
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    const converter::Config& config_;
+    std::string target_;
+    sockaddr_in addr_;
+    int fd_;                    // Socket of the frame being sent
+    std::vector<int> fds_;      // All sockets (tcp_connections for TCP)
+
+    // Frame header state (v1: counter and camera clock)
+    uint64_t lose_every_;
+    bool crc_;
+    uint64_t corrupt_every_;
+    bool zerocopy_;
+    uint32_t zc_sends_;                 // MSG_ZEROCOPY send() calls so far
+    uint32_t zc_completed_;             // Sends before this id are done
+    size_t zc_next_slot_;
+    std::vector<ZeroCopySlot> zc_slots_;
+    uint32_t counter_;
+    uint64_t sent_;
+    std::chrono::steady_clock::time_point clock_start_;
+    uint8_t header_[converter::kMaxFrameHeaderSize];
+    uint8_t trailer_[converter::kFrameTrailerSize];
+    std::vector<uint8_t> message_;      // UDP: header + payload + trailer
+    std::vector<uint8_t> corrupted_;    // --corrupt_every: damaged copy of a payload
+};
+
+/**
+ * Moving circle outlines: positive events where a circle arrives,
+ * negative where it left, plus uniformly random noise events
+ */
+class SceneGenerator {
+public:
+    SceneGenerator(const converter::Config& cfg, int objects, double noise)
+        : width_(cfg.width)
+        , height_(cfg.height)
+        , noise_events_(static_cast<size_t>(noise * cfg.total_pixels()))
+        , rng_(12345)
+    {
+        std::uniform_real_distribution<double> pos_x(0, width_), pos_y(0, height_), vel(-6, 6);
+        std::uniform_int_distribution<int> radius(10, 60);
+        for (int i = 0; i < objects; i++) {
+            circles_.push_back({pos_x(rng_), pos_y(rng_), vel(rng_), vel(rng_), radius(rng_)});
+        }
+    }
+
+    const std::vector<dv::Event>& next()
+    {
+        events_.clear();
+        for (auto& c : circles_) {
+            outline(c, false);
+            c.x += c.vx;
+            c.y += c.vy;
+            if (c.x < 0 || c.x >= width_) c.vx = -c.vx;
+            if (c.y < 0 || c.y >= height_) c.vy = -c.vy;
+            outline(c, true);
+        }
+        std::uniform_int_distribution<int> nx(0, width_ - 1), ny(0, height_ - 1);
+        for (size_t i = 0; i < noise_events_; i++) {
+            events_.emplace_back(0, static_cast<int16_t>(nx(rng_)), static_cast<int16_t>(ny(rng_)),
+                                 static_cast<uint8_t>(rng_() & 1));
+        }
+        return events_;
+    }
+
+private:
+    struct Circle {
+        double x, y, vx, vy;
+        int r;
+    };
+
+    void outline(const Circle& c, bool positive)
+    {
+        // Out-of-frame points are skipped by the packer
+        const int steps = static_cast<int>(2 * std::numbers::pi * c.r);
+        for (int i = 0; i < steps; i++) {
+            const double a = 2 * std::numbers::pi * i / steps;
+            events_.emplace_back(0, static_cast<int16_t>(c.x + c.r * std::cos(a)),
+                                 static_cast<int16_t>(c.y + c.r * std::sin(a)), static_cast<uint8_t>(positive));
+        }
+    }
+
+    int width_;
+    int height_;
+    size_t noise_events_;
+    std::mt19937 rng_;
+    std::vector<Circle> circles_;
+    std::vector<dv::Event> events_;
+};
+
+/**
+ * AEDAT4 recording -> raw FPGA stream, one frame per frame_interval_us
+ * Frames without events are written too, so frame numbers (and the
+ * converter's timestamps) stay on the recording's clock.
+ */
+int transcode(converter::Config& cfg, const SimOptions& opts)
+{
+    if (opts.output.empty()) {
+        std::cerr << "--transcode needs --output FILE" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<dv::io::MonoCameraRecording> reader;
+    try {
+        reader = std::make_unique<dv::io::MonoCameraRecording>(opts.transcode);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to open " << opts.transcode << ": " << e.what() << std::endl;
+        return 1;
+    }
+    if (auto resolution = reader->getEventResolution()) {
+        cfg.width = resolution->width;
+        cfg.height = resolution->height;
+    } else {
+        std::cerr << "Recording has no event stream" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(opts.output, std::ios::binary);
+    if (!out) {
+        std::cerr << "Failed to create " << opts.output << std::endl;
+        return 1;
+    }
+
+    converter::FramePacker packer(cfg);
+    std::vector<dv::Event> window;
+    std::vector<uint8_t> frame;
+    uint64_t frames = 0;
+    uint64_t events_in = 0;
+    int64_t frame_end = 0;
+    bool first = true;
+    const auto start = std::chrono::steady_clock::now();
+
+    auto flush = [&]() {
+        packer.pack(window.data(), window.size(), frame);
+        out.write(reinterpret_cast<const char*>(frame.data()), static_cast<std::streamsize>(frame.size()));
+        window.clear();
+        frames++;
+        frame_end += cfg.frame_interval_us;
+    };
+
+    std::cout << "Transcoding " << opts.transcode << " (" << cfg.width << " x " << cfg.height
+              << ", " << cfg.frame_interval_us << " us frames) -> " << opts.output << std::endl;
+
+    while (running) {
+        auto batch = reader->getNextEventBatch();
+        if (!batch) {
+            break;
+        }
+        for (const auto& e : *batch) {
+            if (first) {
+                frame_end = e.timestamp() + cfg.frame_interval_us;
+                first = false;
+            }
+            while (e.timestamp() >= frame_end) {
+                flush();
+            }
+            window.push_back(e);
+            events_in++;
+        }
+    }
+    if (!window.empty()) {
+        flush();
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Wrote " << frames << " frames (" << frames * frame.size() / 1e6 << " MB) from "
+              << events_in << " events in " << std::fixed << std::setprecision(2) << elapsed << " s" << std::endl;
+    std::cout << "Replay with: --replay " << opts.output << " --width " << cfg.width
+              << " --height " << cfg.height << std::endl;
+    return out ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    SimOptions opts;
+    std::vector<char*> rest;
+    bool help = false;
+    if (!parseSimOptions(argc, argv, opts, rest, help)) {
+        return 1;
+    }
+    if (help) {
+        printSimUsage(argv[0]);
+        return 0;
+    }
+
+    converter::Config cfg;
+    const auto parse_result = converter::parseCommandLine(static_cast<int>(rest.size()), rest.data(), cfg);
+    if (parse_result != converter::ParseResult::Ok) {
+        return parse_result == converter::ParseResult::Exit ? 0 : 1;
+    }
+    if (!converter::validateConfig(cfg)) {
+        return 1;
+    }
+    if (opts.crc && !(cfg.has_header && cfg.header_format == converter::HeaderFormat::V1)) {
+        std::cerr << "--crc needs --has_header=true --header_format=v1" << std::endl;
+        return 1;
+    }
+
+    if (!opts.transcode.empty()) {
+        return transcode(cfg, opts);
+    }
+
+    const size_t frame_size = static_cast<size_t>(cfg.frame_size());
+    std::ifstream replay;
+    if (!opts.replay.empty()) {
+        replay.open(opts.replay, std::ios::binary);
+        if (!replay) {
+            std::cerr << "Failed to open " << opts.replay << std::endl;
+            return 1;
+        }
+    }
+
+    FrameSender sender(cfg, opts);
+    if (!sender.open()) {
+        return 1;
+    }
+
+    converter::FramePacker packer(cfg);
+    SceneGenerator scene(cfg, opts.objects, opts.noise);
+    std::vector<uint8_t> frame(frame_size);
+
+    const auto interval = opts.fps > 0 ? std::chrono::duration<double>(1.0 / opts.fps) : std::chrono::duration<double>(0);
+    const auto start = std::chrono::steady_clock::now();
+    auto last_stats = start;
+    uint64_t sent = 0;
+    uint64_t events = 0;
+    double pack_seconds = 0;
+
+    while (running && (opts.frames == 0 || sent < opts.frames)) {
+        if (replay.is_open()) {
+            if (!replay.read(reinterpret_cast<char*>(frame.data()), static_cast<std::streamsize>(frame_size))) {
+                // A trailing partial frame is dropped
+                if (!opts.loop || sent == 0) {
+                    break;
+                }
+                replay.clear();
+                replay.seekg(0);
+                continue;
+            }
+        } else {
+            const auto& generated = scene.next();
+            const auto t0 = std::chrono::steady_clock::now();
+            events += packer.pack(generated.data(), generated.size(), frame);
+            pack_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        }
+
+        if (!sender.send(frame.data(), frame.size())) {
+            break;
+        }
+        sent++;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_stats >= std::chrono::seconds(1)) {
+            const double elapsed = std::chrono::duration<double>(now - start).count();
+            std::cout << "Frames: " << sent
+                      << " | FPS: " << std::fixed << std::setprecision(1) << sent / elapsed
+                      << " | " << std::setprecision(1) << sent * frame_size * 8.0 / elapsed / 1e6 << " Mbps";
+            if (!replay.is_open() && sent > 0) {
+                std::cout << " | pack " << std::setprecision(3) << pack_seconds * 1e3 / sent << " ms/frame"
+                          << " (" << events / sent << " events)";
+            }
+            std::cout << std::endl;
+            last_stats = now;
+        }
+
+        if (opts.fps > 0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval * sent));
+        }
+    }
+
+    std::cout << "Sent " << sent << " frames." << std::endl;
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include "config.hpp"
+#include "config_loader.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace converter;
+
+namespace {
+
+/**
+ * Run parseCommandLine() on a list of arguments (program name added)
+ */
+ParseResult parse(std::vector<std::string> args, Config& cfg)
+{
+    args.insert(args.begin(), "converter");
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(arg.data());
+    }
+    return parseCommandLine(static_cast<int>(argv.size()), argv.data(), cfg);
+}
+
+} // namespace
+
+TEST(ConfigTest, DefaultsAreValid)
+{
+    Config cfg;
+    EXPECT_EQ(cfg.frame_size(), 230400);
+    EXPECT_TRUE(validateConfig(cfg));
+}
+
+TEST(ConfigTest, FrameSizeRoundsUpToWholeBytes)
+{
+    Config cfg;
+    cfg.width = 5;
+    cfg.height = 3;
+    EXPECT_EQ(cfg.frame_size(), 4);
+}
+
+TEST(ConfigTest, ApplyOptionParsesEveryType)
+{
+    Config cfg;
+    EXPECT_TRUE(applyConfigOption("width", "640", cfg));
+    EXPECT_TRUE(applyConfigOption("frame_interval_us", "2500", cfg));
+    EXPECT_TRUE(applyConfigOption("kernel_bench_density", "0.25", cfg));
+    EXPECT_TRUE(applyConfigOption("verbose", "yes", cfg));
+    EXPECT_TRUE(applyConfigOption("protocol", "UDP", cfg));
+    EXPECT_TRUE(applyConfigOption("header_format", "v1", cfg));
+    EXPECT_TRUE(applyConfigOption("unpack_kernel", "lut", cfg));
+    EXPECT_TRUE(applyConfigOption("shm_name", "\"/cam0\"", cfg));
+
+    EXPECT_EQ(cfg.width, 640);
+    EXPECT_EQ(cfg.frame_interval_us, 2500);
+    EXPECT_DOUBLE_EQ(cfg.kernel_bench_density, 0.25);
+    EXPECT_TRUE(cfg.verbose);
+    EXPECT_EQ(cfg.protocol, Protocol::UDP);
+    EXPECT_EQ(cfg.header_format, HeaderFormat::V1);
+    EXPECT_EQ(cfg.unpack_kernel, UnpackKernel::Lut);
+    EXPECT_EQ(cfg.shm_name, "/cam0");
+}
+
+TEST(ConfigTest, ApplyOptionAcceptsDashesAndBasePrefixes)
+{
+    Config cfg;
+    EXPECT_TRUE(applyConfigOption("recv-buffer-size", "0x100000", cfg));
+    EXPECT_EQ(cfg.recv_buffer_size, 0x100000);
+    EXPECT_TRUE(applyConfigOption("shm_mode", "0660", cfg));
+    EXPECT_EQ(cfg.shm_mode, 0660);
+}
+
+TEST(ConfigTest, ApplyOptionRejectsBadInput)
+{
+    Config cfg;
+    EXPECT_FALSE(applyConfigOption("no_such_option", "1", cfg));
+    EXPECT_FALSE(applyConfigOption("width", "12px", cfg));
+    EXPECT_FALSE(applyConfigOption("width", "99999999999", cfg));
+    EXPECT_FALSE(applyConfigOption("verbose", "maybe", cfg));
+    EXPECT_FALSE(applyConfigOption("protocol", "sctp", cfg));
+    EXPECT_EQ(cfg.width, Config().width);
+}
+
+TEST(ConfigTest, CommandLineForms)
+{
+    Config cfg;
+    ASSERT_EQ(parse({"--width=640", "--height", "480", "--verbose", "--protocol", "udp"}, cfg), ParseResult::Ok);
+    EXPECT_EQ(cfg.width, 640);
+    EXPECT_EQ(cfg.height, 480);
+    EXPECT_TRUE(cfg.verbose);
+    EXPECT_EQ(cfg.protocol, Protocol::UDP);
+}
+
+TEST(ConfigTest, CommandLineErrors)
+{
+    Config cfg;
+    EXPECT_EQ(parse({"--width"}, cfg), ParseResult::Error);
+    EXPECT_EQ(parse({"width=640"}, cfg), ParseResult::Error);
+    EXPECT_EQ(parse({"--bogus=1"}, cfg), ParseResult::Error);
+    EXPECT_EQ(parse({"--config"}, cfg), ParseResult::Error);
+}
+
+TEST(ConfigTest, ConfigFileIsOverriddenByCommandLine)
+{
+    test::TempFile file("config.conf");
+    {
+        std::ofstream out(file.path());
+        out << "# Rig 2\n"
+            << "width = 640      # sensor width\n"
+            << "height = 480\n"
+            << "\n"
+            << "shm_name = \"/rig#2\"\n";
+    }
+
+    Config cfg;
+    ASSERT_EQ(parse({"--config", file.path(), "--width=320"}, cfg), ParseResult::Ok);
+    EXPECT_EQ(cfg.width, 320);
+    EXPECT_EQ(cfg.height, 480);
+    EXPECT_EQ(cfg.shm_name, "/rig#2");
+}
+
+TEST(ConfigTest, ConfigFileErrors)
+{
+    Config cfg;
+    EXPECT_FALSE(loadConfigFile("/nonexistent/dvbridge.conf", cfg));
+
+    test::TempFile file("bad.conf");
+    {
+        std::ofstream out(file.path());
+        out << "width 640\n"
+            << "height = 480\n";
+    }
+    EXPECT_FALSE(loadConfigFile(file.path(), cfg));
+    // Valid lines are still applied
+    EXPECT_EQ(cfg.height, 480);
+}
+
+TEST(ConfigTest, WrittenConfigReadsBack)
+{
+    Config cfg;
+    cfg.width = 346;
+    cfg.protocol = Protocol::UDP;
+    cfg.has_header = true;
+    cfg.header_format = HeaderFormat::V1;
+    cfg.shm_name = "/cam1";
+    cfg.frame_interval_us = 3333;
+    cfg.shm_mode = 0640;
+
+    test::TempFile file("written.conf");
+    {
+        std::ofstream out(file.path());
+        writeConfig(cfg, out);
+    }
+    std::ostringstream text;
+    writeConfig(cfg, text);
+    EXPECT_NE(text.str().find("shm_mode = 0640 "), std::string::npos);
+
+    Config read;
+    ASSERT_TRUE(loadConfigFile(file.path(), read));
+    EXPECT_EQ(read.width, 346);
+    EXPECT_EQ(read.protocol, Protocol::UDP);
+    EXPECT_TRUE(read.has_header);
+    EXPECT_EQ(read.header_format, HeaderFormat::V1);
+    EXPECT_EQ(read.shm_name, "/cam1");
+    EXPECT_EQ(read.frame_interval_us, 3333);
+    EXPECT_EQ(read.shm_mode, 0640);
+}
+
+TEST(ConfigTest, ValidateRejectsBadValues)
+{
+    auto invalid = [](auto change) {
+        Config cfg;
+        change(cfg);
+        return !validateConfig(cfg);
+    };
+    EXPECT_TRUE(invalid([](Config& c) { c.width = 2; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.height = 0; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.width = 40000; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.camera_port = 70000; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.recv_buffer_size = 0; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.protocol = Protocol::File; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.shm_mode = 01777; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.tcp_connections = 0; }));
+    // Striping needs v1 headers to order frames
+    EXPECT_TRUE(invalid([](Config& c) { c.tcp_connections = 4; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.stream_rows = c.height + 1; }));
+    EXPECT_TRUE(invalid([](Config& c) { c.tcp_zerocopy = true; c.protocol = Protocol::UDP; }));
+    // 1280 x 720 has tiles 0-919
+    EXPECT_TRUE(invalid([](Config& c) { c.tile_subscription = "900-920"; }));
+    EXPECT_FALSE(invalid([](Config& c) { c.tile_subscription = "900-919"; }));
+}
+
+TEST(ConfigTest, ValidateAcceptsConsistentCombinations)
+{
+    Config striped;
+    striped.has_header = true;
+    striped.header_format = HeaderFormat::V1;
+    striped.tcp_connections = 4;
+    EXPECT_TRUE(validateConfig(striped));
+
+    Config file;
+    file.protocol = Protocol::File;
+    file.input_file = "capture.raw";
+    EXPECT_TRUE(validateConfig(file));
+}
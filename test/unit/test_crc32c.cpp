@@ -0,0 +1,109 @@
+#include "crc32c.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace converter;
+
+namespace {
+
+/**
+ * Bit-at-a-time CRC32C, straight from the definition
+ */
+uint32_t referenceCrc(const uint8_t* data, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+        }
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+std::vector<uint8_t> randomBytes(size_t size, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> bytes(size);
+    for (auto& b : bytes) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return bytes;
+}
+
+} // namespace
+
+TEST(Crc32cTest, CheckValue)
+{
+    const char* check = "123456789";
+    EXPECT_EQ(crc32c(reinterpret_cast<const uint8_t*>(check), std::strlen(check)), 0xE3069283u);
+    EXPECT_EQ(crc32c(nullptr, 0), 0u);
+}
+
+TEST(Crc32cTest, KnownVectors)
+{
+    // RFC 3720 (iSCSI) B.4
+    std::vector<uint8_t> zeros(32, 0x00);
+    std::vector<uint8_t> ones(32, 0xFF);
+    std::vector<uint8_t> ascending(32);
+    for (size_t i = 0; i < ascending.size(); i++) {
+        ascending[i] = static_cast<uint8_t>(i);
+    }
+    EXPECT_EQ(crc32c(zeros.data(), zeros.size()), 0x8A9136AAu);
+    EXPECT_EQ(crc32c(ones.data(), ones.size()), 0x62A8AB43u);
+    EXPECT_EQ(crc32c(ascending.data(), ascending.size()), 0x46DD794Eu);
+}
+
+TEST(Crc32cTest, MatchesReferenceAtEverySizeAndAlignment)
+{
+    SCOPED_TRACE(crc32cImplementation());
+    const std::vector<uint8_t> bytes = randomBytes(20000, 1);
+    // Sizes around the interleaved block lengths, from unaligned starts
+    for (size_t size : {1u, 7u, 8u, 9u, 63u, 64u, 65u, 255u, 256u, 1000u, 4095u, 4096u, 4097u, 12289u, 19990u}) {
+        for (size_t offset = 0; offset < 8; offset++) {
+            ASSERT_EQ(crc32c(bytes.data() + offset, size), referenceCrc(bytes.data() + offset, size))
+                << size << " bytes at offset " << offset;
+        }
+    }
+}
+
+TEST(Crc32cTest, RunningCrcContinues)
+{
+    const std::vector<uint8_t> bytes = randomBytes(10000, 2);
+    const uint32_t whole = crc32c(bytes.data(), bytes.size());
+    for (size_t split : {0u, 1u, 13u, 4096u, 9999u, 10000u}) {
+        const uint32_t first = crc32c(bytes.data(), split);
+        EXPECT_EQ(crc32c(bytes.data() + split, bytes.size() - split, first), whole) << "split at " << split;
+    }
+}
+
+TEST(Crc32cTest, CombineMatchesWholeBuffer)
+{
+    const std::vector<uint8_t> bytes = randomBytes(230400, 3);
+    const uint32_t whole = crc32c(bytes.data(), bytes.size());
+    for (size_t split : {0u, 1u, 3u, 1000u, 57600u, 115200u, 230399u, 230400u}) {
+        const uint32_t a = crc32c(bytes.data(), split);
+        const uint32_t b = crc32c(bytes.data() + split, bytes.size() - split);
+        EXPECT_EQ(crc32cCombine(a, b, bytes.size() - split), whole) << "split at " << split;
+    }
+
+    // Bands merged left to right, as decode_band_rows does
+    uint32_t merged = 0;
+    const size_t band = 230400 / 9;
+    for (size_t begin = 0; begin < bytes.size(); begin += band) {
+        const size_t size = std::min(band, bytes.size() - begin);
+        merged = crc32cCombine(merged, crc32c(bytes.data() + begin, size), size);
+    }
+    EXPECT_EQ(merged, whole);
+}
+
+TEST(Crc32cTest, ImplementationIsNamed)
+{
+    const std::string name = crc32cImplementation();
+    EXPECT_TRUE(name == "sse4.2" || name == "armv8" || name == "table") << name;
+}
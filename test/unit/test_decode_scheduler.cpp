@@ -0,0 +1,127 @@
+#include "decode_scheduler.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace converter;
+
+namespace {
+
+Config schedulerConfig(int threads, const std::string& metrics_prefix)
+{
+    Config cfg = test::makeConfig(16, 2, metrics_prefix);
+    cfg.decode_threads = threads;
+    return cfg;
+}
+
+/**
+ * Spin until `done` or five seconds pass
+ */
+bool waitFor(const std::function<bool()>& done)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(DecodeSchedulerTest, RunsEveryJob)
+{
+    DecodeScheduler scheduler(schedulerConfig(4, "test_sched_all_"));
+    EXPECT_EQ(scheduler.workerCount(), 4u);
+    EXPECT_EQ(scheduler.currentWorker(), -1);
+
+    const uint64_t executed = scheduler.getJobsExecuted();
+    std::atomic<int> done(0);
+    for (int i = 0; i < 1000; i++) {
+        scheduler.submit([&done]() { done++; });
+    }
+    ASSERT_TRUE(waitFor([&]() { return done == 1000; }));
+    EXPECT_TRUE(waitFor([&]() { return scheduler.getJobsExecuted() - executed == 1000; }));
+}
+
+TEST(DecodeSchedulerTest, IdleWorkersStealFromBusyOne)
+{
+    DecodeScheduler scheduler(schedulerConfig(4, "test_sched_steal_"));
+    constexpr int kJobs = 64;
+    std::atomic<int> done(0);
+    std::atomic<int> owner(-1);
+    std::mutex mutex;
+    std::set<int> thieves;
+
+    // Jobs submitted by a worker go to its own deque; it stays busy, so
+    // the others have to steal every one of them
+    std::atomic<bool> waited(false);
+    scheduler.submit([&]() {
+        owner = scheduler.currentWorker();
+        for (int i = 0; i < kJobs; i++) {
+            scheduler.submit([&]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                thieves.insert(scheduler.currentWorker());
+                done++;
+            });
+        }
+        waited = waitFor([&]() { return done == kJobs; });
+    });
+    ASSERT_TRUE(waitFor([&]() { return done == kJobs && waited; }));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(thieves.count(owner), 0u);
+    EXPECT_GE(thieves.size(), 1u);
+    EXPECT_GE(scheduler.getJobsStolen(), static_cast<uint64_t>(kJobs));
+}
+
+TEST(DecodeSchedulerTest, DestructorRunsQueuedJobs)
+{
+    constexpr int kJobs = 200;
+    std::atomic<int> done(0);
+    std::atomic<bool> release(false);
+    {
+        DecodeScheduler scheduler(schedulerConfig(2, "test_sched_stop_"));
+        // Both workers blocked: everything after stays queued
+        std::atomic<int> blocked(0);
+        for (int i = 0; i < 2; i++) {
+            scheduler.submit([&]() {
+                blocked++;
+                while (!release) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        }
+        ASSERT_TRUE(waitFor([&]() { return blocked == 2; }));
+        for (int i = 0; i < kJobs; i++) {
+            scheduler.submit([&done]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                done++;
+            });
+        }
+        EXPECT_EQ(done.load(), 0);
+        release = true;
+    }
+    EXPECT_EQ(done.load(), kJobs);
+}
+
+TEST(DecodeSchedulerTest, WakesSleepingWorkers)
+{
+    DecodeScheduler scheduler(schedulerConfig(3, "test_sched_wake_"));
+    std::atomic<int> done(0);
+    // Let the workers fall asleep between rounds
+    for (int round = 1; round <= 20; round++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        scheduler.submit([&done]() { done++; });
+        ASSERT_TRUE(waitFor([&]() { return done == round; })) << "round " << round;
+    }
+}
@@ -0,0 +1,75 @@
+#include "event_limiter.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace converter;
+using converter::test::counterValue;
+
+namespace {
+
+Config limiterConfig(const std::string& metrics_prefix)
+{
+    Config cfg = test::makeConfig(1280, 720, metrics_prefix);
+    cfg.decimation_enabled = true;
+    cfg.decimation_event_budget = 1000;
+    cfg.decimation_backlog_frames = 2;
+    cfg.decimation_max_factor = 16;
+    return cfg;
+}
+
+} // namespace
+
+TEST(EventLimiterTest, UnderBudgetPassesThrough)
+{
+    const Config cfg = limiterConfig("test_limiter_pass_");
+    EventLimiter limiter(cfg);
+    EXPECT_EQ(limiter.getFactor(), 1);
+    for (size_t events : {0u, 1u, 999u, 1000u}) {
+        EXPECT_EQ(limiter.choose(events, 0), 1) << events << " events";
+        EXPECT_EQ(limiter.choose(events, 1), 1) << events << " events, backlog below the limit";
+    }
+    EXPECT_EQ(counterValue(cfg, "decimation_frames"), 0u);
+    EXPECT_EQ(counterValue(cfg, "decimation_events_dropped"), 0u);
+}
+
+TEST(EventLimiterTest, SmallestFactorThatFitsTheBudget)
+{
+    const Config cfg = limiterConfig("test_limiter_budget_");
+    EventLimiter limiter(cfg);
+    EXPECT_EQ(limiter.choose(1001, 0), 2);
+    EXPECT_EQ(limiter.choose(2000, 0), 2);
+    EXPECT_EQ(limiter.choose(2001, 0), 4);
+    EXPECT_EQ(limiter.choose(8000, 0), 8);
+    // Capped at decimation_max_factor
+    EXPECT_EQ(limiter.choose(921600, 0), 16);
+    EXPECT_EQ(limiter.getFactor(), 16);
+
+    EXPECT_EQ(counterValue(cfg, "decimation_frames"), 5u);
+    // 1001 - 500, 2000 - 1000, 2001 - 500, 8000 - 1000, 921600 - 57600
+    EXPECT_EQ(counterValue(cfg, "decimation_events_dropped"), 501u + 1000 + 1501 + 7000 + 864000);
+}
+
+TEST(EventLimiterTest, BacklogEscalatesAndRelaxesOneStepPerFrame)
+{
+    const Config cfg = limiterConfig("test_limiter_backlog_");
+    EventLimiter limiter(cfg);
+
+    // Small frames, but delivery is behind: one more halving per frame
+    EXPECT_EQ(limiter.choose(10, 2), 2);
+    EXPECT_EQ(limiter.choose(10, 3), 4);
+    EXPECT_EQ(limiter.choose(10, 2), 8);
+    EXPECT_EQ(limiter.choose(10, 2), 16);
+    EXPECT_EQ(limiter.choose(10, 5), 16);
+
+    // Backlog below the limit but not empty: pressure holds
+    EXPECT_EQ(limiter.choose(10, 1), 16);
+
+    // Caught up: back one step per frame. The budget factor of a dense
+    // frame still applies on top
+    EXPECT_EQ(limiter.choose(10, 0), 8);
+    EXPECT_EQ(limiter.choose(1500, 0), 8);
+    EXPECT_EQ(limiter.choose(10, 0), 2);
+    EXPECT_EQ(limiter.choose(10, 0), 1);
+    EXPECT_EQ(limiter.choose(10, 0), 1);
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include "event_loop.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace converter;
+
+#ifdef __linux__
+
+namespace {
+
+/**
+ * Non-blocking pipe, closed on scope exit
+ */
+class Pipe {
+public:
+    Pipe() { ok_ = pipe2(fds_, O_NONBLOCK | O_CLOEXEC) == 0; }
+
+    ~Pipe()
+    {
+        closeWrite();
+        if (ok_) {
+            close(fds_[0]);
+        }
+    }
+
+    Pipe(const Pipe&) = delete;
+    Pipe& operator=(const Pipe&) = delete;
+
+    bool ok() const { return ok_; }
+    int readFd() const { return fds_[0]; }
+
+    bool write(char c) { return ::write(fds_[1], &c, 1) == 1; }
+
+    void closeWrite()
+    {
+        if (ok_ && fds_[1] >= 0) {
+            close(fds_[1]);
+            fds_[1] = -1;
+        }
+    }
+
+private:
+    int fds_[2] = {-1, -1};
+    bool ok_ = false;
+};
+
+/**
+ * Run the loop on its own thread; false if it did not return within five
+ * seconds (it is stopped then, so the test fails instead of hanging)
+ */
+bool runLoop(EventLoop& loop)
+{
+    auto done = std::async(std::launch::async, [&loop]() { loop.run(); });
+    if (done.wait_for(std::chrono::seconds(5)) == std::future_status::ready) {
+        return true;
+    }
+    loop.stop();
+    done.wait();
+    return false;
+}
+
+Task<void> record(std::vector<std::string>& log, std::string name)
+{
+    log.push_back(name);
+    co_return;
+}
+
+Task<void> sleepThenStop(EventLoop& loop, std::vector<std::string>& log, std::string name)
+{
+    co_await loop.sleepFor(std::chrono::milliseconds(20));
+    log.push_back(name);
+    loop.stop();
+}
+
+/**
+ * Reads one byte per wake-up until the writer hangs up
+ */
+Task<void> readUntilHangUp(EventLoop& loop, int fd, std::string& received, bool& hung_up)
+{
+    while (true) {
+        if (!co_await loop.readable(fd)) {
+            break;
+        }
+        char c;
+        const ssize_t n = read(fd, &c, 1);
+        if (n <= 0) {
+            break;
+        }
+        received.push_back(c);
+    }
+    hung_up = true;
+    loop.stop();
+}
+
+/**
+ * Sets a flag when the coroutine frame holding it is destroyed
+ */
+struct DestroyFlag {
+    bool& destroyed;
+    ~DestroyFlag() { destroyed = true; }
+};
+
+Task<void> waitReadable(EventLoop& loop, int fd, bool& resumed, bool& destroyed)
+{
+    DestroyFlag flag{destroyed};
+    co_await loop.readable(fd);
+    resumed = true;
+    loop.stop();
+}
+
+} // namespace
+
+TEST(EventLoopTest, SpawnedTasksAndPostedFunctionsRunInOrder)
+{
+    EventLoop loop;
+    ASSERT_TRUE(loop.open());
+    std::vector<std::string> log;
+
+    // Queued before run(), from this thread
+    loop.spawn(sleepThenStop(loop, log, "sleeper"));
+    loop.spawn(record(log, "task 1"));
+    loop.post([&log]() { log.push_back("post 1"); });
+    loop.spawn(record(log, "task 2"));
+    loop.post([&log]() { log.push_back("post 2"); });
+    // Posted from the loop thread: runs in the next round
+    loop.post([&]() {
+        EXPECT_TRUE(loop.inLoopThread());
+        loop.post([&log]() { log.push_back("post 3"); });
+    });
+    EXPECT_FALSE(loop.inLoopThread());
+
+    ASSERT_TRUE(runLoop(loop));
+    // A batch starts its spawned tasks before running its posted functions
+    EXPECT_EQ(log, (std::vector<std::string>{"task 1", "task 2", "post 1", "post 2", "post 3", "sleeper"}));
+    EXPECT_EQ(loop.activeTasks(), 0u);
+}
+
+TEST(EventLoopTest, ReadableFdResumesAwaitingTask)
+{
+    Pipe pipe;
+    ASSERT_TRUE(pipe.ok());
+    EventLoop loop;
+    ASSERT_TRUE(loop.open());
+
+    std::string received;
+    bool hung_up = false;
+    loop.spawn(readUntilHangUp(loop, pipe.readFd(), received, hung_up));
+    auto writer = std::async(std::launch::async, [&pipe]() {
+        for (char c : std::string("abc")) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            pipe.write(c);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        pipe.closeWrite();
+    });
+
+    ASSERT_TRUE(runLoop(loop));
+    writer.wait();
+    EXPECT_EQ(received, "abc");
+    EXPECT_TRUE(hung_up);
+    EXPECT_EQ(loop.activeTasks(), 0u);
+}
+
+TEST(EventLoopTest, StopLeavesPendingTasksSuspended)
+{
+    Pipe pipe;
+    ASSERT_TRUE(pipe.ok());
+    bool resumed = false;
+    bool destroyed = false;
+    {
+        EventLoop loop;
+        ASSERT_TRUE(loop.open());
+        loop.spawn(waitReadable(loop, pipe.readFd(), resumed, destroyed));
+        loop.post([&loop]() { loop.stop(); });
+        ASSERT_TRUE(runLoop(loop));
+        EXPECT_FALSE(resumed);
+        EXPECT_FALSE(destroyed);
+        EXPECT_EQ(loop.activeTasks(), 1u);
+
+        // run() again picks up where it left off
+        ASSERT_TRUE(pipe.write('x'));
+        ASSERT_TRUE(runLoop(loop));
+        EXPECT_TRUE(resumed);
+        EXPECT_TRUE(destroyed);
+        EXPECT_EQ(loop.activeTasks(), 0u);
+    }
+
+    // Never resumed: the loop destroys the suspended task with itself
+    char c;
+    ASSERT_EQ(read(pipe.readFd(), &c, 1), 1);
+    resumed = false;
+    destroyed = false;
+    {
+        EventLoop loop;
+        ASSERT_TRUE(loop.open());
+        loop.spawn(waitReadable(loop, pipe.readFd(), resumed, destroyed));
+        loop.stop();
+        ASSERT_TRUE(runLoop(loop));
+        EXPECT_EQ(loop.activeTasks(), 1u);
+        EXPECT_FALSE(destroyed);
+    }
+    EXPECT_FALSE(resumed);
+    EXPECT_TRUE(destroyed);
+}
+
+#endif // __linux__
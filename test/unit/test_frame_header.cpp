@@ -0,0 +1,175 @@
+#include "frame_header.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace converter;
+using converter::test::counterValue;
+using converter::test::encodedHeader;
+using converter::test::v1Config;
+
+TEST(FrameHeaderTest, EncodeDecodeRoundTrip)
+{
+    const auto bytes = encodedHeader(0xFFFFFFFEu, 4096, -5, FrameFlags::Crc32c);
+    // Little-endian magic "DVBF" first
+    EXPECT_EQ(std::string(bytes.begin(), bytes.begin() + 4), "DVBF");
+
+    FrameHeader header;
+    ASSERT_TRUE(decodeFrameHeader(bytes.data(), header));
+    EXPECT_EQ(header.version, kFrameHeaderVersion);
+    EXPECT_EQ(header.format, static_cast<uint8_t>(FrameFormat::Packed2Bit));
+    EXPECT_EQ(header.flags, FrameFlags::Crc32c);
+    EXPECT_EQ(header.counter, 0xFFFFFFFEu);
+    EXPECT_EQ(header.length, 4096u);
+    EXPECT_EQ(header.timestamp, -5);
+}
+
+TEST(FrameHeaderTest, DecodeRejectsMagicAndVersion)
+{
+    FrameHeader header;
+    auto bytes = encodedHeader(1, 8, 0);
+    bytes[0] ^= 0xFF;
+    EXPECT_FALSE(decodeFrameHeader(bytes.data(), header));
+
+    bytes = encodedHeader(1, 8, 0);
+    bytes[4] = kFrameHeaderVersion + 1;
+    EXPECT_FALSE(decodeFrameHeader(bytes.data(), header));
+}
+
+TEST(FrameHeaderParserTest, HeaderSizes)
+{
+    Config none = test::makeConfig(16, 2);
+    EXPECT_EQ(FrameHeaderParser(none).size(), 0u);
+
+    Config length = none;
+    length.has_header = true;
+    length.header_format = HeaderFormat::Length;
+    length.header_size = 4;
+    EXPECT_EQ(FrameHeaderParser(length).size(), 4u);
+    EXPECT_FALSE(FrameHeaderParser(length).isVersioned());
+
+    const Config v1 = v1Config("");
+    EXPECT_EQ(FrameHeaderParser(v1).size(), kFrameHeaderSize);
+    EXPECT_TRUE(FrameHeaderParser(v1).isVersioned());
+}
+
+TEST(FrameHeaderParserTest, LengthHeaderFallsBackOnImplausibleValues)
+{
+    Config cfg = test::makeConfig(16, 2);
+    cfg.has_header = true;
+    cfg.header_format = HeaderFormat::Length;
+    cfg.header_size = 4;
+    FrameHeaderParser parser(cfg);
+
+    size_t payload = 0;
+    const uint8_t length[] = {0x00, 0x01, 0x00, 0x00};  // 256
+    ASSERT_TRUE(parser.parse(length, payload));
+    EXPECT_EQ(payload, 256u);
+
+    const uint8_t zero[] = {0, 0, 0, 0};
+    ASSERT_TRUE(parser.parse(zero, payload));
+    EXPECT_EQ(payload, static_cast<size_t>(cfg.frame_size()));
+    EXPECT_EQ(parser.timestamp(), -1);
+}
+
+TEST(FrameHeaderParserTest, ParsesV1AndRejectsGarbage)
+{
+    const Config cfg = v1Config("test_hdr_bad_");
+    FrameHeaderParser parser(cfg);
+
+    size_t payload = 0;
+    ASSERT_TRUE(parser.parse(encodedHeader(7, 100, 123456).data(), payload));
+    EXPECT_EQ(payload, 100u);
+    EXPECT_EQ(parser.counter(), 7u);
+    EXPECT_EQ(parser.timestamp(), 123456);
+    EXPECT_EQ(parser.trailerSize(), 0u);
+
+    EXPECT_FALSE(parser.parse(encodedHeader(8, 0, 0).data(), payload));
+    auto bad_format = encodedHeader(8, 100, 0);
+    bad_format[5] = 7;
+    EXPECT_FALSE(parser.parse(bad_format.data(), payload));
+    std::vector<uint8_t> garbage(kFrameHeaderSize, 0xAB);
+    EXPECT_FALSE(parser.parse(garbage.data(), payload));
+    EXPECT_EQ(counterValue(cfg, "rx_header_errors"), 3u);
+}
+
+TEST(FrameHeaderParserTest, CountsCounterGaps)
+{
+    const Config cfg = v1Config("test_hdr_gaps_");
+    FrameHeaderParser parser(cfg);
+    size_t payload = 0;
+
+    // First frame: nothing to compare with
+    ASSERT_TRUE(parser.parse(encodedHeader(100, 8, 0).data(), payload));
+    ASSERT_TRUE(parser.parse(encodedHeader(101, 8, 0).data(), payload));
+    EXPECT_EQ(counterValue(cfg, "rx_frames_lost"), 0u);
+
+    ASSERT_TRUE(parser.parse(encodedHeader(105, 8, 0).data(), payload));
+    EXPECT_EQ(counterValue(cfg, "rx_frames_lost"), 3u);
+
+    // Reset flag and going backwards restart the sequence without a gap
+    ASSERT_TRUE(parser.parse(encodedHeader(0, 8, 0, FrameFlags::CounterReset).data(), payload));
+    ASSERT_TRUE(parser.parse(encodedHeader(1, 8, 0).data(), payload));
+    ASSERT_TRUE(parser.parse(encodedHeader(0, 8, 0).data(), payload));
+    EXPECT_EQ(counterValue(cfg, "rx_frames_lost"), 3u);
+
+    // Wraps around
+    ASSERT_TRUE(parser.parse(encodedHeader(0xFFFFFFFFu, 8, 0, FrameFlags::CounterReset).data(), payload));
+    ASSERT_TRUE(parser.parse(encodedHeader(1, 8, 0).data(), payload));
+    EXPECT_EQ(counterValue(cfg, "rx_frames_lost"), 4u);
+
+    // A new connection: no gap to its first frame
+    parser.reset();
+    ASSERT_TRUE(parser.parse(encodedHeader(50, 8, 0).data(), payload));
+    EXPECT_EQ(counterValue(cfg, "rx_frames_lost"), 4u);
+    EXPECT_EQ(parser.timestamp(), 0);
+}
+
+TEST(FrameHeaderParserTest, StripeParserDoesNotCountGaps)
+{
+    const Config cfg = v1Config("test_hdr_stripe_");
+    FrameHeaderParser parser(cfg, false);
+    size_t payload = 0;
+    for (uint32_t counter = 0; counter < 40; counter += 4) {
+        ASSERT_TRUE(parser.parse(encodedHeader(counter, 8, 0).data(), payload));
+    }
+    EXPECT_EQ(counterValue(cfg, "rx_frames_lost"), 0u);
+}
+
+TEST(FrameHeaderParserTest, CrcTrailer)
+{
+    const Config cfg = v1Config("");
+    FrameHeaderParser parser(cfg);
+    size_t payload = 0;
+    ASSERT_TRUE(parser.parse(encodedHeader(1, 8, 0, FrameFlags::Crc32c).data(), payload));
+    ASSERT_EQ(parser.trailerSize(), kFrameTrailerSize);
+    EXPECT_FALSE(parser.crc());
+
+    const uint8_t trailer[] = {0x83, 0x92, 0x06, 0xE3};
+    parser.parseTrailer(trailer);
+    EXPECT_EQ(parser.crc(), 0xE3069283u);
+
+    // The next header clears it
+    ASSERT_TRUE(parser.parse(encodedHeader(2, 8, 0).data(), payload));
+    EXPECT_EQ(parser.trailerSize(), 0u);
+    EXPECT_FALSE(parser.crc());
+}
+
+TEST(FrameHeaderParserTest, AssignmentCarriesConnectionState)
+{
+    const Config cfg = v1Config("test_hdr_assign_");
+    FrameHeaderParser parser(cfg);
+    size_t payload = 0;
+    ASSERT_TRUE(parser.parse(encodedHeader(10, 8, 777).data(), payload));
+
+    FrameHeaderParser other(cfg);
+    other = parser;
+    EXPECT_EQ(other.timestamp(), 777);
+    EXPECT_EQ(other.counter(), 10u);
+    // Still expects counter 11: 12 is one lost frame
+    ASSERT_TRUE(other.parse(encodedHeader(12, 8, 0).data(), payload));
+    EXPECT_EQ(counterValue(cfg, "rx_frames_lost"), 1u);
+}
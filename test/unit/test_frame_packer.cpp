@@ -0,0 +1,185 @@
+#include "frame_packer.hpp"
+#include "frame_unpacker.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace converter;
+
+namespace {
+
+/**
+ * Random frame: events at `density` of the pixels, some code-11 pixels,
+ * random bits in the padding of the last byte
+ */
+std::vector<uint8_t> noisyFrame(const Config& cfg, double density, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::vector<uint8_t> frame = test::emptyFrame(cfg);
+    const size_t padded = frame.size() * 4;
+    for (size_t pixel = 0; pixel < padded; pixel++) {
+        uint8_t code = 0;
+        const double r = chance(rng);
+        if (pixel >= static_cast<size_t>(cfg.total_pixels())) {
+            code = static_cast<uint8_t>(rng() & 3);
+        } else if (r < density) {
+            code = r < density / 2 ? test::kPositive : test::kNegative;
+        } else if (r < density + 0.001) {
+            code = test::kUnused;
+        }
+        frame[pixel / 4] |= static_cast<uint8_t>(code << (6 - 2 * (pixel % 4)));
+    }
+    return frame;
+}
+
+/**
+ * What the packer must produce for a frame: code 11 and padding cleared
+ */
+std::vector<uint8_t> canonical(const Config& cfg, const std::vector<uint8_t>& frame)
+{
+    std::vector<uint8_t> out(frame.size(), 0);
+    for (size_t pixel = 0; pixel < static_cast<size_t>(cfg.total_pixels()); pixel++) {
+        const unsigned shift = 6 - 2 * (pixel % 4);
+        const unsigned code = (frame[pixel / 4] >> shift) & 3;
+        if (code == test::kPositive || code == test::kNegative) {
+            out[pixel / 4] |= static_cast<uint8_t>(code << shift);
+        }
+    }
+    return out;
+}
+
+/**
+ * Parameters: bulk kernel index, (width, height), event density
+ * Densities below 1 / FramePacker::kBulkDivisor take the sparse path.
+ */
+class FramePackerTest : public ::testing::TestWithParam<std::tuple<size_t, std::pair<int, int>, double>> {
+protected:
+    void SetUp() override
+    {
+        const auto [kernel, size, density] = GetParam();
+        const auto [width, height] = size;
+        cfg_ = test::makeConfig(width, height);
+        packer_ = std::make_unique<FramePacker>(cfg_);
+        packer_->setKernel(availablePackKernels().at(kernel));
+        unpacker_ = std::make_unique<FrameUnpacker>(cfg_);
+
+        rng_.seed(static_cast<uint32_t>(width * 7919 + density * 1e6));
+        frame_ = noisyFrame(cfg_, density, rng_);
+        expected_ = canonical(cfg_, frame_);
+        unpacker_->unpack(frame_.data(), frame_.size(), 0, packet_);
+    }
+
+    Config cfg_;
+    std::unique_ptr<FramePacker> packer_;
+    std::unique_ptr<FrameUnpacker> unpacker_;
+    std::mt19937 rng_;
+    std::vector<uint8_t> frame_;
+    std::vector<uint8_t> expected_;
+    dv::EventPacket packet_;
+};
+
+std::string paramName(const ::testing::TestParamInfo<FramePackerTest::ParamType>& info)
+{
+    const auto [kernel, size, density] = info.param;
+    return std::string(availablePackKernels().at(kernel).name) + "_" + std::to_string(size.first) + "x" +
+           std::to_string(size.second) + "_" + std::to_string(static_cast<int>(density * 1000)) + "permille";
+}
+
+} // namespace
+
+TEST_P(FramePackerTest, PackOfUnpackIsIdentity)
+{
+    std::vector<uint8_t> packed;
+    EXPECT_EQ(packer_->pack(packet_.elements.data(), packet_.elements.size(), packed), packet_.elements.size());
+    EXPECT_EQ(packed, expected_);
+
+    const dv::EventStore store(std::make_shared<const dv::EventPacket>(packet_));
+    packer_->pack(store, packed);
+    EXPECT_EQ(packed, expected_);
+}
+
+TEST_P(FramePackerTest, StructureOfArraysInput)
+{
+    EventFrameSoA soa;
+    unpacker_->unpackSoA(frame_.data(), frame_.size(), 0, soa);
+    std::vector<uint8_t> packed;
+    EXPECT_EQ(packer_->pack(soa, packed), soa.count);
+    EXPECT_EQ(packed, expected_);
+
+    std::vector<uint8_t> polarity(soa.count);
+    for (size_t i = 0; i < soa.count; i++) {
+        polarity[i] = soa.positive(i) ? 1 : 0;
+    }
+    packer_->pack(soa.x.data(), soa.y.data(), polarity.data(), soa.count, packed);
+    EXPECT_EQ(packed, expected_);
+}
+
+TEST_P(FramePackerTest, OrderOfDistinctPixelsDoesNotMatter)
+{
+    std::vector<dv::Event> events = packet_.elements;
+    std::shuffle(events.begin(), events.end(), rng_);
+    std::vector<uint8_t> packed;
+    packer_->pack(events.data(), events.size(), packed);
+    EXPECT_EQ(packed, expected_);
+}
+
+TEST_P(FramePackerTest, LastEventPerPixelWins)
+{
+    // Every pixel first gets the opposite polarity, then the real one
+    std::vector<dv::Event> events;
+    events.reserve(packet_.elements.size() * 2);
+    for (const auto& e : packet_.elements) {
+        events.emplace_back(e.timestamp(), e.x(), e.y(), !e.polarity());
+    }
+    events.insert(events.end(), packet_.elements.begin(), packet_.elements.end());
+    std::vector<uint8_t> packed;
+    packer_->pack(events.data(), events.size(), packed);
+    EXPECT_EQ(packed, expected_);
+}
+
+TEST_P(FramePackerTest, OutOfFrameEventsAreDropped)
+{
+    std::vector<dv::Event> events = packet_.elements;
+    events.emplace_back(0, static_cast<int16_t>(cfg_.width), 0, true);
+    events.emplace_back(0, 0, static_cast<int16_t>(cfg_.height), true);
+    events.emplace_back(0, static_cast<int16_t>(-1), 0, false);
+    events.emplace_back(0, 0, static_cast<int16_t>(-1), false);
+    std::vector<uint8_t> packed;
+    EXPECT_EQ(packer_->pack(events.data(), events.size(), packed), packet_.elements.size());
+    EXPECT_EQ(packed, expected_);
+}
+
+TEST_P(FramePackerTest, OutputBufferIsReused)
+{
+    // A previous, fuller frame in the output must not leak through
+    std::vector<uint8_t> packed(expected_.size(), 0xFF);
+    packer_->pack(packet_.elements.data(), packet_.elements.size(), packed);
+    EXPECT_EQ(packed, expected_);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllKernels, FramePackerTest,
+    ::testing::Combine(::testing::Range<size_t>(0, availablePackKernels().size()),
+                       // 347 x 5: the last byte is padded
+                       ::testing::Values(std::pair<int, int>{1280, 720}, std::pair<int, int>{347, 5}),
+                       ::testing::Values(0.0, 0.001, 0.05, 0.5, 1.0)),
+    paramName);
+
+TEST(FramePackerKernelsTest, ScalarFirstAndDefaultIsFastest)
+{
+    const auto& kernels = availablePackKernels();
+    ASSERT_FALSE(kernels.empty());
+    EXPECT_STREQ(kernels.front().name, "scalar");
+
+    Config cfg = test::makeConfig(64, 4);
+    FramePacker packer(cfg);
+    EXPECT_STREQ(packer.getKernelName(), kernels.back().name);
+}
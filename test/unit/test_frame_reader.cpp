@@ -0,0 +1,112 @@
+#include "frame_header.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace converter;
+using converter::test::counterValue;
+using converter::test::encodedHeader;
+using converter::test::v1Config;
+
+namespace {
+
+/**
+ * Run a FrameReader over a byte stream, as a receiver would
+ * @return false if the stream ran out
+ */
+bool readFrame(FrameHeaderParser& parser, const std::vector<uint8_t>& stream, size_t& offset,
+               std::vector<uint8_t>& buffer, size_t frame_size, const PayloadHandler* handler = nullptr,
+               size_t chunk = 0, int* bad_headers = nullptr)
+{
+    FrameReader frame(parser, buffer, frame_size, handler, chunk);
+    for (FrameReader::Step step; frame.next(step);) {
+        if (offset + step.size > stream.size()) {
+            return false;
+        }
+        std::memcpy(step.data, stream.data() + offset, step.size);
+        offset += step.size;
+        if (!frame.received(step) && bad_headers) {
+            (*bad_headers)++;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(FrameReaderTest, HeaderPayloadTrailer)
+{
+    const Config cfg = v1Config("");
+    FrameHeaderParser parser(cfg);
+
+    std::vector<uint8_t> stream = encodedHeader(1, 5, 42, FrameFlags::Crc32c);
+    for (uint8_t b : {1, 2, 3, 4, 5, 0x11, 0x22, 0x33, 0x44}) {
+        stream.push_back(b);
+    }
+    size_t offset = 0;
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(readFrame(parser, stream, offset, buffer, 999));
+    EXPECT_EQ(offset, stream.size());
+    EXPECT_EQ(buffer, (std::vector<uint8_t>{1, 2, 3, 4, 5}));
+    EXPECT_EQ(parser.timestamp(), 42);
+    EXPECT_EQ(parser.crc(), 0x44332211u);
+}
+
+TEST(FrameReaderTest, WithoutHeaderReadsConfiguredSize)
+{
+    const Config cfg = test::makeConfig(16, 2);
+    FrameHeaderParser parser(cfg);
+    const std::vector<uint8_t> stream(20, 0x55);
+    size_t offset = 0;
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(readFrame(parser, stream, offset, buffer, static_cast<size_t>(cfg.frame_size())));
+    EXPECT_EQ(buffer.size(), 8u);
+    EXPECT_EQ(offset, 8u);
+}
+
+TEST(FrameReaderTest, PayloadHandlerSeesEveryChunk)
+{
+    const Config cfg = v1Config("");
+    FrameHeaderParser parser(cfg);
+    std::vector<uint8_t> stream = encodedHeader(1, 10, 0);
+    stream.resize(stream.size() + 10, 0x55);
+
+    std::vector<size_t> progress;
+    const PayloadHandler handler = [&](const uint8_t*, size_t size, size_t received) {
+        EXPECT_EQ(size, 10u);
+        progress.push_back(received);
+    };
+    size_t offset = 0;
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(readFrame(parser, stream, offset, buffer, 0, &handler, 4));
+    EXPECT_EQ(progress, (std::vector<size_t>{4, 8, 10}));
+
+    // An empty handler means none
+    const PayloadHandler empty;
+    offset = 0;
+    ASSERT_TRUE(readFrame(parser, stream, offset, buffer, 0, &empty, 4));
+    EXPECT_EQ(offset, stream.size());
+}
+
+TEST(FrameReaderTest, InvalidHeaderIsReadAgain)
+{
+    const Config cfg = v1Config("test_reader_resync_");
+    FrameHeaderParser parser(cfg);
+    // A stray header-sized block, then a valid frame (UDP resync)
+    std::vector<uint8_t> stream(kFrameHeaderSize, 0);
+    const auto header = encodedHeader(3, 2, 0);
+    stream.insert(stream.end(), header.begin(), header.end());
+    stream.push_back(0xAA);
+    stream.push_back(0x55);
+
+    size_t offset = 0;
+    int bad_headers = 0;
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(readFrame(parser, stream, offset, buffer, 0, nullptr, 0, &bad_headers));
+    EXPECT_EQ(bad_headers, 1);
+    EXPECT_EQ(buffer, (std::vector<uint8_t>{0xAA, 0x55}));
+    EXPECT_EQ(counterValue(cfg, "rx_header_errors"), 1u);
+}
@@ -0,0 +1,187 @@
+#include "frame_unpacker.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace converter;
+using converter::test::kNegative;
+using converter::test::kPositive;
+using converter::test::kUnused;
+
+namespace {
+
+/**
+ * Events of a frame in pixel order, decoded pixel by pixel
+ */
+std::vector<dv::Event> referenceEvents(const Config& cfg, const std::vector<uint8_t>& frame, int64_t timestamp)
+{
+    std::vector<dv::Event> events;
+    for (int y = 0; y < cfg.height; y++) {
+        for (int x = 0; x < cfg.width; x++) {
+            const size_t pixel = static_cast<size_t>(y) * cfg.width + x;
+            const int value = (frame[pixel / 4] >> (6 - 2 * (pixel % 4))) & 0x03;
+            if (value == kPositive || value == kNegative) {
+                events.emplace_back(timestamp, static_cast<int16_t>(x), static_cast<int16_t>(y),
+                                    static_cast<uint8_t>(value == kPositive));
+            }
+        }
+    }
+    return events;
+}
+
+void expectSameEvents(const std::vector<dv::Event>& expected, const dv::EventStore& actual)
+{
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(actual[i].timestamp(), expected[i].timestamp()) << "event " << i;
+        EXPECT_EQ(actual[i].x(), expected[i].x()) << "event " << i;
+        EXPECT_EQ(actual[i].y(), expected[i].y()) << "event " << i;
+        EXPECT_EQ(actual[i].polarity(), expected[i].polarity()) << "event " << i;
+    }
+}
+
+} // namespace
+
+TEST(FrameUnpackerTest, DecodesPixelValuesAndPositions)
+{
+    Config cfg = test::makeConfig(8, 2);
+    std::vector<uint8_t> frame = test::emptyFrame(cfg);
+    test::setPixel(frame, cfg.width, 0, 0, kPositive);
+    test::setPixel(frame, cfg.width, 3, 0, kNegative);
+    test::setPixel(frame, cfg.width, 5, 0, kUnused);
+    test::setPixel(frame, cfg.width, 7, 1, kPositive);
+
+    FrameUnpacker unpacker(cfg);
+    dv::EventStore events;
+    ASSERT_EQ(unpacker.unpack(frame, 3, events), 3u);
+
+    const int64_t t = 3 * cfg.frame_interval_us;
+    expectSameEvents({dv::Event(t, 0, 0, 1), dv::Event(t, 3, 0, 0), dv::Event(t, 7, 1, 1)}, events);
+}
+
+TEST(FrameUnpackerTest, EmptyAndShortFrames)
+{
+    Config cfg = test::makeConfig(64, 4);
+    FrameUnpacker unpacker(cfg);
+    dv::EventStore events;
+
+    EXPECT_EQ(unpacker.unpack(test::emptyFrame(cfg), 0, events), 0u);
+    EXPECT_TRUE(events.isEmpty());
+
+    std::vector<uint8_t> short_frame(static_cast<size_t>(cfg.frame_size()) - 1, 0x55);
+    EXPECT_EQ(unpacker.unpack(short_frame, 0, events), 0u);
+}
+
+TEST(FrameUnpackerTest, RowStraddlingBytes)
+{
+    // Width not a multiple of 4: bytes hold pixels of two rows
+    Config cfg = test::makeConfig(6, 5);
+    const std::vector<uint8_t> frame = test::randomFrame(cfg, 0.5, 7);
+
+    FrameUnpacker unpacker(cfg);
+    dv::EventStore events;
+    unpacker.unpack(frame, 1, events);
+    expectSameEvents(referenceEvents(cfg, frame, cfg.frame_interval_us), events);
+}
+
+TEST(FrameUnpackerTest, EveryKernelMatchesReference)
+{
+    Config cfg = test::makeConfig(320, 24);
+    const std::vector<uint8_t> frame = test::randomFrame(cfg, 0.1, 11);
+    const auto expected = referenceEvents(cfg, frame, 0);
+
+    for (const KernelInfo& kernel : availableKernels()) {
+        SCOPED_TRACE(kernel.name);
+        cfg.unpack_kernel = kernel.id;
+        FrameUnpacker unpacker(cfg);
+        dv::EventStore events;
+        unpacker.unpack(frame, 0, events);
+        expectSameEvents(expected, events);
+    }
+}
+
+TEST(FrameUnpackerTest, CameraTimestamp)
+{
+    Config cfg = test::makeConfig(8, 1);
+    std::vector<uint8_t> frame = test::emptyFrame(cfg);
+    test::setPixel(frame, cfg.width, 1, 0, kPositive);
+
+    FrameUnpacker unpacker(cfg);
+    dv::EventStore events;
+    unpacker.setTimestamp(123456789);
+    unpacker.unpack(frame, 5, events);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].timestamp(), 123456789);
+
+    unpacker.setTimestamp(-1);
+    unpacker.unpack(frame, 5, events);
+    EXPECT_EQ(events[0].timestamp(), 5 * cfg.frame_interval_us);
+}
+
+TEST(FrameUnpackerTest, SoAMatchesEvents)
+{
+    Config cfg = test::makeConfig(130, 9);
+    const std::vector<uint8_t> frame = test::randomFrame(cfg, 0.3, 3);
+    const auto expected = referenceEvents(cfg, frame, 2 * cfg.frame_interval_us);
+
+    FrameUnpacker unpacker(cfg);
+    EventFrameSoA soa;
+    ASSERT_EQ(unpacker.unpackSoA(frame.data(), frame.size(), 2, soa), expected.size());
+    ASSERT_EQ(soa.count, expected.size());
+    EXPECT_EQ(soa.timestamp, 2 * cfg.frame_interval_us);
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(soa.x[i], expected[i].x()) << "event " << i;
+        EXPECT_EQ(soa.y[i], expected[i].y()) << "event " << i;
+        EXPECT_EQ(soa.positive(i), expected[i].polarity()) << "event " << i;
+    }
+}
+
+TEST(FrameUnpackerTest, RangesConcatenateToWholeFrame)
+{
+    Config cfg = test::makeConfig(100, 10);
+    const std::vector<uint8_t> frame = test::randomFrame(cfg, 0.2, 5);
+    const auto expected = referenceEvents(cfg, frame, 0);
+
+    FrameUnpacker unpacker(cfg);
+    std::vector<dv::Event> out(4 * frame.size());
+    size_t count = 0;
+    const size_t splits[] = {0, 1, 37, 38, 200, frame.size()};
+    for (size_t i = 0; i + 1 < std::size(splits); i++) {
+        count += unpacker.unpackRange(frame.data(), frame.size(), 0, splits[i], splits[i + 1], out.data() + count);
+    }
+    ASSERT_EQ(count, expected.size());
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_EQ(out[i].x(), expected[i].x()) << "event " << i;
+        EXPECT_EQ(out[i].y(), expected[i].y()) << "event " << i;
+        EXPECT_EQ(out[i].polarity(), expected[i].polarity()) << "event " << i;
+    }
+}
+
+TEST(FrameUnpackerTest, ByteRangesSkipOtherBytes)
+{
+    Config cfg = test::makeConfig(16, 4);
+    std::vector<uint8_t> frame(static_cast<size_t>(cfg.frame_size()), 0x55);  // All positive
+
+    FrameUnpacker unpacker(cfg);
+    unpacker.setRanges(std::make_shared<std::vector<ByteRange>>(std::vector<ByteRange>{{4, 6}, {12, 13}}));
+    dv::EventStore events;
+    ASSERT_EQ(unpacker.unpack(frame, 0, events), 12u);
+    EXPECT_EQ(events[0].y(), 1);
+    EXPECT_EQ(events[0].x(), 0);
+    EXPECT_EQ(events[8].y(), 3);
+}
+
+TEST(FrameUnpackerTest, DecimationKeepsOneInN)
+{
+    Config cfg = test::makeConfig(64, 64);
+    std::vector<uint8_t> frame(static_cast<size_t>(cfg.frame_size()), 0xAA);  // All negative
+
+    FrameUnpacker unpacker(cfg);
+    dv::EventStore events;
+    unpacker.setDecimation(4);
+    EXPECT_EQ(unpacker.unpack(frame, 0, events), static_cast<size_t>(64 * 64 / 4));
+    unpacker.setDecimation(1);
+    EXPECT_EQ(unpacker.unpack(frame, 0, events), static_cast<size_t>(64 * 64));
+}
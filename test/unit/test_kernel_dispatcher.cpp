@@ -0,0 +1,60 @@
+#include "kernel_dispatcher.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace converter;
+
+namespace {
+
+Config autoConfig(int reeval_interval)
+{
+    Config cfg = test::makeConfig(64, 8);
+    cfg.unpack_kernel = UnpackKernel::Auto;
+    cfg.kernel_bench_ms = 1;
+    cfg.kernel_reeval_interval = reeval_interval;
+    return cfg;
+}
+
+} // namespace
+
+TEST(KernelDispatcherTest, AutoPicksAKernelMatchingTheReference)
+{
+    const Config cfg = autoConfig(0);
+    KernelDispatcher dispatcher(cfg);
+    dispatcher.initialize();
+    const auto results = dispatcher.benchmark(0.1, 1);
+    ASSERT_FALSE(results.empty());
+    bool found = false;
+    for (const auto& r : results) {
+        EXPECT_TRUE(r.matches_reference) << r.kernel->name;
+        found = found || r.kernel == &dispatcher.current();
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(KernelDispatcherTest, ObserversFromManyThreadsShareOneReevaluation)
+{
+    // Every frame asks for a re-evaluation; workers of a decode scheduler
+    // all report to the same dispatcher
+    const Config cfg = autoConfig(1);
+    KernelDispatcher dispatcher(cfg);
+    dispatcher.initialize();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&dispatcher, &cfg, t]() {
+            for (int i = 0; i < 2000; i++) {
+                dispatcher.observe(static_cast<size_t>((i * 7 + t) % 512), cfg.width * cfg.height);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_GT(dispatcher.getLiveDensity(), 0.0);
+    EXPECT_NE(dispatcher.current().name, nullptr);
+}
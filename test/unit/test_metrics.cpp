@@ -0,0 +1,98 @@
+#include "metrics.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace converter;
+
+TEST(MetricsTest, CounterAddsUp)
+{
+    Counter counter = MetricsRegistry::global().counter("test_metrics_adds");
+    EXPECT_EQ(counter.value(), 0u);
+    counter.add();
+    counter.add(41);
+    EXPECT_EQ(counter.value(), 42u);
+}
+
+TEST(MetricsTest, SameNameIsSameMetric)
+{
+    Counter a = MetricsRegistry::global().counter("test_metrics_shared");
+    Counter b = MetricsRegistry::global().counter("test_metrics_shared");
+    a.add(3);
+    b.add(4);
+    EXPECT_EQ(a.value(), 7u);
+    EXPECT_EQ(b.value(), 7u);
+}
+
+TEST(MetricsTest, CountsFromManyThreads)
+{
+    Counter counter = MetricsRegistry::global().counter("test_metrics_threads");
+    constexpr int kThreads = 8;
+    constexpr int kAdds = 100000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([counter]() {
+            for (int i = 0; i < kAdds; i++) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    // Shards of exited threads still count
+    EXPECT_EQ(counter.value(), static_cast<uint64_t>(kThreads) * kAdds);
+}
+
+TEST(MetricsTest, UnregisteredHandlesAreHarmless)
+{
+    Counter counter;
+    counter.add(5);
+    EXPECT_EQ(counter.value(), 0u);
+    Gauge gauge;
+    gauge.set(5);
+}
+
+TEST(MetricsTest, GaugeLastValueWins)
+{
+    Gauge gauge = MetricsRegistry::global().gauge("test_metrics_gauge");
+    gauge.set(10);
+    gauge.add(-3);
+    EXPECT_EQ(gauge.value(), 7);
+    gauge.set(-2);
+    EXPECT_EQ(gauge.value(), -2);
+}
+
+TEST(MetricsTest, SnapshotAndText)
+{
+    Counter counter = MetricsRegistry::global().counter("test_metrics_snap_counter");
+    Gauge gauge = MetricsRegistry::global().gauge("test_metrics_snap_gauge");
+    counter.add(9);
+    gauge.set(-4);
+
+    const MetricsSnapshot snap = MetricsRegistry::global().snapshot();
+    EXPECT_EQ(snap.get("test_metrics_snap_counter"), 9);
+    EXPECT_EQ(snap.get("test_metrics_snap_gauge"), -4);
+    EXPECT_EQ(snap.get("test_metrics_no_such_metric"), 0);
+
+    std::ostringstream text;
+    snap.writeText(text);
+    EXPECT_NE(text.str().find("test_metrics_snap_counter 9\n"), std::string::npos);
+    EXPECT_NE(text.str().find("test_metrics_snap_gauge -4\n"), std::string::npos);
+}
+
+TEST(MetricsTest, PrefixSeparatesPipelines)
+{
+    const Config cam0 = test::makeConfig(8, 8, "cam0_");
+    const Config cam1 = test::makeConfig(8, 8, "cam1_");
+    EXPECT_EQ(metricName(cam0, "rx_bytes"), "cam0_rx_bytes");
+
+    MetricsRegistry::global().counter(metricName(cam0, "rx_bytes")).add(1);
+    MetricsRegistry::global().counter(metricName(cam1, "rx_bytes")).add(2);
+    EXPECT_EQ(MetricsRegistry::global().counter(metricName(cam0, "rx_bytes")).value(), 1u);
+    EXPECT_EQ(MetricsRegistry::global().counter(metricName(cam1, "rx_bytes")).value(), 2u);
+}
@@ -0,0 +1,380 @@
+#include "pipeline.hpp"
+#include "buffer_pool.hpp"
+#include "decode_scheduler.hpp"
+#include "unpack_kernels.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace converter;
+
+namespace {
+
+constexpr int kWidth = 64;
+constexpr int kHeight = 8;
+
+/**
+ * File-input configuration over a raw capture; file input is lossless,
+ * so every frame written must come out
+ */
+Config fileConfig(const std::string& path, const std::string& metrics_prefix)
+{
+    Config cfg = test::makeConfig(kWidth, kHeight, metrics_prefix);
+    cfg.protocol = Protocol::File;
+    cfg.input_file = path;
+    cfg.pipeline_queue_depth = 2;
+    cfg.pipeline_pool_size = 4;
+    return cfg;
+}
+
+/**
+ * Frame i has i + 1 positive events, so frames can be told apart
+ */
+std::vector<std::vector<uint8_t>> countingFrames(const Config& cfg, int count)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < count; i++) {
+        std::vector<uint8_t> frame = test::emptyFrame(cfg);
+        for (int e = 0; e <= i; e++) {
+            test::setPixel(frame, cfg.width, e % cfg.width, e / cfg.width, test::kPositive);
+        }
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+} // namespace
+
+TEST(BufferPoolTest, ReusesReleasedBuffers)
+{
+    BufferPool<std::vector<int>> pool(2);
+    auto a = pool.acquire();
+    ASSERT_NE(a, nullptr);
+    a->assign(1000, 7);
+    std::vector<int>* storage = a.get();
+
+    a.reset();
+    EXPECT_EQ(pool.inUse(), 0u);
+    auto b = pool.acquire();
+    EXPECT_EQ(b.get(), storage);
+    // Contents and allocation are kept for the next user
+    EXPECT_EQ(b->size(), 1000u);
+}
+
+TEST(BufferPoolTest, ExhaustedUntilLastCopyIsGone)
+{
+    BufferPool<std::vector<int>> pool(2);
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    EXPECT_EQ(pool.inUse(), 2u);
+    EXPECT_EQ(pool.acquire(), nullptr);
+
+    auto copy = a;
+    a.reset();
+    EXPECT_EQ(pool.acquire(), nullptr);
+    copy.reset();
+    EXPECT_NE(pool.acquire(), nullptr);
+}
+
+TEST(BufferPoolTest, BufferOutlivesPool)
+{
+    BufferPool<std::vector<int>>::Ptr kept;
+    {
+        BufferPool<std::vector<int>> pool(1);
+        kept = pool.acquire();
+        kept->push_back(42);
+    }
+    // Released into the pool's shared state, which the deleter keeps alive
+    EXPECT_EQ(kept->at(0), 42);
+    kept.reset();
+}
+
+TEST(BufferPoolTest, ReleaseFromOtherThreads)
+{
+    BufferPool<std::vector<int>> pool(4);
+    for (int round = 0; round < 100; round++) {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++) {
+            auto buffer = pool.acquire();
+            ASSERT_NE(buffer, nullptr);
+            threads.emplace_back([buffer]() mutable { buffer.reset(); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        EXPECT_EQ(pool.inUse(), 0u);
+    }
+}
+
+TEST(PipelineTest, PullQueueDeliversEveryFrameInOrder)
+{
+    test::TempFile file("pipeline_pull.raw");
+    Config cfg = fileConfig(file.path(), "test_pull_");
+    const auto frames = countingFrames(cfg, 10);
+    ASSERT_TRUE(file.writeFrames(frames));
+
+    Pipeline pipeline(cfg);
+    ASSERT_TRUE(pipeline.start());
+
+    std::vector<EventFramePtr> received;
+    while (auto frame = pipeline.next(5000)) {
+        received.push_back(frame);
+        // Slower than the reader: the queue fills, file input waits
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    pipeline.stop();
+
+    EXPECT_TRUE(pipeline.inputFinished());
+    ASSERT_EQ(received.size(), frames.size());
+    for (size_t i = 0; i < received.size(); i++) {
+        EXPECT_EQ(received[i]->frame_number, i);
+        EXPECT_EQ(received[i]->events.size(), i + 1);
+        EXPECT_EQ(received[i]->timestamp, static_cast<int64_t>(i) * cfg.frame_interval_us);
+    }
+    EXPECT_EQ(pipeline.getFramesDelivered(), frames.size());
+    EXPECT_EQ(pipeline.getFramesDropped(), 0u);
+    EXPECT_EQ(pipeline.getEventsDelivered(), 55u);
+}
+
+TEST(PipelineTest, CallbackReplacesPullQueue)
+{
+    test::TempFile file("pipeline_callback.raw");
+    Config cfg = fileConfig(file.path(), "test_callback_");
+    cfg.pipeline_soa = true;
+    const auto frames = countingFrames(cfg, 6);
+    ASSERT_TRUE(file.writeFrames(frames));
+
+    std::mutex mutex;
+    std::vector<size_t> counts;
+    std::thread::id callback_thread;
+
+    Pipeline pipeline(cfg);
+    pipeline.setCallback([&](const EventFramePtr& frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_NE(frame->soa, nullptr);
+        counts.push_back(frame->soa->count);
+        callback_thread = std::this_thread::get_id();
+    });
+    ASSERT_TRUE(pipeline.start());
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pipeline.inputFinished() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    // Nothing is queued for next() while a callback is set
+    EXPECT_EQ(pipeline.next(0), nullptr);
+    pipeline.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(counts, (std::vector<size_t>{1, 2, 3, 4, 5, 6}));
+    EXPECT_NE(callback_thread, std::this_thread::get_id());
+}
+
+TEST(PipelineTest, HeldFramesKeepTheirEvents)
+{
+    test::TempFile file("pipeline_hold.raw");
+    Config cfg = fileConfig(file.path(), "test_hold_");
+    cfg.pipeline_pool_size = 2;
+    cfg.pipeline_queue_depth = 1;
+    const auto frames = countingFrames(cfg, 8);
+    ASSERT_TRUE(file.writeFrames(frames));
+
+    Pipeline pipeline(cfg);
+    ASSERT_TRUE(pipeline.start());
+
+    // Keep the first frame while the others pass through the pool
+    EventFramePtr first = pipeline.next(5000);
+    ASSERT_NE(first, nullptr);
+    size_t later = 0;
+    while (auto frame = pipeline.next(5000)) {
+        later++;
+    }
+    pipeline.stop();
+
+    EXPECT_EQ(later, frames.size() - 1);
+    ASSERT_EQ(first->events.size(), 1u);
+    EXPECT_EQ(first->events[0].x(), 0);
+    EXPECT_EQ(first->events[0].y(), 0);
+}
+
+TEST(PipelineTest, StartRejectsInvalidConfig)
+{
+    test::TempFile file("pipeline_invalid.raw");
+    Config cfg = fileConfig(file.path(), "test_invalid_");
+    ASSERT_TRUE(file.writeFrames(countingFrames(cfg, 2)));
+
+    // Longer than any frame header: never reaches the receiver
+    cfg.has_header = true;
+    cfg.header_format = HeaderFormat::Length;
+    cfg.header_size = 64;
+    Pipeline pipeline(cfg);
+    EXPECT_FALSE(pipeline.start());
+    EXPECT_FALSE(pipeline.isRunning());
+}
+
+TEST(PipelineTest, ParallelDecodeDeliversInOrder)
+{
+    test::TempFile file("pipeline_parallel.raw");
+    Config cfg = fileConfig(file.path(), "test_parallel_");
+    cfg.width = 640;
+    cfg.height = 480;
+    cfg.decode_threads = 4;
+    cfg.pipeline_pool_size = 8;
+    cfg.pipeline_queue_depth = 64;
+
+    // Dense frames between nearly empty ones: decodes finish out of order
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < 40; i++) {
+        frames.push_back(test::randomFrame(cfg, i % 3 == 0 ? 0.8 : 0.001, static_cast<uint32_t>(i)));
+    }
+    ASSERT_TRUE(file.writeFrames(frames));
+
+    Pipeline pipeline(cfg);
+    ASSERT_TRUE(pipeline.start());
+    std::vector<EventFramePtr> received;
+    while (auto frame = pipeline.next(5000)) {
+        received.push_back(frame);
+    }
+    pipeline.stop();
+
+    ASSERT_EQ(received.size(), frames.size());
+    for (size_t i = 0; i < received.size(); i++) {
+        EXPECT_EQ(received[i]->frame_number, i);
+        EXPECT_EQ(received[i]->events.size(), countEvents(frames[i].data(), frames[i].size())) << "frame " << i;
+    }
+    EXPECT_GT(test::counterValue(cfg, "decode_jobs"), 0u);
+    EXPECT_EQ(pipeline.getFramesDropped(), 0u);
+}
+
+TEST(PipelineTest, SharedSchedulerKeepsEachPipelineInOrder)
+{
+    // Two cameras on one scheduler: each still gets its own frames in order
+    test::TempFile left_file("pipeline_shared_left.raw");
+    test::TempFile right_file("pipeline_shared_right.raw");
+    Config left_cfg = fileConfig(left_file.path(), "test_shared_left_");
+    Config right_cfg = fileConfig(right_file.path(), "test_shared_right_");
+    left_cfg.decode_threads = 3;
+    const auto frames = countingFrames(left_cfg, 30);
+    ASSERT_TRUE(left_file.writeFrames(frames));
+    ASSERT_TRUE(right_file.writeFrames(frames));
+
+    auto scheduler = std::make_shared<DecodeScheduler>(left_cfg);
+    Pipeline left(left_cfg, nullptr, scheduler);
+    Pipeline right(right_cfg, nullptr, scheduler);
+    ASSERT_TRUE(left.start());
+    ASSERT_TRUE(right.start());
+    for (Pipeline* pipeline : {&left, &right}) {
+        std::vector<size_t> sizes;
+        while (auto frame = pipeline->next(5000)) {
+            EXPECT_EQ(frame->frame_number, sizes.size());
+            sizes.push_back(frame->events.size());
+        }
+        pipeline->stop();
+        ASSERT_EQ(sizes.size(), frames.size());
+        for (size_t i = 0; i < sizes.size(); i++) {
+            EXPECT_EQ(sizes[i], i + 1);
+        }
+    }
+}
+
+TEST(PipelineTest, SubscribeRejectsTilesOutsideTheFrame)
+{
+    // 64 x 8: two tiles
+    const Config cfg = fileConfig("unused.raw", "test_tiles_range_");
+    Pipeline pipeline(cfg);
+    TileSelection outside;
+    outside.tiles = {1, 2};
+    EXPECT_EQ(pipeline.subscribeTiles(outside), -1);
+    TileSelection inside;
+    inside.tiles = {1};
+    EXPECT_GE(pipeline.subscribeTiles(inside), 0);
+}
+
+#ifdef __linux__
+
+TEST(PipelineTest, StreamRowsDeliversEveryEventOnceInOrder)
+{
+    // 70 pixels per row: one-row parts of 17 bytes end mid-row, so rows
+    // are split across parts
+    Config cfg = test::makeConfig(70, 12, "test_stream_rows_");
+    cfg.camera_port = 46176;
+    cfg.stream_rows = 1;
+    const std::vector<std::vector<uint8_t>> frames = {test::randomFrame(cfg, 0.3, 1),
+                                                      test::randomFrame(cfg, 0.3, 2)};
+
+    // Copied out: holding on to the parts would keep their pooled packets
+    struct Part {
+        uint64_t frame_number;
+        int row_begin;
+        int row_end;
+        bool frame_end;
+        std::vector<std::tuple<int, int, bool>> events;
+    };
+    std::mutex mutex;
+    std::vector<Part> parts;
+    Pipeline pipeline(cfg);
+    pipeline.setCallback([&](const EventFramePtr& frame) {
+        Part part{frame->frame_number, frame->row_begin, frame->row_end, frame->frame_end, {}};
+        for (const auto& event : frame->events) {
+            part.events.emplace_back(event.x(), event.y(), event.polarity());
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        parts.push_back(std::move(part));
+    });
+    ASSERT_TRUE(pipeline.start());
+    // Odd-sized pieces: parts are decoded as their bytes trickle in
+    test::sendFrames(cfg.camera_port, frames, 7);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pipeline.getFramesDelivered() < frames.size() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    pipeline.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (uint64_t f = 0; f < frames.size(); f++) {
+        SCOPED_TRACE("frame " + std::to_string(f));
+        // Expected events in pixel order
+        std::vector<std::tuple<int, int, bool>> expected;
+        for (int y = 0; y < cfg.height; y++) {
+            for (int x = 0; x < cfg.width; x++) {
+                const size_t pixel = static_cast<size_t>(y * cfg.width + x);
+                const uint8_t value = (frames[f][pixel / 4] >> (6 - 2 * (pixel % 4))) & 0x03;
+                if (value == test::kPositive || value == test::kNegative) {
+                    expected.emplace_back(x, y, value == test::kPositive);
+                }
+            }
+        }
+
+        std::vector<std::tuple<int, int, bool>> streamed;
+        int row_end = 0;
+        size_t frame_parts = 0;
+        bool ended = false;
+        for (const auto& part : parts) {
+            if (part.frame_number != f) {
+                continue;
+            }
+            EXPECT_FALSE(ended) << "part after frame_end";
+            // In row order; a row split across parts appears in both
+            EXPECT_GE(part.row_begin, row_end - 1);
+            EXPECT_GT(part.row_end, part.row_begin);
+            row_end = part.row_end;
+            ended = part.frame_end;
+            frame_parts++;
+            streamed.insert(streamed.end(), part.events.begin(), part.events.end());
+        }
+        EXPECT_TRUE(ended);
+        EXPECT_EQ(row_end, cfg.height);
+        EXPECT_GT(frame_parts, static_cast<size_t>(cfg.height) / 2);
+        EXPECT_EQ(streamed, expected);
+    }
+}
+
+#endif // __linux__
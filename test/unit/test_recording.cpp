@@ -0,0 +1,172 @@
+#include "recording.hpp"
+#include "batch_converter.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace converter;
+
+namespace {
+
+/**
+ * Empty directory for a recording's segments and index, removed afterwards
+ */
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& name)
+        : path_(std::filesystem::path(P_tmpdir) / ("dvbridge_test_" + name))
+    {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempDirectory() { std::filesystem::remove_all(path_); }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    std::string file(const std::string& name) const { return (path_ / name).string(); }
+
+private:
+    std::filesystem::path path_;
+};
+
+/**
+ * `count` events at the start of the first row
+ */
+dv::EventStore eventsOf(size_t count, int64_t timestamp)
+{
+    auto packet = std::make_shared<dv::EventPacket>();
+    for (size_t i = 0; i < count; i++) {
+        packet->elements.emplace_back(timestamp, static_cast<int16_t>(i), 0, 1);
+    }
+    return dv::EventStore(std::shared_ptr<const dv::EventPacket>(packet));
+}
+
+} // namespace
+
+TEST(RecordingIndexTest, SegmentAndIndexPaths)
+{
+    EXPECT_EQ(RecordingIndex::indexPath("out.aedat4"), "out.aedat4.index");
+    EXPECT_EQ(RecordingIndex::segmentPath("rec/out.aedat4", 3), "rec/out.00003.aedat4");
+    EXPECT_EQ(RecordingIndex::segmentPath("out", 12), "out.00012");
+}
+
+TEST(RecordingIndexTest, WriterSegmentsReadBack)
+{
+    TempDirectory dir("recording_writer");
+    Config cfg = test::makeConfig(64, 8);
+    cfg.output_file = dir.file("capture.aedat4");
+    cfg.output_segment_frames = 3;
+    cfg.frame_interval_us = 1000;
+
+    {
+        RecordingWriter writer(cfg);
+        ASSERT_TRUE(writer.open());
+        // Frame 4 is lost; frame i has i events, camera clock starts at 5000
+        for (uint64_t frame : {0, 1, 2, 3, 5, 6}) {
+            writer.write(frame, 5000 + static_cast<int64_t>(frame) * 1000, eventsOf(frame, 0));
+        }
+        writer.close();
+    }
+
+    std::vector<RecordingSegment> segments;
+    ASSERT_TRUE(RecordingIndex::load(RecordingIndex::indexPath(cfg.output_file), segments));
+    ASSERT_EQ(segments.size(), 3u);
+
+    EXPECT_EQ(segments[0].path, dir.file("capture.00000.aedat4"));
+    EXPECT_EQ(segments[0].first_frame, 0u);
+    EXPECT_EQ(segments[0].frames, 3u);
+    EXPECT_EQ(segments[0].begin_us, 5000);
+    EXPECT_EQ(segments[0].end_us, 8000);
+    EXPECT_EQ(segments[0].events, 3u);
+
+    EXPECT_EQ(segments[1].path, dir.file("capture.00001.aedat4"));
+    EXPECT_EQ(segments[1].first_frame, 3u);
+    EXPECT_EQ(segments[1].frames, 3u);
+    EXPECT_EQ(segments[1].begin_us, 8000);
+    EXPECT_EQ(segments[1].end_us, 11000);
+    EXPECT_EQ(segments[1].events, 8u);
+
+    EXPECT_EQ(segments[2].first_frame, 6u);
+    EXPECT_EQ(segments[2].frames, 1u);
+    EXPECT_EQ(segments[2].events, 6u);
+    for (const auto& segment : segments) {
+        EXPECT_TRUE(std::filesystem::exists(segment.path)) << segment.path;
+    }
+}
+
+TEST(RecordingIndexTest, BatchConverterSegmentsReadBackInFrameOrder)
+{
+    TempDirectory dir("recording_batch");
+    Config cfg = test::makeConfig(64, 8);
+    cfg.protocol = Protocol::File;
+    cfg.input_file = dir.file("capture.raw");
+    cfg.output_file = dir.file("capture.aedat4");
+    cfg.convert_chunk_frames = 4;
+    cfg.decode_threads = 3;
+
+    // Frame i has i + 1 events
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < 10; i++) {
+        std::vector<uint8_t> frame = test::emptyFrame(cfg);
+        for (int e = 0; e <= i; e++) {
+            test::setPixel(frame, cfg.width, e, 0, test::kPositive);
+        }
+        frames.push_back(std::move(frame));
+    }
+    {
+        std::ofstream out(cfg.input_file, std::ios::binary);
+        for (const auto& frame : frames) {
+            out.write(reinterpret_cast<const char*>(frame.data()), static_cast<std::streamsize>(frame.size()));
+        }
+    }
+
+    {
+        BatchConverter batch(cfg);
+        ASSERT_TRUE(batch.start());
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (batch.isRunning() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        ASSERT_TRUE(batch.isComplete());
+    }
+
+    // Chunks finish in any order; load() sorts them
+    std::vector<RecordingSegment> segments;
+    ASSERT_TRUE(RecordingIndex::load(RecordingIndex::indexPath(cfg.output_file), segments));
+    ASSERT_EQ(segments.size(), 3u);
+    const uint64_t expected_events[] = {1 + 2 + 3 + 4, 5 + 6 + 7 + 8, 9 + 10};
+    for (size_t i = 0; i < segments.size(); i++) {
+        SCOPED_TRACE("segment " + std::to_string(i));
+        EXPECT_EQ(segments[i].path, RecordingIndex::segmentPath(cfg.output_file, i));
+        EXPECT_EQ(segments[i].first_frame, 4 * i);
+        EXPECT_EQ(segments[i].frames, i < 2 ? 4u : 2u);
+        EXPECT_EQ(segments[i].begin_us, static_cast<int64_t>(4 * i) * cfg.frame_interval_us);
+        EXPECT_EQ(segments[i].end_us, static_cast<int64_t>(4 * i + segments[i].frames) * cfg.frame_interval_us);
+        EXPECT_EQ(segments[i].events, expected_events[i]);
+    }
+}
+
+TEST(RecordingIndexTest, LoadRejectsOtherFiles)
+{
+    TempDirectory dir("recording_bad");
+    std::vector<RecordingSegment> segments;
+    EXPECT_FALSE(RecordingIndex::load(dir.file("missing.index"), segments));
+
+    const std::string not_index = dir.file("not.index");
+    std::ofstream(not_index) << "capture.00000.aedat4 0 10 0 100 5\n";
+    EXPECT_FALSE(RecordingIndex::load(not_index, segments));
+
+    const std::string malformed = dir.file("malformed.index");
+    std::ofstream(malformed) << "# DVBridge recording index 1\n"
+                             << "capture.00000.aedat4 0 10 zero 100 5\n";
+    EXPECT_FALSE(RecordingIndex::load(malformed, segments));
+}
@@ -0,0 +1,124 @@
+#include "reorder_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace converter;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Buffer = ReorderBuffer<int>;
+
+std::vector<int> drain(Buffer& buffer, Buffer::Clock::time_point now)
+{
+    std::vector<int> out;
+    while (auto value = buffer.pop(now)) {
+        out.push_back(*value);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(ReorderBufferTest, ReleasesInSequenceOrder)
+{
+    Buffer buffer(8);
+    const auto now = Buffer::Clock::now();
+    EXPECT_TRUE(buffer.insert(2, 20));
+    EXPECT_TRUE(buffer.insert(1, 10));
+    // 0 is missing: nothing comes out
+    EXPECT_FALSE(buffer.pop(now));
+    EXPECT_TRUE(buffer.insert(0, 0));
+    EXPECT_EQ(drain(buffer, now), (std::vector<int>{0, 10, 20}));
+    EXPECT_EQ(buffer.next(), 3u);
+    EXPECT_EQ(buffer.getSkipped(), 0u);
+}
+
+TEST(ReorderBufferTest, StartsAtFirstSequence)
+{
+    Buffer buffer(8, Buffer::Clock::duration::max(), 100);
+    EXPECT_TRUE(buffer.insert(100, 1));
+    EXPECT_EQ(buffer.pop().value_or(-1), 1);
+    EXPECT_FALSE(buffer.insert(99, 2));
+    EXPECT_EQ(buffer.getLate(), 1u);
+}
+
+TEST(ReorderBufferTest, GapSkippedAfterMaxWait)
+{
+    Buffer buffer(8, 50ms);
+    const auto t0 = Buffer::Clock::now();
+    buffer.insert(1, 10);
+    buffer.insert(2, 20);
+    EXPECT_FALSE(buffer.pop(t0));
+    ASSERT_TRUE(buffer.nextDeadline());
+    EXPECT_EQ(*buffer.nextDeadline(), t0 + 50ms);
+
+    EXPECT_FALSE(buffer.pop(t0 + 49ms));
+    EXPECT_EQ(drain(buffer, t0 + 50ms), (std::vector<int>{10, 20}));
+    EXPECT_EQ(buffer.getSkipped(), 1u);
+    EXPECT_FALSE(buffer.nextDeadline());
+
+    // The skipped result is late when it finally arrives
+    EXPECT_FALSE(buffer.insert(0, 0));
+    EXPECT_EQ(buffer.getLate(), 1u);
+}
+
+TEST(ReorderBufferTest, GapSkippedAtCapacity)
+{
+    Buffer buffer(3);
+    const auto now = Buffer::Clock::now();
+    buffer.insert(5, 50);
+    buffer.insert(6, 60);
+    EXPECT_FALSE(buffer.pop(now));
+    // No max_wait: only capacity gives up on the gap
+    EXPECT_FALSE(buffer.nextDeadline());
+    buffer.insert(7, 70);
+    EXPECT_EQ(drain(buffer, now), (std::vector<int>{50, 60, 70}));
+    EXPECT_EQ(buffer.getSkipped(), 5u);
+}
+
+TEST(ReorderBufferTest, DuplicatesAreRejected)
+{
+    Buffer buffer(8);
+    EXPECT_TRUE(buffer.insert(1, 10));
+    EXPECT_FALSE(buffer.insert(1, 11));
+    EXPECT_EQ(buffer.size(), 1u);
+    EXPECT_EQ(buffer.getLate(), 0u);
+}
+
+TEST(ReorderBufferTest, PopAnyAndReset)
+{
+    Buffer buffer(8);
+    buffer.insert(3, 30);
+    buffer.insert(5, 50);
+    EXPECT_EQ(buffer.popAny().value_or(-1), 30);
+    EXPECT_EQ(buffer.popAny().value_or(-1), 50);
+    EXPECT_FALSE(buffer.popAny());
+    EXPECT_EQ(buffer.getSkipped(), 4u);
+
+    buffer.insert(7, 70);
+    buffer.reset(2);
+    EXPECT_EQ(buffer.size(), 0u);
+    EXPECT_EQ(buffer.next(), 2u);
+    // Counters survive a reset
+    EXPECT_EQ(buffer.getSkipped(), 4u);
+    EXPECT_TRUE(buffer.insert(2, 20));
+    EXPECT_EQ(buffer.pop().value_or(-1), 20);
+}
+
+TEST(ReorderBufferTest, MoveOnlyValues)
+{
+    ReorderBuffer<std::unique_ptr<int>> buffer(4);
+    buffer.insert(1, std::make_unique<int>(1));
+    buffer.insert(0, std::make_unique<int>(0));
+    auto first = buffer.pop();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(**first, 0);
+    auto second = buffer.pop();
+    ASSERT_TRUE(second);
+    EXPECT_EQ(**second, 1);
+}
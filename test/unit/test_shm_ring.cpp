@@ -0,0 +1,190 @@
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include "shm_reader.hpp"
+#include "shm_writer.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+using namespace converter;
+
+#ifdef __linux__
+
+namespace {
+
+Config shmConfig(const std::string& name, int slot_count, int slot_events)
+{
+    Config cfg = test::makeConfig(64, 8, "test_" + name.substr(1) + "_");
+    cfg.shm_name = name;
+    cfg.shm_slot_count = slot_count;
+    cfg.shm_slot_events = slot_events;
+    return cfg;
+}
+
+/**
+ * Frame whose event i has x = first_x + i
+ */
+EventFrameSoA frameOf(uint64_t frame_number, size_t count, int16_t first_x = 0)
+{
+    EventFrameSoA frame;
+    frame.reserve(count);
+    frame.frame_number = frame_number;
+    frame.timestamp = static_cast<int64_t>(frame_number) * 1000;
+    frame.count = count;
+    for (size_t i = 0; i < count; i++) {
+        frame.x[i] = static_cast<int16_t>(first_x + static_cast<int16_t>(i));
+        frame.y[i] = 1;
+    }
+    return frame;
+}
+
+/**
+ * Writable mapping of a ring, standing in for a writer caught mid-packet
+ */
+class RingMapping {
+public:
+    RingMapping(const std::string& name, size_t size)
+        : size_(size)
+        , header_(nullptr)
+    {
+        const int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd >= 0) {
+            void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (addr != MAP_FAILED) {
+                header_ = static_cast<shm::RingHeader*>(addr);
+            }
+            close(fd);
+        }
+    }
+
+    ~RingMapping()
+    {
+        if (header_) {
+            munmap(header_, size_);
+        }
+    }
+
+    RingMapping(const RingMapping&) = delete;
+    RingMapping& operator=(const RingMapping&) = delete;
+
+    shm::RingHeader* header() { return header_; }
+
+private:
+    size_t size_;
+    shm::RingHeader* header_;
+};
+
+} // namespace
+
+TEST(SharedMemoryRingTest, LargeFrameIsSplitIntoContinuedPackets)
+{
+    const Config cfg = shmConfig("/dvbridge_test_shm_split", 8, 4);
+    SharedMemoryWriter writer(cfg);
+    ASSERT_TRUE(writer.open());
+    SharedMemoryReader reader(cfg.shm_name);
+    ASSERT_TRUE(reader.open());
+
+    EXPECT_EQ(writer.writeFrame(frameOf(7, 10)), 3u);
+
+    std::vector<int16_t> xs;
+    const uint32_t expected_flags[] = {shm::kFlagContinued, shm::kFlagContinued, 0};
+    for (uint32_t flags : expected_flags) {
+        SharedMemoryReader::Packet packet;
+        ASSERT_EQ(reader.next(packet, 1000), SharedMemoryReader::Status::Ok);
+        EXPECT_EQ(packet.flags, flags);
+        EXPECT_EQ(packet.frame_number, 7u);
+        EXPECT_EQ(packet.timestamp, 7000);
+        ASSERT_NE(packet.events, nullptr);
+        for (uint32_t i = 0; i < packet.count; i++) {
+            xs.push_back(packet.events[i].x);
+        }
+        EXPECT_TRUE(reader.isValid(packet));
+    }
+    EXPECT_EQ(xs, (std::vector<int16_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(reader.getOverrunPackets(), 0u);
+}
+
+TEST(SharedMemoryRingTest, LappedReaderSkipsToOldestIntactPacket)
+{
+    const Config cfg = shmConfig("/dvbridge_test_shm_overrun", 4, 16);
+    SharedMemoryWriter writer(cfg);
+    ASSERT_TRUE(writer.open());
+    SharedMemoryReader reader(cfg.shm_name);
+    ASSERT_TRUE(reader.open());
+
+    for (uint64_t frame = 0; frame < 10; frame++) {
+        writer.writeFrame(frameOf(frame, 1));
+    }
+
+    // Only the last slot_count packets are still in the ring
+    SharedMemoryReader::Packet packet;
+    ASSERT_EQ(reader.next(packet, 1000), SharedMemoryReader::Status::Ok);
+    EXPECT_EQ(packet.index, 6u);
+    EXPECT_EQ(packet.frame_number, 6u);
+    EXPECT_EQ(reader.getOverrunPackets(), 6u);
+    for (uint64_t frame = 7; frame < 10; frame++) {
+        ASSERT_EQ(reader.next(packet, 1000), SharedMemoryReader::Status::Ok);
+        EXPECT_EQ(packet.frame_number, frame);
+    }
+    EXPECT_EQ(reader.next(packet, 10), SharedMemoryReader::Status::Timeout);
+}
+
+TEST(SharedMemoryRingTest, TornPacketsAreDetected)
+{
+    const Config cfg = shmConfig("/dvbridge_test_shm_torn", 4, 16);
+    SharedMemoryWriter writer(cfg);
+    ASSERT_TRUE(writer.open());
+    SharedMemoryReader reader(cfg.shm_name);
+    ASSERT_TRUE(reader.open());
+
+    // Overwritten while in use: isValid() tells the consumer to discard it
+    writer.writeFrame(frameOf(0, 2));
+    SharedMemoryReader::Packet packet;
+    ASSERT_EQ(reader.next(packet, 1000), SharedMemoryReader::Status::Ok);
+    EXPECT_TRUE(reader.isValid(packet));
+    for (uint64_t frame = 1; frame <= 4; frame++) {
+        writer.writeFrame(frameOf(frame, 2));
+    }
+    EXPECT_FALSE(reader.isValid(packet));
+
+    // Caught mid-write (odd sequence): skipped and counted, the reader
+    // goes on with the next packet
+    RingMapping ring(cfg.shm_name, shm::regionSize(4, 16));
+    ASSERT_NE(ring.header(), nullptr);
+    const uint64_t overrun = reader.getOverrunPackets();
+    shm::slotAt(ring.header(), packet.index + 1)->sequence.store(2 * (packet.index + 1) + 1);
+    ASSERT_EQ(reader.next(packet, 1000), SharedMemoryReader::Status::Ok);
+    EXPECT_EQ(packet.frame_number, 2u);
+    EXPECT_EQ(reader.getOverrunPackets(), overrun + 1);
+}
+
+TEST(SharedMemoryRingTest, CloseWakesBlockedReader)
+{
+    const Config cfg = shmConfig("/dvbridge_test_shm_close", 4, 16);
+    SharedMemoryWriter writer(cfg);
+    ASSERT_TRUE(writer.open());
+    SharedMemoryReader reader(cfg.shm_name);
+    ASSERT_TRUE(reader.open());
+
+    auto status = std::async(std::launch::async, [&reader]() {
+        SharedMemoryReader::Packet packet;
+        return reader.next(packet, -1);
+    });
+    // Let it block on the futex first
+    EXPECT_EQ(status.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    writer.close();
+    ASSERT_EQ(status.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(status.get(), SharedMemoryReader::Status::Closed);
+}
+
+#endif // __linux__
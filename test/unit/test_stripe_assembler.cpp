@@ -0,0 +1,179 @@
+#include "stripe_assembler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace converter;
+using namespace std::chrono_literals;
+
+namespace {
+
+StripeAssembler::Frame frameWithCounter(uint32_t counter, bool counter_reset = false)
+{
+    StripeAssembler::Frame frame;
+    frame.counter = counter;
+    frame.counter_reset = counter_reset;
+    frame.data.assign(16, static_cast<uint8_t>(counter));
+    return frame;
+}
+
+/**
+ * Assembler with its own rx_frames_lost counter
+ */
+struct Stripes {
+    Counter lost;
+    StripeAssembler assembler;
+
+    Stripes(const std::string& name, size_t connections, size_t capacity = 16,
+            std::chrono::milliseconds max_wait = 2000ms)
+        : lost(MetricsRegistry::global().counter(name))
+        , assembler(connections, capacity, max_wait, lost)
+    {
+    }
+
+    std::vector<uint32_t> popCounters(size_t count)
+    {
+        std::vector<uint32_t> counters;
+        StripeAssembler::Frame frame;
+        while (counters.size() < count && assembler.pop(frame)) {
+            counters.push_back(frame.counter);
+        }
+        return counters;
+    }
+};
+
+} // namespace
+
+TEST(StripeAssemblerTest, RestoresCounterOrder)
+{
+    Stripes s("test_stripe_order_lost", 2);
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(0, true)));
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(2)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(1)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(3)));
+    EXPECT_EQ(s.popCounters(4), (std::vector<uint32_t>{0, 1, 2, 3}));
+    EXPECT_EQ(s.lost.value(), 0u);
+}
+
+TEST(StripeAssemblerTest, StartWithoutCounterResetCountsNoLosses)
+{
+    // The session starts mid-stream at counter 500: 497..499 were never
+    // sent to this receiver and must not show up as lost frames
+    Stripes s("test_stripe_start_lost", 4);
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(500)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(501)));
+    ASSERT_TRUE(s.assembler.push(2, frameWithCounter(502)));
+    ASSERT_TRUE(s.assembler.push(3, frameWithCounter(503)));
+    EXPECT_EQ(s.popCounters(4), (std::vector<uint32_t>{500, 501, 502, 503}));
+    EXPECT_EQ(s.lost.value(), 0u);
+}
+
+TEST(StripeAssemblerTest, EarlierFrameFromSlowerConnectionStillFirst)
+{
+    // Without CounterReset, frames up to K-1 before the first one pushed
+    // may still come on the other connections
+    Stripes s("test_stripe_early_lost", 3);
+    ASSERT_TRUE(s.assembler.push(2, frameWithCounter(12)));
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(10)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(11)));
+    EXPECT_EQ(s.popCounters(3), (std::vector<uint32_t>{10, 11, 12}));
+    EXPECT_EQ(s.lost.value(), 0u);
+}
+
+TEST(StripeAssemblerTest, CounterResetDropsEarlierFrames)
+{
+    Stripes s("test_stripe_reset_lost", 2);
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(7)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(8, true)));
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(9)));
+    EXPECT_EQ(s.popCounters(2), (std::vector<uint32_t>{8, 9}));
+    EXPECT_EQ(s.lost.value(), 0u);
+}
+
+TEST(StripeAssemblerTest, GapIsSkippedOnceEveryConnectionIsPastIt)
+{
+    Stripes s("test_stripe_gap_lost", 2);
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(0, true)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(1)));
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(2)));
+    // 3 and 4 lost on the wire
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(5)));
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(6)));
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(s.popCounters(5), (std::vector<uint32_t>{0, 1, 2, 5, 6}));
+    // Known lost: no waiting for max_wait
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1000ms);
+    EXPECT_EQ(s.lost.value(), 2u);
+
+    // A late frame for a skipped slot is dropped
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(3)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(7)));
+    EXPECT_EQ(s.popCounters(1), (std::vector<uint32_t>{7}));
+}
+
+TEST(StripeAssemblerTest, QuietConnectionHoldsUpOnlyForMaxWait)
+{
+    Stripes s("test_stripe_quiet_lost", 2, 16, 50ms);
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(0, true)));
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(2)));
+    // Connection 1 never delivers 1
+    EXPECT_EQ(s.popCounters(2), (std::vector<uint32_t>{0, 2}));
+    EXPECT_EQ(s.lost.value(), 1u);
+}
+
+TEST(StripeAssemblerTest, CountersWrapAround)
+{
+    Stripes s("test_stripe_wrap_lost", 2);
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(0xFFFFFFFEu, true)));
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(0)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(0xFFFFFFFFu)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(1)));
+    EXPECT_EQ(s.popCounters(4), (std::vector<uint32_t>{0xFFFFFFFEu, 0xFFFFFFFFu, 0, 1}));
+    EXPECT_EQ(s.lost.value(), 0u);
+}
+
+TEST(StripeAssemblerTest, ClosedConnectionEndsStreamAfterPendingFrames)
+{
+    Stripes s("test_stripe_end_lost", 2);
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(0, true)));
+    ASSERT_TRUE(s.assembler.push(1, frameWithCounter(1)));
+    s.assembler.closeConnection(1);
+    EXPECT_EQ(s.popCounters(10), (std::vector<uint32_t>{0, 1}));
+}
+
+TEST(StripeAssemblerTest, CloseWakesPopAndPush)
+{
+    Stripes s("test_stripe_close_lost", 1, 1);
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(0, true)));
+
+    // Full: this push blocks until close()
+    bool pushed = true;
+    std::thread reader([&]() { pushed = s.assembler.push(0, frameWithCounter(1)); });
+    std::this_thread::sleep_for(20ms);
+    s.assembler.close();
+    reader.join();
+    EXPECT_FALSE(pushed);
+
+    StripeAssembler::Frame frame;
+    EXPECT_FALSE(s.assembler.pop(frame));
+}
+
+TEST(StripeAssemblerTest, RecyclesPayloadBuffers)
+{
+    Stripes s("test_stripe_buffers_lost", 1);
+    EXPECT_EQ(s.assembler.takeBuffer().capacity(), 0u);
+
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(0, true)));
+    ASSERT_TRUE(s.assembler.push(0, frameWithCounter(1)));
+    StripeAssembler::Frame frame;
+    ASSERT_TRUE(s.assembler.pop(frame));
+    const uint8_t* storage = frame.data.data();
+    // The next pop() hands the previous payload buffer back to the readers
+    ASSERT_TRUE(s.assembler.pop(frame));
+    EXPECT_EQ(s.assembler.takeBuffer().data(), storage);
+}
@@ -0,0 +1,153 @@
+#include "tile_activity.hpp"
+#include "unpack_kernels.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace converter;
+using converter::test::kNegative;
+using converter::test::kPositive;
+using converter::test::kUnused;
+
+TEST(TileGridTest, LayoutRoundsUpPartialTiles)
+{
+    TileGrid grid;
+    grid.resize(1280, 720);
+    EXPECT_EQ(grid.tilesX(), 40);
+    EXPECT_EQ(grid.tilesY(), 23);
+    EXPECT_EQ(grid.tileCount(), 920u);
+
+    grid.resize(346, 260);
+    EXPECT_EQ(grid.tilesX(), 11);
+    EXPECT_EQ(grid.tilesY(), 9);
+}
+
+TEST(TileGridTest, CountsEventsPerTile)
+{
+    const Config cfg = test::makeConfig(100, 40);
+    std::vector<uint8_t> frame = test::emptyFrame(cfg);
+    test::setPixel(frame, cfg.width, 0, 0, kPositive);      // Tile 0
+    test::setPixel(frame, cfg.width, 31, 31, kNegative);    // Tile 0
+    test::setPixel(frame, cfg.width, 32, 0, kPositive);     // Tile 1
+    test::setPixel(frame, cfg.width, 99, 39, kPositive);    // Tile 7, the narrow corner
+    test::setPixel(frame, cfg.width, 50, 10, kUnused);      // Not an event
+
+    TileGrid grid;
+    grid.resize(cfg.width, cfg.height);
+    TileActivity activity;
+    grid.count(frame.data(), frame.size(), activity);
+
+    ASSERT_EQ(activity.counts.size(), 8u);
+    EXPECT_EQ(activity.tiles_x, 4);
+    EXPECT_EQ(activity.tiles_y, 2);
+    EXPECT_EQ(activity.counts, (std::vector<uint32_t>{2, 1, 0, 0, 0, 0, 0, 1}));
+    EXPECT_EQ(activity.total, 4u);
+    EXPECT_EQ(activity.active(), 3u);
+    EXPECT_EQ(activity.active(2), 1u);
+}
+
+TEST(TileGridTest, TotalMatchesCountEvents)
+{
+    for (double density : {0.0, 0.01, 0.3, 1.0}) {
+        const Config cfg = test::makeConfig(1280, 720);
+        const std::vector<uint8_t> frame = test::randomFrame(cfg, density, 17);
+        TileGrid grid;
+        grid.resize(cfg.width, cfg.height);
+        TileActivity activity;
+        grid.count(frame.data(), frame.size(), activity);
+
+        uint64_t sum = 0;
+        for (uint32_t c : activity.counts) {
+            sum += c;
+        }
+        EXPECT_EQ(activity.total, countEvents(frame.data(), frame.size())) << "density " << density;
+        EXPECT_EQ(sum, activity.total);
+    }
+}
+
+TEST(TileGridTest, RangesCoverSelectedTiles)
+{
+    TileGrid grid;
+    grid.resize(128, 64);   // 4 x 2 tiles, 32 bytes per row
+    std::vector<uint8_t> selected(grid.tileCount(), 0);
+    std::vector<ByteRange> ranges;
+
+    // Tile 1: bytes 8..16 of each of the first 32 rows
+    selected[1] = 1;
+    grid.ranges(selected, ranges);
+    ASSERT_EQ(ranges.size(), 32u);
+    EXPECT_EQ(ranges[0].begin, 8u);
+    EXPECT_EQ(ranges[0].end, 16u);
+    EXPECT_EQ(ranges[31].begin, 31u * 32 + 8);
+
+    // A whole row of tiles merges into one range
+    std::fill(selected.begin(), selected.end(), 0);
+    for (int tx = 0; tx < 4; tx++) {
+        selected[4 + tx] = 1;
+    }
+    grid.ranges(selected, ranges);
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].begin, 32u * 32);
+    EXPECT_EQ(ranges[0].end, 64u * 32);
+
+    // Tile 3 ends where tile 4 starts (row 31 into row 32): 32 + 32 rows,
+    // one merge
+    std::fill(selected.begin(), selected.end(), 0);
+    selected[3] = 1;
+    selected[4] = 1;
+    grid.ranges(selected, ranges);
+    ASSERT_EQ(ranges.size(), 63u);
+    EXPECT_EQ(ranges[31].begin, 31u * 32 + 24);
+    EXPECT_EQ(ranges[31].end, 32u * 32 + 8);
+}
+
+TEST(TileGridTest, RangesOfEveryTileAreTheWholeFrame)
+{
+    // Width not a multiple of 4: bytes straddle rows
+    TileGrid grid;
+    grid.resize(70, 35);
+    std::vector<uint8_t> selected(grid.tileCount(), 1);
+    std::vector<ByteRange> ranges;
+    grid.ranges(selected, ranges);
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].begin, 0u);
+    EXPECT_EQ(ranges[0].end, static_cast<size_t>((70 * 35 + 3) / 4));
+}
+
+TEST(TileSelectionTest, Parse)
+{
+    const size_t tiles = TileGrid::tileCount(1280, 720);
+    EXPECT_EQ(tiles, 920u);
+    TileSelection selection;
+    ASSERT_TRUE(parseTileSelection("", tiles, selection));
+    EXPECT_TRUE(selection.all());
+
+    ASSERT_TRUE(parseTileSelection("active", tiles, selection));
+    EXPECT_TRUE(selection.active_only);
+    EXPECT_TRUE(selection.tiles.empty());
+
+    ASSERT_TRUE(parseTileSelection(" 0, 5-7 ,40,active", tiles, selection));
+    EXPECT_TRUE(selection.active_only);
+    EXPECT_EQ(selection.tiles, (std::vector<uint32_t>{0, 5, 6, 7, 40}));
+
+    EXPECT_FALSE(parseTileSelection("3-1", tiles, selection));
+    EXPECT_FALSE(parseTileSelection("x", tiles, selection));
+    EXPECT_FALSE(parseTileSelection("4-", tiles, selection));
+    EXPECT_FALSE(parseTileSelection("4.5", tiles, selection));
+}
+
+TEST(TileSelectionTest, TilesMustBeInsideTheFrame)
+{
+    const size_t tiles = TileGrid::tileCount(128, 64);  // 4 x 2
+    TileSelection selection;
+    ASSERT_TRUE(parseTileSelection("0-7", tiles, selection));
+    EXPECT_EQ(selection.tiles.size(), 8u);
+    EXPECT_FALSE(parseTileSelection("8", tiles, selection));
+    EXPECT_FALSE(parseTileSelection("6-8", tiles, selection));
+    // Rejected before anything is expanded
+    EXPECT_FALSE(parseTileSelection("0-4000000000", tiles, selection));
+    EXPECT_TRUE(selection.tiles.empty());
+}
@@ -0,0 +1,61 @@
+#include "udp_receiver.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
+
+using namespace converter;
+using converter::test::counterValue;
+using converter::test::encodedHeader;
+using converter::test::v1Config;
+
+#ifdef __linux__
+
+TEST(UdpReceiverTest, MoveAssignmentKeepsHeaderState)
+{
+    Config cfg = v1Config("test_udp_move_");
+    cfg.camera_ip = "127.0.0.1";
+    cfg.camera_port = 46173;
+    cfg.recv_buffer_size = 1 << 16;
+
+    UdpReceiver first(cfg);
+    ASSERT_TRUE(first.connect());
+
+    const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sender, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(cfg.camera_port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    auto send = [&](uint32_t counter, int64_t timestamp) {
+        std::vector<uint8_t> datagram = encodedHeader(counter, 8, timestamp);
+        datagram.resize(datagram.size() + 8, 0x55);
+        return sendto(sender, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&addr),
+                      sizeof(addr)) == static_cast<ssize_t>(datagram.size());
+    };
+
+    std::vector<uint8_t> buffer;
+    ASSERT_TRUE(send(20, 1000));
+    ASSERT_TRUE(first.receiveFrame(buffer));
+
+    UdpReceiver second(cfg);
+    second = std::move(first);
+    EXPECT_EQ(second.getFrameTimestamp(), 1000);
+
+    // Counter 22 after 20 on the same stream: one frame lost
+    ASSERT_TRUE(send(22, 3000));
+    ASSERT_TRUE(second.receiveFrame(buffer));
+    EXPECT_EQ(second.getFrameTimestamp(), 3000);
+    EXPECT_EQ(counterValue(cfg, "rx_frames_lost"), 1u);
+    close(sender);
+}
+
+#endif // __linux__
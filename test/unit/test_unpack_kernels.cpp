@@ -0,0 +1,181 @@
+#include "unpack_kernels.hpp"
+#include "fixtures/test_frames.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace converter;
+
+namespace {
+
+/**
+ * A frame and the coordinate tables the kernels need
+ */
+struct KernelFrame {
+    int width = 0;
+    int total_pixels = 0;
+    std::vector<uint8_t> data;
+    std::vector<int16_t> byte_x;
+    std::vector<int16_t> byte_y;
+
+    KernelFrame(int w, int h, std::vector<uint8_t> bytes)
+        : width(w)
+        , total_pixels(w * h)
+        , data(std::move(bytes))
+    {
+        buildCoordinateTables(width, static_cast<int>(data.size()), byte_x, byte_y);
+    }
+
+    UnpackContext context(size_t begin, size_t end) const
+    {
+        UnpackContext ctx;
+        ctx.data = data.data();
+        ctx.begin = begin;
+        ctx.end = end;
+        ctx.width = width;
+        ctx.total_pixels = total_pixels;
+        ctx.byte_x = byte_x.data();
+        ctx.byte_y = byte_y.data();
+        ctx.timestamp = 1234;
+        return ctx;
+    }
+};
+
+/**
+ * Bytes where each byte is non-zero with probability `density` (random
+ * pixel values, including the unused 11)
+ */
+std::vector<uint8_t> randomBytes(size_t size, double density, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<uint8_t> bytes(size, 0);
+    for (auto& b : bytes) {
+        if (uniform(rng) < density) {
+            b = static_cast<uint8_t>(rng() & 0xFF);
+        }
+    }
+    return bytes;
+}
+
+/**
+ * Run every available kernel over [begin, end) and compare with unpackScalar
+ * Kernels that need full bytes get the range up to the last full byte.
+ */
+void expectKernelsMatchScalar(const KernelFrame& frame, size_t begin, size_t end)
+{
+    for (const KernelInfo& kernel : availableKernels()) {
+        SCOPED_TRACE(std::string(kernel.name) + " bytes [" + std::to_string(begin) + ", " + std::to_string(end) + ")");
+        size_t kernel_end = end;
+        if (kernel.full_bytes_only) {
+            kernel_end = std::min(end, std::max(begin, static_cast<size_t>(frame.total_pixels / 4)));
+        }
+        const UnpackContext ctx = frame.context(begin, kernel_end);
+
+        std::vector<dv::Event> expected(4 * (kernel_end - begin) + 1);
+        std::vector<dv::Event> actual(4 * (kernel_end - begin) + 1);
+        const size_t expected_count = unpackScalar(ctx, expected.data());
+        const size_t actual_count = kernel.fn(ctx, actual.data());
+
+        ASSERT_EQ(actual_count, expected_count);
+        for (size_t i = 0; i < expected_count; i++) {
+            ASSERT_EQ(actual[i].x(), expected[i].x()) << "event " << i;
+            ASSERT_EQ(actual[i].y(), expected[i].y()) << "event " << i;
+            ASSERT_EQ(actual[i].polarity(), expected[i].polarity()) << "event " << i;
+            ASSERT_EQ(actual[i].timestamp(), expected[i].timestamp()) << "event " << i;
+        }
+    }
+}
+
+} // namespace
+
+TEST(UnpackKernelsTest, ScalarIsFirstAndEveryKernelIsFindable)
+{
+    const auto& kernels = availableKernels();
+    ASSERT_FALSE(kernels.empty());
+    EXPECT_EQ(kernels.front().id, UnpackKernel::Scalar);
+    for (const KernelInfo& kernel : kernels) {
+        EXPECT_EQ(findKernel(kernel.id), &kernel) << kernel.name;
+    }
+#if defined(__aarch64__) || defined(_M_ARM64)
+    EXPECT_NE(findKernel(UnpackKernel::Neon), nullptr);
+#endif
+}
+
+TEST(UnpackKernelsTest, RandomDensities)
+{
+    // 1280x720 and an odd width whose bytes straddle rows
+    for (const auto& [width, height] : {std::pair<int, int>{1280, 720}, std::pair<int, int>{346, 260}}) {
+        const size_t size = static_cast<size_t>((width * height + 3) / 4);
+        for (double density : {0.0005, 0.01, 0.1, 0.5, 1.0}) {
+            SCOPED_TRACE("density " + std::to_string(density) + ", width " + std::to_string(width));
+            const KernelFrame frame(width, height, randomBytes(size, density, static_cast<uint32_t>(density * 1e6)));
+            expectKernelsMatchScalar(frame, 0, size);
+        }
+    }
+}
+
+TEST(UnpackKernelsTest, UniformFrames)
+{
+    // All zero (nothing), all 0xFF (every pixel unused, still nothing),
+    // all positive, all negative
+    for (uint8_t value : {uint8_t{0x00}, uint8_t{0xFF}, uint8_t{0x55}, uint8_t{0xAA}}) {
+        SCOPED_TRACE("byte " + std::to_string(value));
+        const KernelFrame frame(640, 48, std::vector<uint8_t>(640 * 48 / 4, value));
+        expectKernelsMatchScalar(frame, 0, frame.data.size());
+    }
+
+    const KernelFrame unused(64, 8, std::vector<uint8_t>(64 * 8 / 4, 0xFF));
+    std::vector<dv::Event> out(unused.data.size() * 4);
+    for (const KernelInfo& kernel : availableKernels()) {
+        EXPECT_EQ(kernel.fn(unused.context(0, unused.data.size()), out.data()), 0u) << kernel.name;
+    }
+}
+
+TEST(UnpackKernelsTest, TailsShorterThanVectorBlocks)
+{
+    // Range lengths around the 16 / 32 / 64-byte blocks of the SIMD kernels
+    const KernelFrame frame(1024, 4, randomBytes(1024, 0.3, 99));
+    for (size_t length : {1u, 3u, 15u, 16u, 17u, 31u, 33u, 63u, 64u, 65u, 127u, 129u, 200u, 1000u}) {
+        expectKernelsMatchScalar(frame, 0, length);
+    }
+}
+
+TEST(UnpackKernelsTest, UnalignedSubRanges)
+{
+    const KernelFrame frame(1280, 16, randomBytes(1280 * 16 / 4, 0.2, 42));
+    std::mt19937 rng(7);
+    for (int i = 0; i < 200; i++) {
+        size_t begin = rng() % frame.data.size();
+        size_t end = begin + rng() % (frame.data.size() - begin + 1);
+        expectKernelsMatchScalar(frame, begin, end);
+    }
+    expectKernelsMatchScalar(frame, 5, 5);
+}
+
+TEST(UnpackKernelsTest, PartialLastByte)
+{
+    // 7 x 3 = 21 pixels: the last byte holds one pixel and three padding
+    // pixels, which must never produce events
+    std::vector<uint8_t> bytes(6, 0x55);
+    const KernelFrame frame(7, 3, bytes);
+    expectKernelsMatchScalar(frame, 0, bytes.size());
+
+    std::vector<dv::Event> out(4 * bytes.size());
+    EXPECT_EQ(unpackScalar(frame.context(0, bytes.size()), out.data()), 21u);
+    EXPECT_EQ(out[20].x(), 6);
+    EXPECT_EQ(out[20].y(), 2);
+}
+
+TEST(UnpackKernelsTest, CountEventsMatchesScalar)
+{
+    const KernelFrame frame(1280, 32, randomBytes(1280 * 32 / 4, 0.2, 3));
+    std::vector<dv::Event> out(frame.data.size() * 4);
+    for (size_t length : {size_t{0}, size_t{7}, size_t{8}, size_t{9}, frame.data.size()}) {
+        EXPECT_EQ(countEvents(frame.data.data(), length), unpackScalar(frame.context(0, length), out.data()))
+            << length << " bytes";
+    }
+}
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+DVBridge Recording Range Extractor
+
+Cuts a time or frame range out of a recording written with output_file
+(optionally split with output_segment_frames) or by batch conversion
+(convert_chunk_frames), into a single AEDAT4 file.
+
+The recording's index (<output_file>.index, see include/recording.hpp)
+lists the frame and time range of every segment, so only the segments
+that overlap the range are opened; inside a segment the AEDAT4 packet
+table seeks to the first packet of the range, and events are copied in
+windows of --window seconds. Extracting a minute out of a multi-hour
+recording reads about a minute of data.
+
+Requires dv-processing (pip install dv-processing), except for --list.
+
+Usage:
+    python tools/extract_range.py capture.aedat4.index --list
+    python tools/extract_range.py capture.aedat4.index --start 3600 --end 3660 -o minute.aedat4
+    python tools/extract_range.py capture.aedat4.index --start-frame 1000 --end-frame 2000 -o part.aedat4
+"""
+
+import argparse
+import sys
+from pathlib import Path
+
+MAGIC = "# DVBridge recording index"
+VERSION = 1
+
+
+def read_index(path):
+    """Parse an index into (header dict, segments sorted by first frame)."""
+    path = Path(path)
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    if not lines or not lines[0].startswith(MAGIC):
+        raise ValueError(f"{path}: not a DVBridge recording index")
+    version = int(lines[0][len(MAGIC):])
+    if version != VERSION:
+        raise ValueError(f"{path}: unsupported index version {version}")
+
+    header = {}
+    segments = []
+    for line in lines[1:]:
+        if line.startswith("#"):
+            # "# width=1280 height=720 frame_interval_us=10000"
+            for field in line[1:].split():
+                key, sep, value = field.partition("=")
+                if sep:
+                    header[key] = int(value)
+            continue
+        if not line.strip():
+            continue
+        fields = line.split()
+        if len(fields) != 6:
+            raise ValueError(f"{path}: malformed line '{line}'")
+        name, first_frame, frames, begin_us, end_us, events = fields
+        segments.append({
+            "path": path.parent / name,
+            "first_frame": int(first_frame),
+            "frames": int(frames),
+            "begin_us": int(begin_us),
+            "end_us": int(end_us),
+            "events": int(events),
+        })
+
+    for key in ("width", "height", "frame_interval_us"):
+        if key not in header:
+            raise ValueError(f"{path}: missing {key}")
+    segments.sort(key=lambda s: s["first_frame"])
+    return header, segments
+
+
+def print_segments(header, segments):
+    print(f"{header['width']}x{header['height']}, {header['frame_interval_us']} us per frame")
+    print(f"{'segment':<32} {'frames':<21} {'seconds':<23} {'events':>12}")
+    for s in segments:
+        last = s["first_frame"] + s["frames"]
+        print(f"{s['path'].name:<32} {s['first_frame']:>10}-{last:<10} "
+              f"{s['begin_us'] / 1e6:>11.3f}-{s['end_us'] / 1e6:<11.3f} {s['events']:>12}")
+    if segments:
+        total = sum(s["events"] for s in segments)
+        print(f"{len(segments)} segments, {segments[-1]['end_us'] / 1e6:.3f} s, {total} events")
+
+
+def frame_time(header, segments, frame):
+    """Timestamp (us) of a frame number, from the segment that holds it."""
+    interval = header["frame_interval_us"]
+    for s in segments:
+        if frame < s["first_frame"] + s["frames"]:
+            # Segment times are the frames' own (camera clock with v1 headers)
+            return s["begin_us"] + (max(frame, s["first_frame"]) - s["first_frame"]) * interval
+    if not segments:
+        return frame * interval
+    last = segments[-1]
+    return last["end_us"] + (frame - last["first_frame"] - last["frames"]) * interval
+
+
+def extract(header, segments, start_us, end_us, output, window_us):
+    """Copy events with start_us <= timestamp < end_us into output."""
+    try:
+        import dv_processing as dv
+    except ImportError:
+        raise RuntimeError("dv-processing not installed (pip install dv-processing)")
+
+    selected = [s for s in segments if s["begin_us"] < end_us and s["end_us"] > start_us]
+    if not selected:
+        raise ValueError("no segment overlaps the range")
+
+    config = dv.io.MonoCameraWriter.EventOnlyConfig("DVBridge", (header["width"], header["height"]))
+    writer = dv.io.MonoCameraWriter(str(output), config)
+    written = 0
+    for s in selected:
+        reader = dv.io.MonoCameraRecording(str(s["path"]))
+        t = max(start_us, s["begin_us"])
+        stop = min(end_us, s["end_us"])
+        while t < stop:
+            step = min(t + window_us, stop)
+            events = reader.getEventsTimeRange(t, step)
+            if events is not None and len(events) > 0:
+                writer.writeEvents(events)
+                written += len(events)
+            t = step
+    return len(selected), written
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Extract a time range of a DVBridge recording")
+    parser.add_argument("index", help="Recording index (<output_file>.index)")
+    parser.add_argument("--list", action="store_true", help="List the segments and exit")
+    parser.add_argument("--start", type=float, help="Range start timestamp in seconds (default: recording start)")
+    parser.add_argument("--end", type=float, help="Range end timestamp in seconds, exclusive (default: recording end)")
+    parser.add_argument("--start-frame", type=int, help="Range start as a frame number")
+    parser.add_argument("--end-frame", type=int, help="Range end as a frame number, exclusive")
+    parser.add_argument("-o", "--output", help="Output AEDAT4 file")
+    parser.add_argument("--window", type=float, default=1.0, help="Seconds of events read at a time")
+    args = parser.parse_args()
+
+    try:
+        header, segments = read_index(args.index)
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    if args.list:
+        print_segments(header, segments)
+        return 0
+    if not args.output:
+        parser.error("-o/--output is required unless --list is given")
+    if args.start is not None and args.start_frame is not None:
+        parser.error("--start and --start-frame are exclusive")
+    if args.end is not None and args.end_frame is not None:
+        parser.error("--end and --end-frame are exclusive")
+
+    start_us = segments[0]["begin_us"] if segments else 0
+    end_us = segments[-1]["end_us"] if segments else 0
+    if args.start is not None:
+        start_us = int(args.start * 1e6)
+    elif args.start_frame is not None:
+        start_us = frame_time(header, segments, args.start_frame)
+    if args.end is not None:
+        end_us = int(args.end * 1e6)
+    elif args.end_frame is not None:
+        end_us = frame_time(header, segments, args.end_frame)
+    if end_us <= start_us:
+        parser.error("empty range")
+
+    try:
+        count, written = extract(header, segments, start_us, end_us, args.output, max(1, int(args.window * 1e6)))
+    except (OSError, RuntimeError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+    print(f"Wrote {written} events ({start_us / 1e6:.3f}-{end_us / 1e6:.3f} s) from {count} segments to {args.output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+DVBridge Trace Converter
+
+Converts a binary trace dump (written on SIGUSR1 or when a frame exceeds
+trace_latency_threshold_us, see include/trace.hpp) to Chrome trace JSON.
+Open the result in https://ui.perfetto.dev or chrome://tracing.
+
+Each converter thread (receive, decode-N, ...) becomes a track; receive,
+decode and publish are spans on their thread, reorder and queue waits are
+async spans per frame. --summary prints per-stage timings and the slowest
+spans instead, to find the stage that stalled without opening a viewer.
+
+Usage:
+    python tools/trace_to_chrome.py dvbridge_trace.bin.1
+    python tools/trace_to_chrome.py dvbridge_trace.bin.1 -o trace.json
+    python tools/trace_to_chrome.py dvbridge_trace.bin.1 --summary
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"DVTRACE1"
+VERSION = 1
+RECORD = struct.Struct("<QQBB6x")
+
+PHASE_BEGIN, PHASE_END, PHASE_ASYNC_BEGIN, PHASE_ASYNC_END = range(4)
+
+
+def read_trace(path):
+    """Parse a dump into (header dict, list of (index, name, records))."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if data[:8] != MAGIC:
+        raise ValueError(f"{path}: not a DVBridge trace")
+    version, ring_count, steady_ns, system_ns, stage_count = struct.unpack_from("<IIqqI", data, 8)
+    if version != VERSION:
+        raise ValueError(f"{path}: unsupported trace version {version}")
+    offset = 8 + struct.calcsize("<IIqqI")
+
+    stages = []
+    for _ in range(stage_count):
+        length = data[offset]
+        stages.append(data[offset + 1:offset + 1 + length].decode())
+        offset += 1 + length
+
+    threads = []
+    for _ in range(ring_count):
+        index, name, count = struct.unpack_from("<I16sQ", data, offset)
+        offset += struct.calcsize("<I16sQ")
+        records = list(RECORD.iter_unpack(data[offset:offset + count * RECORD.size]))
+        offset += count * RECORD.size
+        name = name.split(b"\0", 1)[0].decode(errors="replace") or f"thread-{index}"
+        threads.append((index, name, records))
+
+    header = {"steady_ns": steady_ns, "system_ns": system_ns, "stages": stages}
+    return header, threads
+
+
+def stage_name(stages, stage):
+    return stages[stage] if stage < len(stages) else f"stage-{stage}"
+
+
+def collect_spans(header, threads):
+    """Pair begin/end records into (stage, frame, tid, start_ns, end_ns, async)."""
+    stages = header["stages"]
+    spans = []
+    async_begin = {}
+    async_end = {}
+    for tid, _, records in threads:
+        stack = []
+        for time_ns, frame, stage, phase in records:
+            if phase == PHASE_BEGIN:
+                stack.append((stage, frame, time_ns))
+            elif phase == PHASE_END:
+                # Ends whose begin was overwritten in the ring are dropped
+                while stack:
+                    b_stage, b_frame, b_time = stack.pop()
+                    if b_stage == stage and b_frame == frame:
+                        spans.append((stage_name(stages, stage), frame, tid, b_time, time_ns, False))
+                        break
+            elif phase == PHASE_ASYNC_BEGIN:
+                async_begin[(stage, frame)] = (tid, time_ns)
+            elif phase == PHASE_ASYNC_END:
+                async_end.setdefault((stage, frame), []).append(time_ns)
+
+    # Async ends may be on another thread than their begin
+    for key, (tid, b_time) in async_begin.items():
+        end = min((t for t in async_end.get(key, ()) if t >= b_time), default=None)
+        if end is not None:
+            spans.append((stage_name(stages, key[0]), key[1], tid, b_time, end, True))
+    return spans
+
+
+def to_chrome(header, threads, spans):
+    origin = min((s[3] for s in spans), default=0)
+    events = [{"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "dvbridge"}}]
+    for tid, name, _ in threads:
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": {"name": name}})
+
+    for name, frame, tid, start, end, is_async in spans:
+        ts = (start - origin) / 1000.0
+        if is_async:
+            common = {"name": name, "cat": name, "id": frame, "pid": 1, "tid": tid, "args": {"frame": frame}}
+            events.append(dict(common, ph="b", ts=ts))
+            events.append(dict(common, ph="e", ts=(end - origin) / 1000.0))
+        else:
+            events.append({"name": name, "cat": "stage", "ph": "X", "pid": 1, "tid": tid,
+                           "ts": ts, "dur": (end - start) / 1000.0, "args": {"frame": frame}})
+
+    # Wall-clock time of the first span, for matching against logs
+    wall_ns = header["system_ns"] - (header["steady_ns"] - origin)
+    return {"traceEvents": events, "displayTimeUnit": "ns", "otherData": {"start_unix_ns": wall_ns}}
+
+
+def print_summary(spans, slowest):
+    by_stage = {}
+    for span in spans:
+        by_stage.setdefault(span[0], []).append(span[4] - span[3])
+
+    print(f"{'stage':<12} {'count':>8} {'mean us':>10} {'p99 us':>10} {'max us':>10}")
+    for name, durations in sorted(by_stage.items()):
+        durations.sort()
+        p99 = durations[min(len(durations) - 1, int(len(durations) * 0.99))]
+        mean = sum(durations) / len(durations)
+        print(f"{name:<12} {len(durations):>8} {mean / 1000:>10.1f} {p99 / 1000:>10.1f} {durations[-1] / 1000:>10.1f}")
+
+    print(f"\nSlowest {slowest} spans:")
+    for name, frame, tid, start, end, _ in sorted(spans, key=lambda s: s[3] - s[4])[:slowest]:
+        print(f"  {name:<12} frame {frame:<10} thread {tid:<4} {(end - start) / 1000:>10.1f} us")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a DVBridge trace dump to Chrome trace JSON")
+    parser.add_argument("trace", help="Trace dump (dvbridge_trace.bin.N)")
+    parser.add_argument("-o", "--output", help="Output JSON file (default: <trace>.json)")
+    parser.add_argument("--summary", action="store_true", help="Print per-stage timings instead")
+    parser.add_argument("--slowest", type=int, default=10, help="Slowest spans listed by --summary")
+    args = parser.parse_args()
+
+    try:
+        header, threads = read_trace(args.trace)
+    except (OSError, ValueError, struct.error) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+
+    spans = collect_spans(header, threads)
+    if args.summary:
+        print_summary(spans, args.slowest)
+        return 0
+
+    output = args.output or args.trace + ".json"
+    with open(output, "w") as f:
+        json.dump(to_chrome(header, threads, spans), f)
+    print(f"Wrote {len(spans)} spans of {len(threads)} threads to {output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())